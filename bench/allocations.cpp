@@ -0,0 +1,73 @@
+#include "bench.h"
+#include <atomic>
+
+namespace libgs::bench
+{
+
+namespace
+{
+
+std::atomic_size_t g_allocations {0};
+
+// Static TLS of the executable, reading it never allocates.
+thread_local bool g_ignored = false;
+
+inline void count_allocation() noexcept
+{
+	if( not g_ignored )
+		g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+} //namespace
+
+size_t allocation_count() noexcept
+{
+	return g_allocations.load(std::memory_order_relaxed);
+}
+
+void ignore_thread_allocations() noexcept
+{
+	g_ignored = true;
+}
+
+} //namespace libgs::bench
+
+#ifdef __GLIBC__
+
+// Interposes malloc, so operator new and the aligned frames asio recycles
+// (std::aligned_alloc) are all seen.
+extern "C"
+{
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t align, size_t size);
+
+void *malloc(size_t size)
+{
+	libgs::bench::count_allocation();
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	libgs::bench::count_allocation();
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	libgs::bench::count_allocation();
+	return __libc_realloc(ptr, size);
+}
+
+void *aligned_alloc(size_t align, size_t size)
+{
+	libgs::bench::count_allocation();
+	return __libc_memalign(align, size);
+}
+
+} //extern "C"
+
+#endif //__GLIBC__
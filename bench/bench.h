@@ -0,0 +1,128 @@
+#ifndef LIBGS_BENCH_BENCH_H
+#define LIBGS_BENCH_BENCH_H
+
+#include <libgs/core/global.h>
+#include <nlohmann/json.hpp>
+#include <functional>
+#include <vector>
+
+namespace libgs::bench
+{
+
+// Keeps the compiler from discarding a computed value.
+template <typename T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void *sink;
+	sink = &value;
+#endif
+}
+
+// Heap allocations made so far by the counted threads, always 0 where malloc
+// can not be hooked (only glibc is).
+[[nodiscard]] size_t allocation_count() noexcept;
+
+// Stops counting the allocations of the calling thread, for load generators.
+void ignore_thread_allocations() noexcept;
+
+struct result
+{
+	std::string name;
+	size_t iterations = 0;
+	double ns_per_op = 0;
+	double mb_per_sec = 0;
+	double allocs_per_op = 0;
+};
+
+// Runs 'func(n)' with a growing 'n' until one batch takes at least the minimum
+// time, the last batch is reported. 'bytes' is the amount processed per operation.
+class runner
+{
+public:
+	using func_t = std::function<void(size_t)>;
+
+	runner(std::string filter, std::chrono::milliseconds min_time) :
+		m_filter(std::move(filter)), m_min_time(min_time) {}
+
+public:
+	void run(std::string name, const func_t &func, size_t bytes = 0)
+	{
+		using namespace std::chrono;
+		if( not m_filter.empty() and name.find(m_filter) == std::string::npos )
+			return ;
+
+		func(1);
+		size_t iterations = 1;
+		for(;;)
+		{
+			auto allocations = allocation_count();
+			auto begin = steady_clock::now();
+			func(iterations);
+			auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - begin);
+			allocations = allocation_count() - allocations;
+
+			if( elapsed >= m_min_time or iterations >= (size_t(1) << 40) )
+			{
+				result res {std::move(name), iterations};
+				res.ns_per_op = static_cast<double>(elapsed.count()) / static_cast<double>(iterations);
+				res.allocs_per_op = static_cast<double>(allocations) / static_cast<double>(iterations);
+				if( bytes > 0 )
+					res.mb_per_sec = static_cast<double>(bytes) * 1000.0 / res.ns_per_op;
+				m_results.emplace_back(std::move(res));
+				return ;
+			}
+			// Aim a bit past the minimum time for the next batch.
+			auto factor = elapsed.count() > 0 ?
+				static_cast<double>(duration_cast<nanoseconds>(m_min_time).count()) * 1.4 / static_cast<double>(elapsed.count()) : 100.0;
+			iterations = static_cast<size_t>(static_cast<double>(iterations) * std::clamp(factor, 2.0, 100.0));
+		}
+	}
+
+	[[nodiscard]] bool enabled(std::string_view name) const noexcept {
+		return m_filter.empty() or name.find(m_filter) != std::string_view::npos;
+	}
+
+	[[nodiscard]] nlohmann::json to_json() const
+	{
+		auto array = nlohmann::json::array();
+		for(auto &res : m_results)
+		{
+			nlohmann::json obj {
+				{"name", res.name},
+				{"iterations", res.iterations},
+				{"ns_per_op", res.ns_per_op},
+				{"allocs_per_op", res.allocs_per_op}
+			};
+			if( res.mb_per_sec > 0 )
+				obj["mb_per_sec"] = res.mb_per_sec;
+			array.emplace_back(std::move(obj));
+		}
+		return array;
+	}
+
+private:
+	std::string m_filter;
+	std::chrono::milliseconds m_min_time;
+	std::vector<result> m_results;
+};
+
+void core_benchmarks(runner &runner);
+void http_benchmarks(runner &runner);
+
+struct loopback_option
+{
+	unsigned short port = 23456;
+	size_t connections = 64;
+	size_t threads = 4;
+	std::chrono::milliseconds duration {5000};
+	size_t body_size = 64;
+};
+[[nodiscard]] nlohmann::json loopback_benchmark(const loopback_option &option);
+
+} //namespace libgs::bench
+
+
+#endif //LIBGS_BENCH_BENCH_H
@@ -0,0 +1,499 @@
+#include "bench.h"
+#include <libgs/core/algorithm.h>
+#include <libgs/core/lock_free_queue.h>
+#include <libgs/core/shared_mutex.h>
+#include <libgs/core/rcu_ptr.h>
+#include <libgs/core/coro.h>
+#include <fstream>
+#include <thread>
+
+namespace libgs::bench
+{
+
+static void string_benchmarks(runner &runner)
+{
+	runner.run("wildcard_match/literal", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(wildcard_match("/api/v1/users/profile", "/api/v1/users/profile"));
+	});
+	runner.run("wildcard_match/star", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(wildcard_match("/api/*/users/*", "/api/v1/users/profile/avatar.png"));
+	});
+	runner.run("wildcard_match/miss", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(wildcard_match("/static/*.css", "/api/v1/users/profile/avatar.png"));
+	});
+
+	const std::string plain = "/search?q=hello world&lang=zh-CN&tag=c++/asio&page=10#top";
+	const auto encoded = to_percent_encoding(plain);
+	runner.run("percent_encoding/encode", [&](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(to_percent_encoding(plain));
+	},
+	plain.size());
+	runner.run("percent_encoding/decode", [&](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(from_percent_encoding(encoded));
+	},
+	encoded.size());
+
+	runner.run("ston/int32", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(ston<int32_t>(std::string_view("-1234567")));
+	});
+	runner.run("ston/uint64_hex", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(ston<uint64_t>(std::string_view("7fffffffffffffff"), 16));
+	});
+	runner.run("ston/double", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(ston<double>(std::string_view("3.14159265358979")));
+	});
+}
+
+template <concepts::hash_algorithm Hash>
+static void hash_file_benchmark(runner &runner, std::string_view name, const std::filesystem::path &file, size_t size)
+{
+	runner.run(std::format("file_hash/{}/16MiB", name), [&](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(file_hash<Hash>(file).digest());
+	},
+	size);
+}
+
+static void hash_file_benchmarks(runner &runner)
+{
+	if( not runner.enabled("file_hash") )
+		return ;
+
+	constexpr size_t size = 16 * 1024 * 1024;
+	auto file = std::filesystem::temp_directory_path() / "libgs_bench_hash";
+	{
+		std::string data(size, '\0');
+		for(size_t i=0; i<size; i++)
+			data[i] = static_cast<char>(i * 131);
+		std::ofstream(file, std::ios::binary).write(data.data(), static_cast<std::streamsize>(size));
+	}
+	hash_file_benchmark<sha1>(runner, "sha1", file, size);
+	hash_file_benchmark<sha256>(runner, "sha256", file, size);
+	hash_file_benchmark<xxhash64>(runner, "xxhash64", file, size);
+	hash_file_benchmark<xxhash3>(runner, "xxhash3", file, size);
+
+	std::error_code error;
+	std::filesystem::remove(file, error);
+}
+
+static void codec_benchmarks(runner &runner)
+{
+	runner.run("uuid/generate", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(uuid::generate());
+	});
+	runner.run("uuid/generate_v7", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(uuid::generate_v7());
+	});
+	runner.run("uuid/to_string", [uuid = uuid::generate()](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(uuid.to_string());
+	});
+	runner.run("uuid/to_chars", [uuid = uuid::generate()](size_t n)
+	{
+		char buf[uuid::string_size];
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(uuid.to_chars(buf));
+	});
+	runner.run("uuid/from_chars", [text = uuid::generate().to_string()](size_t n)
+	{
+		uuid result;
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(result.from_chars(text));
+	});
+	runner.run("secure_random/uint64", [](size_t n)
+	{
+		secure_random engine;
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(engine());
+	});
+
+	for(size_t size : {64, 1024, 64 * 1024})
+	{
+		std::string data(size, 'x');
+		runner.run(std::format("sha1/{}", size), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(sha1(data).finalize().digest());
+		},
+		size);
+		runner.run(std::format("sha256/{}", size), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(sha256(data).finalize().digest());
+		},
+		size);
+		runner.run(std::format("xxhash64/{}", size), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(xxhash64::hash(data));
+		},
+		size);
+		runner.run(std::format("xxhash3/{}", size), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(xxhash3::hash(data));
+		},
+		size);
+	}
+	hash_file_benchmarks(runner);
+
+	for(size_t size : {64, 1024, 64 * 1024})
+	{
+		std::string data(size, '\0');
+		for(size_t i=0; i<size; i++)
+			data[i] = static_cast<char>(i * 131);
+
+		const auto base64 = to_base64(data);
+		const auto hex = to_hex(data);
+		std::string buf(hex.size(), '\0');
+
+		runner.run(std::format("base64/encode/{}", size), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(to_base64(data.data(), data.size(), buf.data()));
+		},
+		size);
+		runner.run(std::format("base64/decode/{}", size), [&](size_t n)
+		{
+			error_code error;
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(from_base64(base64, buf.data(), error));
+		},
+		size);
+		runner.run(std::format("hex/encode/{}", size), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(to_hex(data.data(), data.size(), buf.data()));
+		},
+		size);
+		runner.run(std::format("hex/decode/{}", size), [&](size_t n)
+		{
+			error_code error;
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(from_hex(hex, buf.data(), error));
+		},
+		size);
+	}
+
+	runner.run("mime_type/suffix", [](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(mime_type_view("/var/www/static/index.html"));
+	});
+	constexpr char png[] = "\x89PNG\r\n\x1a\n\0\0\0\rIHDR";
+	runner.run("mime_type/magic_buffer", [&](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(magic_mime_type(png, sizeof(png) - 1));
+	});
+	auto file = std::filesystem::temp_directory_path() / "libgs_bench_magic";
+	std::ofstream(file, std::ios::binary).write(png, sizeof(png) - 1);
+
+	runner.run("mime_type/magic", [&](size_t n)
+	{
+		for(size_t i=0; i<n; i++)
+			do_not_optimize(mime_type_view(file, true));
+	});
+	std::error_code error;
+	std::filesystem::remove(file, error);
+}
+
+static void queue_benchmarks(runner &runner)
+{
+	runner.run("lock_free_queue/single_thread", [](size_t n)
+	{
+		lock_free_queue<size_t> queue;
+		for(size_t i=0; i<n; i++)
+		{
+			queue.enqueue(i);
+			do_not_optimize(queue.dequeue());
+		}
+	});
+	runner.run("lock_free_queue/4p1c", [](size_t n)
+	{
+		constexpr size_t producers = 4;
+		lock_free_queue<size_t> queue;
+		std::vector<std::thread> threads;
+
+		for(size_t p=0; p<producers; p++)
+		{
+			threads.emplace_back([&queue, count = n / producers + (p < n % producers)]
+			{
+				for(size_t i=0; i<count; i++)
+					queue.enqueue(i);
+			});
+		}
+		for(size_t i=0; i<n;)
+		{
+			if( queue.dequeue() )
+				i++;
+		}
+		for(auto &thread : threads)
+			thread.join();
+	});
+}
+
+template <typename Mutex>
+static void shared_lock_benchmark(runner &runner, std::string_view name)
+{
+	// Seven readers to one writer, the usual session lookup pattern.
+	runner.run(std::format("{}/read_mostly/8t", name), [](size_t n)
+	{
+		constexpr size_t threads = 8;
+		Mutex mutex;
+		size_t value = 0;
+		std::vector<std::thread> pool;
+
+		for(size_t t=0; t<threads; t++)
+		{
+			pool.emplace_back([&, t, count = n / threads + (t < n % threads)]
+			{
+				for(size_t i=0; i<count; i++)
+				{
+					if( t == 0 )
+					{
+						std::unique_lock lock(mutex);
+						++value;
+					}
+					else
+					{
+						std::shared_lock lock(mutex);
+						do_not_optimize(value);
+					}
+				}
+			});
+		}
+		for(auto &thread : pool)
+			thread.join();
+	});
+}
+
+static void lock_benchmarks(runner &runner)
+{
+	runner.run("spin_mutex/contention/4t", [](size_t n)
+	{
+		constexpr size_t threads = 4;
+		spin_mutex mutex;
+		size_t counter = 0;
+		std::vector<std::thread> pool;
+
+		for(size_t t=0; t<threads; t++)
+		{
+			pool.emplace_back([&, count = n / threads + (t < n % threads)]
+			{
+				for(size_t i=0; i<count; i++)
+				{
+					std::lock_guard lock(mutex);
+					++counter;
+				}
+			});
+		}
+		for(auto &thread : pool)
+			thread.join();
+		do_not_optimize(counter);
+	});
+	shared_lock_benchmark<spin_shared_mutex>(runner, "spin_shared_mutex");
+	shared_lock_benchmark<std::shared_mutex>(runner, "std::shared_mutex");
+
+	// Same pattern as above, the writer publishes a new copy instead of locking.
+	runner.run("rcu_ptr/read_mostly/8t", [](size_t n)
+	{
+		constexpr size_t threads = 8;
+		rcu_ptr<size_t> value(std::make_unique<size_t>(0));
+		std::vector<std::thread> pool;
+
+		for(size_t t=0; t<threads; t++)
+		{
+			pool.emplace_back([&, t, count = n / threads + (t < n % threads)]
+			{
+				for(size_t i=0; i<count; i++)
+				{
+					if( t == 0 )
+						value.update([](size_t &v){ ++v; });
+					else
+						do_not_optimize(*value.read());
+				}
+			});
+		}
+		for(auto &thread : pool)
+			thread.join();
+	});
+}
+
+static void co_mutex_benchmarks(runner &runner)
+{
+	for(size_t threads : {1, 4})
+	{
+		runner.run(std::format("co_mutex/contention/{}t", threads), [threads](size_t n)
+		{
+			constexpr size_t workers = 16;
+			asio::io_context ioc(static_cast<int>(threads));
+			co_mutex mutex;
+			size_t counter = 0;
+
+			for(size_t w=0; w<workers; w++)
+			{
+				asio::co_spawn(ioc, [&, count = n / workers + (w < n % workers)]() -> awaitable<void>
+				{
+					for(size_t i=0; i<count; i++)
+					{
+						co_await mutex.lock();
+						++counter;
+						mutex.unlock();
+					}
+					co_return ;
+				},
+				asio::detached);
+			}
+			std::vector<std::thread> pool;
+			for(size_t t=1; t<threads; t++)
+				pool.emplace_back([&ioc]{ ioc.run(); });
+			ioc.run();
+
+			for(auto &thread : pool)
+				thread.join();
+			do_not_optimize(counter);
+		});
+	}
+}
+
+template <size_t Depth>
+static awaitable<size_t> co_frame_chain(size_t value)
+{
+	if constexpr( Depth == 0 )
+		co_return value;
+	else
+		co_return co_await co_frame_chain<Depth - 1>(value + 1);
+}
+
+static void co_frame_benchmarks(runner &runner)
+{
+	// A session step awaits a handful of nested frames, see allocs_per_op.
+	runner.run("coro_frame/chain6", [](size_t n)
+	{
+		asio::io_context ioc;
+		asio::co_spawn(ioc, [n]() -> awaitable<void>
+		{
+			for(size_t i=0; i<n; i++)
+			{
+				do_not_optimize(co_await co_frame_chain<6>(i));
+				co_await asio::post(co_await asio::this_coro::executor, use_awaitable);
+			}
+		},
+		asio::detached);
+		ioc.run();
+	});
+}
+
+static void co_channel_benchmarks(runner &runner)
+{
+	constexpr size_t producers = 4;
+	auto spawn_producers = [](asio::io_context &ioc, size_t n, auto &&send)
+	{
+		for(size_t p=0; p<producers; p++)
+		{
+			asio::co_spawn(ioc, [send, count = n / producers + (p < n % producers)]() -> awaitable<void>
+			{
+				for(size_t i=0; i<count; i++)
+					co_await send(i);
+				co_return ;
+			},
+			asio::detached);
+		}
+	};
+	runner.run("co_channel/4p1c", [&](size_t n)
+	{
+		asio::io_context ioc;
+		co_channel<size_t> channel(1024);
+		spawn_producers(ioc, n, [&](size_t i) -> awaitable<void> {
+			co_await channel.send(i);
+		});
+		asio::co_spawn(ioc, [&]() -> awaitable<void>
+		{
+			for(size_t i=0; i<n; i++)
+				do_not_optimize(co_await channel.receive());
+		},
+		asio::detached);
+		ioc.run();
+	});
+	runner.run("co_channel/4p1c/receive_many", [&](size_t n)
+	{
+		asio::io_context ioc;
+		co_channel<size_t> channel(1024);
+		spawn_producers(ioc, n, [&](size_t i) -> awaitable<void> {
+			co_await channel.send(i);
+		});
+		asio::co_spawn(ioc, [&]() -> awaitable<void>
+		{
+			for(size_t i=0; i<n;)
+				i += (co_await channel.receive_many(64)).size();
+		},
+		asio::detached);
+		ioc.run();
+	});
+
+	// The pattern co_channel replaces: a co_mutex guarded queue the consumer polls.
+	runner.run("co_mutex+lock_free_queue/4p1c", [&](size_t n)
+	{
+		asio::io_context ioc;
+		co_mutex mutex;
+		lock_free_queue<size_t> queue;
+		spawn_producers(ioc, n, [&](size_t i) -> awaitable<void>
+		{
+			co_await mutex.lock();
+			queue.enqueue(i);
+			mutex.unlock();
+		});
+		asio::co_spawn(ioc, [&]() -> awaitable<void>
+		{
+			for(size_t i=0; i<n;)
+			{
+				co_await mutex.lock();
+				auto value = queue.dequeue();
+				mutex.unlock();
+
+				if( value )
+					i++;
+				else
+					co_await asio::post(ioc, use_awaitable);
+			}
+		},
+		asio::detached);
+		ioc.run();
+	});
+}
+
+void core_benchmarks(runner &runner)
+{
+	string_benchmarks(runner);
+	codec_benchmarks(runner);
+	queue_benchmarks(runner);
+	lock_benchmarks(runner);
+	co_mutex_benchmarks(runner);
+	co_frame_benchmarks(runner);
+	co_channel_benchmarks(runner);
+}
+
+} //namespace libgs::bench
@@ -0,0 +1,168 @@
+#include "bench.h"
+#include <libgs/http/server/request_parser.h>
+#include <libgs/http/h2/hpack.h>
+
+namespace libgs::http::bench
+{
+
+using namespace libgs::bench;
+
+static constexpr std::string_view small_request =
+	"GET /index.html HTTP/1.1\r\n"
+	"Host: 127.0.0.1:8080\r\n"
+	"\r\n";
+
+static constexpr std::string_view browser_request =
+	"GET /api/v1/users/10086/profile?fields=name,avatar&lang=zh-CN HTTP/1.1\r\n"
+	"Host: www.example.com\r\n"
+	"User-Agent: Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0 Safari/537.36\r\n"
+	"Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8\r\n"
+	"Accept-Language: zh-CN,zh;q=0.9,en;q=0.8\r\n"
+	"Accept-Encoding: gzip, deflate, br\r\n"
+	"Connection: keep-alive\r\n"
+	"Cookie: session=3f1c2a9e8b7d6c5f; theme=dark; tz=Asia%2FShanghai\r\n"
+	"Cache-Control: max-age=0\r\n"
+	"\r\n";
+
+static constexpr std::string_view post_request =
+	"POST /upload HTTP/1.1\r\n"
+	"Host: 127.0.0.1\r\n"
+	"Content-Type: application/json\r\n"
+	"Content-Length: 48\r\n"
+	"\r\n"
+	"{\"id\":10086,\"name\":\"libgs\",\"tags\":[\"a\",\"b\",\"c\"]}";
+
+static void parser_benchmarks(runner &runner)
+{
+	for(auto [name, data] : {
+		std::pair{"parser/append/small", small_request},
+		std::pair{"parser/append/browser", browser_request},
+		std::pair{"parser/append/post", post_request} })
+	{
+		runner.run(name, [data](size_t n)
+		{
+			request_parser parser;
+			for(size_t i=0; i<n; i++)
+			{
+				do_not_optimize(parser.append(buffer(data)));
+				parser.reset();
+			}
+		},
+		data.size());
+	}
+	// The request trickles in, as it does over a slow link.
+	runner.run("parser/append/browser_16b_fragments", [](size_t n)
+	{
+		request_parser parser;
+		for(size_t i=0; i<n; i++)
+		{
+			for(size_t pos=0; pos<browser_request.size(); pos+=16)
+				do_not_optimize(parser.append(buffer(browser_request.substr(pos, 16))));
+			parser.reset();
+		}
+	},
+	browser_request.size());
+}
+
+static void routing_benchmarks(runner &runner)
+{
+	for(size_t count : {10, 100, 1000})
+	{
+		// What basic_server does for every request: try each rule, keep the best weight.
+		std::vector<std::string> rules;
+		for(size_t i=0; i<count; i++)
+		{
+			switch( i % 4 )
+			{
+			case 0: rules.emplace_back(std::format("/api/v1/resource{}", i)); break;
+			case 1: rules.emplace_back(std::format("/api/v1/resource{}/*", i)); break;
+			case 2: rules.emplace_back(std::format("/api/v1/resource{}/{{id}}/detail", i)); break;
+			default: rules.emplace_back(std::format("/static{}/*.css", i)); break;
+			}
+		}
+		rules.emplace_back("/*");
+
+		request_parser parser;
+		parser.append(buffer(std::format("GET /api/v1/resource{}/10086/detail HTTP/1.1\r\n\r\n", count / 2 + 2)));
+
+		runner.run(std::format("routing/path_match/{}_rules", count), [&](size_t n)
+		{
+			for(size_t i=0; i<n; i++)
+			{
+				int32_t weight = std::numeric_limits<int32_t>::max();
+				const std::string *matched = nullptr;
+				for(auto &rule : rules)
+				{
+					auto _weight = parser.path_match(rule);
+					if( _weight == 0 )
+					{
+						matched = &rule;
+						break;
+					}
+					else if( _weight > 0 and _weight < weight )
+					{
+						matched = &rule;
+						weight = _weight;
+					}
+				}
+				do_not_optimize(matched);
+			}
+		});
+	}
+}
+
+static void hpack_benchmarks(runner &runner)
+{
+	const std::vector<std::pair<std::string,std::string>> fields {
+		{":method", "GET"}, {":scheme", "https"}, {":path", "/api/v1/users/10086/profile"},
+		{":authority", "www.example.com"}, {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) Chrome/120.0"},
+		{"accept", "text/html,application/xhtml+xml"}, {"accept-encoding", "gzip, deflate, br"},
+		{"cookie", "session=3f1c2a9e8b7d6c5f; theme=dark"}
+	};
+	runner.run("hpack/encode", [&](size_t n)
+	{
+		hpack_encoder encoder;
+		std::string buf;
+		for(size_t i=0; i<n; i++)
+		{
+			buf.clear();
+			for(auto &[name, value] : fields)
+				encoder.encode(name, value, buf);
+			do_not_optimize(buf);
+		}
+	});
+
+	hpack_encoder encoder;
+	std::string block;
+	for(auto &[name, value] : fields)
+		encoder.encode(name, value, block);
+
+	runner.run("hpack/decode", [&](size_t n)
+	{
+		hpack_fields result;
+		error_code error;
+		for(size_t i=0; i<n; i++)
+		{
+			// A fresh decoder each time, 'block' only carries literals.
+			hpack_decoder decoder;
+			result.clear();
+			decoder.decode(buffer(block), result, error);
+			do_not_optimize(result);
+		}
+	},
+	block.size());
+}
+
+} //namespace libgs::http::bench
+
+namespace libgs::bench
+{
+
+void http_benchmarks(runner &runner)
+{
+	http::bench::parser_benchmarks(runner);
+	http::bench::routing_benchmarks(runner);
+	http::bench::hpack_benchmarks(runner);
+}
+
+} //namespace libgs::bench
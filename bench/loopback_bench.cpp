@@ -0,0 +1,189 @@
+#include "bench.h"
+#include <libgs/http/server.h>
+#include <spdlog/spdlog.h>
+#include <thread>
+
+namespace libgs::bench
+{
+
+namespace
+{
+
+struct client_stats
+{
+	std::vector<uint32_t> latencies; // microseconds
+	size_t errors = 0;
+	size_t bytes = 0;
+	size_t requests = 0; // warm up included
+};
+
+// One keep-alive connection sending requests back to back.
+awaitable<void> co_client(const loopback_option &option, client_stats &stats,
+						  std::chrono::steady_clock::time_point record_begin,
+						  std::chrono::steady_clock::time_point deadline)
+{
+	using namespace std::chrono;
+	constexpr std::string_view request =
+		"GET /bench HTTP/1.1\r\n"
+		"Host: 127.0.0.1\r\n"
+		"Connection: keep-alive\r\n"
+		"\r\n";
+
+	asio::ip::tcp::socket socket(co_await asio::this_coro::executor);
+	error_code error;
+	co_await socket.async_connect (
+		{asio::ip::make_address_v4("127.0.0.1"), option.port}, use_awaitable | error
+	);
+	if( error )
+	{
+		++stats.errors;
+		co_return ;
+	}
+	socket.set_option(asio::ip::tcp::no_delay(true), error);
+	std::string buf;
+
+	while( steady_clock::now() < deadline )
+	{
+		auto begin = steady_clock::now();
+		co_await asio::async_write(socket, buffer(request), use_awaitable | error);
+		if( error )
+			break;
+
+		auto size = co_await asio::async_read_until(socket, asio::dynamic_buffer(buf), "\r\n\r\n", use_awaitable | error);
+		if( error )
+			break;
+
+		// Responses carry 'content-length', the body may partly be in 'buf' already.
+		std::string_view head(buf.data(), size);
+		auto pos = str_to_lower(std::string(head)).find("content-length:");
+		if( pos == std::string_view::npos )
+			break;
+
+		auto length = stou64_or(str_trimmed(head.substr(pos + 15, head.find("\r\n", pos) - pos - 15)));
+		if( buf.size() < size + length )
+		{
+			co_await asio::async_read (
+				socket, asio::dynamic_buffer(buf), asio::transfer_exactly(size + length - buf.size()),
+				use_awaitable | error
+			);
+			if( error )
+				break;
+		}
+		buf.erase(0, size + length);
+
+		auto end = steady_clock::now();
+		++stats.requests;
+		if( begin >= record_begin )
+		{
+			stats.latencies.emplace_back(static_cast<uint32_t>(duration_cast<microseconds>(end - begin).count()));
+			stats.bytes += size + length;
+		}
+	}
+	if( error )
+		++stats.errors;
+	socket.close(error);
+	co_return ;
+}
+
+} //namespace
+
+nlohmann::json loopback_benchmark(const loopback_option &option)
+{
+	using namespace std::chrono;
+	const std::string body(option.body_size, 'x');
+
+	http::server server(asio::ip::tcp::acceptor(get_executor()));
+	server.bind({ip_type::v4, option.port})
+	.on_request<http::method::GET>("/bench", [&body](http::server::context_t &context) -> awaitable<void>
+	{
+		co_await context.response()
+			.set_header(http::header::content_type, "text/plain")
+			.write(body, use_awaitable);
+		co_return ;
+	})
+	.start();
+
+	// The first tenth of the run warms the connections up and is not recorded.
+	const auto begin = steady_clock::now() + milliseconds(100);
+	const auto record_begin = begin + option.duration / 10;
+	const auto deadline = record_begin + option.duration;
+
+	const size_t threads = std::max<size_t>(option.threads, 1);
+	std::vector<client_stats> stats(option.connections);
+	std::thread load_generator([&]
+	{
+		// Only the server side allocations are reported.
+		ignore_thread_allocations();
+		std::vector<std::unique_ptr<asio::io_context>> contexts;
+		for(size_t t=0; t<threads; t++)
+			contexts.emplace_back(std::make_unique<asio::io_context>(1));
+
+		std::this_thread::sleep_until(begin);
+		for(size_t c=0; c<option.connections; c++)
+		{
+			asio::co_spawn(*contexts[c % threads],
+						   co_client(option, stats[c], record_begin, deadline),
+						   asio::detached);
+		}
+		std::vector<std::thread> pool;
+		for(size_t t=1; t<threads; t++)
+		{
+			pool.emplace_back([&ioc = *contexts[t]]
+			{
+				ignore_thread_allocations();
+				ioc.run();
+			});
+		}
+		contexts[0]->run();
+
+		for(auto &thread : pool)
+			thread.join();
+		asio::post(get_executor(), [&server]
+		{
+			server.stop();
+			libgs::exit();
+		});
+	});
+	spdlog::set_level(spdlog::level::warn);
+	auto allocations = allocation_count();
+	exec();
+	load_generator.join();
+	allocations = allocation_count() - allocations;
+
+	std::vector<uint32_t> latencies;
+	size_t errors = 0, bytes = 0, requests = 0;
+	for(auto &_stats : stats)
+	{
+		latencies.insert(latencies.end(), _stats.latencies.begin(), _stats.latencies.end());
+		errors += _stats.errors;
+		bytes += _stats.bytes;
+		requests += _stats.requests;
+	}
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&](double p) -> uint32_t
+	{
+		if( latencies.empty() )
+			return 0;
+		return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * static_cast<double>(latencies.size())))];
+	};
+	const auto seconds = duration_cast<duration<double>>(option.duration).count();
+	return {
+		{"connections", option.connections},
+		{"threads", threads},
+		{"duration_ms", option.duration.count()},
+		{"body_size", option.body_size},
+		{"requests", latencies.size()},
+		{"errors", errors},
+		{"rps", static_cast<double>(latencies.size()) / seconds},
+		{"mb_per_sec", static_cast<double>(bytes) / seconds / 1000000.0},
+		{"allocs_per_request", requests ? static_cast<double>(allocations) / static_cast<double>(requests) : 0.0},
+		{"latency_us", {
+			{"p50", percentile(0.5)},
+			{"p99", percentile(0.99)},
+			{"p999", percentile(0.999)},
+			{"max", latencies.empty() ? 0 : latencies.back()}
+		}}
+	};
+}
+
+} //namespace libgs::bench
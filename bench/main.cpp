@@ -0,0 +1,53 @@
+#include "bench.h"
+#include <libgs/core/args_parser.h>
+#include <iostream>
+
+int main(int argc, const char *argv[])
+{
+	using namespace std::chrono;
+	auto args = libgs::cmdline::args_parser("gs_bench: libgs micro and loopback benchmarks, the report is written as JSON.")
+		.add_group("-f,--filter", "Only run the micro benchmarks whose name contains this.", "filter")
+		.add_group("-t,--min-time", "Minimum time of a micro benchmark batch in milliseconds (default 200).", "min-time")
+		.add_flag("--no-micro", "Skip the micro benchmarks.", "no-micro")
+		.add_flag("--no-loopback", "Skip the loopback server benchmark.", "no-loopback")
+		.add_group("-p,--port", "Loopback server port (default 23456).", "port")
+		.add_group("-c,--connections", "Loopback client connections (default 64).", "connections")
+		.add_group("-j,--threads", "Loopback client threads (default 4).", "threads")
+		.add_group("-d,--duration", "Loopback run time in milliseconds (default 5000).", "duration")
+		.add_group("-b,--body-size", "Loopback response body size (default 64).", "body-size")
+		.enable_h()
+		.parsing(argc, argv);
+
+	auto arg = [&]<typename T>(const std::string &key, T def) -> T
+	{
+		auto it = args.find(key);
+		if( it == args.end() )
+			return def;
+		else if constexpr( std::is_same_v<T, std::string> )
+			return it->second.to_string();
+		else
+			return it->second.template get<T>();
+	};
+	nlohmann::json report {
+		{"version", LIBGS_VERSION_STR}
+	};
+	if( not (args & "no-micro") )
+	{
+		libgs::bench::runner runner(arg("filter", std::string()), milliseconds(arg("min-time", 200)));
+		libgs::bench::core_benchmarks(runner);
+		libgs::bench::http_benchmarks(runner);
+		report["micro"] = runner.to_json();
+	}
+	if( not (args & "no-loopback") )
+	{
+		libgs::bench::loopback_option option;
+		option.port = arg("port", option.port);
+		option.connections = arg("connections", option.connections);
+		option.threads = arg("threads", option.threads);
+		option.duration = milliseconds(arg("duration", static_cast<int>(option.duration.count())));
+		option.body_size = arg("body-size", option.body_size);
+		report["loopback"] = libgs::bench::loopback_benchmark(option);
+	}
+	std::cout << report.dump(4) << std::endl;
+	return 0;
+}
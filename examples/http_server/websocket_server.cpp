@@ -0,0 +1,41 @@
+#include <libgs/http/server.h>
+#include <spdlog/spdlog.h>
+
+int main()
+{
+	spdlog::set_level(spdlog::level::trace);
+	asio::ip::tcp::acceptor acceptor(libgs::get_executor());
+	constexpr unsigned short port = 12345;
+
+	libgs::http::server server(std::move(acceptor));
+	server.bind({libgs::ip_type::v4, port})
+
+	.set_websocket_deflate({.enable = true})
+	.on_websocket("/echo",
+	[](libgs::http::server::context_t &context, libgs::http::server::websocket_t &websocket) -> libgs::awaitable<void>
+	{
+		spdlog::debug("WebSocket connected: {}", context.request().path());
+		for(;;)
+		{
+			libgs::error_code error;
+			auto message = co_await websocket.co_read(error);
+			if( error )
+			{
+				spdlog::debug("WebSocket closed: {} ({})", error, websocket.close_code());
+				break;
+			}
+			co_await websocket.co_write(libgs::buffer(message.data), message.opcode);
+		}
+		co_return ;
+	})
+	.on_server_error([](std::error_code error)
+	{
+		spdlog::error("on_server_error: {}", error);
+		libgs::exit(-1);
+		return true;
+	})
+	.start();
+
+	spdlog::info("WebSocket Server started ({}) ...", port);
+	return libgs::exec();
+}
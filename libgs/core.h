@@ -35,7 +35,10 @@
 #include <libgs/core/args_parser.h>
 #include <libgs/core/shared_mutex.h>
 #include <libgs/core/string_list.h>
+#include <libgs/core/arena.h>
 #include <libgs/core/library.h>
+#include <libgs/core/mapped_file.h>
+#include <libgs/core/async_file.h>
 #include <libgs/core/ini.h>
 #include <libgs/core/coro.h>
 
@@ -32,8 +32,14 @@
 #include <libgs/core/algorithm/base.h>
 #include <libgs/core/algorithm/byte_order.h>
 #include <libgs/core/algorithm/mime_type.h>
+#include <libgs/core/algorithm/random.h>
 #include <libgs/core/algorithm/uuid.h>
 #include <libgs/core/algorithm/sha1.h>
+#include <libgs/core/algorithm/sha256.h>
+#include <libgs/core/algorithm/xxhash.h>
+#include <libgs/core/algorithm/base64.h>
+#include <libgs/core/algorithm/hex.h>
+#include <libgs/core/algorithm/hash.h>
 #include <libgs/core/algorithm/math.h>
 #include <libgs/core/algorithm/misc.h>
 
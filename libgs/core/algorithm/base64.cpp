@@ -0,0 +1,358 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "base64.h"
+#include "detail/codec_x86.h"
+
+namespace libgs
+{
+
+namespace detail
+{
+
+static constexpr const char *base64_standard_table =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+	"abcdefghijklmnopqrstuvwxyz"
+	"0123456789"
+	"+/";
+
+static constexpr const char *base64_url_safe_table =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+	"abcdefghijklmnopqrstuvwxyz"
+	"0123456789"
+	"-_";
+
+[[nodiscard]] static consteval std::array<int8_t,256> base64_make_values(const char *table)
+{
+	std::array<int8_t,256> values {};
+	values.fill(-1);
+	for(int8_t i=0; i<64; i++)
+		values[static_cast<uint8_t>(table[i])] = i;
+	return values;
+}
+
+static constexpr auto base64_standard_values = base64_make_values(base64_standard_table);
+static constexpr auto base64_url_safe_values = base64_make_values(base64_url_safe_table);
+
+[[nodiscard]] static const char *base64_table(base64_alphabet alphabet) noexcept
+{
+	return alphabet == base64_alphabet::url_safe ? base64_url_safe_table : base64_standard_table;
+}
+
+[[nodiscard]] static const int8_t *base64_values(base64_alphabet alphabet) noexcept
+{
+	return alphabet == base64_alphabet::url_safe ? base64_url_safe_values.data() : base64_standard_values.data();
+}
+
+// Whole groups of 3 bytes, returns the count consumed.
+static size_t base64_encode(const uint8_t *src, size_t size, char *dst, base64_alphabet alphabet) noexcept
+{
+	// The vector kernels are picked once, at the first use.
+	static const auto kernel = base64_encode_x86();
+	size_t i = 0;
+
+	if( kernel )
+	{
+		i = kernel(src, size, dst, alphabet == base64_alphabet::url_safe);
+		dst += i / 3 * 4;
+	}
+	const auto table = base64_table(alphabet);
+	for(; size - i >= 3; i += 3, dst += 4)
+	{
+		const uint32_t x = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+		dst[0] = table[(x >> 18) & 0x3F];
+		dst[1] = table[(x >> 12) & 0x3F];
+		dst[2] = table[(x >> 6) & 0x3F];
+		dst[3] = table[x & 0x3F];
+	}
+	return i;
+}
+
+// The last 1 or 2 bytes.
+static size_t base64_encode_tail(const uint8_t *src, size_t size, char *dst, base64_alphabet alphabet, bool padding) noexcept
+{
+	if( size == 0 )
+		return 0;
+
+	const auto table = base64_table(alphabet);
+	uint32_t x = src[0] << 16;
+	if( size > 1 )
+		x |= src[1] << 8;
+
+	size_t count = 0;
+	dst[count++] = table[(x >> 18) & 0x3F];
+	dst[count++] = table[(x >> 12) & 0x3F];
+	if( size > 1 )
+		dst[count++] = table[(x >> 6) & 0x3F];
+	while( padding and count < 4 )
+		dst[count++] = '=';
+	return count;
+}
+
+// Whole quads, up to the first one with padding or a bad character; returns the count consumed.
+static size_t base64_decode(const char *src, size_t size, uint8_t *dst, base64_alphabet alphabet) noexcept
+{
+	static const auto kernel = base64_decode_x86();
+	size_t i = 0;
+
+	if( kernel )
+	{
+		i = kernel(src, size, dst, alphabet == base64_alphabet::url_safe);
+		dst += i / 4 * 3;
+	}
+	const auto values = base64_values(alphabet);
+	for(; size - i >= 4; i += 4, dst += 3)
+	{
+		const int32_t a = values[static_cast<uint8_t>(src[i])];
+		const int32_t b = values[static_cast<uint8_t>(src[i + 1])];
+		const int32_t c = values[static_cast<uint8_t>(src[i + 2])];
+		const int32_t d = values[static_cast<uint8_t>(src[i + 3])];
+		if( (a | b | c | d) < 0 )
+			break;
+
+		const uint32_t x = (a << 18) | (b << 12) | (c << 6) | d;
+		dst[0] = static_cast<uint8_t>(x >> 16);
+		dst[1] = static_cast<uint8_t>(x >> 8);
+		dst[2] = static_cast<uint8_t>(x);
+	}
+	return i;
+}
+
+// One quad that may end with padding, returns the count written.
+static size_t base64_decode_quad
+(const char *src, uint8_t *dst, base64_alphabet alphabet, bool &padded, error_code &error) noexcept
+{
+	const auto values = base64_values(alphabet);
+	const int padding = src[3] != '=' ? 0 : src[2] == '=' ? 2 : 1;
+
+	const int32_t a = values[static_cast<uint8_t>(src[0])];
+	const int32_t b = values[static_cast<uint8_t>(src[1])];
+	const int32_t c = padding > 1 ? 0 : values[static_cast<uint8_t>(src[2])];
+	const int32_t d = padding > 0 ? 0 : values[static_cast<uint8_t>(src[3])];
+	if( (a | b | c | d) < 0 )
+	{
+		error = std::make_error_code(std::errc::illegal_byte_sequence);
+		return 0;
+	}
+	const uint32_t x = (a << 18) | (b << 12) | (c << 6) | d;
+	dst[0] = static_cast<uint8_t>(x >> 16);
+	if( padding < 2 )
+		dst[1] = static_cast<uint8_t>(x >> 8);
+	if( padding < 1 )
+		dst[2] = static_cast<uint8_t>(x);
+
+	padded = padding > 0;
+	return 3 - padding;
+}
+
+} //namespace detail
+
+size_t to_base64(const void *data, size_t size, char *buf, base64_alphabet alphabet, bool padding) noexcept
+{
+	const auto src = static_cast<const uint8_t*>(data);
+	const auto count = detail::base64_encode(src, size, buf, alphabet);
+	return count / 3 * 4 + detail::base64_encode_tail(src + count, size - count, buf + count / 3 * 4, alphabet, padding);
+}
+
+std::string to_base64(const void *data, size_t size, base64_alphabet alphabet, bool padding)
+{
+	std::string result(base64_encoded_size(size, padding), '\0');
+	to_base64(data, size, result.data(), alphabet, padding);
+	return result;
+}
+
+std::string to_base64(std::string_view data, base64_alphabet alphabet, bool padding)
+{
+	return to_base64(data.data(), data.size(), alphabet, padding);
+}
+
+size_t from_base64(std::string_view text, void *buf, error_code &error, base64_alphabet alphabet) noexcept
+{
+	base64_decoder decoder(alphabet);
+	auto size = decoder.append(text, buf, error);
+	if( not error )
+		size += decoder.finalize(static_cast<uint8_t*>(buf) + size, error);
+	return size;
+}
+
+std::string from_base64(std::string_view text, error_code &error, base64_alphabet alphabet)
+{
+	std::string result(base64_decoded_size(text.size()), '\0');
+	const auto size = from_base64(text, result.data(), error, alphabet);
+	result.resize(error ? 0 : size);
+	return result;
+}
+
+std::string from_base64(std::string_view text, base64_alphabet alphabet)
+{
+	error_code error;
+	auto result = from_base64(text, error, alphabet);
+	if( error )
+		throw system_error(error, "libgs::from_base64");
+	return result;
+}
+
+base64_encoder::base64_encoder(base64_alphabet alphabet, bool padding) noexcept :
+	m_alphabet(alphabet), m_padding(padding)
+{
+
+}
+
+size_t base64_encoder::append(const void *data, size_t size, char *buf) noexcept
+{
+	auto src = static_cast<const uint8_t*>(data);
+	size_t written = 0;
+
+	// Complete the pending group first.
+	if( m_buf_size > 0 )
+	{
+		const auto count = std::min<size_t>(3 - m_buf_size, size);
+		memcpy(m_buf + m_buf_size, src, count);
+		src += count;
+		size -= count;
+
+		if( m_buf_size + count < 3 )
+		{
+			m_buf_size += count;
+			return 0;
+		}
+		m_buf_size = 0;
+		written = detail::base64_encode(m_buf, 3, buf, m_alphabet) / 3 * 4;
+	}
+	const auto count = detail::base64_encode(src, size, buf + written, m_alphabet);
+	written += count / 3 * 4;
+
+	m_buf_size = static_cast<uint32_t>(size - count);
+	memcpy(m_buf, src + count, m_buf_size);
+	return written;
+}
+
+size_t base64_encoder::append(std::string_view data, char *buf) noexcept
+{
+	return append(data.data(), data.size(), buf);
+}
+
+size_t base64_encoder::finalize(char *buf) noexcept
+{
+	const auto count = detail::base64_encode_tail(m_buf, m_buf_size, buf, m_alphabet, m_padding);
+	m_buf_size = 0;
+	return count;
+}
+
+base64_encoder &base64_encoder::reset() noexcept
+{
+	m_buf_size = 0;
+	return *this;
+}
+
+base64_decoder::base64_decoder(base64_alphabet alphabet) noexcept :
+	m_alphabet(alphabet)
+{
+
+}
+
+size_t base64_decoder::append(std::string_view text, void *buf, error_code &error) noexcept
+{
+	error = error_code();
+	if( text.empty() )
+		return 0;
+	else if( m_finished )
+	{
+		// Nothing may follow the padding.
+		error = std::make_error_code(std::errc::illegal_byte_sequence);
+		return 0;
+	}
+	auto dst = static_cast<uint8_t*>(buf);
+	size_t written = 0;
+
+	// Complete the pending quad first.
+	if( m_buf_size > 0 )
+	{
+		const auto count = std::min<size_t>(4 - m_buf_size, text.size());
+		memcpy(m_buf + m_buf_size, text.data(), count);
+		text.remove_prefix(count);
+
+		m_buf_size += static_cast<uint32_t>(count);
+		if( m_buf_size < 4 )
+			return 0;
+
+		m_buf_size = 0;
+		written = detail::base64_decode_quad(m_buf, dst, m_alphabet, m_finished, error);
+		if( error )
+			return 0;
+		else if( m_finished and not text.empty() )
+		{
+			error = std::make_error_code(std::errc::illegal_byte_sequence);
+			return written;
+		}
+	}
+	const auto count = detail::base64_decode(text.data(), text.size(), dst + written, m_alphabet);
+	written += count / 4 * 3;
+	text.remove_prefix(count);
+
+	if( text.size() >= 4 )
+	{
+		// Stopped at the padding or at a bad character.
+		written += detail::base64_decode_quad(text.data(), dst + written, m_alphabet, m_finished, error);
+		if( not error and text.size() > 4 )
+			error = std::make_error_code(std::errc::illegal_byte_sequence);
+		return written;
+	}
+	m_buf_size = static_cast<uint32_t>(text.size());
+	memcpy(m_buf, text.data(), m_buf_size);
+	return written;
+}
+
+size_t base64_decoder::finalize(void *buf, error_code &error) noexcept
+{
+	error = error_code();
+	size_t written = 0;
+
+	if( m_buf_size == 1 )
+		error = std::make_error_code(std::errc::invalid_argument);
+	else if( m_buf_size > 1 )
+	{
+		// An unpadded last quad, decode it as if it were padded.
+		char quad[4] { m_buf[0], m_buf[1], m_buf_size > 2 ? m_buf[2] : '=', '=' };
+		if( m_buf_size > 2 and m_buf[2] == '=' )
+			error = std::make_error_code(std::errc::illegal_byte_sequence);
+		else
+			written = detail::base64_decode_quad(quad, static_cast<uint8_t*>(buf), m_alphabet, m_finished, error);
+	}
+	reset();
+	return written;
+}
+
+base64_decoder &base64_decoder::reset() noexcept
+{
+	m_buf_size = 0;
+	m_finished = false;
+	return *this;
+}
+
+} //namespace libgs
@@ -0,0 +1,127 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_BASE64_H
+#define LIBGS_CORE_ALGORITHM_BASE64_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+enum class base64_alphabet
+{
+	standard, // RFC 4648 section 4, "+/"
+	url_safe  // RFC 4648 section 5, "-_"
+};
+
+[[nodiscard]] constexpr size_t base64_encoded_size(size_t size, bool padding = true) noexcept;
+
+// Upper bound, padding and a partial last quad decode to fewer bytes.
+[[nodiscard]] constexpr size_t base64_decoded_size(size_t size) noexcept;
+
+// Writes base64_encoded_size(size, padding) characters to buf, returns that count.
+LIBGS_CORE_API size_t to_base64 (
+	const void *data, size_t size, char *buf,
+	base64_alphabet alphabet = base64_alphabet::standard, bool padding = true
+) noexcept;
+
+[[nodiscard]] LIBGS_CORE_API std::string to_base64 (
+	const void *data, size_t size,
+	base64_alphabet alphabet = base64_alphabet::standard, bool padding = true
+);
+
+[[nodiscard]] LIBGS_CORE_API std::string to_base64 (
+	std::string_view data,
+	base64_alphabet alphabet = base64_alphabet::standard, bool padding = true
+);
+
+// The padding is optional. buf must hold base64_decoded_size(text.size()) bytes,
+// returns the count written.
+LIBGS_CORE_API size_t from_base64 (
+	std::string_view text, void *buf, error_code &error,
+	base64_alphabet alphabet = base64_alphabet::standard
+) noexcept;
+
+[[nodiscard]] LIBGS_CORE_API std::string from_base64 (
+	std::string_view text, error_code &error,
+	base64_alphabet alphabet = base64_alphabet::standard
+);
+
+[[nodiscard]] LIBGS_CORE_API std::string from_base64 (
+	std::string_view text, base64_alphabet alphabet = base64_alphabet::standard
+);
+
+// Incremental encoding for data that arrives (or is sent) in pieces.
+class LIBGS_CORE_API base64_encoder
+{
+public:
+	explicit base64_encoder(base64_alphabet alphabet = base64_alphabet::standard, bool padding = true) noexcept;
+
+public:
+	// buf must hold base64_encoded_size(size) characters, returns the count written.
+	size_t append(const void *data, size_t size, char *buf) noexcept;
+	size_t append(std::string_view data, char *buf) noexcept;
+
+	// Flushes the last partial group, buf must hold 4 characters.
+	size_t finalize(char *buf) noexcept;
+	base64_encoder &reset() noexcept;
+
+private:
+	base64_alphabet m_alphabet;
+	bool m_padding;
+	uint8_t m_buf[3] {0};
+	uint32_t m_buf_size = 0;
+};
+
+// Incremental decoding, the counterpart of base64_encoder.
+class LIBGS_CORE_API base64_decoder
+{
+public:
+	explicit base64_decoder(base64_alphabet alphabet = base64_alphabet::standard) noexcept;
+
+public:
+	// buf must hold base64_decoded_size(text.size()) bytes, returns the count written.
+	size_t append(std::string_view text, void *buf, error_code &error) noexcept;
+
+	// Flushes an unpadded last quad, buf must hold 2 bytes.
+	size_t finalize(void *buf, error_code &error) noexcept;
+	base64_decoder &reset() noexcept;
+
+private:
+	base64_alphabet m_alphabet;
+	char m_buf[4] {0};
+	uint32_t m_buf_size = 0;
+	bool m_finished = false;
+};
+
+} //namespace libgs
+#include <libgs/core/algorithm/detail/base64.h>
+
+
+#endif //LIBGS_CORE_ALGORITHM_BASE64_H
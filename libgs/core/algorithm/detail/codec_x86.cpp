@@ -0,0 +1,375 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "codec_x86.h"
+#include "cpu_x86.h"
+
+#ifdef LIBGS_CPU_X86
+# define LIBGS_CODEC_X86
+# include <immintrin.h>
+# ifdef _MSC_VER
+#  define LIBGS_SSSE3_TARGET
+#  define LIBGS_AVX2_TARGET
+# else
+#  define LIBGS_SSSE3_TARGET __attribute__((target("ssse3")))
+#  define LIBGS_AVX2_TARGET __attribute__((target("avx2")))
+# endif
+#endif
+
+namespace libgs::detail
+{
+
+#ifdef LIBGS_CODEC_X86
+
+/*
+ * Base64 after Wojciech Muła and Daniel Lemire:
+ * encoding spreads every 3 bytes over 4 lanes of 6-bit indices and turns them into ascii with one
+ * pshufb offset lookup; decoding classifies every character by its nibbles (which validates the
+ * whole block at once), rolls it back to its 6-bit value and merges the values with two multiply-adds.
+ */
+
+LIBGS_SSSE3_TARGET static inline __m128i base64_indices(__m128i in) noexcept
+{
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1));
+	const auto t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+	const auto t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+	return _mm_or_si128(t0, t1);
+}
+
+LIBGS_AVX2_TARGET static inline __m256i base64_indices(__m256i in) noexcept
+{
+	in = _mm256_shuffle_epi8(in, _mm256_broadcastsi128_si256(_mm_set_epi8(10,11,9,10, 7,8,6,7, 4,5,3,4, 1,2,0,1)));
+	const auto t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+	const auto t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+	return _mm256_or_si256(t0, t1);
+}
+
+LIBGS_SSSE3_TARGET static inline __m128i base64_shift_lut(bool url_safe) noexcept
+{
+	// Indexed by the reduced index: 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12.
+	return _mm_setr_epi8 (
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		static_cast<char>((url_safe ? '-' : '+') - 62), static_cast<char>((url_safe ? '_' : '/') - 63), 'A', 0, 0
+	);
+}
+
+LIBGS_SSSE3_TARGET static inline __m128i base64_ascii(__m128i indices, __m128i shift_lut) noexcept
+{
+	auto reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	const auto less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+	return _mm_add_epi8(indices, _mm_shuffle_epi8(shift_lut, reduced));
+}
+
+LIBGS_AVX2_TARGET static inline __m256i base64_ascii(__m256i indices, __m256i shift_lut) noexcept
+{
+	auto reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+	const auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+	reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+	return _mm256_add_epi8(indices, _mm256_shuffle_epi8(shift_lut, reduced));
+}
+
+LIBGS_SSSE3_TARGET static size_t base64_encode_ssse3(const uint8_t *src, size_t size, char *dst, bool url_safe) noexcept
+{
+	const auto shift_lut = base64_shift_lut(url_safe);
+	size_t i = 0;
+
+	// Loads 16 bytes, consumes 12.
+	for(; size - i >= 16; i += 12, dst += 16)
+	{
+		const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), base64_ascii(base64_indices(in), shift_lut));
+	}
+	return i;
+}
+
+LIBGS_AVX2_TARGET static size_t base64_encode_avx2(const uint8_t *src, size_t size, char *dst, bool url_safe) noexcept
+{
+	const auto shift_lut = _mm256_broadcastsi128_si256(base64_shift_lut(url_safe));
+	size_t i = 0;
+
+	// Two 12-byte groups per iteration, one in each 128-bit lane.
+	for(; size - i >= 28; i += 24, dst += 32)
+	{
+		const auto in = _mm256_inserti128_si256 (
+			_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+			_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12)), 1
+		);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), base64_ascii(base64_indices(in), shift_lut));
+	}
+	return i;
+}
+
+LIBGS_SSSE3_TARGET static inline __m128i base64_fold_url_safe(__m128i in, __m128i &error) noexcept
+{
+	// '-' and '_' become '+' and '/', which are not part of this alphabet themselves.
+	error = _mm_or_si128(_mm_cmpeq_epi8(in, _mm_set1_epi8('+')), _mm_cmpeq_epi8(in, _mm_set1_epi8('/')));
+	const auto minus = _mm_cmpeq_epi8(in, _mm_set1_epi8('-'));
+	const auto underline = _mm_cmpeq_epi8(in, _mm_set1_epi8('_'));
+	return _mm_or_si128 (
+		_mm_andnot_si128(_mm_or_si128(minus, underline), in),
+		_mm_or_si128(_mm_and_si128(minus, _mm_set1_epi8('+')), _mm_and_si128(underline, _mm_set1_epi8('/')))
+	);
+}
+
+LIBGS_AVX2_TARGET static inline __m256i base64_fold_url_safe(__m256i in, __m256i &error) noexcept
+{
+	error = _mm256_or_si256(_mm256_cmpeq_epi8(in, _mm256_set1_epi8('+')), _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/')));
+	const auto minus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('-'));
+	const auto underline = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('_'));
+	return _mm256_or_si256 (
+		_mm256_andnot_si256(_mm256_or_si256(minus, underline), in),
+		_mm256_or_si256(_mm256_and_si256(minus, _mm256_set1_epi8('+')), _mm256_and_si256(underline, _mm256_set1_epi8('/')))
+	);
+}
+
+LIBGS_SSSE3_TARGET static inline bool base64_values(__m128i &in, bool url_safe) noexcept
+{
+	const auto lut_lo = _mm_setr_epi8(0x15,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x13,0x1A,0x1B,0x1B,0x1B,0x1A);
+	const auto lut_hi = _mm_setr_epi8(0x10,0x10,0x01,0x02,0x04,0x08,0x04,0x08,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10);
+	const auto lut_roll = _mm_setr_epi8(0,16,19,4,-65,-65,-71,-71,0,0,0,0,0,0,0,0);
+
+	auto error = _mm_setzero_si128();
+	if( url_safe )
+		in = base64_fold_url_safe(in, error);
+
+	const auto hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F));
+	const auto lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, _mm_set1_epi8(0x0F)));
+	const auto hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+
+	error = _mm_or_si128(error, _mm_and_si128(lo, hi));
+	if( _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF )
+		return false;
+
+	const auto eq_2f = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+	in = _mm_add_epi8(in, _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles)));
+	return true;
+}
+
+LIBGS_AVX2_TARGET static inline bool base64_values(__m256i &in, bool url_safe) noexcept
+{
+	const auto lut_lo = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x15,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x11,0x13,0x1A,0x1B,0x1B,0x1B,0x1A));
+	const auto lut_hi = _mm256_broadcastsi128_si256(_mm_setr_epi8(0x10,0x10,0x01,0x02,0x04,0x08,0x04,0x08,0x10,0x10,0x10,0x10,0x10,0x10,0x10,0x10));
+	const auto lut_roll = _mm256_broadcastsi128_si256(_mm_setr_epi8(0,16,19,4,-65,-65,-71,-71,0,0,0,0,0,0,0,0));
+
+	auto error = _mm256_setzero_si256();
+	if( url_safe )
+		in = base64_fold_url_safe(in, error);
+
+	const auto hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+	const auto lo = _mm256_shuffle_epi8(lut_lo, _mm256_and_si256(in, _mm256_set1_epi8(0x0F)));
+	const auto hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+
+	error = _mm256_or_si256(error, _mm256_and_si256(lo, hi));
+	if( _mm256_movemask_epi8(_mm256_cmpeq_epi8(error, _mm256_setzero_si256())) != -1 )
+		return false;
+
+	const auto eq_2f = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+	in = _mm256_add_epi8(in, _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles)));
+	return true;
+}
+
+LIBGS_SSSE3_TARGET static inline __m128i base64_pack(__m128i values) noexcept
+{
+	const auto merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+	return _mm_shuffle_epi8(merged, _mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1));
+}
+
+LIBGS_AVX2_TARGET static inline __m256i base64_pack(__m256i values) noexcept
+{
+	const auto merged = _mm256_madd_epi16(_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+	const auto packed = _mm256_shuffle_epi8(merged, _mm256_broadcastsi128_si256(_mm_setr_epi8(2,1,0, 6,5,4, 10,9,8, 14,13,12, -1,-1,-1,-1)));
+	return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0,1,2, 4,5,6, 7,7));
+}
+
+LIBGS_SSSE3_TARGET static size_t base64_decode_ssse3(const char *src, size_t size, uint8_t *dst, bool url_safe) noexcept
+{
+	size_t i = 0;
+
+	// Stores 16 bytes, produces 12: the 16 characters left behind keep the spill inside the output.
+	for(; size - i >= 32; i += 16, dst += 12)
+	{
+		auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		if( not base64_values(in, url_safe) )
+			break;
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), base64_pack(in));
+	}
+	return i;
+}
+
+LIBGS_AVX2_TARGET static size_t base64_decode_avx2(const char *src, size_t size, uint8_t *dst, bool url_safe) noexcept
+{
+	size_t i = 0;
+
+	// Stores 32 bytes, produces 24.
+	for(; size - i >= 48; i += 32, dst += 24)
+	{
+		auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		if( not base64_values(in, url_safe) )
+			break;
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), base64_pack(in));
+	}
+	return i;
+}
+
+LIBGS_SSSE3_TARGET static size_t hex_encode_ssse3(const uint8_t *src, size_t size, char *dst, bool upper_case) noexcept
+{
+	const auto lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper_case ? "0123456789ABCDEF" : "0123456789abcdef"));
+	const auto mask = _mm_set1_epi8(0x0F);
+	size_t i = 0;
+
+	for(; size - i >= 16; i += 16, dst += 32)
+	{
+		const auto in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		const auto hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+		const auto lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(hi, lo));
+	}
+	return i;
+}
+
+LIBGS_AVX2_TARGET static size_t hex_encode_avx2(const uint8_t *src, size_t size, char *dst, bool upper_case) noexcept
+{
+	const auto lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(upper_case ? "0123456789ABCDEF" : "0123456789abcdef")));
+	const auto mask = _mm256_set1_epi8(0x0F);
+	size_t i = 0;
+
+	for(; size - i >= 32; i += 32, dst += 64)
+	{
+		const auto in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		const auto hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+		const auto lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, mask));
+
+		// The unpacks work per lane: bytes 0..7 and 16..23, then 8..15 and 24..31.
+		const auto first = _mm256_unpacklo_epi8(hi, lo);
+		const auto second = _mm256_unpackhi_epi8(hi, lo);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(first, second, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+	}
+	return i;
+}
+
+LIBGS_SSSE3_TARGET static inline bool hex_nibbles(__m128i &in) noexcept
+{
+	const auto digit = _mm_sub_epi8(in, _mm_set1_epi8('0'));
+	const auto alpha = _mm_sub_epi8(_mm_or_si128(in, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	const auto is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+	const auto is_alpha = _mm_cmpeq_epi8(_mm_min_epu8(alpha, _mm_set1_epi8(5)), alpha);
+
+	if( _mm_movemask_epi8(_mm_or_si128(is_digit, is_alpha)) != 0xFFFF )
+		return false;
+	in = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_alpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+	return true;
+}
+
+LIBGS_AVX2_TARGET static inline bool hex_nibbles(__m256i &in) noexcept
+{
+	const auto digit = _mm256_sub_epi8(in, _mm256_set1_epi8('0'));
+	const auto alpha = _mm256_sub_epi8(_mm256_or_si256(in, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+	const auto is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+	const auto is_alpha = _mm256_cmpeq_epi8(_mm256_min_epu8(alpha, _mm256_set1_epi8(5)), alpha);
+
+	if( _mm256_movemask_epi8(_mm256_or_si256(is_digit, is_alpha)) != -1 )
+		return false;
+	in = _mm256_or_si256(_mm256_and_si256(is_digit, digit), _mm256_and_si256(is_alpha, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+	return true;
+}
+
+LIBGS_SSSE3_TARGET static size_t hex_decode_ssse3(const char *src, size_t size, uint8_t *dst) noexcept
+{
+	// (high << 4) | low for every pair of nibbles.
+	const auto weights = _mm_set1_epi16(0x0110);
+	size_t i = 0;
+
+	for(; size - i >= 32; i += 32, dst += 16)
+	{
+		auto first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+		auto second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16));
+		if( not hex_nibbles(first) or not hex_nibbles(second) )
+			break;
+
+		const auto packed = _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), packed);
+	}
+	return i;
+}
+
+LIBGS_AVX2_TARGET static size_t hex_decode_avx2(const char *src, size_t size, uint8_t *dst) noexcept
+{
+	const auto weights = _mm256_set1_epi16(0x0110);
+	size_t i = 0;
+
+	for(; size - i >= 64; i += 64, dst += 32)
+	{
+		auto first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+		auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32));
+		if( not hex_nibbles(first) or not hex_nibbles(second) )
+			break;
+
+		// The pack interleaves the lanes of both halves, put them back in order.
+		const auto packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	return i;
+}
+
+base64_encode_kernel_t base64_encode_x86() noexcept
+{
+	const auto &cpu = cpu_x86();
+	return cpu.avx2 ? &base64_encode_avx2 : cpu.ssse3 ? &base64_encode_ssse3 : nullptr;
+}
+
+base64_decode_kernel_t base64_decode_x86() noexcept
+{
+	const auto &cpu = cpu_x86();
+	return cpu.avx2 ? &base64_decode_avx2 : cpu.ssse3 ? &base64_decode_ssse3 : nullptr;
+}
+
+hex_encode_kernel_t hex_encode_x86() noexcept
+{
+	const auto &cpu = cpu_x86();
+	return cpu.avx2 ? &hex_encode_avx2 : cpu.ssse3 ? &hex_encode_ssse3 : nullptr;
+}
+
+hex_decode_kernel_t hex_decode_x86() noexcept
+{
+	const auto &cpu = cpu_x86();
+	return cpu.avx2 ? &hex_decode_avx2 : cpu.ssse3 ? &hex_decode_ssse3 : nullptr;
+}
+
+#else //LIBGS_CODEC_X86
+
+base64_encode_kernel_t base64_encode_x86() noexcept { return nullptr; }
+base64_decode_kernel_t base64_decode_x86() noexcept { return nullptr; }
+hex_encode_kernel_t hex_encode_x86() noexcept { return nullptr; }
+hex_decode_kernel_t hex_decode_x86() noexcept { return nullptr; }
+
+#endif //LIBGS_CODEC_X86
+
+} //namespace libgs::detail
@@ -0,0 +1,54 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_DETAIL_CODEC_X86_H
+#define LIBGS_CORE_ALGORITHM_DETAIL_CODEC_X86_H
+
+#include <libgs/core/global.h>
+
+// Internal, the SSSE3/AVX2 kernels behind the base64 and hex codecs.
+// Every kernel only takes whole vector blocks and returns how much of the input it consumed,
+// the scalar code finishes the tail (and reports the error, if the kernel stopped at one).
+namespace libgs::detail
+{
+
+using base64_encode_kernel_t = size_t(*)(const uint8_t*, size_t, char*, bool) noexcept;
+using base64_decode_kernel_t = size_t(*)(const char*, size_t, uint8_t*, bool) noexcept;
+using hex_encode_kernel_t = size_t(*)(const uint8_t*, size_t, char*, bool) noexcept;
+using hex_decode_kernel_t = size_t(*)(const char*, size_t, uint8_t*) noexcept;
+
+// The best kernels for this cpu, nullptr if there is none.
+[[nodiscard]] LIBGS_DECL_HIDDEN base64_encode_kernel_t base64_encode_x86() noexcept;
+[[nodiscard]] LIBGS_DECL_HIDDEN base64_decode_kernel_t base64_decode_x86() noexcept;
+[[nodiscard]] LIBGS_DECL_HIDDEN hex_encode_kernel_t hex_encode_x86() noexcept;
+[[nodiscard]] LIBGS_DECL_HIDDEN hex_decode_kernel_t hex_decode_x86() noexcept;
+
+} //namespace libgs::detail
+
+
+#endif //LIBGS_CORE_ALGORITHM_DETAIL_CODEC_X86_H
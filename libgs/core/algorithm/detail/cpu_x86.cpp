@@ -0,0 +1,95 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "cpu_x86.h"
+
+#ifdef LIBGS_CPU_X86
+# ifdef _MSC_VER
+#  include <intrin.h>
+# else
+#  include <cpuid.h>
+# endif
+#endif
+
+namespace libgs::detail
+{
+
+#ifdef LIBGS_CPU_X86
+
+[[nodiscard]] static cpu_x86_features cpu_x86_probe() noexcept
+{
+	cpu_x86_features features;
+	uint32_t leaf1[4] {0}, leaf7[4] {0};
+#ifdef _MSC_VER
+	int regs[4] {0};
+	__cpuid(regs, 0);
+	const auto max_leaf = static_cast<uint32_t>(regs[0]);
+	__cpuid(reinterpret_cast<int*>(leaf1), 1);
+	if( max_leaf >= 7 )
+		__cpuidex(reinterpret_cast<int*>(leaf7), 7, 0);
+#else
+	const auto max_leaf = __get_cpuid_max(0, nullptr);
+	__cpuid(1, leaf1[0], leaf1[1], leaf1[2], leaf1[3]);
+	if( max_leaf >= 7 )
+		__cpuid_count(7, 0, leaf7[0], leaf7[1], leaf7[2], leaf7[3]);
+#endif
+	features.ssse3 = leaf1[2] & (1u << 9);
+	features.sse41 = leaf1[2] & (1u << 19);
+	features.sha = leaf7[1] & (1u << 29);
+
+	// AVX2 also needs the OS to save the YMM state (OSXSAVE, then XCR0 bits 1 and 2).
+	if( (leaf1[2] & (1u << 27)) and (leaf1[2] & (1u << 28)) )
+	{
+#ifdef _MSC_VER
+		const auto xcr0 = static_cast<uint32_t>(_xgetbv(0));
+#else
+		uint32_t xcr0 = 0, edx = 0;
+		__asm__ volatile("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+#endif
+		features.avx2 = (xcr0 & 0x6) == 0x6 and (leaf7[1] & (1u << 5));
+	}
+	return features;
+}
+
+const cpu_x86_features &cpu_x86() noexcept
+{
+	static const auto features = cpu_x86_probe();
+	return features;
+}
+
+#else //LIBGS_CPU_X86
+
+const cpu_x86_features &cpu_x86() noexcept
+{
+	static const cpu_x86_features features {};
+	return features;
+}
+
+#endif //LIBGS_CPU_X86
+
+} //namespace libgs::detail
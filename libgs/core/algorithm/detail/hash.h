@@ -0,0 +1,67 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_DETAIL_HASH_H
+#define LIBGS_CORE_ALGORITHM_DETAIL_HASH_H
+
+namespace libgs
+{
+
+template <concepts::hash_algorithm Hash>
+Hash &append_file(Hash &hash, const std::filesystem::path &file_name, error_code &error) noexcept
+{
+	mapped_file file;
+	file.open(file_name, error);
+	if( not error and file.size() > 0 )
+		hash.append(file.data(), file.size());
+	return hash;
+}
+
+template <concepts::hash_algorithm Hash>
+Hash &append_file(Hash &hash, const std::filesystem::path &file_name)
+{
+	error_code error;
+	append_file(hash, file_name, error);
+	if( error )
+		throw system_error(error, "libgs::append_file: '{}'", file_name);
+	return hash;
+}
+
+template <concepts::hash_algorithm Hash>
+Hash file_hash(const std::filesystem::path &file_name)
+{
+	Hash hash;
+	append_file(hash, file_name);
+	hash.finalize();
+	return hash;
+}
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_ALGORITHM_DETAIL_HASH_H
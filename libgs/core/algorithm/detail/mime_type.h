@@ -34,75 +34,69 @@
 namespace libgs { namespace detail
 {
 
+[[nodiscard]] LIBGS_CORE_API bool is_text_data(const char *buf, size_t size) noexcept;
+[[nodiscard]] LIBGS_CORE_API std::string_view suffix_mime_type(const std::filesystem::path &file_name);
+
 template <typename FS>
 [[nodiscard]] LIBGS_CORE_TAPI bool is_text_file(FS &stream)
 	requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
 {
 	char buf[0x4000] = {0};
 	stream.read(buf, sizeof(buf));
-
-	auto buf_size = static_cast<size_t>(stream.gcount());
-	std::string data(buf, buf_size);
-
-	constexpr const char *FE = "\xFE\xFF";
-	constexpr const char *FF = "\xFF\xFE";
-
-	// UTF16 byte order marks
-	if( data.starts_with(FE) or data.starts_with(FF) )
-		return true;
-
-	// Check the first 128 bytes (see shared-mime spec)
-	const char *p = buf;
-	const char *e = p + ( 128 < buf_size ? 128 : buf_size );
-
-	for(; p<e; p++)
-	{
-		if( static_cast<char>(*p) < 32 and *p != 9 and *p != 10 and *p != 13 )
-			return false;
-	}
-	return true;
+	return is_text_data(buf, static_cast<size_t>(stream.gcount()));
 }
 
-[[nodiscard]] LIBGS_CORE_API std::string mime_search
-(const mime_head_map &mimes, const char *buf, size_t size);
-
 template <typename FS>
-[[nodiscard]] LIBGS_CORE_TAPI std::string mime_from_magic(FS &stream)
+[[nodiscard]] LIBGS_CORE_TAPI std::string_view mime_from_magic(FS &stream)
 	requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
 {
 	if( not stream.is_open() )
 		return "unknown";
 
-	constexpr size_t buf_len = 0xFF;
-	char buf[buf_len] = {0};
-	stream.read(buf, buf_len);
+	// The stream may belong to the caller (send_file), so put the read position back.
+	auto pos = stream.tellg();
+	char buf[0xFF];
+	stream.read(buf, sizeof(buf));
 
 	auto size = static_cast<size_t>(stream.gcount());
-	if( size < buf_len )
-	{
-		stream.seekg(0, std::ios_base::beg);
-		if( is_text_file(stream) )
-			return "text/plain";
-	}
-	auto mime_type = mime_search(signatures_map(), buf, size);
-	if( mime_type.empty() and size > 4 )
-		mime_type = mime_search(signatures_map_offset4(), buf + 4, size - 4);
-	return mime_type;
+	stream.clear();
+	if( pos != std::streampos(-1) )
+		stream.seekg(pos);
+
+	if( size < sizeof(buf) and is_text_data(buf, size) )
+		return "text/plain";
+	return magic_mime_type(buf, size);
 }
 
 } //namespace detail
 
 template <typename FS>
-std::string mime_type(FS &stream) requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
+std::string_view mime_type_view(FS &stream) requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
 {
 	return detail::mime_from_magic(stream);
 }
 
+template <typename FS>
+std::string_view mime_type_view(const std::filesystem::path &file_name, FS &stream)
+	requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
+{
+	auto type = detail::suffix_mime_type(file_name);
+	if( type != "unknown" )
+		return type;
+	return detail::mime_from_magic(stream);
+}
+
+template <typename FS>
+std::string mime_type(FS &stream) requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
+{
+	return std::string(detail::mime_from_magic(stream));
+}
+
 template <typename FS>
 bool is_text_file(FS &stream) requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>
 {
 	if( stream.is_open() )
-		return is_text_file(stream);
+		return detail::is_text_file(stream);
 	return false;
 }
 
@@ -0,0 +1,92 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifdef __unix__
+
+#include "random_impl.hii"
+#include <sys/random.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+
+namespace libgs::detail
+{
+
+static std::atomic<uint32_t> g_fork_generation {0};
+
+static const int g_atfork_registered = pthread_atfork(nullptr, nullptr, []{
+	g_fork_generation.fetch_add(1, std::memory_order_relaxed);
+});
+
+[[nodiscard]] static size_t urandom_read(uint8_t *buf, size_t size) noexcept
+{
+	// Kernels before 3.17 have no getrandom.
+	const int fd = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+	if( fd < 0 )
+		return 0;
+
+	size_t count = 0;
+	while( count < size )
+	{
+		const auto res = ::read(fd, buf + count, size - count);
+		if( res > 0 )
+			count += static_cast<size_t>(res);
+		else if( res == 0 or errno != EINTR )
+			break;
+	}
+	::close(fd);
+	return count;
+}
+
+void system_random(void *buf, size_t size) noexcept
+{
+	auto ptr = static_cast<uint8_t*>(buf);
+	while( size > 0 )
+	{
+		const auto res = ::getrandom(ptr, size, 0);
+		if( res > 0 )
+		{
+			ptr += res;
+			size -= static_cast<size_t>(res);
+		}
+		else if( errno != EINTR )
+			break;
+	}
+	if( size > 0 and urandom_read(ptr, size) != size )
+		std::terminate();
+}
+
+uint32_t fork_generation() noexcept
+{
+	return g_fork_generation.load(std::memory_order_relaxed);
+}
+
+} //namespace libgs::detail
+
+#endif //__unix__
@@ -0,0 +1,65 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#if defined(__WINNT__) || defined(_WINDOWS)
+
+#include "random_impl.hii"
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <bcrypt.h>
+
+#ifdef _MSC_VER
+# pragma comment(lib, "bcrypt.lib")
+#endif
+
+namespace libgs::detail
+{
+
+void system_random(void *buf, size_t size) noexcept
+{
+	auto ptr = static_cast<uint8_t*>(buf);
+	while( size > 0 )
+	{
+		const auto count = static_cast<ULONG>(std::min<size_t>(size, 0x10000000));
+		if( BCryptGenRandom(nullptr, ptr, count, BCRYPT_USE_SYSTEM_PREFERRED_RNG) != 0 )
+			std::terminate();
+		ptr += count;
+		size -= count;
+	}
+}
+
+uint32_t fork_generation() noexcept
+{
+	// There is no fork().
+	return 0;
+}
+
+} //namespace libgs::detail
+
+#endif //Windows
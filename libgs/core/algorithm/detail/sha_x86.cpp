@@ -0,0 +1,190 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "sha_x86.h"
+#include "cpu_x86.h"
+
+#ifdef LIBGS_CPU_X86
+# define LIBGS_SHA_X86
+# include <immintrin.h>
+# ifdef _MSC_VER
+#  define LIBGS_SHA_X86_TARGET
+# else
+#  define LIBGS_SHA_X86_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+# endif
+#endif
+
+namespace libgs::detail
+{
+
+#ifdef LIBGS_SHA_X86
+
+bool sha_x86_supported() noexcept
+{
+	// SHA, plus SSSE3 and SSE4.1 for the shuffles.
+	const auto &cpu = cpu_x86();
+	return cpu.ssse3 and cpu.sse41 and cpu.sha;
+}
+
+// Four rounds of SHA-1 per group, the message schedule runs three groups ahead.
+template <int G>
+LIBGS_SHA_X86_TARGET static inline void sha1_x86_group
+(__m128i &abcd, __m128i (&e)[2], __m128i (&msg)[4], const uint8_t *data, const __m128i &mask)
+{
+	auto &e_in = e[G & 1];
+	auto &e_out = e[(G + 1) & 1];
+
+	if constexpr( G < 4 )
+		msg[G] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + G * 16)), mask);
+
+	if constexpr( G == 0 )
+		e_in = _mm_add_epi32(e_in, msg[0]);
+	else
+		e_in = _mm_sha1nexte_epu32(e_in, msg[G % 4]);
+
+	e_out = abcd;
+	if constexpr( G >= 3 and G <= 18 )
+		msg[(G + 1) % 4] = _mm_sha1msg2_epu32(msg[(G + 1) % 4], msg[G % 4]);
+
+	abcd = _mm_sha1rnds4_epu32(abcd, e_in, G / 5);
+	if constexpr( G >= 1 and G <= 16 )
+		msg[(G + 3) % 4] = _mm_sha1msg1_epu32(msg[(G + 3) % 4], msg[G % 4]);
+	if constexpr( G >= 2 and G <= 17 )
+		msg[(G + 2) % 4] = _mm_xor_si128(msg[(G + 2) % 4], msg[G % 4]);
+}
+
+template <int...G>
+LIBGS_SHA_X86_TARGET static inline void sha1_x86_block
+(__m128i &abcd, __m128i (&e)[2], const uint8_t *data, const __m128i &mask, std::integer_sequence<int,G...>)
+{
+	__m128i msg[4];
+	(sha1_x86_group<G>(abcd, e, msg, data, mask), ...);
+}
+
+LIBGS_SHA_X86_TARGET void sha1_x86_blocks(uint32_t *state, const uint8_t *data, size_t blocks) noexcept
+{
+	const __m128i mask = _mm_set_epi64x(0x0001020304050607LL, 0x08090A0B0C0D0E0FLL);
+	__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0x1B);
+	__m128i e[2] { _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0), _mm_setzero_si128() };
+
+	for(; blocks; blocks--, data += 64)
+	{
+		const auto abcd_save = abcd;
+		const auto e_save = e[0];
+
+		sha1_x86_block(abcd, e, data, mask, std::make_integer_sequence<int,20>{});
+		e[0] = _mm_sha1nexte_epu32(e[0], e_save);
+		abcd = _mm_add_epi32(abcd, abcd_save);
+	}
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1B));
+	state[4] = static_cast<uint32_t>(_mm_extract_epi32(e[0], 3));
+}
+
+alignas(16) static constexpr uint32_t sha256_k[64]
+{
+	0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+	0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+	0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+	0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+	0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+	0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+	0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+	0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+};
+
+// Four rounds of SHA-256 per group, the message schedule runs three groups ahead.
+template <int G>
+LIBGS_SHA_X86_TARGET static inline void sha256_x86_group
+(__m128i &state0, __m128i &state1, __m128i (&msg)[4], const uint8_t *data, const __m128i &mask)
+{
+	if constexpr( G < 4 )
+		msg[G] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + G * 16)), mask);
+
+	auto tmp = _mm_add_epi32(msg[G % 4], _mm_load_si128(reinterpret_cast<const __m128i*>(sha256_k + G * 4)));
+	state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);
+
+	if constexpr( G >= 3 and G <= 14 )
+	{
+		auto &next = msg[(G + 1) % 4];
+		next = _mm_add_epi32(next, _mm_alignr_epi8(msg[G % 4], msg[(G + 3) % 4], 4));
+		next = _mm_sha256msg2_epu32(next, msg[G % 4]);
+	}
+	state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(tmp, 0x0E));
+	if constexpr( G >= 1 and G <= 12 )
+		msg[(G + 3) % 4] = _mm_sha256msg1_epu32(msg[(G + 3) % 4], msg[G % 4]);
+}
+
+template <int...G>
+LIBGS_SHA_X86_TARGET static inline void sha256_x86_block
+(__m128i &state0, __m128i &state1, const uint8_t *data, const __m128i &mask, std::integer_sequence<int,G...>)
+{
+	__m128i msg[4];
+	(sha256_x86_group<G>(state0, state1, msg, data, mask), ...);
+}
+
+LIBGS_SHA_X86_TARGET void sha256_x86_blocks(uint32_t *state, const uint8_t *data, size_t blocks) noexcept
+{
+	const __m128i mask = _mm_set_epi64x(0x0C0D0E0F08090A0BLL, 0x0405060700010203LL);
+
+	// The rounds instruction wants the state as ABEF / CDGH.
+	auto tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xB1);
+	auto state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1B);
+	auto state0 = _mm_alignr_epi8(tmp, state1, 8);
+	state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+	for(; blocks; blocks--, data += 64)
+	{
+		const auto state0_save = state0;
+		const auto state1_save = state1;
+
+		sha256_x86_block(state0, state1, data, mask, std::make_integer_sequence<int,16>{});
+		state0 = _mm_add_epi32(state0, state0_save);
+		state1 = _mm_add_epi32(state1, state1_save);
+	}
+	tmp = _mm_shuffle_epi32(state0, 0x1B);
+	state1 = _mm_shuffle_epi32(state1, 0xB1);
+	state0 = _mm_blend_epi16(tmp, state1, 0xF0);
+	state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state), state0);
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), state1);
+}
+
+#else //LIBGS_SHA_X86
+
+bool sha_x86_supported() noexcept
+{
+	return false;
+}
+
+void sha1_x86_blocks(uint32_t*, const uint8_t*, size_t) noexcept {}
+void sha256_x86_blocks(uint32_t*, const uint8_t*, size_t) noexcept {}
+
+#endif //LIBGS_SHA_X86
+
+} //namespace libgs::detail
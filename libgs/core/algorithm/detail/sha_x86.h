@@ -0,0 +1,46 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_DETAIL_SHA_X86_H
+#define LIBGS_CORE_ALGORITHM_DETAIL_SHA_X86_H
+
+#include <libgs/core/global.h>
+
+// Internal, the SHA extension kernels used by sha1 and sha256.
+namespace libgs::detail
+{
+
+[[nodiscard]] LIBGS_DECL_HIDDEN bool sha_x86_supported() noexcept;
+
+LIBGS_DECL_HIDDEN void sha1_x86_blocks(uint32_t *state, const uint8_t *data, size_t blocks) noexcept;
+LIBGS_DECL_HIDDEN void sha256_x86_blocks(uint32_t *state, const uint8_t *data, size_t blocks) noexcept;
+
+} //namespace libgs::detail
+
+
+#endif //LIBGS_CORE_ALGORITHM_DETAIL_SHA_X86_H
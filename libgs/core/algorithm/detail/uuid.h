@@ -26,69 +26,77 @@
 *                                                                                   *
 *************************************************************************************/
 
-#include <cinttypes>
-#include <random>
+#include <libgs/core/algorithm/random.h>
 #include <format>
-#include <cstdio>
+#include <chrono>
 
 namespace libgs
 {
 
 template <concepts::char_type CharT>
-basic_uuid<CharT>::basic_uuid(string_view_t basic_uuid)
+basic_uuid<CharT>::basic_uuid() noexcept :
+	wide_integers{0,0}
+{
+
+}
+
+template <concepts::char_type CharT>
+basic_uuid<CharT>::basic_uuid(string_view_t basic_uuid) :
+	wide_integers{0,0}
 {
 	operator=(basic_uuid);
 }
 
 template <concepts::char_type CharT>
-basic_uuid<CharT> basic_uuid<CharT>::generate()
-{
-#if defined(__APPLE__) || defined(__clang__)
-	std::random_device rd;
-	std::mt19937_64 gen(rd());
-#else
-	thread_local std::random_device rd;
-	thread_local std::mt19937_64 gen(rd());
-#endif
-	std::uniform_int_distribution<uint64_t> dis64;
-	basic_uuid obj {string_t()};
-
-	obj.wide_integers[0] = dis64(gen);
-	obj.wide_integers[1] = dis64(gen);
-
-	obj.bytes.d3[0] = (obj.bytes.d3[0] & 0x3F) | static_cast<uint8_t>(0x80);
-	obj.bytes.d2[1] = (obj.bytes.d2[1] & 0x0F) | static_cast<uint8_t>(0x40);
+basic_uuid<CharT> basic_uuid<CharT>::generate() noexcept
+{
+	basic_uuid obj;
+	secure_random::fill(&obj, sizeof(obj));
+
+	obj.internals.d2 = (obj.internals.d2 & 0x0FFF) | 0x4000;
+	obj.internals.d3[0] = (obj.internals.d3[0] & 0x3F) | 0x80;
 	return obj;
 }
 
 template <concepts::char_type CharT>
-basic_uuid<CharT> &basic_uuid<CharT>::operator=(string_view_t basic_uuid)
+basic_uuid<CharT> basic_uuid<CharT>::generate_v7() noexcept
 {
-	if constexpr( is_char_v )
+	using namespace std::chrono;
+	thread_local uint64_t last_ms = 0;
+	thread_local uint16_t counter = 0;
+
+	basic_uuid obj;
+	secure_random::fill(&obj, sizeof(obj));
+
+	// The 12-bit counter restarts at a random point in its lower half every millisecond.
+	// Running out of it (or the clock going back) borrows the next millisecond.
+	const auto ms = static_cast<uint64_t>(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
+	if( ms > last_ms )
 	{
-		if( basic_uuid.size() == 38 ) //aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee
-		{
-			std::sscanf(basic_uuid.data(), "%08" SCNx32 "-%04" SCNx16 "-%04" SCNx16 "-%02" SCNx8 "%02" SCNx8 "-%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "%02" SCNx8,
-						&internals.d0, &internals.d1, &internals.d2, &internals.d3[0], &internals.d3[1], &internals.d3[2], &internals.d3[3], &internals.d3[4], &internals.d3[5], &internals.d3[6], &internals.d3[7]);
-		}
-		else if( basic_uuid.size() == 40 ) //{aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee}
-		{
-			std::sscanf(basic_uuid.data(), "{%08" SCNx32 "-%04" SCNx16 "-%04" SCNx16 "-%02" SCNx8 "%02" SCNx8 "-%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "%02" SCNx8 "}",
-						&internals.d0, &internals.d1, &internals.d2, &internals.d3[0], &internals.d3[1], &internals.d3[2], &internals.d3[3], &internals.d3[4], &internals.d3[5], &internals.d3[6], &internals.d3[7]);
-		}
+		last_ms = ms;
+		counter = obj.internals.d2 & 0x07FF;
 	}
-	else
+	else if( ++counter > 0x0FFF )
 	{
-		if( basic_uuid.size() == 38 ) //aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee
-		{
-			std::swscanf(basic_uuid.data(), L"%08" LIBGS_WCHAR(SCNx32) L"-%04" LIBGS_WCHAR(SCNx16) L"-%04" LIBGS_WCHAR(SCNx16) L"-%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"-%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8),
-						 &internals.d0, &internals.d1, &internals.d2, &internals.d3[0], &internals.d3[1], &internals.d3[2], &internals.d3[3], &internals.d3[4], &internals.d3[5], &internals.d3[6], &internals.d3[7]);
-		}
-		else if( basic_uuid.size() == 40 ) //{aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee}
-		{
-			std::swscanf(basic_uuid.data(), L"{%08" LIBGS_WCHAR(SCNx32) L"-%04" LIBGS_WCHAR(SCNx16) L"-%04" LIBGS_WCHAR(SCNx16) L"-%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"-%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"%02" LIBGS_WCHAR(SCNx8) L"}",
-						 &internals.d0, &internals.d1, &internals.d2, &internals.d3[0], &internals.d3[1], &internals.d3[2], &internals.d3[3], &internals.d3[4], &internals.d3[5], &internals.d3[6], &internals.d3[7]);
-		}
+		last_ms++;
+		counter = obj.internals.d2 & 0x07FF;
+	}
+	obj.internals.d0 = static_cast<uint32_t>(last_ms >> 16);
+	obj.internals.d1 = static_cast<uint16_t>(last_ms);
+	obj.internals.d2 = static_cast<uint16_t>(0x7000 | counter);
+	obj.internals.d3[0] = (obj.internals.d3[0] & 0x3F) | 0x80;
+	return obj;
+}
+
+template <concepts::char_type CharT>
+basic_uuid<CharT> &basic_uuid<CharT>::operator=(string_view_t basic_uuid)
+{
+	if( not from_chars(basic_uuid) )
+	{
+		if constexpr( is_char_v )
+			throw runtime_error("libgs::uuid: Invalid uuid string: '{}'.", basic_uuid);
+		else
+			throw runtime_error("libgs::uuid: Invalid uuid string: '{}'.", wcstombs(basic_uuid));
 	}
 	return *this;
 }
@@ -108,48 +116,103 @@ bool basic_uuid<CharT>::operator!=(const basic_uuid &other) const
 template <concepts::char_type CharT>
 bool basic_uuid<CharT>::operator<(const basic_uuid &other) const
 {
-	return std::memcmp(this, &other, sizeof(basic_uuid)) < 0;
+	// In the order of the text, which puts version 7 ids in time order.
+	if( internals.d0 != other.internals.d0 )
+		return internals.d0 < other.internals.d0;
+	else if( internals.d1 != other.internals.d1 )
+		return internals.d1 < other.internals.d1;
+	else if( internals.d2 != other.internals.d2 )
+		return internals.d2 < other.internals.d2;
+	return std::memcmp(internals.d3, other.internals.d3, sizeof(internals.d3)) < 0;
 }
 
 template <concepts::char_type CharT>
 bool basic_uuid<CharT>::operator>(const basic_uuid &other) const
 {
-	return std::memcmp(this, &other, sizeof(basic_uuid)) > 0;
+	return other < *this;
 }
 
 template <concepts::char_type CharT>
-std::basic_string<CharT> basic_uuid<CharT>::to_string(bool parcel) const
+int basic_uuid<CharT>::version() const noexcept
 {
-	if constexpr( is_char_v )
+	return internals.d2 >> 12;
+}
+
+template <concepts::char_type CharT>
+CharT *basic_uuid<CharT>::to_chars(char_t *buf, bool parcel) const noexcept
+{
+	const auto put = [&buf](uint32_t value, int digits)
 	{
-		char buffer[41] = ""; //aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee
-		if( parcel )
-		{
-			std::snprintf(buffer, 40, "{%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
-						 internals.d0, internals.d1, internals.d2, internals.d3[0], internals.d3[1], internals.d3[2], internals.d3[3], internals.d3[4], internals.d3[5], internals.d3[6], internals.d3[7]);
-		}
-		else
-		{
-			std::snprintf(buffer, 40, "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-						 internals.d0, internals.d1, internals.d2, internals.d3[0], internals.d3[1], internals.d3[2], internals.d3[3], internals.d3[4], internals.d3[5], internals.d3[6], internals.d3[7]);
-		}
-		return buffer;
+		while( digits-- > 0 )
+			*buf++ = static_cast<char_t>("0123456789ABCDEF"[(value >> (digits << 2)) & 0x0F]);
+	};
+	if( parcel )
+		*buf++ = '{';
+
+	put(internals.d0, 8);
+	*buf++ = '-';
+	put(internals.d1, 4);
+	*buf++ = '-';
+	put(internals.d2, 4);
+	*buf++ = '-';
+	put((internals.d3[0] << 8) | internals.d3[1], 4);
+	*buf++ = '-';
+
+	for(int i=2; i<8; i++)
+		put(internals.d3[i], 2);
+	if( parcel )
+		*buf++ = '}';
+	return buf;
+}
+
+template <concepts::char_type CharT>
+bool basic_uuid<CharT>::from_chars(string_view_t text) noexcept
+{
+	if( text.size() == string_size + 2 )
+	{
+		if( text.front() != '{' or text.back() != '}' )
+			return false;
+		text = text.substr(1, string_size);
 	}
-	else
+	else if( text.size() != string_size )
+		return false;
+
+	const auto nibble = [](char_t c) -> int
 	{
-		wchar_t buffer[41] = L""; //aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee
-		if( parcel )
-		{
-			std::swprintf(buffer, 40, L"{%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
-						  internals.d0, internals.d1, internals.d2, internals.d3[0], internals.d3[1], internals.d3[2], internals.d3[3], internals.d3[4], internals.d3[5], internals.d3[6], internals.d3[7]);
-		}
-		else
+		if( c >= '0' and c <= '9' )
+			return c - '0';
+		else if( c >= 'a' and c <= 'f' )
+			return c - 'a' + 10;
+		else if( c >= 'A' and c <= 'F' )
+			return c - 'A' + 10;
+		return -1;
+	};
+	uint8_t value[16];
+	for(size_t i=0, k=0; i<string_size; i+=2, k++)
+	{
+		if( i == 8 or i == 13 or i == 18 or i == 23 )
 		{
-			std::swprintf(buffer, 40, L"%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
-						  internals.d0, internals.d1, internals.d2, internals.d3[0], internals.d3[1], internals.d3[2], internals.d3[3], internals.d3[4], internals.d3[5], internals.d3[6], internals.d3[7]);
+			if( text[i++] != '-' )
+				return false;
 		}
-		return buffer;
+		const int hi = nibble(text[i]);
+		const int lo = nibble(text[i + 1]);
+		if( (hi | lo) < 0 )
+			return false;
+		value[k] = static_cast<uint8_t>((hi << 4) | lo);
 	}
+	internals.d0 = (static_cast<uint32_t>(value[0]) << 24) | (value[1] << 16) | (value[2] << 8) | value[3];
+	internals.d1 = static_cast<uint16_t>((value[4] << 8) | value[5]);
+	internals.d2 = static_cast<uint16_t>((value[6] << 8) | value[7]);
+	memcpy(internals.d3, value + 8, sizeof(internals.d3));
+	return true;
+}
+
+template <concepts::char_type CharT>
+std::basic_string<CharT> basic_uuid<CharT>::to_string(bool parcel) const
+{
+	char_t buf[string_size + 2];
+	return string_t(buf, to_chars(buf, parcel));
 }
 
 } //namespace libgs
@@ -161,14 +224,15 @@ template <libgs::concepts::char_type CharT>
 struct formatter<libgs::basic_uuid<CharT>, CharT>
 {
 	auto format(const libgs::basic_uuid<CharT> &uuid, auto &context) const {
-		return m_formatter.format(uuid.to_string(), context);
+		CharT buf[libgs::basic_uuid<CharT>::string_size];
+		return m_formatter.format(std::basic_string_view<CharT>(buf, uuid.to_chars(buf)), context);
 	}
 	constexpr auto parse(auto &context) noexcept {
 		return m_formatter.parse(context);
 	}
 
 private:
-	formatter<std::basic_string<CharT>, CharT> m_formatter;
+	formatter<std::basic_string_view<CharT>, CharT> m_formatter;
 };
 
 } //namespace std
@@ -0,0 +1,67 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_HASH_H
+#define LIBGS_CORE_ALGORITHM_HASH_H
+
+#include <libgs/core/mapped_file.h>
+
+namespace libgs
+{
+
+namespace concepts
+{
+
+// The incremental interface shared by sha1, sha256, xxhash64 and xxhash3.
+template <typename T>
+concept hash_algorithm = requires(T &hash, const void *data, size_t size)
+{
+	{ T::digest_size } -> std::convertible_to<size_t>;
+	{ hash.append(data, size) } -> std::same_as<T&>;
+	{ hash.finalize() } -> std::same_as<T&>;
+	{ hash.digest() } -> std::same_as<std::array<uint8_t,T::digest_size>>;
+	{ hash.hex() } -> std::same_as<std::string>;
+};
+
+} //namespace concepts
+
+// Feeds the whole file through a read-only mapping.
+template <concepts::hash_algorithm Hash>
+LIBGS_CORE_TAPI Hash &append_file(Hash &hash, const std::filesystem::path &file_name, error_code &error) noexcept;
+
+template <concepts::hash_algorithm Hash>
+LIBGS_CORE_TAPI Hash &append_file(Hash &hash, const std::filesystem::path &file_name);
+
+template <concepts::hash_algorithm Hash>
+[[nodiscard]] LIBGS_CORE_TAPI Hash file_hash(const std::filesystem::path &file_name);
+
+} //namespace libgs
+#include <libgs/core/algorithm/detail/hash.h>
+
+
+#endif //LIBGS_CORE_ALGORITHM_HASH_H
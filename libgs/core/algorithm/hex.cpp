@@ -0,0 +1,134 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "hex.h"
+#include "detail/codec_x86.h"
+
+namespace libgs
+{
+
+namespace detail
+{
+
+[[nodiscard]] static consteval std::array<int8_t,256> hex_make_values()
+{
+	std::array<int8_t,256> values {};
+	values.fill(-1);
+	for(int8_t i=0; i<10; i++)
+		values['0' + i] = i;
+	for(int8_t i=0; i<6; i++)
+	{
+		values['a' + i] = static_cast<int8_t>(10 + i);
+		values['A' + i] = static_cast<int8_t>(10 + i);
+	}
+	return values;
+}
+
+static constexpr auto hex_values = hex_make_values();
+
+} //namespace detail
+
+size_t to_hex(const void *data, size_t size, char *buf, bool upper_case) noexcept
+{
+	// The vector kernels are picked once, at the first use.
+	static const auto kernel = detail::hex_encode_x86();
+	const auto src = static_cast<const uint8_t*>(data);
+	size_t i = 0;
+
+	if( kernel )
+		i = kernel(src, size, buf, upper_case);
+
+	const auto alphabet = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+	for(; i<size; i++)
+	{
+		buf[(i << 1) + 0] = alphabet[src[i] >> 4];
+		buf[(i << 1) + 1] = alphabet[src[i] & 0x0F];
+	}
+	return size << 1;
+}
+
+std::string to_hex(const void *data, size_t size, bool upper_case)
+{
+	std::string result(size << 1, '\0');
+	to_hex(data, size, result.data(), upper_case);
+	return result;
+}
+
+std::string to_hex(std::string_view data, bool upper_case)
+{
+	return to_hex(data.data(), data.size(), upper_case);
+}
+
+size_t from_hex(std::string_view text, void *buf, error_code &error) noexcept
+{
+	error = error_code();
+	if( text.size() & 1 )
+	{
+		error = std::make_error_code(std::errc::invalid_argument);
+		return 0;
+	}
+	static const auto kernel = detail::hex_decode_x86();
+	const auto dst = static_cast<uint8_t*>(buf);
+	size_t i = 0;
+
+	if( kernel )
+		i = kernel(text.data(), text.size(), dst);
+
+	for(; i<text.size(); i+=2)
+	{
+		const int32_t hi = detail::hex_values[static_cast<uint8_t>(text[i])];
+		const int32_t lo = detail::hex_values[static_cast<uint8_t>(text[i + 1])];
+		if( (hi | lo) < 0 )
+		{
+			error = std::make_error_code(std::errc::illegal_byte_sequence);
+			return i >> 1;
+		}
+		dst[i >> 1] = static_cast<uint8_t>((hi << 4) | lo);
+	}
+	return text.size() >> 1;
+}
+
+std::string from_hex(std::string_view text, error_code &error)
+{
+	std::string result(text.size() >> 1, '\0');
+	from_hex(text, result.data(), error);
+	if( error )
+		result.clear();
+	return result;
+}
+
+std::string from_hex(std::string_view text)
+{
+	error_code error;
+	auto result = from_hex(text, error);
+	if( error )
+		throw system_error(error, "libgs::from_hex");
+	return result;
+}
+
+} //namespace libgs
@@ -0,0 +1,52 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_HEX_H
+#define LIBGS_CORE_ALGORITHM_HEX_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+// Writes (size << 1) characters to buf, returns that count.
+LIBGS_CORE_API size_t to_hex(const void *data, size_t size, char *buf, bool upper_case = true) noexcept;
+
+[[nodiscard]] LIBGS_CORE_API std::string to_hex(const void *data, size_t size, bool upper_case = true);
+[[nodiscard]] LIBGS_CORE_API std::string to_hex(std::string_view data, bool upper_case = true);
+
+// Either case is accepted. buf must hold (text.size() >> 1) bytes, returns the count written.
+LIBGS_CORE_API size_t from_hex(std::string_view text, void *buf, error_code &error) noexcept;
+
+[[nodiscard]] LIBGS_CORE_API std::string from_hex(std::string_view text, error_code &error);
+[[nodiscard]] LIBGS_CORE_API std::string from_hex(std::string_view text);
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_ALGORITHM_HEX_H
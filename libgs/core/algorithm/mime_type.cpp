@@ -25,13 +25,15 @@
 *   SOFTWARE.                                                                       *
 *                                                                                   *
 *************************************************************************************/
-
 #include "mime_type.h"
 #include "libgs/core/app_utls.h"
 #include "base.h"
 
-#include <unordered_map>
+#include <algorithm>
+#include <numeric>
 #include <fstream>
+#include <array>
+#include <bit>
 
 namespace fs = std::filesystem;
 
@@ -52,7 +54,24 @@ namespace libgs
 #define VIDEO        "video/"
 #define INTERFACE    "interface"
 
-static suffix_type_map g_suffix_hash
+struct suffix_entry
+{
+	std::string_view suffix;
+	std::string_view type;
+};
+
+struct magic_entry
+{
+	// Takes the literal length, signatures may contain NUL bytes.
+	template <size_t N>
+	consteval magic_entry(const char (&signature)[N], std::string_view type) :
+		signature(signature, N - 1), type(type) {}
+
+	std::string_view signature;
+	std::string_view type;
+};
+
+static constexpr suffix_entry g_suffix_entries[]
 {
 	{ ".1"             , TEXT "troff"                                                                  },
 	{ ".3ds"           , IMAGE "x-3ds"                                                                 },
@@ -65,13 +84,6 @@ static suffix_type_map g_suffix_hash
 	{ ".6pl"           , TEXT "x-perl"                                                                 },
 	{ ".7z"            , APPLICATION "x-7z-compressed"                                                 },
 	{ ".8svx"          , AUDIO "8svx"                                                                  },
-	{ ".ML"            , TEXT "x-ocaml"                                                                },
-	{ ".MYD"           , APPLICATION "x-mysql-misam-data"                                              },
-	{ ".MYI"           , APPLICATION "x-mysql-misam-compressed-index"                                  },
-	{ ".R"             , TEXT "x-rsrc"                                                                 },
-	{ ".TIF"           , IMAGE "tiff"                                                                  },
-	{ ".XXX"           , APPLICATION "octet-stream"                                                    },
-	{ ".Z"             , APPLICATION "x-compress"                                                      },
 	{ ".aa"            , AUDIO "x-pn-audibleaudio"                                                     },
 	{ ".ac3"           , AUDIO "ac3"                                                                   },
 	{ ".acsm"          , APPLICATION "vnd.adobe.adept+xml"                                             },
@@ -438,6 +450,8 @@ static suffix_type_map g_suffix_hash
 	{ ".mxf"           , APPLICATION "mxf"                                                             },
 	{ ".mxl"           , APPLICATION "vnd.recordare.musicxml"                                          },
 	{ ".mxmf"          , AUDIO "mobile-xmf"                                                            },
+	{ ".myd"           , APPLICATION "x-mysql-misam-data"                                              },
+	{ ".myi"           , APPLICATION "x-mysql-misam-compressed-index"                                  },
 	{ ".n3"            , TEXT "n3"                                                                     },
 	{ ".nap"           , IMAGE "naplps"                                                                },
 	{ ".nb"            , APPLICATION "mathematica"                                                     },
@@ -560,7 +574,6 @@ static suffix_type_map g_suffix_hash
 	{ ".ram"           , AUDIO "vnd.rn-realaudio"                                                      },
 	{ ".raml"          , TEXT "x-yaml"                                                                 },
 	{ ".rar"           , APPLICATION "vnd.rar"                                                         },
-	{ ".rar"           , APPLICATION "vnd.rar"                                                         },
 	{ ".ras"           , IMAGE "x-sun-raster"                                                          },
 	{ ".raw"           , IMAGE "x-raw-panasonic"                                                       },
 	{ ".rb"            , TEXT "x-ruby"                                                                 },
@@ -790,14 +803,16 @@ static suffix_type_map g_suffix_hash
 	{ ".xsp-config"    , TEXT "xml"                                                                    },
 	{ ".xspf"          , APPLICATION "xspf+xml"                                                        },
 	{ ".xwd"           , IMAGE "x-xwindowdump"                                                         },
+	{ ".xxx"           , APPLICATION "octet-stream"                                                    },
 	{ ".xz"            , APPLICATION "x-xz"                                                            },
 	{ ".y"             , TEXT "x-yacc"                                                                 },
 	{ ".yaml"          , TEXT "x-yaml"                                                                 },
 	{ ".yml"           , TEXT "x-yaml"                                                                 },
+	{ ".z"             , APPLICATION "x-compress"                                                      },
 	{ ".zip"           , APPLICATION "zip"                                                             }
 };
 
-static mime_head_map g_signatures_map
+static constexpr magic_entry g_signature_entries[]
 {
 	{ "\x00\x01\x00\x00\x00"                           , APPLICATION "x-font-ttf"             },
 	{ "\x04%!PS-Adobe-"                                , APPLICATION "postscript"             },
@@ -942,8 +957,7 @@ static mime_head_map g_signatures_map
 	{ "\xFF\xD8\xFF\xEE"                               , IMAGE "jpeg"                         }
 };
 
-
-static mime_head_map g_signatures_map_offset4
+static constexpr magic_entry g_signature_entries_offset4[]
 {
 	{ "\x0AVersion:Vivo"             , VIDEO "vivo"                     },
 	{ "#VRML V"                      , MODEL "vrml"                     },
@@ -979,48 +993,357 @@ static mime_head_map g_signatures_map_offset4
 	{ "wide"                         , VIDEO "quicktime"                }
 };
 
-namespace detail
+[[nodiscard]] static constexpr char ascii_to_lower(char c) noexcept
+{
+	return c >= 'A' and c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+[[nodiscard]] static constexpr bool suffix_equal(std::string_view a, std::string_view b) noexcept
+{
+	if( a.size() != b.size() )
+		return false;
+	for(size_t i=0; i<a.size(); i++)
+	{
+		if( ascii_to_lower(a[i]) != ascii_to_lower(b[i]) )
+			return false;
+	}
+	return true;
+}
+
+[[nodiscard]] static constexpr uint32_t hash_mix(uint32_t hash) noexcept
 {
+	// murmur3 finalizer, spreads the bits used for indexing.
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6Bu;
+	hash ^= hash >> 13;
+	hash *= 0xC2B2AE35u;
+	hash ^= hash >> 16;
+	return hash;
+}
 
-std::string mime_search(const mime_head_map &mimes, const char *buf, size_t size)
+[[nodiscard]] static constexpr uint32_t suffix_hash(std::string_view suffix) noexcept
 {
-	if( size == 0 )
-		return "text/plain";
-	size_t index = 0;
+	// FNV-1a over the lower-cased suffix.
+	uint32_t hash = 0x811C9DC5u;
+	for(char c : suffix)
+	{
+		hash ^= static_cast<uint8_t>(ascii_to_lower(c));
+		hash *= 0x01000193u;
+	}
+	return hash_mix(hash);
+}
+
+[[nodiscard]] static constexpr uint32_t slot_hash(uint32_t hash, uint32_t seed) noexcept
+{
+	return hash_mix(hash ^ (seed * 0x9E3779B9u));
+}
+
+// Hash and displace: the keys are spread over buckets first, then every bucket
+// (largest first) searches for its own seed which drops all of its keys into
+// free slots. A lookup is one pass over the suffix and one comparison.
+// The table is built at runtime on first use (the seed search is far beyond
+// the compilers' constexpr evaluation limits), hashing every suffix once.
+template <size_t N>
+class suffix_perfect_hash
+{
+public:
+	static constexpr size_t bucket_count = std::bit_ceil(N) / 4;
+	static constexpr size_t slot_count = std::bit_ceil(N) * 2;
+
+	explicit suffix_perfect_hash(const suffix_entry (&entries)[N]) :
+		m_entries(entries)
+	{
+		std::vector<uint32_t> hashes(N);
+		std::array<size_t, bucket_count> sizes {};
+		for(size_t i=0; i<N; i++)
+		{
+			hashes[i] = suffix_hash(entries[i].suffix);
+			sizes[hashes[i] & (bucket_count - 1)]++;
+		}
+
+		std::array<size_t, bucket_count> order {};
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			return sizes[a] > sizes[b];
+		});
+		for(auto bucket : order)
+		{
+			if( sizes[bucket] == 0 )
+				break;
+
+			std::vector<size_t> members;
+			for(size_t i=0; i<N; i++)
+			{
+				if( (hashes[i] & (bucket_count - 1)) != bucket )
+					continue;
+				for(auto j : members)
+				{
+					if( suffix_equal(entries[j].suffix, entries[i].suffix) )
+						throw runtime_error("libgs::suffix_perfect_hash: Duplicate suffix: '{}'.", entries[i].suffix);
+				}
+				members.emplace_back(i);
+			}
+			m_seeds[bucket] = find_seed(members, hashes);
+		}
+	}
+
+	[[nodiscard]] const suffix_entry *find(std::string_view suffix) const noexcept
+	{
+		auto hash = suffix_hash(suffix);
+		auto seed = m_seeds[hash & (bucket_count - 1)];
+		if( seed == 0 )
+			return nullptr;
+
+		auto slot = m_slots[slot_hash(hash, seed) & (slot_count - 1)];
+		if( slot == 0 or not suffix_equal(m_entries[slot - 1].suffix, suffix) )
+			return nullptr;
+		return &m_entries[slot - 1];
+	}
+
+private:
+	uint32_t find_seed(const std::vector<size_t> &members, const std::vector<uint32_t> &hashes)
+	{
+		const size_t count = members.size();
+		std::vector<size_t> slots(count);
+		for(uint32_t seed=1; seed<0x10000; seed++)
+		{
+			size_t i = 0;
+			for(; i<count; i++)
+			{
+				slots[i] = slot_hash(hashes[members[i]], seed) & (slot_count - 1);
+				if( m_slots[slots[i]] != 0 or std::find(slots.begin(), slots.begin() + i, slots[i]) != slots.begin() + i )
+					break;
+			}
+			if( i < count )
+				continue;
+			for(i=0; i<count; i++)
+				m_slots[slots[i]] = static_cast<uint16_t>(members[i] + 1);
+			return seed;
+		}
+		throw runtime_error("libgs::suffix_perfect_hash: No seed found.");
+	}
+
+private:
+	const suffix_entry *m_entries;
+	std::array<uint32_t, bucket_count> m_seeds {};
+	std::array<uint16_t, slot_count> m_slots {};
+};
+
+template <size_t N>
+[[nodiscard]] static consteval size_t magic_node_count(const magic_entry (&entries)[N])
+{
+	std::array<std::string_view, N> signatures {};
+	for(size_t i=0; i<N; i++)
+		signatures[i] = entries[i].signature;
+	std::sort(signatures.begin(), signatures.end());
+
+	// One node per distinct prefix, the root included.
+	size_t count = 1;
+	for(size_t i=0; i<N; i++)
+	{
+		size_t common = 0;
+		if( i > 0 )
+		{
+			auto &prev = signatures[i - 1];
+			while( common < prev.size() and common < signatures[i].size() and prev[common] == signatures[i][common] )
+				common++;
+		}
+		count += signatures[i].size() - common;
+	}
+	return count;
+}
+
+// Byte trie over the signatures, the edges of a node are contiguous and sorted by byte.
+template <size_t N, size_t NodeCount>
+class magic_trie
+{
+public:
+	consteval explicit magic_trie(const magic_entry (&entries)[N]) :
+		m_entries(entries)
+	{
+		std::array<size_t, N> order {};
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			return entries[a].signature < entries[b].signature;
+		});
+		size_t node_count = 1, edge_count = 0;
+		build(order, 0, N, 0, 0, node_count, edge_count);
+	}
+
+	// Returns 0 (the root, which is never a child) if there is no such edge.
+	[[nodiscard]] constexpr size_t next(size_t node, uint8_t byte) const noexcept
+	{
+		auto begin = m_edges.begin() + m_nodes[node].first_edge;
+		auto end = begin + m_nodes[node].edge_count;
+
+		auto it = std::lower_bound(begin, end, byte, [](const edge &e, uint8_t b) {
+			return e.byte < b;
+		});
+		return it != end and it->byte == byte ? it->node : 0;
+	}
+
+	[[nodiscard]] constexpr const magic_entry *entry(size_t node) const noexcept
+	{
+		auto index = m_nodes[node].entry;
+		return index == 0 ? nullptr : &m_entries[index - 1];
+	}
+
+private:
+	consteval void build(const std::array<size_t, N> &order, size_t begin, size_t end, size_t depth,
+						 size_t node, size_t &node_count, size_t &edge_count)
+	{
+		auto signature = [&](size_t i) {
+			return m_entries[order[i]].signature;
+		};
+		// A signature sorts ahead of those it is a prefix of.
+		if( begin < end and signature(begin).size() == depth )
+			m_nodes[node].entry = static_cast<uint16_t>(order[begin] + 1);
+		while( begin < end and signature(begin).size() == depth )
+			begin++;
+
+		size_t edge = edge_count;
+		for(size_t i=begin; i<end; edge_count++)
+		{
+			auto byte = signature(i)[depth];
+			while( i < end and signature(i)[depth] == byte )
+				i++;
+		}
+		m_nodes[node].first_edge = static_cast<uint16_t>(edge);
+		m_nodes[node].edge_count = static_cast<uint16_t>(edge_count - edge);
+
+		for(size_t i=begin; i<end; edge++)
+		{
+			auto first = i;
+			auto byte = signature(i)[depth];
+			while( i < end and signature(i)[depth] == byte )
+				i++;
+
+			auto child = node_count++;
+			m_edges[edge] = { static_cast<uint8_t>(byte), static_cast<uint16_t>(child) };
+			build(order, first, i, depth + 1, child, node_count, edge_count);
+		}
+	}
+
+private:
+	struct node
+	{
+		uint16_t first_edge = 0;
+		uint16_t edge_count = 0;
+		uint16_t entry = 0;
+	};
+	struct edge
+	{
+		uint8_t byte = 0;
+		uint16_t node = 0;
+	};
+	const magic_entry *m_entries;
+	std::array<node, NodeCount> m_nodes {};
+	std::array<edge, NodeCount - 1> m_edges {};
+};
+
+[[nodiscard]] static const suffix_perfect_hash<std::size(g_suffix_entries)> &suffix_table()
+{
+	static const suffix_perfect_hash table {g_suffix_entries};
+	return table;
+}
+
+static constexpr magic_trie<std::size(g_signature_entries), magic_node_count(g_signature_entries)>
+	g_signature_trie {g_signature_entries};
+
+static constexpr magic_trie<std::size(g_signature_entries_offset4), magic_node_count(g_signature_entries_offset4)>
+	g_signature_trie_offset4 {g_signature_entries_offset4};
+
+static suffix_type_map g_suffix_map;
+static mime_head_map g_signatures_map;
+static mime_head_map g_signatures_map_offset4;
+
+[[nodiscard]] static const std::string *signatures_map_search
+(const mime_head_map &mimes, const char *buf, size_t size) noexcept
+{
+	const std::string *result = nullptr;
+	size_t length = 0;
 
 	for(auto &[key,value] : mimes)
 	{
-		if( key[index] != buf[index] )
-			continue;
-		do {
-			if( ++index == key.size() )
-				return value;
-
-			else if( index == size or key[index] > buf[index] )
-				return "unknown";
+		if( key.size() >= length and key.size() <= size and std::string_view(buf, key.size()) == key )
+		{
+			result = &value;
+			length = key.size();
 		}
-		while( key[index] == buf[index] );
-		break;
 	}
-	return "unknown";
+	return result;
+}
+
+namespace detail
+{
+
+bool is_text_data(const char *buf, size_t size) noexcept
+{
+	// UTF16 byte order marks
+	if( size >= 2 and ((buf[0] == '\xFE' and buf[1] == '\xFF') or (buf[0] == '\xFF' and buf[1] == '\xFE')) )
+		return true;
+
+	// Check the first 128 bytes (see shared-mime spec)
+	const char *p = buf;
+	const char *e = p + ( 128 < size ? 128 : size );
+
+	for(; p<e; p++)
+	{
+		if( static_cast<char>(*p) < 32 and *p != 9 and *p != 10 and *p != 13 )
+			return false;
+	}
+	return true;
+}
+
+std::string_view suffix_mime_type(const fs::path &file_name)
+{
+	// Pick the suffix out of the native string, path::extension() would allocate.
+	using char_t = fs::path::value_type;
+	auto &name = file_name.native();
+
+	auto pos = name.size();
+	for(;;)
+	{
+		if( pos == 0 )
+			return "unknown";
+		auto c = name[--pos];
+		if( c == '.' )
+			break;
+		else if( c == '/' or c == fs::path::preferred_separator )
+			return "unknown";
+	}
+
+	char buf[32];
+	auto size = name.size() - pos;
+	if( size > sizeof(buf) )
+		return "unknown";
+
+	for(size_t i=0; i<size; i++)
+	{
+		auto c = static_cast<std::make_unsigned_t<char_t>>(name[pos + i]);
+		if( c > 0x7F )
+			return "unknown";
+		buf[i] = static_cast<char>(c);
+	}
+	return libgs::suffix_mime_type({buf, size});
 }
 
 } //namespace detail
 
 void set_suffix_map(suffix_type_map map)
 {
-	g_suffix_hash = std::move(map);
+	g_suffix_map = std::move(map);
 }
 
 void insert_suffix_map(suffix_type_map map)
 {
 	for(auto &[key,value] : map)
-		g_suffix_hash[std::move(key)] = std::move(value);
+		g_suffix_map[std::move(key)] = std::move(value);
 }
 
 suffix_type_map &suffix_map()
 {
-	return g_suffix_hash;
+	return g_suffix_map;
 }
 
 mime_head_map &signatures_map()
@@ -1033,43 +1356,85 @@ mime_head_map &signatures_map_offset4()
 	return g_signatures_map_offset4;
 }
 
-static std::string mime_from_magic(const fs::path &file_name)
+std::string_view suffix_mime_type(std::string_view suffix)
 {
-	std::ifstream file(app::absolute_path(file_name));
-	auto mime_type = detail::mime_from_magic(file);
-	file.close();
-	return mime_type;
+	if( not g_suffix_map.empty() )
+	{
+		auto it = g_suffix_map.find(str_to_lower(suffix));
+		if( it != g_suffix_map.end() )
+			return it->second;
+	}
+	auto entry = suffix_table().find(suffix);
+	return entry ? entry->type : "unknown";
 }
 
-std::string mime_type(const fs::path &file_name, bool magic_first)
+std::string_view magic_mime_type(const void *data, size_t size) noexcept
 {
-	if( magic_first )
+	auto buf = static_cast<const char*>(data);
+	if( not g_signatures_map.empty() )
 	{
-		auto type = mime_from_magic(file_name);
-		if( type != "unknown" )
-			return type;
+		if( auto type = signatures_map_search(g_signatures_map, buf, size) )
+			return *type;
+	}
+	if( not g_signatures_map_offset4.empty() and size > 4 )
+	{
+		if( auto type = signatures_map_search(g_signatures_map_offset4, buf + 4, size - 4) )
+			return *type;
+	}
+	// Both tries are walked in the same pass, the longest match wins and offset 0 goes first.
+	const magic_entry *match = nullptr, *match_offset4 = nullptr;
+	size_t node = 0, node_offset4 = 0;
+	bool walking = true, walking_offset4 = size > 4;
 
-		auto name = libgs::file_name(file_name.string());
-		auto pos = name.rfind('.');
+	for(size_t i=0; i<size and (walking or (walking_offset4 and not match)); i++)
+	{
+		auto byte = static_cast<uint8_t>(buf[i]);
+		if( walking )
+		{
+			node = g_signature_trie.next(node, byte);
+			walking = node != 0;
+			if( walking and g_signature_trie.entry(node) )
+				match = g_signature_trie.entry(node);
+		}
+		if( walking_offset4 and i >= 4 )
+		{
+			node_offset4 = g_signature_trie_offset4.next(node_offset4, byte);
+			walking_offset4 = node_offset4 != 0;
+			if( walking_offset4 and g_signature_trie_offset4.entry(node_offset4) )
+				match_offset4 = g_signature_trie_offset4.entry(node_offset4);
+		}
+	}
+	if( match )
+		return match->type;
+	else if( match_offset4 )
+		return match_offset4->type;
+	return "unknown";
+}
 
-		if( pos == std::string::npos )
-			return type;
+static std::string_view mime_from_magic(const fs::path &file_name)
+{
+	std::ifstream file(app::absolute_path(file_name), std::ios_base::binary);
+	return detail::mime_from_magic(file);
+}
 
-		auto it = g_suffix_hash.find(str_to_lower(name.substr(pos)));
-		if( it == g_suffix_hash.end() )
+std::string_view mime_type_view(const fs::path &file_name, bool magic_first)
+{
+	if( magic_first )
+	{
+		auto type = mime_from_magic(file_name);
+		if( type != "unknown" )
 			return type;
-		return it->second;
+		return detail::suffix_mime_type(file_name);
 	}
-	auto name = libgs::file_name(file_name.string());
-	auto pos = name.rfind('.');
-
-	if( pos == std::string::npos )
-		return mime_from_magic(file_name);
+	auto type = detail::suffix_mime_type(file_name);
+	if( type != "unknown" )
+		return type;
+	return mime_from_magic(file_name);
+}
 
-	auto it = g_suffix_hash.find(str_to_lower(name.substr(pos)));
-	if( it == g_suffix_hash.end() )
-		return mime_from_magic(file_name);
-	return it->second;
+std::string mime_type(const fs::path &file_name, bool magic_first)
+{
+	return std::string(mime_type_view(file_name, magic_first));
 }
 
 bool is_text_file(const fs::path &file_name)
@@ -39,10 +39,21 @@ namespace libgs
 using suffix_type_map = std::unordered_map<std::string, std::string>;
 using mime_head_map = std::map<std::string, std::string>;
 
+// User entries, looked up ahead of the built-in tables (empty by default).
 [[nodiscard]] LIBGS_CORE_API suffix_type_map &suffix_map();
 [[nodiscard]] LIBGS_CORE_API mime_head_map &signatures_map();
 [[nodiscard]] LIBGS_CORE_API mime_head_map &signatures_map_offset4();
 
+// The views refer to static storage (or to the user maps above), no allocations are made.
+[[nodiscard]] LIBGS_CORE_API
+std::string_view suffix_mime_type(std::string_view suffix);
+
+[[nodiscard]] LIBGS_CORE_API
+std::string_view magic_mime_type(const void *data, size_t size) noexcept;
+
+[[nodiscard]] LIBGS_CORE_API
+std::string_view mime_type_view(const std::filesystem::path &file_name, bool magic_first = false);
+
 [[nodiscard]] LIBGS_CORE_API
 std::string mime_type(const std::filesystem::path &file_name, bool magic_first = false);
 
@@ -55,6 +66,14 @@ bool is_binary_file(const std::filesystem::path &file_name);
 [[nodiscard]] LIBGS_CORE_API
 std::string text_file_encoding(const std::filesystem::path &file_name);
 
+template <typename FS>
+[[nodiscard]] LIBGS_CORE_TAPI std::string_view mime_type_view(FS &stream)
+	requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>;
+
+template <typename FS>
+[[nodiscard]] LIBGS_CORE_TAPI std::string_view mime_type_view(const std::filesystem::path &file_name, FS &stream)
+	requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>;
+
 template <typename FS>
 [[nodiscard]] LIBGS_CORE_TAPI std::string mime_type(FS &stream)
 	requires is_char_fstream_v<FS> or is_char_ifstream_v<FS>;
@@ -0,0 +1,240 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "detail/random_impl.hii"
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define LIBGS_CHACHA20_SSE2
+# include <emmintrin.h>
+#endif
+
+namespace libgs
+{
+
+namespace detail
+{
+
+static constexpr uint32_t chacha20_sigma[4] { 0x61707865, 0x3320646E, 0x79622D32, 0x6B206574 };
+
+#ifdef LIBGS_CHACHA20_SSE2
+
+[[nodiscard]] static inline __m128i chacha20_rotl(__m128i x, int n) noexcept
+{
+	return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n));
+}
+
+static inline void chacha20_quarter_round(__m128i &a, __m128i &b, __m128i &c, __m128i &d) noexcept
+{
+	a = _mm_add_epi32(a, b); d = chacha20_rotl(_mm_xor_si128(d, a), 16);
+	c = _mm_add_epi32(c, d); b = chacha20_rotl(_mm_xor_si128(b, c), 12);
+	a = _mm_add_epi32(a, b); d = chacha20_rotl(_mm_xor_si128(d, a), 8);
+	c = _mm_add_epi32(c, d); b = chacha20_rotl(_mm_xor_si128(b, c), 7);
+}
+
+// Four blocks side by side, one state word of every block per vector.
+static void chacha20_blocks(const uint32_t *key, uint32_t counter, uint8_t *out, size_t blocks) noexcept
+{
+	for(; blocks; blocks-=4, counter+=4, out+=256)
+	{
+		__m128i input[16], x[16];
+		for(int i=0; i<4; i++)
+			input[i] = _mm_set1_epi32(static_cast<int>(chacha20_sigma[i]));
+		for(int i=0; i<8; i++)
+			input[i + 4] = _mm_set1_epi32(static_cast<int>(key[i]));
+
+		input[12] = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(counter)), _mm_setr_epi32(0,1,2,3));
+		input[13] = input[14] = input[15] = _mm_setzero_si128();
+		memcpy(x, input, sizeof(x));
+
+		for(int i=0; i<10; i++)
+		{
+			chacha20_quarter_round(x[0], x[4], x[8],  x[12]);
+			chacha20_quarter_round(x[1], x[5], x[9],  x[13]);
+			chacha20_quarter_round(x[2], x[6], x[10], x[14]);
+			chacha20_quarter_round(x[3], x[7], x[11], x[15]);
+			chacha20_quarter_round(x[0], x[5], x[10], x[15]);
+			chacha20_quarter_round(x[1], x[6], x[11], x[12]);
+			chacha20_quarter_round(x[2], x[7], x[8],  x[13]);
+			chacha20_quarter_round(x[3], x[4], x[9],  x[14]);
+		}
+		// Transpose back, four words of every block at a time.
+		for(int i=0; i<16; i+=4)
+		{
+			const auto a = _mm_add_epi32(x[i + 0], input[i + 0]);
+			const auto b = _mm_add_epi32(x[i + 1], input[i + 1]);
+			const auto c = _mm_add_epi32(x[i + 2], input[i + 2]);
+			const auto d = _mm_add_epi32(x[i + 3], input[i + 3]);
+
+			const auto ab_lo = _mm_unpacklo_epi32(a, b), cd_lo = _mm_unpacklo_epi32(c, d);
+			const auto ab_hi = _mm_unpackhi_epi32(a, b), cd_hi = _mm_unpackhi_epi32(c, d);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 0   + (i << 2)), _mm_unpacklo_epi64(ab_lo, cd_lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 64  + (i << 2)), _mm_unpackhi_epi64(ab_lo, cd_lo));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 128 + (i << 2)), _mm_unpacklo_epi64(ab_hi, cd_hi));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 192 + (i << 2)), _mm_unpackhi_epi64(ab_hi, cd_hi));
+		}
+	}
+}
+
+#else //LIBGS_CHACHA20_SSE2
+
+static inline void chacha20_quarter_round(uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d) noexcept
+{
+	a += b; d = std::rotl(d ^ a, 16);
+	c += d; b = std::rotl(b ^ c, 12);
+	a += b; d = std::rotl(d ^ a, 8);
+	c += d; b = std::rotl(b ^ c, 7);
+}
+
+static void chacha20_blocks(const uint32_t *key, uint32_t counter, uint8_t *out, size_t blocks) noexcept
+{
+	for(; blocks; blocks--, counter++, out+=64)
+	{
+		const uint32_t input[16]
+		{
+			chacha20_sigma[0], chacha20_sigma[1], chacha20_sigma[2], chacha20_sigma[3],
+			key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+			counter, 0, 0, 0
+		};
+		uint32_t x[16];
+		memcpy(x, input, sizeof(x));
+
+		for(int i=0; i<10; i++)
+		{
+			chacha20_quarter_round(x[0], x[4], x[8],  x[12]);
+			chacha20_quarter_round(x[1], x[5], x[9],  x[13]);
+			chacha20_quarter_round(x[2], x[6], x[10], x[14]);
+			chacha20_quarter_round(x[3], x[7], x[11], x[15]);
+			chacha20_quarter_round(x[0], x[5], x[10], x[15]);
+			chacha20_quarter_round(x[1], x[6], x[11], x[12]);
+			chacha20_quarter_round(x[2], x[7], x[8],  x[13]);
+			chacha20_quarter_round(x[3], x[4], x[9],  x[14]);
+		}
+		for(int i=0; i<16; i++)
+		{
+			const auto word = x[i] + input[i];
+			out[(i << 2) + 0] = static_cast<uint8_t>(word);
+			out[(i << 2) + 1] = static_cast<uint8_t>(word >> 8);
+			out[(i << 2) + 2] = static_cast<uint8_t>(word >> 16);
+			out[(i << 2) + 3] = static_cast<uint8_t>(word >> 24);
+		}
+	}
+}
+
+#endif //LIBGS_CHACHA20_SSE2
+
+class LIBGS_DECL_HIDDEN secure_random_state
+{
+	LIBGS_DISABLE_COPY_MOVE(secure_random_state)
+
+	static constexpr size_t batch_blocks = 16; // a multiple of 4
+	static constexpr size_t reseed_interval = 1024 * 1024;
+
+public:
+	secure_random_state() = default;
+
+	void fill(uint8_t *buf, size_t size) noexcept
+	{
+		if( not m_seeded or m_generation != fork_generation() )
+			reseed();
+
+		while( size > 0 )
+		{
+			if( m_pos == sizeof(m_buf) )
+				refill();
+
+			// Bytes handed out do not stay behind.
+			const auto count = std::min(size, sizeof(m_buf) - m_pos);
+			memcpy(buf, m_buf + m_pos, count);
+			memset(m_buf + m_pos, 0, count);
+
+			m_pos += count;
+			buf += count;
+			size -= count;
+		}
+	}
+
+private:
+	void reseed() noexcept
+	{
+		system_random(m_key, sizeof(m_key));
+		m_generation = fork_generation();
+		m_seeded = true;
+		m_output = 0;
+		m_pos = sizeof(m_buf);
+	}
+
+	void refill() noexcept
+	{
+		if( m_output >= reseed_interval )
+			reseed();
+		chacha20_blocks(m_key, 0, m_buf, batch_blocks);
+
+		// Fast key erasure: the head of every batch becomes the next key and is never handed out,
+		// so a leaked state says nothing about the bytes that came before.
+		for(size_t i=0; i<8; i++)
+		{
+			const auto *ptr = m_buf + (i << 2);
+			m_key[i] = ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (static_cast<uint32_t>(ptr[3]) << 24);
+		}
+		memset(m_buf, 0, sizeof(m_key));
+		m_pos = sizeof(m_key);
+		m_output += sizeof(m_buf);
+	}
+
+private:
+	uint32_t m_key[8] {0};
+	uint8_t m_buf[batch_blocks << 6] {0};
+	size_t m_pos = sizeof(m_buf);
+	size_t m_output = 0;
+	uint32_t m_generation = 0;
+	bool m_seeded = false;
+};
+
+[[nodiscard]] static secure_random_state &secure_random_local() noexcept
+{
+	thread_local secure_random_state state;
+	return state;
+}
+
+} //namespace detail
+
+secure_random::result_type secure_random::operator()() const noexcept
+{
+	result_type value;
+	fill(&value, sizeof(value));
+	return value;
+}
+
+void secure_random::fill(void *buf, size_t size) noexcept
+{
+	detail::secure_random_local().fill(static_cast<uint8_t*>(buf), size);
+}
+
+} //namespace libgs
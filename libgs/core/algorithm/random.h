@@ -0,0 +1,57 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_RANDOM_H
+#define LIBGS_CORE_ALGORITHM_RANDOM_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+// A ChaCha20 keystream per thread, keyed from the system entropy source
+// (getrandom, BCryptGenRandom) and handed out in batches. Good for session ids,
+// tokens and nonces; satisfies std::uniform_random_bit_generator.
+class LIBGS_CORE_API secure_random
+{
+public:
+	using result_type = uint64_t;
+
+public:
+	[[nodiscard]] result_type operator()() const noexcept;
+	static void fill(void *buf, size_t size) noexcept;
+
+public:
+	[[nodiscard]] static constexpr result_type min() noexcept { return 0; }
+	[[nodiscard]] static constexpr result_type max() noexcept { return static_cast<result_type>(-1); }
+};
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_ALGORITHM_RANDOM_H
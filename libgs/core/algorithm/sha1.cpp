@@ -27,6 +27,9 @@
 *************************************************************************************/
 
 #include "sha1.h"
+#include "base64.h"
+#include "hex.h"
+#include "detail/sha_x86.h"
 
 namespace libgs
 {
@@ -44,22 +47,37 @@ public:
 		if( m_i >= sizeof(m_buf) )
 		{
 			m_i = 0;
-			process_block(m_buf);
+			process_blocks(m_buf, 1);
 		}
 	}
 
-	void process_block(const uint8_t *ptr)
+	void process_blocks(const uint8_t *ptr, size_t blocks)
+	{
+		// The SHA extensions are picked once, at the first use.
+		static const auto kernel = detail::sha_x86_supported() ?
+			&detail::sha1_x86_blocks : &impl::process_blocks_scalar;
+		kernel(m_state, ptr, blocks);
+	}
+
+private:
+	static void process_blocks_scalar(uint32_t *state, const uint8_t *ptr, size_t blocks) noexcept
+	{
+		for(; blocks; blocks--, ptr += 64)
+			process_block(state, ptr);
+	}
+
+	static void process_block(uint32_t *state, const uint8_t *ptr) noexcept
 	{
 		static constexpr uint32_t c0 = 0x5A827999;
 		static constexpr uint32_t c1 = 0x6ED9EBA1;
 		static constexpr uint32_t c2 = 0x8F1BBCDC;
 		static constexpr uint32_t c3 = 0xCA62C1D6;
 
-		uint32_t a = m_state[0];
-		uint32_t b = m_state[1];
-		uint32_t c = m_state[2];
-		uint32_t d = m_state[3];
-		uint32_t e = m_state[4];
+		uint32_t a = state[0];
+		uint32_t b = state[1];
+		uint32_t c = state[2];
+		uint32_t d = state[3];
+		uint32_t e = state[4];
 
 		uint32_t w[16];
 		for(int i=0; i<16; i++)
@@ -171,14 +189,13 @@ public:
 #undef SHA1_ROUND_3
 #undef SHA1_ROUND_4
 
-		m_state[0] += a;
-		m_state[1] += b;
-		m_state[2] += c;
-		m_state[3] += d;
-		m_state[4] += e;
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
 	}
 
-private:
 	static uint32_t make_word(const uint8_t *p)
 	{
 		return ( static_cast<uint32_t>(p[0]) << 24 ) |
@@ -245,8 +262,8 @@ sha1::~sha1()
 
 sha1 &sha1::operator=(const sha1 &other)
 {
-	memcpy(m_impl->m_state, other.m_impl->m_state, 5);
-	memcpy(m_impl->m_buf, other.m_impl->m_buf, 64);
+	memcpy(m_impl->m_state, other.m_impl->m_state, sizeof(m_impl->m_state));
+	memcpy(m_impl->m_buf, other.m_impl->m_buf, sizeof(m_impl->m_buf));
 
 	m_impl->m_i = other.m_impl->m_i;
 	m_impl->m_n_bits = other.m_impl->m_n_bits;
@@ -292,11 +309,14 @@ sha1 &sha1::append(const void *data, size_t size)
 	for(; size and m_impl->m_i % sizeof(m_impl->m_buf); size--)
 		append(*ptr++);
 
-	for(; size >= sizeof(m_impl->m_buf); size -= sizeof(m_impl->m_buf))
+	if( size >= sizeof(m_impl->m_buf) )
 	{
-		m_impl->process_block(ptr);
-		ptr += sizeof(m_impl->m_buf);
-		m_impl->m_n_bits += sizeof(m_impl->m_buf) << 3;
+		const size_t blocks = size / sizeof(m_impl->m_buf);
+		m_impl->process_blocks(ptr, blocks);
+
+		ptr += blocks * sizeof(m_impl->m_buf);
+		size -= blocks * sizeof(m_impl->m_buf);
+		m_impl->m_n_bits += blocks * sizeof(m_impl->m_buf) << 3;
 	}
 	for(; size; size--)
 		append(*ptr++);
@@ -354,55 +374,24 @@ sha1& sha1::finalize()
 	return *this;
 }
 
-std::string sha1::hex(bool upper_case) const
+sha1::digest_t sha1::digest() const
 {
-	static constexpr const char *lower = "0123456789abcdef";
-	static constexpr const char *upper = "0123456789ABCDEF";
-
-	auto alphabet = upper_case ? upper : lower;
-	char _hex[64] = "";
-	int k = 0;
+	digest_t result {};
+	for(size_t i=0; i<result.size(); i++)
+		result[i] = static_cast<uint8_t>(m_impl->m_state[i >> 2] >> ((3 - (i & 3)) << 3));
+	return result;
+}
 
-//	for(int i=0; i<5; i++)
-	for(int i : {0,1,2,3,4})
-	{
-		for(int j=7; j>=0; j--)
-			_hex[k++] = alphabet[(m_impl->m_state[i] >> (j << 2)) & 0x0F];
-	}
-	return _hex;
+std::string sha1::hex(bool upper_case) const
+{
+	const auto bytes = digest();
+	return to_hex(bytes.data(), bytes.size(), upper_case);
 }
 
 std::string sha1::base64() const
 {
-	static constexpr const char *table =
-			"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-			"abcdefghijklmnopqrstuvwxyz"
-			"0123456789"
-			"+/";
-
-	uint32_t triples[7]
-	{
-		( (m_impl->m_state[0] & 0xFFFFFF00) >> (1 << 3) ),
-		( (m_impl->m_state[0] & 0x000000FF) << (2 << 3) ) | ( (m_impl->m_state[1] & 0xFFFF0000) >> (2 << 3) ),
-		( (m_impl->m_state[1] & 0x0000FFFF) << (1 << 3) ) | ( (m_impl->m_state[2] & 0xFF000000) >> (3 << 3) ),
-		( (m_impl->m_state[2] & 0x00FFFFFF) << (0 << 3) ),
-		( (m_impl->m_state[3] & 0xFFFFFF00) >> (1 << 3) ),
-		( (m_impl->m_state[3] & 0x000000FF) << (2 << 3) ) | ( (m_impl->m_state[4] & 0xFFFF0000) >> (2 << 3) ),
-		( (m_impl->m_state[4] & 0x0000FFFF) << (1 << 3) ),
-	};
-	char _base64[32] = "";
-	int i = 0;
-
-	for(; i<7; i++)
-	{
-		auto x = triples[i];
-		_base64[(i << 2) + 0] = table[(x >> 3 * 6) % 64];
-		_base64[(i << 2) + 1] = table[(x >> 2 * 6) % 64];
-		_base64[(i << 2) + 2] = table[(x >> 1 * 6) % 64];
-		_base64[(i << 2) + 3] = table[(x >> 0 * 6) % 64];
-	}
-	_base64[(--i << 2) + 3] = '=';
-	return _base64;
+	const auto bytes = digest();
+	return to_base64(bytes.data(), bytes.size());
 }
 
 [[nodiscard]] std::wstring sha1::whex(bool upper_case) const
@@ -36,6 +36,10 @@ namespace libgs
 
 class LIBGS_CORE_API sha1
 {
+public:
+	static constexpr size_t digest_size = 20;
+	using digest_t = std::array<uint8_t,digest_size>;
+
 public:
 	sha1();
 	sha1(std::string_view text);
@@ -65,6 +69,7 @@ public:
 
 public:
 	sha1 &finalize();
+	[[nodiscard]] digest_t digest() const;
 	[[nodiscard]] std::string hex(bool upper_case = true) const;
 	[[nodiscard]] std::string base64() const;
 
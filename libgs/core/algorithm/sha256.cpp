@@ -0,0 +1,329 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "sha256.h"
+#include "base64.h"
+#include "hex.h"
+#include "detail/sha_x86.h"
+
+namespace libgs
+{
+
+class LIBGS_DECL_HIDDEN sha256::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+	impl() = default;
+
+	void add_byte_dont_count_bits(uint8_t x)
+	{
+		m_buf[m_i++] = x;
+		if( m_i >= sizeof(m_buf) )
+		{
+			m_i = 0;
+			process_blocks(m_buf, 1);
+		}
+	}
+
+	void process_blocks(const uint8_t *ptr, size_t blocks)
+	{
+		// The SHA extensions are picked once, at the first use.
+		static const auto kernel = detail::sha_x86_supported() ?
+			&detail::sha256_x86_blocks : &impl::process_blocks_scalar;
+		kernel(m_state, ptr, blocks);
+	}
+
+private:
+	static void process_blocks_scalar(uint32_t *state, const uint8_t *ptr, size_t blocks) noexcept
+	{
+		for(; blocks; blocks--, ptr += 64)
+			process_block(state, ptr);
+	}
+
+	static void process_block(uint32_t *state, const uint8_t *ptr) noexcept
+	{
+		static constexpr uint32_t k[64]
+		{
+			0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+			0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+			0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+			0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+			0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+			0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+			0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+			0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+		};
+		uint32_t w[64];
+		for(int i=0; i<16; i++)
+			w[i] = make_word(ptr + (i << 2));
+
+		for(int i=16; i<64; i++)
+		{
+			auto s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			auto s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+		uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+		uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+		for(int i=0; i<64; i++)
+		{
+			auto t1 = h + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+			auto t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+
+	static uint32_t make_word(const uint8_t *p)
+	{
+		return ( static_cast<uint32_t>(p[0]) << 24 ) |
+			   ( static_cast<uint32_t>(p[1]) << 16 ) |
+			   ( static_cast<uint32_t>(p[2]) <<  8 ) |
+			   ( static_cast<uint32_t>(p[3]) <<  0 );
+	}
+
+	static uint32_t ror32(uint32_t x, uint32_t n)
+	{
+		return (x >> n) | (x << (32 - n));
+	}
+
+public:
+	uint32_t m_state[8]
+	{
+		0x6A09E667,
+		0xBB67AE85,
+		0x3C6EF372,
+		0xA54FF53A,
+		0x510E527F,
+		0x9B05688C,
+		0x1F83D9AB,
+		0x5BE0CD19
+	};
+	uint8_t m_buf[64] {0};
+	uint32_t m_i = 0;
+	uint64_t m_n_bits = 0;
+};
+
+/*----------------------------------------------------------------------------------------------------------*/
+
+sha256::sha256() :
+	m_impl(new impl())
+{
+
+}
+
+sha256::sha256(std::string_view text) :
+	m_impl(new impl())
+{
+	append(text);
+}
+
+sha256::sha256(std::wstring_view text) :
+	m_impl(new impl())
+{
+	append(text);
+}
+
+sha256::sha256(const sha256 &other) :
+	m_impl(new impl())
+{
+	operator=(other);
+}
+
+sha256::sha256(sha256 &&other) noexcept :
+	m_impl(other.m_impl)
+{
+	other.m_impl = new impl();
+}
+
+sha256::~sha256()
+{
+	delete m_impl;
+}
+
+sha256 &sha256::operator=(const sha256 &other)
+{
+	memcpy(m_impl->m_state, other.m_impl->m_state, sizeof(m_impl->m_state));
+	memcpy(m_impl->m_buf, other.m_impl->m_buf, sizeof(m_impl->m_buf));
+
+	m_impl->m_i = other.m_impl->m_i;
+	m_impl->m_n_bits = other.m_impl->m_n_bits;
+	return *this;
+}
+
+sha256 &sha256::operator=(sha256 &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	delete m_impl;
+	m_impl = other.m_impl;
+	other.m_impl = new impl();
+	return *this;
+}
+
+sha256 &sha256::append(uint8_t x)
+{
+	m_impl->add_byte_dont_count_bits(x);
+	m_impl->m_n_bits += 8;
+	return *this;
+}
+
+sha256 &sha256::append(char c)
+{
+	return append(static_cast<uint8_t>(c));
+}
+
+sha256 &sha256::append(wchar_t c)
+{
+	return append(wcstombs(c));
+}
+
+sha256 &sha256::append(const void *data, size_t size)
+{
+	if( data == nullptr )
+	{
+		throw std::invalid_argument (
+			"libgs::sha256::append: data is nullptr"
+		);
+	}
+	auto ptr = static_cast<const uint8_t*>(data);
+	for(; size and m_impl->m_i % sizeof(m_impl->m_buf); size--)
+		append(*ptr++);
+
+	if( size >= sizeof(m_impl->m_buf) )
+	{
+		const size_t blocks = size / sizeof(m_impl->m_buf);
+		m_impl->process_blocks(ptr, blocks);
+
+		ptr += blocks * sizeof(m_impl->m_buf);
+		size -= blocks * sizeof(m_impl->m_buf);
+		m_impl->m_n_bits += blocks * sizeof(m_impl->m_buf) << 3;
+	}
+	for(; size; size--)
+		append(*ptr++);
+	return *this;
+}
+
+sha256 &sha256::append(std::string_view text)
+{
+	if( text.empty() )
+		return *this;
+	return append(text.data(), text.size());
+}
+
+sha256 &sha256::append(std::wstring_view text)
+{
+	if( text.empty() )
+		return *this;
+
+	auto tmp = wcstombs(text);
+	return append(tmp.data(), tmp.size());
+}
+
+void sha256::operator+=(uint8_t x)
+{
+	append(x);
+}
+
+void sha256::operator+=(char c)
+{
+	append(c);
+}
+
+void sha256::operator+=(wchar_t c)
+{
+	append(c);
+}
+
+void sha256::operator+=(const std::string &text)
+{
+	append(text);
+}
+
+void sha256::operator+=(const std::wstring &text)
+{
+	append(text);
+}
+
+sha256 &sha256::finalize()
+{
+	m_impl->add_byte_dont_count_bits(0x80);
+	while( m_impl->m_i % 64 != 56 )
+		m_impl->add_byte_dont_count_bits(0x00);
+	for(int j=7; j>=0; j--)
+		m_impl->add_byte_dont_count_bits(static_cast<uint8_t>(m_impl->m_n_bits >> (j << 3)));
+	return *this;
+}
+
+sha256::digest_t sha256::digest() const
+{
+	digest_t result {};
+	for(size_t i=0; i<result.size(); i++)
+		result[i] = static_cast<uint8_t>(m_impl->m_state[i >> 2] >> ((3 - (i & 3)) << 3));
+	return result;
+}
+
+std::string sha256::hex(bool upper_case) const
+{
+	const auto bytes = digest();
+	return to_hex(bytes.data(), bytes.size(), upper_case);
+}
+
+std::string sha256::base64() const
+{
+	const auto bytes = digest();
+	return to_base64(bytes.data(), bytes.size());
+}
+
+std::wstring sha256::whex(bool upper_case) const
+{
+	return mbstowcs(hex(upper_case));
+}
+
+std::wstring sha256::wbase64() const
+{
+	return mbstowcs(base64());
+}
+
+} //namespace libgs
@@ -35,7 +35,7 @@ namespace libgs
 {
 
 template <concepts::char_type CharT>
-union LIBGS_CORE_TAPI basic_uuid // version 4
+union LIBGS_CORE_TAPI basic_uuid
 {
 	static constexpr bool is_char_v = libgs::is_char_v<CharT>;
 
@@ -44,12 +44,21 @@ public:
 	using string_t = std::basic_string<char_t>;
 	using string_view_t = std::basic_string_view<char_t>;
 
+	// aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee, two more with the braces.
+	static constexpr size_t string_size = 36;
+
 public:
-	basic_uuid(string_view_t basic_uuid);
+	basic_uuid() noexcept; // nil
+	basic_uuid(string_view_t basic_uuid); // throws on invalid text, see from_chars
 	basic_uuid(const basic_uuid &other) = default;
 
 public:
-	[[nodiscard]] static basic_uuid generate();
+	// Version 4, 122 bits from secure_random.
+	[[nodiscard]] static basic_uuid generate() noexcept;
+
+	// Version 7, a unix timestamp in milliseconds followed by a counter and random bits.
+	// The ids of one thread keep increasing, so they sort (and index) in creation order.
+	[[nodiscard]] static basic_uuid generate_v7() noexcept;
 
 public:
 	basic_uuid &operator=(const basic_uuid &other) = default;
@@ -62,6 +71,14 @@ public:
 	bool operator>(const basic_uuid &other) const;
 
 public:
+	[[nodiscard]] int version() const noexcept;
+
+	// Writes string_size characters (two more with 'parcel'), returns the end.
+	char_t *to_chars(char_t *buf, bool parcel = false) const noexcept;
+
+	// Either form and either case; returns false and leaves the uuid unchanged if the text is not one.
+	bool from_chars(string_view_t text) noexcept;
+
 	// aaaaaaaa-bbbb-cccc-dddd-eeeeeeeeeeee
 	[[nodiscard]] string_t to_string(bool parcel = false) const;
 	operator string_t() const { return to_string(); }
@@ -0,0 +1,648 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "xxhash.h"
+#include "hex.h"
+#include "byte_order.h"
+
+namespace libgs
+{
+
+namespace detail
+{
+
+static constexpr uint64_t xxh_prime1 = 0x9E3779B185EBCA87ULL;
+static constexpr uint64_t xxh_prime2 = 0xC2B2AE3D27D4EB4FULL;
+static constexpr uint64_t xxh_prime3 = 0x165667B19E3779F9ULL;
+static constexpr uint64_t xxh_prime4 = 0x85EBCA77C2B2AE63ULL;
+static constexpr uint64_t xxh_prime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t xxh_rol64(uint64_t x, int n) noexcept
+{
+	return (x << n) | (x >> (64 - n));
+}
+
+// Little-endian loads, memcpy keeps them alignment-safe.
+static inline uint64_t xxh_read64(const uint8_t *p) noexcept
+{
+	uint64_t x;
+	memcpy(&x, p, sizeof(x));
+	if constexpr( std::endian::native == std::endian::big )
+		x = reverse(x);
+	return x;
+}
+
+static inline uint32_t xxh_read32(const uint8_t *p) noexcept
+{
+	uint32_t x;
+	memcpy(&x, p, sizeof(x));
+	if constexpr( std::endian::native == std::endian::big )
+		x = reverse(x);
+	return x;
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input) noexcept
+{
+	acc += input * xxh_prime2;
+	acc = xxh_rol64(acc, 31);
+	return acc * xxh_prime1;
+}
+
+static inline uint64_t xxh_merge_round(uint64_t acc, uint64_t value) noexcept
+{
+	acc ^= xxh_round(0, value);
+	return acc * xxh_prime1 + xxh_prime4;
+}
+
+// Consumes whole 32-byte stripes, returns the pointer past the last one.
+static inline const uint8_t *xxh_stripes(uint64_t (&acc)[4], const uint8_t *p, const uint8_t *end) noexcept
+{
+	for(; p + 32 <= end; p += 32)
+	{
+		acc[0] = xxh_round(acc[0], xxh_read64(p +  0));
+		acc[1] = xxh_round(acc[1], xxh_read64(p +  8));
+		acc[2] = xxh_round(acc[2], xxh_read64(p + 16));
+		acc[3] = xxh_round(acc[3], xxh_read64(p + 24));
+	}
+	return p;
+}
+
+static inline uint64_t xxh_finalize
+(const uint64_t (&acc)[4], uint64_t seed, uint64_t total, const uint8_t *p, const uint8_t *end) noexcept
+{
+	uint64_t h;
+	if( total >= 32 )
+	{
+		h = xxh_rol64(acc[0], 1) + xxh_rol64(acc[1], 7) + xxh_rol64(acc[2], 12) + xxh_rol64(acc[3], 18);
+		for(auto v : acc)
+			h = xxh_merge_round(h, v);
+	}
+	else
+		h = seed + xxh_prime5;
+	h += total;
+
+	for(; p + 8 <= end; p += 8)
+	{
+		h ^= xxh_round(0, xxh_read64(p));
+		h = xxh_rol64(h, 27) * xxh_prime1 + xxh_prime4;
+	}
+	if( p + 4 <= end )
+	{
+		h ^= static_cast<uint64_t>(xxh_read32(p)) * xxh_prime1;
+		h = xxh_rol64(h, 23) * xxh_prime2 + xxh_prime3;
+		p += 4;
+	}
+	for(; p < end; p++)
+	{
+		h ^= *p * xxh_prime5;
+		h = xxh_rol64(h, 11) * xxh_prime1;
+	}
+	h ^= h >> 33;
+	h *= xxh_prime2;
+	h ^= h >> 29;
+	h *= xxh_prime3;
+	h ^= h >> 32;
+	return h;
+}
+
+static constexpr uint64_t xxh_prime32_1 = 0x9E3779B1U;
+static constexpr uint64_t xxh_prime32_2 = 0x85EBCA77U;
+static constexpr uint64_t xxh_prime32_3 = 0xC2B2AE3DU;
+static constexpr uint64_t xxh_prime_mx1 = 0x165667919E3779F9ULL;
+static constexpr uint64_t xxh_prime_mx2 = 0x9FB21C651E98DF25ULL;
+
+static constexpr size_t xxh3_secret_size = 192;
+static constexpr size_t xxh3_stripe_len = 64;
+static constexpr size_t xxh3_consume_rate = 8;
+static constexpr size_t xxh3_stripes_per_block = (xxh3_secret_size - xxh3_stripe_len) / xxh3_consume_rate;
+static constexpr size_t xxh3_block_len = xxh3_stripe_len * xxh3_stripes_per_block;
+static constexpr size_t xxh3_secret_limit = xxh3_secret_size - xxh3_stripe_len;
+static constexpr size_t xxh3_midsize_max = 240;
+
+// The default secret, seeded hashes derive theirs from it (see xxh3_init_secret).
+alignas(64) static constexpr uint8_t xxh3_default_secret[xxh3_secret_size]
+{
+	0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+	0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+	0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+	0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+	0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+	0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+	0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+	0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+	0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+	0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+	0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+	0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static inline void xxh_write64(uint8_t *p, uint64_t x) noexcept
+{
+	if constexpr( std::endian::native == std::endian::big )
+		x = reverse(x);
+	memcpy(p, &x, sizeof(x));
+}
+
+// 64x64->128 multiplication, folded back to 64 bits by xor-ing both halves.
+static inline uint64_t xxh3_mul128_fold64(uint64_t lhs, uint64_t rhs) noexcept
+{
+#ifdef __SIZEOF_INT128__
+	auto product = static_cast<unsigned __int128>(lhs) * rhs;
+	return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+	const uint64_t lo_lo = (lhs & 0xFFFFFFFF) * (rhs & 0xFFFFFFFF);
+	const uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFF);
+	const uint64_t lo_hi = (lhs & 0xFFFFFFFF) * (rhs >> 32);
+	const uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+	const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+	const uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+	const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+	return lower ^ upper;
+#endif
+}
+
+static inline uint64_t xxh64_avalanche(uint64_t h) noexcept
+{
+	h ^= h >> 33;
+	h *= xxh_prime2;
+	h ^= h >> 29;
+	h *= xxh_prime3;
+	h ^= h >> 32;
+	return h;
+}
+
+static inline uint64_t xxh3_avalanche(uint64_t h) noexcept
+{
+	h ^= h >> 37;
+	h *= xxh_prime_mx1;
+	h ^= h >> 32;
+	return h;
+}
+
+static inline uint64_t xxh3_rrmxmx(uint64_t h, uint64_t len) noexcept
+{
+	h ^= xxh_rol64(h, 49) ^ xxh_rol64(h, 24);
+	h *= xxh_prime_mx2;
+	h ^= (h >> 35) + len;
+	h *= xxh_prime_mx2;
+	h ^= h >> 28;
+	return h;
+}
+
+static inline uint64_t xxh3_len_0to16(const uint8_t *p, size_t len, const uint8_t *secret, uint64_t seed) noexcept
+{
+	if( len > 8 )
+	{
+		const uint64_t flip_lo = (xxh_read64(secret + 24) ^ xxh_read64(secret + 32)) + seed;
+		const uint64_t flip_hi = (xxh_read64(secret + 40) ^ xxh_read64(secret + 48)) - seed;
+		const uint64_t lo = xxh_read64(p) ^ flip_lo;
+		const uint64_t hi = xxh_read64(p + len - 8) ^ flip_hi;
+		return xxh3_avalanche(len + reverse(lo) + hi + xxh3_mul128_fold64(lo, hi));
+	}
+	else if( len >= 4 )
+	{
+		seed ^= static_cast<uint64_t>(reverse(static_cast<uint32_t>(seed))) << 32;
+		const uint64_t flip = (xxh_read64(secret + 8) ^ xxh_read64(secret + 16)) - seed;
+		const uint64_t input = xxh_read32(p + len - 4) + (static_cast<uint64_t>(xxh_read32(p)) << 32);
+		return xxh3_rrmxmx(input ^ flip, len);
+	}
+	else if( len > 0 )
+	{
+		const uint32_t combined =
+			(static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[len >> 1]) << 24) |
+			static_cast<uint32_t>(p[len - 1]) | static_cast<uint32_t>(len << 8);
+		const uint64_t flip = (xxh_read32(secret) ^ xxh_read32(secret + 4)) + seed;
+		return xxh64_avalanche(combined ^ flip);
+	}
+	return xxh64_avalanche(seed ^ xxh_read64(secret + 56) ^ xxh_read64(secret + 64));
+}
+
+static inline uint64_t xxh3_mix16(const uint8_t *p, const uint8_t *secret, uint64_t seed) noexcept
+{
+	return xxh3_mul128_fold64 (
+		xxh_read64(p) ^ (xxh_read64(secret) + seed),
+		xxh_read64(p + 8) ^ (xxh_read64(secret + 8) - seed)
+	);
+}
+
+static inline uint64_t xxh3_len_17to128(const uint8_t *p, size_t len, const uint8_t *secret, uint64_t seed) noexcept
+{
+	uint64_t acc = len * xxh_prime1;
+	if( len > 32 )
+	{
+		if( len > 64 )
+		{
+			if( len > 96 )
+			{
+				acc += xxh3_mix16(p + 48, secret + 96, seed);
+				acc += xxh3_mix16(p + len - 64, secret + 112, seed);
+			}
+			acc += xxh3_mix16(p + 32, secret + 64, seed);
+			acc += xxh3_mix16(p + len - 48, secret + 80, seed);
+		}
+		acc += xxh3_mix16(p + 16, secret + 32, seed);
+		acc += xxh3_mix16(p + len - 32, secret + 48, seed);
+	}
+	acc += xxh3_mix16(p, secret, seed);
+	acc += xxh3_mix16(p + len - 16, secret + 16, seed);
+	return xxh3_avalanche(acc);
+}
+
+static inline uint64_t xxh3_len_129to240(const uint8_t *p, size_t len, const uint8_t *secret, uint64_t seed) noexcept
+{
+	uint64_t acc = len * xxh_prime1;
+	for(size_t i=0; i<8; i++)
+		acc += xxh3_mix16(p + 16 * i, secret + 16 * i, seed);
+	acc = xxh3_avalanche(acc);
+
+	const size_t rounds = len / 16;
+	for(size_t i=8; i<rounds; i++)
+		acc += xxh3_mix16(p + 16 * i, secret + 16 * (i - 8) + 3, seed);
+	acc += xxh3_mix16(p + len - 16, secret + 136 - 17, seed);
+	return xxh3_avalanche(acc);
+}
+
+// Inputs of at most 240 bytes never touch the accumulators.
+static inline uint64_t xxh3_hash_short(const uint8_t *p, size_t len, const uint8_t *secret, uint64_t seed) noexcept
+{
+	if( len <= 16 )
+		return xxh3_len_0to16(p, len, secret, seed);
+	else if( len <= 128 )
+		return xxh3_len_17to128(p, len, secret, seed);
+	return xxh3_len_129to240(p, len, secret, seed);
+}
+
+static inline void xxh3_init_acc(uint64_t (&acc)[8]) noexcept
+{
+	acc[0] = xxh_prime32_3; acc[1] = xxh_prime1;
+	acc[2] = xxh_prime2;    acc[3] = xxh_prime3;
+	acc[4] = xxh_prime4;    acc[5] = xxh_prime32_2;
+	acc[6] = xxh_prime5;    acc[7] = xxh_prime32_1;
+}
+
+static inline void xxh3_init_secret(uint8_t *secret, uint64_t seed) noexcept
+{
+	for(size_t i=0; i<xxh3_secret_size; i+=16)
+	{
+		xxh_write64(secret + i, xxh_read64(xxh3_default_secret + i) + seed);
+		xxh_write64(secret + i + 8, xxh_read64(xxh3_default_secret + i + 8) - seed);
+	}
+}
+
+// Eight independent lanes, written plainly so that the compiler can vectorize them.
+static inline void xxh3_accumulate_512(uint64_t (&acc)[8], const uint8_t *p, const uint8_t *secret) noexcept
+{
+	for(size_t i=0; i<8; i++)
+	{
+		const uint64_t data = xxh_read64(p + 8 * i);
+		const uint64_t key = data ^ xxh_read64(secret + 8 * i);
+		acc[i ^ 1] += data;
+		acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+	}
+}
+
+static inline void xxh3_accumulate(uint64_t (&acc)[8], const uint8_t *p, const uint8_t *secret, size_t stripes) noexcept
+{
+	for(size_t i=0; i<stripes; i++)
+		xxh3_accumulate_512(acc, p + i * xxh3_stripe_len, secret + i * xxh3_consume_rate);
+}
+
+static inline void xxh3_scramble(uint64_t (&acc)[8], const uint8_t *secret) noexcept
+{
+	for(size_t i=0; i<8; i++)
+	{
+		uint64_t a = acc[i];
+		a ^= a >> 47;
+		a ^= xxh_read64(secret + 8 * i);
+		acc[i] = a * xxh_prime32_1;
+	}
+}
+
+// Feeds whole stripes, scrambling at each block boundary; 'stripes_so_far' counts the
+// stripes of the current block and is carried between calls by the streaming interface.
+static inline const uint8_t *xxh3_consume_stripes
+(uint64_t (&acc)[8], size_t &stripes_so_far, const uint8_t *p, size_t stripes, const uint8_t *secret) noexcept
+{
+	auto block_secret = secret + stripes_so_far * xxh3_consume_rate;
+	if( stripes >= xxh3_stripes_per_block - stripes_so_far )
+	{
+		auto count = xxh3_stripes_per_block - stripes_so_far;
+		do {
+			xxh3_accumulate(acc, p, block_secret, count);
+			xxh3_scramble(acc, secret + xxh3_secret_limit);
+			p += count * xxh3_stripe_len;
+			stripes -= count;
+			count = xxh3_stripes_per_block;
+			block_secret = secret;
+		}
+		while( stripes >= xxh3_stripes_per_block );
+		stripes_so_far = 0;
+	}
+	if( stripes > 0 )
+	{
+		xxh3_accumulate(acc, p, block_secret, stripes);
+		p += stripes * xxh3_stripe_len;
+		stripes_so_far += stripes;
+	}
+	return p;
+}
+
+static inline uint64_t xxh3_merge_accs(const uint64_t (&acc)[8], const uint8_t *secret, uint64_t len) noexcept
+{
+	uint64_t result = len * xxh_prime1;
+	for(size_t i=0; i<4; i++)
+	{
+		result += xxh3_mul128_fold64 (
+			acc[2 * i] ^ xxh_read64(secret + 16 * i),
+			acc[2 * i + 1] ^ xxh_read64(secret + 16 * i + 8)
+		);
+	}
+	return xxh3_avalanche(result);
+}
+
+static inline uint64_t xxh3_hash_long(const uint8_t *p, size_t len, const uint8_t *secret) noexcept
+{
+	uint64_t acc[8];
+	xxh3_init_acc(acc);
+
+	const size_t blocks = (len - 1) / xxh3_block_len;
+	for(size_t i=0; i<blocks; i++)
+	{
+		xxh3_accumulate(acc, p + i * xxh3_block_len, secret, xxh3_stripes_per_block);
+		xxh3_scramble(acc, secret + xxh3_secret_limit);
+	}
+	const size_t stripes = ((len - 1) - xxh3_block_len * blocks) / xxh3_stripe_len;
+	xxh3_accumulate(acc, p + blocks * xxh3_block_len, secret, stripes);
+
+	// The last stripe always ends at the end of the input, overlapping the previous one.
+	xxh3_accumulate_512(acc, p + len - xxh3_stripe_len, secret + xxh3_secret_limit - 7);
+	return xxh3_merge_accs(acc, secret + 11, len);
+}
+
+} //namespace detail
+
+xxhash64::xxhash64(uint64_t seed) noexcept
+{
+	reset(seed);
+}
+
+xxhash64::xxhash64(std::string_view text, uint64_t seed) noexcept
+{
+	reset(seed);
+	append(text);
+}
+
+xxhash64 &xxhash64::append(const void *data, size_t size) noexcept
+{
+	if( size == 0 )
+		return *this;
+
+	auto p = static_cast<const uint8_t*>(data);
+	auto end = p + size;
+	m_total += size;
+
+	if( m_buf_size + size < sizeof(m_buf) )
+	{
+		memcpy(m_buf + m_buf_size, p, size);
+		m_buf_size += static_cast<uint32_t>(size);
+		return *this;
+	}
+	if( m_buf_size > 0 )
+	{
+		auto fill = sizeof(m_buf) - m_buf_size;
+		memcpy(m_buf + m_buf_size, p, fill);
+		detail::xxh_stripes(m_acc, m_buf, m_buf + sizeof(m_buf));
+		p += fill;
+		m_buf_size = 0;
+	}
+	p = detail::xxh_stripes(m_acc, p, end);
+	if( p < end )
+	{
+		memcpy(m_buf, p, static_cast<size_t>(end - p));
+		m_buf_size = static_cast<uint32_t>(end - p);
+	}
+	return *this;
+}
+
+xxhash64 &xxhash64::append(std::string_view text) noexcept
+{
+	return append(text.data(), text.size());
+}
+
+xxhash64 &xxhash64::reset(uint64_t seed) noexcept
+{
+	m_seed = seed;
+	m_acc[0] = seed + detail::xxh_prime1 + detail::xxh_prime2;
+	m_acc[1] = seed + detail::xxh_prime2;
+	m_acc[2] = seed;
+	m_acc[3] = seed - detail::xxh_prime1;
+	m_buf_size = 0;
+	m_total = 0;
+	m_value = 0;
+	return *this;
+}
+
+xxhash64 &xxhash64::finalize() noexcept
+{
+	m_value = detail::xxh_finalize(m_acc, m_seed, m_total, m_buf, m_buf + m_buf_size);
+	return *this;
+}
+
+uint64_t xxhash64::value() const noexcept
+{
+	return m_value;
+}
+
+xxhash64::digest_t xxhash64::digest() const noexcept
+{
+	digest_t result {};
+	for(size_t i=0; i<result.size(); i++)
+		result[i] = static_cast<uint8_t>(m_value >> ((7 - i) << 3));
+	return result;
+}
+
+std::string xxhash64::hex(bool upper_case) const
+{
+	const auto bytes = digest();
+	return to_hex(bytes.data(), bytes.size(), upper_case);
+}
+
+uint64_t xxhash64::hash(const void *data, size_t size, uint64_t seed) noexcept
+{
+	uint64_t acc[4]
+	{
+		seed + detail::xxh_prime1 + detail::xxh_prime2,
+		seed + detail::xxh_prime2,
+		seed,
+		seed - detail::xxh_prime1
+	};
+	auto p = static_cast<const uint8_t*>(data);
+	auto end = p + size;
+	p = detail::xxh_stripes(acc, p, end);
+	return detail::xxh_finalize(acc, seed, size, p, end);
+}
+
+uint64_t xxhash64::hash(std::string_view text, uint64_t seed) noexcept
+{
+	return hash(text.data(), text.size(), seed);
+}
+
+xxhash3::xxhash3(uint64_t seed) noexcept
+{
+	reset(seed);
+}
+
+xxhash3::xxhash3(std::string_view text, uint64_t seed) noexcept
+{
+	reset(seed);
+	append(text);
+}
+
+xxhash3 &xxhash3::append(const void *data, size_t size) noexcept
+{
+	if( size == 0 )
+		return *this;
+
+	auto p = static_cast<const uint8_t*>(data);
+	auto end = p + size;
+	m_total += size;
+
+	if( size <= sizeof(m_buf) - m_buf_size )
+	{
+		memcpy(m_buf + m_buf_size, p, size);
+		m_buf_size += static_cast<uint32_t>(size);
+		return *this;
+	}
+	constexpr size_t buf_stripes = sizeof(m_buf) / detail::xxh3_stripe_len;
+	if( m_buf_size > 0 )
+	{
+		auto fill = sizeof(m_buf) - m_buf_size;
+		memcpy(m_buf + m_buf_size, p, fill);
+		detail::xxh3_consume_stripes(m_acc, m_stripes, m_buf, buf_stripes, m_secret);
+		p += fill;
+		m_buf_size = 0;
+	}
+	// The input is consumed only up to its final stripe, which has to stay for finalize.
+	if( static_cast<size_t>(end - p) > sizeof(m_buf) )
+	{
+		auto stripes = static_cast<size_t>(end - 1 - p) / detail::xxh3_stripe_len;
+		p = detail::xxh3_consume_stripes(m_acc, m_stripes, p, stripes, m_secret);
+		memcpy(m_buf + sizeof(m_buf) - detail::xxh3_stripe_len, p - detail::xxh3_stripe_len, detail::xxh3_stripe_len);
+	}
+	memcpy(m_buf, p, static_cast<size_t>(end - p));
+	m_buf_size = static_cast<uint32_t>(end - p);
+	return *this;
+}
+
+xxhash3 &xxhash3::append(std::string_view text) noexcept
+{
+	return append(text.data(), text.size());
+}
+
+xxhash3 &xxhash3::reset(uint64_t seed) noexcept
+{
+	m_seed = seed;
+	detail::xxh3_init_acc(m_acc);
+	detail::xxh3_init_secret(m_secret, seed);
+	m_buf_size = 0;
+	m_stripes = 0;
+	m_total = 0;
+	m_value = 0;
+	return *this;
+}
+
+xxhash3 &xxhash3::finalize() noexcept
+{
+	if( m_total <= detail::xxh3_midsize_max )
+	{
+		m_value = detail::xxh3_hash_short(m_buf, m_buf_size, detail::xxh3_default_secret, m_seed);
+		return *this;
+	}
+	// Work on copies, so that appending may continue after finalize.
+	uint64_t acc[8];
+	memcpy(acc, m_acc, sizeof(acc));
+
+	uint8_t last_stripe[detail::xxh3_stripe_len];
+	const uint8_t *last_stripe_ptr = last_stripe;
+
+	if( m_buf_size >= detail::xxh3_stripe_len )
+	{
+		auto stripes_so_far = m_stripes;
+		auto stripes = (m_buf_size - 1) / detail::xxh3_stripe_len;
+		detail::xxh3_consume_stripes(acc, stripes_so_far, m_buf, stripes, m_secret);
+		last_stripe_ptr = m_buf + m_buf_size - detail::xxh3_stripe_len;
+	}
+	else
+	{
+		auto catchup = detail::xxh3_stripe_len - m_buf_size;
+		memcpy(last_stripe, m_buf + sizeof(m_buf) - catchup, catchup);
+		memcpy(last_stripe + catchup, m_buf, m_buf_size);
+	}
+	detail::xxh3_accumulate_512(acc, last_stripe_ptr, m_secret + detail::xxh3_secret_limit - 7);
+	m_value = detail::xxh3_merge_accs(acc, m_secret + 11, m_total);
+	return *this;
+}
+
+uint64_t xxhash3::value() const noexcept
+{
+	return m_value;
+}
+
+xxhash3::digest_t xxhash3::digest() const noexcept
+{
+	digest_t result {};
+	for(size_t i=0; i<result.size(); i++)
+		result[i] = static_cast<uint8_t>(m_value >> ((7 - i) << 3));
+	return result;
+}
+
+std::string xxhash3::hex(bool upper_case) const
+{
+	const auto bytes = digest();
+	return to_hex(bytes.data(), bytes.size(), upper_case);
+}
+
+uint64_t xxhash3::hash(const void *data, size_t size, uint64_t seed) noexcept
+{
+	auto p = static_cast<const uint8_t*>(data);
+	if( size <= detail::xxh3_midsize_max )
+		return detail::xxh3_hash_short(p, size, detail::xxh3_default_secret, seed);
+	else if( seed == 0 )
+		return detail::xxh3_hash_long(p, size, detail::xxh3_default_secret);
+
+	alignas(64) uint8_t secret[detail::xxh3_secret_size];
+	detail::xxh3_init_secret(secret, seed);
+	return detail::xxh3_hash_long(p, size, secret);
+}
+
+uint64_t xxhash3::hash(std::string_view text, uint64_t seed) noexcept
+{
+	return hash(text.data(), text.size(), seed);
+}
+
+} //namespace libgs
@@ -0,0 +1,114 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ALGORITHM_XXHASH_H
+#define LIBGS_CORE_ALGORITHM_XXHASH_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+// XXH64, a fast non-cryptographic hash for ETags, cache keys and hash tables.
+// The digest is the canonical (big-endian) form of value().
+class LIBGS_CORE_API xxhash64
+{
+public:
+	static constexpr size_t digest_size = 8;
+	using digest_t = std::array<uint8_t,digest_size>;
+
+public:
+	explicit xxhash64(uint64_t seed = 0) noexcept;
+	xxhash64(std::string_view text, uint64_t seed = 0) noexcept;
+
+public:
+	xxhash64 &append(const void *data, size_t size) noexcept;
+	xxhash64 &append(std::string_view text) noexcept;
+	xxhash64 &reset(uint64_t seed = 0) noexcept;
+
+public:
+	xxhash64 &finalize() noexcept;
+	[[nodiscard]] uint64_t value() const noexcept;
+	[[nodiscard]] digest_t digest() const noexcept;
+	[[nodiscard]] std::string hex(bool upper_case = true) const;
+
+public:
+	[[nodiscard]] static uint64_t hash(const void *data, size_t size, uint64_t seed = 0) noexcept;
+	[[nodiscard]] static uint64_t hash(std::string_view text, uint64_t seed = 0) noexcept;
+
+private:
+	uint64_t m_seed = 0;
+	uint64_t m_acc[4] {0};
+	uint8_t m_buf[32] {0};
+	uint32_t m_buf_size = 0;
+	uint64_t m_total = 0;
+	uint64_t m_value = 0;
+};
+
+// XXH3 (64-bit), the successor of XXH64 and considerably faster on short keys.
+// Its values differ from XXH64, the digest is the canonical (big-endian) form of value().
+class LIBGS_CORE_API xxhash3
+{
+public:
+	static constexpr size_t digest_size = 8;
+	using digest_t = std::array<uint8_t,digest_size>;
+
+public:
+	explicit xxhash3(uint64_t seed = 0) noexcept;
+	xxhash3(std::string_view text, uint64_t seed = 0) noexcept;
+
+public:
+	xxhash3 &append(const void *data, size_t size) noexcept;
+	xxhash3 &append(std::string_view text) noexcept;
+	xxhash3 &reset(uint64_t seed = 0) noexcept;
+
+public:
+	xxhash3 &finalize() noexcept;
+	[[nodiscard]] uint64_t value() const noexcept;
+	[[nodiscard]] digest_t digest() const noexcept;
+	[[nodiscard]] std::string hex(bool upper_case = true) const;
+
+public:
+	[[nodiscard]] static uint64_t hash(const void *data, size_t size, uint64_t seed = 0) noexcept;
+	[[nodiscard]] static uint64_t hash(std::string_view text, uint64_t seed = 0) noexcept;
+
+private:
+	uint64_t m_seed = 0;
+	uint64_t m_acc[8] {0};
+	uint8_t m_secret[192] {0};
+	uint8_t m_buf[256] {0};
+	uint32_t m_buf_size = 0;
+	size_t m_stripes = 0;
+	uint64_t m_total = 0;
+	uint64_t m_value = 0;
+};
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_ALGORITHM_XXHASH_H
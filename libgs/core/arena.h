@@ -0,0 +1,117 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ARENA_H
+#define LIBGS_CORE_ARENA_H
+
+#include <libgs/core/global.h>
+#include <memory_resource>
+
+namespace libgs
+{
+
+/*
+ * Per-owner (e.g. per-connection) allocation arena.
+ * Objects created by arena::make while a scope is active on the current thread
+ * are allocated from that arena, otherwise from the default heap.
+ * Every object remembers its memory resource, so arena::destroy can be called
+ * from anywhere, but the arena must outlive every object allocated from it.
+ */
+class LIBGS_CORE_VAPI arena final
+{
+	LIBGS_DISABLE_COPY_MOVE(arena)
+
+public:
+	explicit arena(size_t largest_block = 0x1000);
+	~arena() = default;
+
+public:
+	class scope
+	{
+		LIBGS_DISABLE_COPY_MOVE(scope)
+
+	public:
+		explicit scope(arena &a) noexcept;
+		~scope();
+
+	private:
+		std::pmr::memory_resource *m_prev;
+	};
+
+public:
+	[[nodiscard]] std::pmr::memory_resource *resource() noexcept;
+	[[nodiscard]] static std::pmr::memory_resource *current() noexcept;
+	void release();
+
+public:
+	template <typename T, typename...Args>
+	[[nodiscard]] static T *make(Args&&...args);
+
+	template <typename T>
+	static void destroy(T *ptr) noexcept;
+
+public:
+	/*
+	 * Owning handle for objects created by arena::make.
+	 * A moved-from handle is empty, dereferencing it throws instead of
+	 * touching a null pointer.
+	 */
+	template <typename T>
+	class ptr
+	{
+		LIBGS_DISABLE_COPY(ptr)
+
+	public:
+		ptr() noexcept = default;
+		explicit ptr(T *p) noexcept;
+		~ptr();
+
+		ptr(ptr &&other) noexcept;
+		ptr &operator=(ptr &&other) noexcept;
+
+	public:
+		[[nodiscard]] T *operator->() const;
+		[[nodiscard]] T &operator*() const;
+
+		[[nodiscard]] T *get() const noexcept;
+		[[nodiscard]] explicit operator bool() const noexcept;
+
+	private:
+		T *m_ptr = nullptr;
+	};
+
+private:
+	std::pmr::unsynchronized_pool_resource m_resource;
+	inline static thread_local std::pmr::memory_resource *s_current = nullptr;
+};
+
+} //namespace libgs
+#include <libgs/core/detail/arena.h>
+
+
+#endif //LIBGS_CORE_ARENA_H
@@ -0,0 +1,371 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "async_file.h"
+#include <algorithm>
+
+#ifndef LIBGS_ASIO_HAS_FILE
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif //LIBGS_ASIO_HAS_FILE
+
+namespace libgs
+{
+
+#ifndef LIBGS_ASIO_HAS_FILE
+
+static asio::thread_pool &file_pool()
+{
+	// Reads and writes only wait on the disk, a few threads are enough to keep it busy.
+	// Don't destruct it.
+	static auto *pool = new asio::thread_pool (
+		std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2, 8)
+	);
+	return *pool;
+}
+
+#endif //LIBGS_ASIO_HAS_FILE
+
+class LIBGS_DECL_HIDDEN async_file::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+#ifdef LIBGS_ASIO_HAS_FILE
+	explicit impl(const executor_t &exec) :
+		m_file(exec) {}
+#else
+	explicit impl(const executor_t&) {}
+#endif //LIBGS_ASIO_HAS_FILE
+
+	~impl() { close(); }
+
+public:
+	void open(const path_t &file_name, std::ios_base::openmode mode, error_code &error) noexcept
+	{
+		error = error_code();
+		const bool read = mode & std::ios_base::in;
+		const bool write = mode & (std::ios_base::out | std::ios_base::app);
+		const bool trunc = mode & std::ios_base::trunc;
+		const bool append = mode & std::ios_base::app;
+
+		if( not read and not write )
+		{
+			error = std::make_error_code(std::errc::invalid_argument);
+			return ;
+		}
+		// Same semantics as std::fstream: plain 'out' truncates, 'in|out' requires the file.
+		const bool create = write and (not read or trunc or append);
+		const bool truncate = trunc or (write and not read and not append);
+
+#ifdef LIBGS_ASIO_HAS_FILE
+		using flags_t = asio::file_base::flags;
+		auto flags = read and write ? asio::file_base::read_write :
+					 write ? asio::file_base::write_only : asio::file_base::read_only;
+		if( create )
+			flags = static_cast<flags_t>(flags | asio::file_base::create);
+		if( truncate )
+			flags = static_cast<flags_t>(flags | asio::file_base::truncate);
+		if( append )
+			flags = static_cast<flags_t>(flags | asio::file_base::append);
+
+		m_file.open(file_name.string(), flags, error);
+		if( error )
+			return ;
+#else
+		int flags = read and write ? O_RDWR : write ? O_WRONLY : O_RDONLY;
+		flags |= O_CLOEXEC;
+		if( create )
+			flags |= O_CREAT;
+		if( truncate )
+			flags |= O_TRUNC;
+		if( append )
+			flags |= O_APPEND;
+
+		m_fd = ::open(file_name.c_str(), flags, 0644);
+		if( m_fd < 0 )
+		{
+			error = error_code(errno, std::system_category());
+			return ;
+		}
+#endif //LIBGS_ASIO_HAS_FILE
+		m_file_name = file_name;
+	}
+
+	void close() noexcept
+	{
+#ifdef LIBGS_ASIO_HAS_FILE
+		error_code error;
+		m_file.close(error);
+#else
+		if( m_fd >= 0 )
+			::close(m_fd);
+		m_fd = -1;
+#endif //LIBGS_ASIO_HAS_FILE
+		m_file_name.clear();
+	}
+
+	[[nodiscard]] awaitable<size_t> co_read_at(uint64_t offset, const mutable_buffer &buf, error_code &error) noexcept
+	{
+		error = error_code();
+		if( not is_open() )
+		{
+			error = std::make_error_code(std::errc::bad_file_descriptor);
+			co_return 0;
+		}
+#ifdef LIBGS_ASIO_HAS_FILE
+		size_t sum = 0;
+		while( sum < buf.size() )
+		{
+			auto size = co_await m_file.async_read_some_at (
+				offset + sum, buf + sum, asio::redirect_error(use_awaitable, error)
+			);
+			sum += size;
+			if( error == asio::error::eof )
+			{
+				error = error_code();
+				break;
+			}
+			else if( error or size == 0 )
+				break;
+		}
+		co_return sum;
+#else
+		co_return co_await asio::co_spawn(file_pool(),
+		[fd = m_fd, offset, buf, &error]() -> awaitable<size_t>
+		{
+			auto data = static_cast<char*>(buf.data());
+			size_t sum = 0;
+			while( sum < buf.size() )
+			{
+				auto res = ::pread(fd, data + sum, buf.size() - sum, static_cast<off_t>(offset + sum));
+				if( res < 0 )
+				{
+					if( errno == EINTR )
+						continue;
+					error = error_code(errno, std::system_category());
+					break;
+				}
+				else if( res == 0 )
+					break;
+				sum += static_cast<size_t>(res);
+			}
+			co_return sum;
+		},
+		use_awaitable);
+#endif //LIBGS_ASIO_HAS_FILE
+	}
+
+	[[nodiscard]] awaitable<size_t> co_write_at(uint64_t offset, const const_buffer &buf, error_code &error) noexcept
+	{
+		error = error_code();
+		if( not is_open() )
+		{
+			error = std::make_error_code(std::errc::bad_file_descriptor);
+			co_return 0;
+		}
+#ifdef LIBGS_ASIO_HAS_FILE
+		co_return co_await asio::async_write_at (
+			m_file, offset, buf, asio::redirect_error(use_awaitable, error)
+		);
+#else
+		co_return co_await asio::co_spawn(file_pool(),
+		[fd = m_fd, offset, buf, &error]() -> awaitable<size_t>
+		{
+			auto data = static_cast<const char*>(buf.data());
+			size_t sum = 0;
+			while( sum < buf.size() )
+			{
+				auto res = ::pwrite(fd, data + sum, buf.size() - sum, static_cast<off_t>(offset + sum));
+				if( res < 0 )
+				{
+					if( errno == EINTR )
+						continue;
+					error = error_code(errno, std::system_category());
+					break;
+				}
+				sum += static_cast<size_t>(res);
+			}
+			co_return sum;
+		},
+		use_awaitable);
+#endif //LIBGS_ASIO_HAS_FILE
+	}
+
+	[[nodiscard]] size_t size(error_code &error) const noexcept
+	{
+		error = error_code();
+		if( not is_open() )
+		{
+			error = std::make_error_code(std::errc::bad_file_descriptor);
+			return 0;
+		}
+#ifdef LIBGS_ASIO_HAS_FILE
+		return static_cast<size_t>(m_file.size(error));
+#else
+		struct stat st {};
+		if( fstat(m_fd, &st) < 0 )
+		{
+			error = error_code(errno, std::system_category());
+			return 0;
+		}
+		return static_cast<size_t>(st.st_size);
+#endif //LIBGS_ASIO_HAS_FILE
+	}
+
+	[[nodiscard]] bool is_open() const noexcept
+	{
+#ifdef LIBGS_ASIO_HAS_FILE
+		return m_file.is_open();
+#else
+		return m_fd >= 0;
+#endif //LIBGS_ASIO_HAS_FILE
+	}
+
+public:
+#ifdef LIBGS_ASIO_HAS_FILE
+	asio::random_access_file m_file;
+#else
+	int m_fd = -1;
+#endif //LIBGS_ASIO_HAS_FILE
+	path_t m_file_name;
+};
+
+[[nodiscard]] static awaitable<size_t> co_not_open(error_code &error) noexcept
+{
+	error = std::make_error_code(std::errc::bad_file_descriptor);
+	co_return 0;
+}
+
+async_file::async_file(const executor_t &exec) :
+	m_exec(exec),
+	m_impl(new impl(exec))
+{
+
+}
+
+async_file::~async_file()
+{
+	delete m_impl;
+}
+
+async_file::async_file(async_file &&other) noexcept :
+	m_exec(other.m_exec),
+	m_impl(std::exchange(other.m_impl, nullptr))
+{
+
+}
+
+async_file &async_file::operator=(async_file &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	delete m_impl;
+	m_exec = other.m_exec;
+	m_impl = std::exchange(other.m_impl, nullptr);
+	return *this;
+}
+
+void async_file::open(const path_t &file_name, std::ios_base::openmode mode, error_code &error) noexcept
+{
+	close();
+	if( not m_impl )
+	{
+		m_impl = new(std::nothrow) impl(m_exec);
+		if( not m_impl )
+		{
+			error = std::make_error_code(std::errc::not_enough_memory);
+			return ;
+		}
+	}
+	m_impl->open(file_name, mode, error);
+}
+
+void async_file::open(const path_t &file_name, std::ios_base::openmode mode)
+{
+	error_code error;
+	open(file_name, mode, error);
+	if( error )
+		throw system_error(error, "Cannot open file: '{}'", file_name);
+}
+
+void async_file::close() noexcept
+{
+	if( m_impl )
+		m_impl->close();
+}
+
+awaitable<size_t> async_file::co_read_at(uint64_t offset, const mutable_buffer &buf, error_code &error) noexcept
+{
+	if( not m_impl )
+		return co_not_open(error);
+	return m_impl->co_read_at(offset, buf, error);
+}
+
+awaitable<size_t> async_file::co_write_at(uint64_t offset, const const_buffer &buf, error_code &error) noexcept
+{
+	if( not m_impl )
+		return co_not_open(error);
+	return m_impl->co_write_at(offset, buf, error);
+}
+
+size_t async_file::size(error_code &error) const noexcept
+{
+	if( m_impl )
+		return m_impl->size(error);
+	error = std::make_error_code(std::errc::bad_file_descriptor);
+	return 0;
+}
+
+size_t async_file::size() const
+{
+	error_code error;
+	auto res = size(error);
+	if( error )
+		throw system_error(error, "Cannot get the size of file: '{}'", file_name());
+	return res;
+}
+
+const async_file::path_t &async_file::file_name() const noexcept
+{
+	static const path_t empty;
+	return m_impl ? m_impl->m_file_name : empty;
+}
+
+bool async_file::is_open() const noexcept
+{
+	return m_impl and m_impl->is_open();
+}
+
+const async_file::executor_t &async_file::get_executor() const noexcept
+{
+	return m_exec;
+}
+
+} //namespace libgs
@@ -0,0 +1,87 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_ASYNC_FILE_H
+#define LIBGS_CORE_ASYNC_FILE_H
+
+#include <libgs/core/execution.h>
+
+namespace libgs
+{
+
+// Positional file I/O that does not block the calling executor.
+// Backed by asio::random_access_file where the platform has it (IOCP, io_uring),
+// otherwise by pread/pwrite on a small shared thread pool.
+class LIBGS_CORE_API async_file
+{
+	LIBGS_DISABLE_COPY(async_file)
+
+public:
+	using path_t = std::filesystem::path;
+	using executor_t = asio::any_io_executor;
+
+	explicit async_file(const executor_t &exec = libgs::get_executor());
+	~async_file();
+
+	async_file(async_file &&other) noexcept;
+	async_file &operator=(async_file &&other) noexcept;
+
+public:
+	void open(const path_t &file_name, std::ios_base::openmode mode, error_code &error) noexcept;
+	void open(const path_t &file_name, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::binary);
+	void close() noexcept;
+
+public:
+	// Reads until the buffer is full or the end of the file is reached.
+	[[nodiscard]] awaitable<size_t> co_read_at
+	(uint64_t offset, const mutable_buffer &buf, error_code &error) noexcept;
+
+	// Writes the whole buffer unless an error occurs.
+	[[nodiscard]] awaitable<size_t> co_write_at
+	(uint64_t offset, const const_buffer &buf, error_code &error) noexcept;
+
+public:
+	[[nodiscard]] size_t size(error_code &error) const noexcept;
+	[[nodiscard]] size_t size() const;
+
+	[[nodiscard]] const path_t &file_name() const noexcept;
+	[[nodiscard]] bool is_open() const noexcept;
+	[[nodiscard]] const executor_t &get_executor() const noexcept;
+
+private:
+	class impl;
+	executor_t m_exec;
+
+	// Null once moved from, opening it again makes a new one.
+	impl *m_impl;
+};
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_ASYNC_FILE_H
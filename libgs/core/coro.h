@@ -33,5 +33,7 @@
 #include <libgs/core/coro/utilities.h>
 #include <libgs/core/coro/semaphore.h>
 #include <libgs/core/coro/mutex.h>
+#include <libgs/core/coro/channel.h>
+#include <libgs/core/coro/batcher.h>
 
 #endif //LIBGS_CORE_CORO_H
\ No newline at end of file
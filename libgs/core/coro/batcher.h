@@ -0,0 +1,72 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_CORO_BATCHER_H
+#define LIBGS_CORE_CORO_BATCHER_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class LIBGS_CORE_TAPI co_batcher
+{
+	LIBGS_DISABLE_COPY_MOVE(co_batcher)
+
+public:
+	using key_t = Key;
+	using value_t = Value;
+
+	// Receives the distinct keys of a batch and returns one value per key, in the same order.
+	using batch_func_t = std::function<awaitable<std::vector<value_t>>(const std::vector<key_t>&)>;
+
+	// A batch is sent after the current tick of the executor, or after max_delay if it is set,
+	// or as soon as it holds max_size distinct keys.
+	explicit co_batcher(batch_func_t func, size_t max_size = 128, const milliseconds &max_delay = {});
+	~co_batcher();
+
+public:
+	// An exception thrown by the batch function is rethrown to every awaiter of the batch.
+	// A cancelled load throws operation_aborted, its batch is sent regardless.
+	[[nodiscard]] awaitable<value_t> load(key_t key);
+
+public:
+	[[nodiscard]] size_t max_size() const noexcept;
+	[[nodiscard]] milliseconds max_delay() const noexcept;
+
+private:
+	class impl;
+	std::shared_ptr<impl> m_impl;
+};
+
+} //namespace libgs
+#include <libgs/core/coro/detail/batcher.h>
+
+
+#endif //LIBGS_CORE_CORO_BATCHER_H
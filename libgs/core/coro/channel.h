@@ -0,0 +1,83 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_CORO_CHANNEL_H
+#define LIBGS_CORE_CORO_CHANNEL_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+template <typename T>
+class LIBGS_CORE_TAPI co_channel
+{
+	LIBGS_DISABLE_COPY_MOVE(co_channel)
+
+public:
+	using value_t = T;
+	static constexpr size_t unbounded = std::numeric_limits<size_t>::max();
+
+	// A capacity of 0 makes every send wait for its receiver (rendezvous).
+	explicit co_channel(size_t capacity = unbounded);
+	~co_channel();
+
+public:
+	// A waiting send or receive can be cancelled through the cancellation slot of its
+	// coroutine, it then throws operation_aborted (a cancelled send drops its value).
+
+	// Returns false if the channel has been closed.
+	[[nodiscard]] awaitable<bool> send(value_t value);
+	[[nodiscard]] bool try_send(value_t &&value);
+	[[nodiscard]] bool try_send(const value_t &value);
+
+	// Returns nullopt once the channel is closed and drained.
+	[[nodiscard]] awaitable<std::optional<value_t>> receive();
+	[[nodiscard]] std::optional<value_t> try_receive();
+
+	// Waits for at least one value and takes up to max of them with one wake up.
+	// Returns an empty vector once the channel is closed and drained.
+	[[nodiscard]] awaitable<std::vector<value_t>> receive_many(size_t max);
+
+public:
+	void close() noexcept;
+	[[nodiscard]] bool is_closed() const noexcept;
+
+	[[nodiscard]] size_t size() const noexcept;
+	[[nodiscard]] size_t capacity() const noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+} //namespace libgs
+#include <libgs/core/coro/detail/channel.h>
+
+
+#endif //LIBGS_CORE_CORO_CHANNEL_H
@@ -0,0 +1,266 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_CORO_DETAIL_BATCHER_H
+#define LIBGS_CORE_CORO_DETAIL_BATCHER_H
+
+#include <libgs/core/spin_mutex.h>
+#include <unordered_map>
+
+namespace libgs
+{
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+class LIBGS_CORE_TAPI co_batcher<Key,Value,Hash,KeyEqual>::impl :
+	public std::enable_shared_from_this<impl>
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+	using handler_t = asio::detail::awaitable_handler<asio::any_io_executor, error_code>;
+
+	// Lives in the frame of the suspended coroutine.
+	struct waiter
+	{
+		size_t index = 0;
+		std::optional<handler_t> handler {};
+		std::optional<value_t> value {};
+		std::exception_ptr error {};
+	};
+
+	struct batch
+	{
+		std::vector<key_t> keys {};
+		std::unordered_map<key_t,size_t,Hash,KeyEqual> indexes {};
+		std::vector<waiter*> waiters {};
+		std::atomic_flag started {};
+
+		// Only with a max_delay, waited on and cancelled under the lock of the batcher.
+		std::optional<asio::steady_timer> timer {};
+	};
+	using batch_ptr = std::shared_ptr<batch>;
+
+	impl(batch_func_t func, size_t max_size, const milliseconds &max_delay) :
+		m_func(std::move(func)),
+		m_max_size(std::max<size_t>(max_size, 1)),
+		m_max_delay(max_delay)
+	{
+		if( not m_func )
+			throw runtime_error("libgs::co_batcher: The batch function is empty.");
+	}
+
+public:
+	void join(waiter &waiter, const key_t &key, handler_t handler)
+	{
+		auto exec = asio::get_associated_executor(handler);
+		batch_ptr created, full;
+		{
+			std::lock_guard lock(m_mutex);
+			if( not m_current )
+			{
+				m_current = created = std::make_shared<batch>();
+				if( m_max_delay.count() > 0 )
+					m_current->timer.emplace(exec);
+			}
+			auto &batch = *m_current;
+			auto [it, inserted] = batch.indexes.try_emplace(key, batch.keys.size());
+			if( inserted )
+				batch.keys.emplace_back(key);
+
+			waiter.index = it->second;
+			waiter.handler.emplace(std::move(handler));
+			batch.waiters.emplace_back(&waiter);
+			bind_cancellation(waiter, m_current);
+
+			if( batch.keys.size() >= m_max_size )
+			{
+				// Sent right away, the pending flush has nothing left to wait for.
+				full = std::move(m_current);
+				if( full->timer )
+					full->timer->cancel();
+			}
+		}
+		// Spawned outside of the lock, they may start right here and take it.
+		if( created )
+			asio::co_spawn(exec, flush_later(this->shared_from_this(), std::move(created), exec), asio::detached);
+		if( full )
+			asio::co_spawn(exec, run(this->shared_from_this(), std::move(full)), asio::detached);
+	}
+
+private:
+	// The caller holds the lock. A cancelled waiter that has not been answered yet leaves
+	// its batch and gets operation_aborted; the batch itself is still sent. Cancellation is
+	// emitted on the executor of the waiter, the handler clears the slot when it runs.
+	void bind_cancellation(waiter &waiter, batch_ptr batch)
+	{
+		auto slot = asio::get_associated_cancellation_slot(*waiter.handler);
+		if( not slot.is_connected() )
+			return ;
+
+		slot.assign([self = this->shared_from_this(), batch = std::move(batch), &waiter](asio::cancellation_type type)
+		{
+			if( type == asio::cancellation_type::none )
+				return ;
+
+			std::lock_guard lock(self->m_mutex);
+			auto it = std::ranges::find(batch->waiters, &waiter);
+			if( it == batch->waiters.end() )
+				return ;
+			batch->waiters.erase(it);
+			wake(waiter, asio::error::operation_aborted);
+		});
+	}
+
+	static void wake(waiter &waiter, error_code error = {})
+	{
+		auto handler = std::move(*waiter.handler);
+		waiter.handler.reset();
+		asio::post(asio::append(std::move(handler), error));
+	}
+
+	// The batcher is kept alive by self until the batch is done.
+	[[nodiscard]] static awaitable<void> flush_later
+	(std::shared_ptr<impl> self, batch_ptr batch, asio::any_io_executor exec)
+	{
+		if( not batch->timer )
+			co_await asio::post(exec, use_awaitable);
+		else try
+		{
+			co_await asio::async_initiate<const use_awaitable_t&, void(error_code)>(
+			[&](handler_t handler)
+			{
+				// A batch that filled up before this started has been sent already.
+				std::lock_guard lock(self->m_mutex);
+				if( self->m_current != batch )
+					return asio::post(asio::append(std::move(handler), make_error_code(asio::error::operation_aborted)));
+
+				batch->timer->expires_after(self->m_max_delay);
+				batch->timer->async_wait(std::move(handler));
+			},
+			use_awaitable);
+		}
+		catch(const std::system_error&) {
+			co_return ;
+		}
+		{
+			std::lock_guard lock(self->m_mutex);
+			if( self->m_current == batch )
+				self->m_current.reset();
+		}
+		co_await run(std::move(self), std::move(batch));
+		co_return ;
+	}
+
+	[[nodiscard]] static awaitable<void> run(std::shared_ptr<impl> self, batch_ptr batch)
+	{
+		// Sent once, by whichever of the timer and the size limit comes first.
+		if( batch->started.test_and_set() )
+			co_return ;
+
+		std::vector<value_t> values;
+		std::exception_ptr error;
+		try {
+			values = co_await self->m_func(batch->keys);
+			if( values.size() != batch->keys.size() )
+			{
+				throw runtime_error (
+					"libgs::co_batcher: The batch function returned {} values for {} keys.",
+					values.size(), batch->keys.size()
+				);
+			}
+		}
+		catch(...) {
+			error = std::current_exception();
+		}
+		// No more waiters join a batch once it has left m_current, cancelled ones may still leave.
+		std::vector<waiter*> waiters;
+		{
+			std::lock_guard lock(self->m_mutex);
+			waiters.swap(batch->waiters);
+		}
+		for(auto *waiter : waiters)
+		{
+			if( error )
+				waiter->error = error;
+			else
+				waiter->value.emplace(values[waiter->index]);
+			wake(*waiter);
+		}
+		co_return ;
+	}
+
+public:
+	batch_func_t m_func;
+	size_t m_max_size;
+	milliseconds m_max_delay;
+
+	spin_mutex m_mutex;
+	batch_ptr m_current;
+};
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+co_batcher<Key,Value,Hash,KeyEqual>::co_batcher(batch_func_t func, size_t max_size, const milliseconds &max_delay) :
+	m_impl(std::make_shared<impl>(std::move(func), max_size, max_delay))
+{
+
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+co_batcher<Key,Value,Hash,KeyEqual>::~co_batcher() = default;
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+awaitable<Value> co_batcher<Key,Value,Hash,KeyEqual>::load(key_t key)
+{
+	typename impl::waiter waiter;
+	co_await asio::async_initiate<const use_awaitable_t&, void(error_code)>(
+	[this, &waiter, &key](typename impl::handler_t handler) {
+		m_impl->join(waiter, key, std::move(handler));
+	},
+	use_awaitable);
+
+	if( waiter.error )
+		std::rethrow_exception(waiter.error);
+	co_return std::move(*waiter.value);
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+size_t co_batcher<Key,Value,Hash,KeyEqual>::max_size() const noexcept
+{
+	return m_impl->m_max_size;
+}
+
+template <typename Key, typename Value, typename Hash, typename KeyEqual>
+milliseconds co_batcher<Key,Value,Hash,KeyEqual>::max_delay() const noexcept
+{
+	return m_impl->m_max_delay;
+}
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_CORO_DETAIL_BATCHER_H
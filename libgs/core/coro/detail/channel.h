@@ -0,0 +1,334 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_CORO_DETAIL_CHANNEL_H
+#define LIBGS_CORE_CORO_DETAIL_CHANNEL_H
+
+#include <libgs/core/spin_mutex.h>
+#include <deque>
+
+namespace libgs
+{
+
+template <typename T>
+class LIBGS_CORE_TAPI co_channel<T>::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+	using handler_t = asio::detail::awaitable_handler<asio::any_io_executor, error_code>;
+
+	// Lives in the frame of the suspended coroutine, so waiting costs no allocation.
+	struct waiter
+	{
+		std::optional<handler_t> handler {};
+		std::optional<value_t> value {};
+		bool done = false;
+	};
+
+	explicit impl(size_t capacity) :
+		m_capacity(capacity) {}
+
+	~impl()
+	{
+		// Destroys the suspended coroutines.
+		for(auto *waiter : m_receivers)
+			release(*waiter);
+		for(auto *waiter : m_senders)
+			release(*waiter);
+	}
+
+public:
+	// The caller holds the lock.
+	[[nodiscard]] bool put(value_t &value)
+	{
+		// Receivers only wait on an empty buffer, so hand the value over directly.
+		if( not m_receivers.empty() )
+		{
+			auto &receiver = *m_receivers.front();
+			m_receivers.pop_front();
+
+			receiver.value.emplace(std::move(value));
+			receiver.done = true;
+			wake(receiver);
+		}
+		else if( m_buffer.size() < m_capacity )
+			m_buffer.emplace_back(std::move(value));
+		else
+			return false;
+		return true;
+	}
+
+	[[nodiscard]] std::optional<value_t> take()
+	{
+		std::optional<value_t> result;
+		if( not m_buffer.empty() )
+		{
+			result.emplace(std::move(m_buffer.front()));
+			m_buffer.pop_front();
+
+			// A slot is free now, admit the oldest waiting sender.
+			if( not m_senders.empty() )
+			{
+				auto &sender = *m_senders.front();
+				m_senders.pop_front();
+
+				m_buffer.emplace_back(std::move(*sender.value));
+				sender.done = true;
+				wake(sender);
+			}
+		}
+		else if( not m_senders.empty() )
+		{
+			auto &sender = *m_senders.front();
+			m_senders.pop_front();
+
+			result.emplace(std::move(*sender.value));
+			sender.done = true;
+			wake(sender);
+		}
+		return result;
+	}
+
+	// The caller holds the lock.
+	void enqueue(std::deque<waiter*> &queue, waiter &waiter)
+	{
+		queue.emplace_back(&waiter);
+		auto slot = asio::get_associated_cancellation_slot(*waiter.handler);
+		if( not slot.is_connected() )
+			return ;
+
+		// Cancellation (the losing side of an awaitable '||', for instance) is emitted on the
+		// executor of the waiter. A waiter still queued is unlinked and gets operation_aborted;
+		// one already taken has its completion posted and is left alone. The handler clears
+		// the slot when it runs.
+		slot.assign([this, &queue, &waiter](asio::cancellation_type type)
+		{
+			if( type == asio::cancellation_type::none )
+				return ;
+
+			std::lock_guard lock(m_mutex);
+			auto it = std::ranges::find(queue, &waiter);
+			if( it == queue.end() )
+				return ;
+			queue.erase(it);
+			wake(waiter, asio::error::operation_aborted);
+		});
+	}
+
+	static void wake(waiter &waiter, error_code error = {})
+	{
+		// Posted straight to the executor of the waiter, wherever it runs.
+		// Posting never resumes inline, so this is safe under the lock.
+		asio::post(asio::append(release(waiter), error));
+	}
+
+	static handler_t release(waiter &waiter)
+	{
+		// The handler owns the frame holding the waiter, take it out first.
+		auto handler = std::move(*waiter.handler);
+		waiter.handler.reset();
+		return handler;
+	}
+
+public:
+	size_t m_capacity;
+	mutable spin_mutex m_mutex;
+	std::deque<value_t> m_buffer;
+	std::deque<waiter*> m_receivers;
+	std::deque<waiter*> m_senders;
+	bool m_closed = false;
+};
+
+template <typename T>
+co_channel<T>::co_channel(size_t capacity) :
+	m_impl(new impl(capacity))
+{
+
+}
+
+template <typename T>
+co_channel<T>::~co_channel()
+{
+	delete m_impl;
+}
+
+template <typename T>
+awaitable<bool> co_channel<T>::send(value_t value)
+{
+	{
+		std::lock_guard lock(m_impl->m_mutex);
+		if( m_impl->m_closed )
+			co_return false;
+		else if( m_impl->put(value) )
+			co_return true;
+	}
+	typename impl::waiter waiter;
+	waiter.value.emplace(std::move(value));
+
+	co_await asio::async_initiate<const use_awaitable_t&, void(error_code)>(
+	[this, &waiter](typename impl::handler_t handler)
+	{
+		std::lock_guard lock(m_impl->m_mutex);
+		waiter.handler.emplace(std::move(handler));
+
+		// Something may have changed before the coroutine was suspended.
+		if( m_impl->m_closed )
+			impl::wake(waiter);
+		else if( m_impl->put(*waiter.value) )
+		{
+			waiter.done = true;
+			impl::wake(waiter);
+		}
+		else
+			m_impl->enqueue(m_impl->m_senders, waiter);
+	},
+	use_awaitable);
+	co_return waiter.done;
+}
+
+template <typename T>
+bool co_channel<T>::try_send(value_t &&value)
+{
+	std::lock_guard lock(m_impl->m_mutex);
+	return not m_impl->m_closed and m_impl->put(value);
+}
+
+template <typename T>
+bool co_channel<T>::try_send(const value_t &value)
+{
+	return try_send(value_t(value));
+}
+
+template <typename T>
+awaitable<std::optional<T>> co_channel<T>::receive()
+{
+	if( auto value = try_receive() )
+		co_return value;
+
+	typename impl::waiter waiter;
+	co_await asio::async_initiate<const use_awaitable_t&, void(error_code)>(
+	[this, &waiter](typename impl::handler_t handler)
+	{
+		std::lock_guard lock(m_impl->m_mutex);
+		waiter.handler.emplace(std::move(handler));
+
+		if( auto value = m_impl->take() )
+		{
+			waiter.value = std::move(value);
+			impl::wake(waiter);
+		}
+		else if( m_impl->m_closed )
+			impl::wake(waiter);
+		else
+			m_impl->enqueue(m_impl->m_receivers, waiter);
+	},
+	use_awaitable);
+	co_return std::move(waiter.value);
+}
+
+template <typename T>
+std::optional<T> co_channel<T>::try_receive()
+{
+	std::lock_guard lock(m_impl->m_mutex);
+	return m_impl->take();
+}
+
+template <typename T>
+awaitable<std::vector<T>> co_channel<T>::receive_many(size_t max)
+{
+	std::vector<value_t> result;
+	if( max == 0 )
+		co_return result;
+
+	auto drain = [&]
+	{
+		std::lock_guard lock(m_impl->m_mutex);
+		while( result.size() < max )
+		{
+			auto value = m_impl->take();
+			if( not value )
+				break;
+			result.emplace_back(std::move(*value));
+		}
+	};
+	drain();
+	if( not result.empty() )
+		co_return result;
+
+	auto value = co_await receive();
+	if( value )
+	{
+		result.emplace_back(std::move(*value));
+		drain();
+	}
+	co_return result;
+}
+
+template <typename T>
+void co_channel<T>::close() noexcept
+{
+	std::lock_guard lock(m_impl->m_mutex);
+	if( m_impl->m_closed )
+		return ;
+	m_impl->m_closed = true;
+
+	// Pending senders give up their values, buffered ones stay receivable.
+	for(auto *waiter : m_impl->m_receivers)
+		impl::wake(*waiter);
+	for(auto *waiter : m_impl->m_senders)
+		impl::wake(*waiter);
+
+	m_impl->m_receivers.clear();
+	m_impl->m_senders.clear();
+}
+
+template <typename T>
+bool co_channel<T>::is_closed() const noexcept
+{
+	std::lock_guard lock(m_impl->m_mutex);
+	return m_impl->m_closed;
+}
+
+template <typename T>
+size_t co_channel<T>::size() const noexcept
+{
+	std::lock_guard lock(m_impl->m_mutex);
+	return m_impl->m_buffer.size();
+}
+
+template <typename T>
+size_t co_channel<T>::capacity() const noexcept
+{
+	return m_impl->m_capacity;
+}
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_CORO_DETAIL_CHANNEL_H
@@ -49,6 +49,15 @@ namespace asio = boost::asio;
 
 #endif //LIBGS_USING_BOOST_ASIO
 
+#if defined(ASIO_HAS_LOCAL_SOCKETS) || defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+# define LIBGS_ASIO_HAS_LOCAL_SOCKETS
+#endif
+
+// Native asynchronous files: IOCP on Windows, io_uring (LIBGS_ENABLE_IO_URING) on Linux.
+#if defined(ASIO_HAS_FILE) || defined(BOOST_ASIO_HAS_FILE)
+# define LIBGS_ASIO_HAS_FILE
+#endif
+
 namespace libgs
 {
 
@@ -102,6 +102,45 @@ typename basic_endpoint_wrapper<Protocol>::endpoint_t *basic_endpoint_wrapper<Pr
 	return &value;
 }
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
+inline basic_endpoint_wrapper<asio::local::stream_protocol>::basic_endpoint_wrapper(string_wrapper path)
+{
+	if( path->starts_with('@') )
+		path->front() = '\0';
+	value = endpoint_t(*path);
+}
+
+inline basic_endpoint_wrapper<asio::local::stream_protocol>::basic_endpoint_wrapper(endpoint_t ep) :
+	value(std::move(ep))
+{
+
+}
+
+inline basic_endpoint_wrapper<asio::local::stream_protocol>::operator endpoint_t&()
+{
+	return value;
+}
+
+inline basic_endpoint_wrapper<asio::local::stream_protocol>::operator const endpoint_t&() const
+{
+	return value;
+}
+
+inline typename basic_endpoint_wrapper<asio::local::stream_protocol>::endpoint_t&
+basic_endpoint_wrapper<asio::local::stream_protocol>::operator*()
+{
+	return value;
+}
+
+inline typename basic_endpoint_wrapper<asio::local::stream_protocol>::endpoint_t*
+basic_endpoint_wrapper<asio::local::stream_protocol>::operator->()
+{
+	return &value;
+}
+
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
 } //namespace libgs
 
 
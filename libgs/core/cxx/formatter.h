@@ -175,6 +175,27 @@ struct LIBGS_CORE_TAPI formatter<asio::ip::udp::endpoint, CharT> : libgs::no_par
 	}
 };
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
+template <libgs::concepts::char_type CharT>
+struct LIBGS_CORE_TAPI formatter<asio::local::stream_protocol::endpoint, CharT> : libgs::no_parse_formatter<CharT>
+{
+	auto format(const asio::local::stream_protocol::endpoint &endpoint, auto &context) const
+	{
+		// Abstract names start with a NUL, shown as '@'.
+		auto path = endpoint.path();
+		if( not path.empty() and path.front() == '\0' )
+			path.front() = '@';
+
+		if constexpr( std::is_same_v<CharT, char> )
+			return format_to(context.out(), "{}", path);
+		else
+			return format_to(context.out(), L"{}", libgs::mbstowcs(path));
+	}
+};
+
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
 template <libgs::concepts::char_type CharT>
 struct LIBGS_CORE_TAPI formatter<asio::ip::address, CharT>
 {
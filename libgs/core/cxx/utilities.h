@@ -68,6 +68,31 @@ struct LIBGS_CORE_TAPI basic_endpoint_wrapper
 using tcp_endpoint_wrapper = basic_endpoint_wrapper<asio::ip::tcp>;
 using udp_endpoint_wrapper = basic_endpoint_wrapper<asio::ip::udp>;
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
+// Unix domain socket path, a leading '@' names a socket in the abstract namespace (Linux).
+template <>
+struct LIBGS_CORE_VAPI basic_endpoint_wrapper<asio::local::stream_protocol>
+{
+	using protocol_t = asio::local::stream_protocol;
+	using endpoint_t = typename protocol_t::endpoint;
+	endpoint_t value;
+
+	basic_endpoint_wrapper() = default;
+	basic_endpoint_wrapper(string_wrapper path);
+	basic_endpoint_wrapper(endpoint_t ep);
+
+	operator endpoint_t&();
+	operator const endpoint_t&() const;
+
+	endpoint_t &operator*();
+	endpoint_t *operator->();
+};
+
+using local_endpoint_wrapper = basic_endpoint_wrapper<asio::local::stream_protocol>;
+
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
 } //namespace libgs
 #include <libgs/core/cxx/detail/utilities.h>
 
@@ -0,0 +1,173 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_DETAIL_ARENA_H
+#define LIBGS_CORE_DETAIL_ARENA_H
+
+namespace libgs
+{
+
+namespace detail
+{
+
+template <typename T>
+struct arena_header
+{
+	static constexpr size_t align = std::max(alignof(T), alignof(std::pmr::memory_resource*));
+	static constexpr size_t size = (sizeof(std::pmr::memory_resource*) + align - 1) / align * align;
+
+	[[nodiscard]] static std::pmr::memory_resource *&resource(T *ptr) noexcept {
+		return *reinterpret_cast<std::pmr::memory_resource**>(reinterpret_cast<char*>(ptr) - size);
+	}
+};
+
+} //namespace detail
+
+inline arena::arena(size_t largest_block) :
+	m_resource(std::pmr::pool_options{0, largest_block})
+{
+
+}
+
+inline arena::scope::scope(arena &a) noexcept :
+	m_prev(s_current)
+{
+	s_current = a.resource();
+}
+
+inline arena::scope::~scope()
+{
+	s_current = m_prev;
+}
+
+inline std::pmr::memory_resource *arena::resource() noexcept
+{
+	return &m_resource;
+}
+
+inline std::pmr::memory_resource *arena::current() noexcept
+{
+	return s_current ? s_current : std::pmr::new_delete_resource();
+}
+
+inline void arena::release()
+{
+	m_resource.release();
+}
+
+template <typename T, typename...Args>
+T *arena::make(Args&&...args)
+{
+	using header = detail::arena_header<T>;
+	auto *mr = current();
+
+	auto *block = static_cast<char*>(mr->allocate(header::size + sizeof(T), header::align));
+	try {
+		auto *ptr = new(block + header::size) T(std::forward<Args>(args)...);
+		header::resource(ptr) = mr;
+		return ptr;
+	}
+	catch(...)
+	{
+		mr->deallocate(block, header::size + sizeof(T), header::align);
+		throw;
+	}
+}
+
+template <typename T>
+void arena::destroy(T *ptr) noexcept
+{
+	using header = detail::arena_header<T>;
+	if( not ptr )
+		return ;
+
+	auto *mr = header::resource(ptr);
+	ptr->~T();
+	mr->deallocate(reinterpret_cast<char*>(ptr) - header::size, header::size + sizeof(T), header::align);
+}
+
+template <typename T>
+arena::ptr<T>::ptr(T *p) noexcept :
+	m_ptr(p)
+{
+
+}
+
+template <typename T>
+arena::ptr<T>::~ptr()
+{
+	arena::destroy(m_ptr);
+}
+
+template <typename T>
+arena::ptr<T>::ptr(ptr &&other) noexcept :
+	m_ptr(std::exchange(other.m_ptr, nullptr))
+{
+
+}
+
+template <typename T>
+arena::ptr<T> &arena::ptr<T>::operator=(ptr &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	arena::destroy(m_ptr);
+	m_ptr = std::exchange(other.m_ptr, nullptr);
+	return *this;
+}
+
+template <typename T>
+T *arena::ptr<T>::operator->() const
+{
+	return &operator*();
+}
+
+template <typename T>
+T &arena::ptr<T>::operator*() const
+{
+	if( not m_ptr )
+		throw runtime_error("libgs::arena::ptr: Access to a moved-from object.");
+	return *m_ptr;
+}
+
+template <typename T>
+T *arena::ptr<T>::get() const noexcept
+{
+	return m_ptr;
+}
+
+template <typename T>
+arena::ptr<T>::operator bool() const noexcept
+{
+	return m_ptr != nullptr;
+}
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_DETAIL_ARENA_H
@@ -113,9 +113,11 @@ decltype(auto) dispatch(concepts::schedulable auto &&exec, Work &&work, Token &&
 	using work_t = std::remove_cvref_t<Work>;
 	if constexpr( is_awaitable_v<work_t> )
 	{
-		return dispatch(exec, [a = std::forward<Work>(work)]() mutable -> work_t {
-			co_return co_await std::move(a);
-		}, std::forward<Token>(token));
+		// Spawned as it is, a wrapping lambda coroutine would cost one more frame.
+		if constexpr( is_sync_opt_token_v<Token> )
+			return asio::co_spawn(exec, std::forward<Work>(work), use_future).get();
+		else
+			return asio::co_spawn(exec, std::forward<Work>(work), std::forward<Token>(token));
 	}
 	else
 	{
@@ -186,9 +188,11 @@ decltype(auto) post(concepts::schedulable auto &&exec, Work &&work, Token &&toke
 	using work_t = std::remove_cvref_t<Work>;
 	if constexpr( is_awaitable_v<work_t> )
 	{
-		return post(exec, [a = std::forward<Work>(work)]() mutable -> work_t {
-			co_return co_await std::move(a);
-		}, std::forward<Token>(token));
+		// Spawned as it is, a wrapping lambda coroutine would cost one more frame.
+		if constexpr( is_sync_opt_token_v<Token> )
+			return asio::co_spawn(exec, std::forward<Work>(work), use_future).get();
+		else
+			return asio::co_spawn(exec, std::forward<Work>(work), std::forward<Token>(token));
 	}
 	else
 	{
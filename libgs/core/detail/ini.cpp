@@ -1,5 +1,15 @@
 #include <libgs/core/ini.h>
 
+#ifdef __unix__
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#else
+# include <libgs/core/algorithm/random.h>
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#endif //__unix__
+
 namespace libgs::detail
 {
 
@@ -74,4 +84,93 @@ void ini_commit_io_work(std::function<void()> work)
 	asio::post(*g_io_work.ioc, std::move(work));
 }
 
+void ini_atomic_write(const std::filesystem::path &file_name, std::string_view data, error_code &error) noexcept
+{
+	// Readers see either the old file or the new one, never a torn write.
+	// The temporary name is unique, another process may be saving the same file.
+	error = error_code();
+#ifdef __unix__
+	mode_t mode = 0644;
+	struct stat st {};
+	if( stat(file_name.c_str(), &st) == 0 )
+		mode = st.st_mode & 07777;
+
+	std::string temp_name = file_name.native() + ".XXXXXX";
+	int fd = ::mkostemp(temp_name.data(), O_CLOEXEC);
+	if( fd < 0 )
+	{
+		error = error_code(errno, std::system_category());
+		return ;
+	}
+	fchmod(fd, mode);
+	while( not data.empty() )
+	{
+		auto res = ::write(fd, data.data(), data.size());
+		if( res < 0 )
+		{
+			if( errno == EINTR )
+				continue;
+			error = error_code(errno, std::system_category());
+			break;
+		}
+		data.remove_prefix(static_cast<size_t>(res));
+	}
+	if( not error and fsync(fd) < 0 )
+		error = error_code(errno, std::system_category());
+	::close(fd);
+
+	if( not error and ::rename(temp_name.c_str(), file_name.c_str()) < 0 )
+		error = error_code(errno, std::system_category());
+	if( error )
+	{
+		::unlink(temp_name.c_str());
+		return ;
+	}
+	// Persist the rename itself.
+	auto dir = file_name.parent_path();
+	fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if( fd >= 0 )
+	{
+		fsync(fd);
+		::close(fd);
+	}
+#else
+	uint64_t suffix = 0;
+	secure_random::fill(&suffix, sizeof(suffix));
+
+	auto temp_name = file_name;
+	temp_name += std::format(".{:016x}.tmp", suffix);
+
+	auto file = CreateFileW (
+		temp_name.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr
+	);
+	if( file == INVALID_HANDLE_VALUE )
+	{
+		error = error_code(static_cast<int>(GetLastError()), std::system_category());
+		return ;
+	}
+	while( not data.empty() )
+	{
+		DWORD size = 0;
+		auto block = static_cast<DWORD>(std::min<size_t>(data.size(), 0x40000000));
+		if( not WriteFile(file, data.data(), block, &size, nullptr) )
+		{
+			error = error_code(static_cast<int>(GetLastError()), std::system_category());
+			break;
+		}
+		data.remove_prefix(size);
+	}
+	// Same as fsync, the rename must not reach the disk before the data.
+	if( not error and not FlushFileBuffers(file) )
+		error = error_code(static_cast<int>(GetLastError()), std::system_category());
+	CloseHandle(file);
+
+	if( not error and not MoveFileExW(temp_name.c_str(), file_name.c_str(),
+									  MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) )
+		error = error_code(static_cast<int>(GetLastError()), std::system_category());
+	if( error )
+		DeleteFileW(temp_name.c_str());
+#endif //__unix__
+}
+
 } //namespace libgs::detail
\ No newline at end of file
@@ -30,9 +30,16 @@
 #define LIBGS_CORE_DETAIL_INI_H
 
 #include <libgs/core/algorithm/misc.h>
-#include <libgs/core/execution.h>
+#include <libgs/core/coro/utilities.h>
+#include <libgs/core/algorithm/xxhash.h>
+#include <libgs/core/mapped_file.h>
+#include <libgs/core/spin_mutex.h>
 #include <libgs/core/app_utls.h>
-#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+# include <sys/inotify.h>
+#endif //__linux__
 
 namespace libgs
 {
@@ -294,6 +301,10 @@ private:
 
 LIBGS_CORE_API void ini_commit_io_work(std::function<void()> work);
 
+LIBGS_CORE_API void ini_atomic_write (
+	const std::filesystem::path &file_name, std::string_view data, error_code &error
+) noexcept;
+
 } //namespace detail
 
 template <concepts::char_type CharT,
@@ -308,13 +319,48 @@ class LIBGS_CORE_TAPI basic_ini<CharT,IniKeys,Exec,GroupMap>::impl :
 
 public:
 	impl(const auto &exec, const path_t &file_name) :
-		m_exec(exec), m_timer(exec)
+		m_exec(exec), m_timer(exec), m_delay_timer(exec)
 	{
 		set_file_name(std::move(file_name));
 	}
 
-	impl(impl&&) = default;
-	impl& operator=(impl&&) = default;
+	impl(impl &&other) noexcept :
+		m_exec(std::move(other.m_exec)),
+		m_file_name(std::move(other.m_file_name)),
+		m_groups(std::move(other.m_groups)),
+		m_timer(std::move(other.m_timer)),
+		m_sync_period(other.m_sync_period),
+		m_delay_timer(std::move(other.m_delay_timer)),
+		m_sync_delay(other.m_sync_delay),
+		m_sync_on_delete(other.m_sync_on_delete),
+		m_file_hash(other.m_file_hash.load()),
+		m_synced_hash(other.m_synced_hash),
+		m_auto_reload(other.m_auto_reload),
+		m_watch(std::move(other.m_watch)),
+		m_reload_handlers(std::move(other.m_reload_handlers)),
+		m_cancel_list(std::move(other.m_cancel_list))
+	{
+
+	}
+
+	impl &operator=(impl &&other) noexcept
+	{
+		m_exec = std::move(other.m_exec);
+		m_file_name = std::move(other.m_file_name);
+		m_groups = std::move(other.m_groups);
+		m_timer = std::move(other.m_timer);
+		m_sync_period = other.m_sync_period;
+		m_delay_timer = std::move(other.m_delay_timer);
+		m_sync_delay = other.m_sync_delay;
+		m_sync_on_delete = other.m_sync_on_delete;
+		m_file_hash = other.m_file_hash.load();
+		m_synced_hash = other.m_synced_hash;
+		m_auto_reload = other.m_auto_reload;
+		m_watch = std::move(other.m_watch);
+		m_reload_handlers = std::move(other.m_reload_handlers);
+		m_cancel_list = std::move(other.m_cancel_list);
+		return *this;
+	}
 
 	template <typename Exec0>
 	impl(typename basic_ini<CharT,IniKeys,Exec0>::impl &&other) :
@@ -323,9 +369,15 @@ public:
 		m_groups(std::move(other.m_groups)),
 		m_timer(std::move(other.m_timer)),
 		m_sync_period(other.m_sync_period),
-		m_sync_on_delete(other.m_sync_on_delete)
+		m_delay_timer(std::move(other.m_delay_timer)),
+		m_sync_delay(other.m_sync_delay),
+		m_sync_on_delete(other.m_sync_on_delete),
+		m_file_hash(other.m_file_hash.load()),
+		m_synced_hash(other.m_synced_hash),
+		m_reload_handlers(std::move(other.m_reload_handlers))
 	{
 		other.m_sync_period = milliseconds(0);
+		other.m_sync_delay = milliseconds(0);
 		other.m_sync_on_delete = false;
 	}
 
@@ -336,6 +388,9 @@ public:
 		m_file_name = std::move(other.m_file_name);
 		m_groups = std::move(other.m_groups);
 		m_sync_on_delete = other.m_sync_on_delete;
+		m_file_hash = other.m_file_hash.load();
+		m_synced_hash = other.m_synced_hash;
+		m_reload_handlers = std::move(other.m_reload_handlers);
 		other.m_sync_on_delete = false;
 		return *this;
 	}
@@ -343,117 +398,121 @@ public:
 public:
 	void set_file_name(const path_t &file_name)
 	{
-		m_file_name = app::absolute_path(file_name);
+		auto absolute_path = app::absolute_path(file_name);
+		spin_unique_lock lock(m_file_name_mutex);
+		m_file_name = std::move(absolute_path);
+	}
+
+	// The io thread and the watcher read the name while the owner may replace it.
+	[[nodiscard]] path_t file_name() const
+	{
+		spin_unique_lock lock(m_file_name_mutex);
+		return m_file_name;
 	}
 
 	void load(error_code &error, const std::function<bool()> &cancelled)
 	{
 		error = error_code();
-		if( not exists(m_file_name) )
+		auto file_name = this->file_name();
+		if( not exists(file_name) )
 		{
 			error = std::make_error_code(std::errc::no_such_file_or_directory);
 			return ;
 		}
-		std::basic_ifstream<CharT> file;
-		auto prev = file.exceptions();
-		file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-		try {
-			file.open(m_file_name);
-			string_t buf;
-			string_t curr_group;
-
-			for(size_t line=1;; line++)
-			{
-				if( cancelled() )
-				{
-					error = make_error_code(asio::error::operation_aborted);
-					return ;
-				}
-				else if( file.peek() == EOF )
-					break;
+		// Parse straight out of the page cache instead of going through a stream per line.
+		// Our syncs replace the file by rename, which leaves the mapping intact. Truncating
+		// it in place while it is being parsed is not supported (SIGBUS).
+		mapped_file file;
+		file.open(file_name, error);
+		if( error )
+			return ;
 
-				std::getline(file, buf);
-				buf = str_trimmed(buf);
+		parse(file.view(), m_groups, error, cancelled);
+		if( error )
+			return ;
 
-				if( buf.empty() or
-				    buf[0] == detail::ini_keyword_char<CharT>::sharp or
-				    buf[0] == detail::ini_keyword_char<CharT>::semicolon )
-					continue;
+		m_file_hash = xxhash3::hash(file.view());
+		m_synced_hash = xxhash3::hash(serialize(m_groups, error, cancelled));
+	}
 
-				auto list = string_list_t::from_string(buf, detail::ini_keyword_char<CharT>::sharp);
-				buf = str_trimmed(list[0]);
+	void sync(error_code &error, const std::function<bool()> &cancelled)
+	{
+		auto data = serialize(m_groups, error, cancelled);
+		if( error )
+			return ;
 
-				list = string_list_t::from_string(buf, detail::ini_keyword_char<CharT>::semicolon);
-				buf = str_trimmed(list[0]);
+		// Unchanged since the last load or sync, keep the file as it is.
+		auto hash = xxhash3::hash(data);
+		auto file_name = this->file_name();
+		if( hash == m_synced_hash and exists(file_name) )
+			return ;
 
-				if( buf.starts_with(detail::ini_keyword_char<CharT>::left_bracket) )
-					curr_group = parsing_group(buf, line);
-				else
-					parsing_key_value(curr_group, buf, line);
-			}
-		}
-		catch(const std::system_error &ex)
-		{
-			error = ex.code();
+		detail::ini_atomic_write(file_name, data, error);
+		if( error )
 			return ;
-		}
-		file.exceptions(prev);
-		file.close();
+		m_synced_hash = hash;
+		m_file_hash = hash;
 	}
 
-	void sync(error_code &error, const std::function<bool()> &cancelled)
+	void reload()
 	{
-		std::basic_ofstream<CharT> file;
-		auto prev = file.exceptions();
-		file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-		try {
-			file.open(m_file_name, std::ios_base::out | std::ios_base::trunc);
-			using keyword_char_t = detail::ini_keyword_char<CharT>;
+		detail::ini_commit_io_work([self = this->shared_from_this()]
+		{
+			auto groups = std::make_shared<group_map_t>();
+			uint64_t file_hash = 0, synced_hash = 0;
+			error_code error;
 
-			for(auto &[group, keys] : m_groups)
+			mapped_file file;
+			file.open(self->file_name(), error);
+			if( not error )
 			{
-				if( cancelled() )
-				{
-					error = make_error_code(asio::error::operation_aborted);
+				// Our own sync, or a write that left the content as it was.
+				file_hash = xxhash3::hash(file.view());
+				if( file_hash == self->m_file_hash )
 					return ;
-				}
-				file << keyword_char_t::left_bracket
-					 << (is_ascii(group) ? group : to_percent_encoding(group))
-					 << keyword_char_t::right_bracket
-					 << keyword_char_t::line_break;
 
-				for(auto &[key, value] : keys)
+				self->parse(file.view(), *groups, error, []{return false;});
+				if( not error )
+					synced_hash = xxhash3::hash(self->serialize(*groups, error, []{return false;}));
+			}
+			dispatch(self->m_exec, [self, groups, file_hash, synced_hash, error]
+			{
+				if( not error )
 				{
-					if( key.empty() or value->empty() )
-						continue;
-
-					file << (is_ascii(key) ? key : to_percent_encoding(key))
-						 << keyword_char_t::assigning;
-
-					if( value.is_rlnum() )
-					{
-						if( value->front() == 0x2B/*+*/ )
-							value = value->substr(1);
-						file << value.to_string();
-					}
-					else
-					{
-						file << keyword_char_t::double_quotes
-						     << (value.is_ascii() ? value.to_string() : to_percent_encoding(value.to_string()))
-						     << keyword_char_t::double_quotes;
-					}
-					file << keyword_char_t::line_break;
+					self->m_groups = std::move(*groups);
+					self->m_file_hash = file_hash;
+					self->m_synced_hash = synced_hash;
 				}
-				file << keyword_char_t::line_break;
-			}
-		}
-		catch(const std::system_error &ex)
+				for(auto &handler : self->m_reload_handlers)
+					handler(error);
+			});
+		});
+	}
+
+	void set_auto_reload(bool enable)
+	{
+		m_auto_reload = enable;
+		dispatch(m_exec, [self = this->shared_from_this()]
 		{
-			error = ex.code();
-			return ;
-		}
-		file.exceptions(prev);
-		file.close();
+			if( self->m_watch )
+			{
+				auto &watch = *self->m_watch;
+				watch.cancelled = true;
+				watch.timer.cancel();
+#ifdef __linux__
+				if( watch.inotify )
+					watch.inotify->close();
+#endif //__linux__
+				self->m_watch.reset();
+			}
+			if( not self->m_auto_reload )
+				return ;
+
+			self->m_watch = std::make_shared<watch_state>(self->m_exec);
+			dispatch(self->m_exec, [self, watch = self->m_watch]() -> awaitable<void> {
+				co_await self->co_watch(watch);
+			});
+		});
 	}
 
 public:
@@ -507,8 +566,240 @@ public:
 		m_sync_period = std::move(msec);
 	}
 
+	template <typename Rep, typename Period>
+	void set_sync_delay(const duration<Rep,Period> &delay)
+	{
+		m_sync_delay = std::chrono::duration_cast<milliseconds>(delay);
+	}
+
+	// Called by write(), the sync runs once the writes paused for 'm_sync_delay'.
+	void touch()
+	{
+		if( m_sync_delay == milliseconds(0) )
+			return ;
+		dispatch(m_exec, [self = this->shared_from_this()]
+		{
+			self->m_sync_deadline = std::chrono::steady_clock::now() + self->m_sync_delay;
+			if( self->m_sync_pending )
+				return ;
+			self->m_sync_pending = true;
+
+			dispatch(self->m_exec, [self]() -> awaitable<void>
+			{
+				using namespace operators;
+				error_code error;
+				while( not error and std::chrono::steady_clock::now() < self->m_sync_deadline )
+				{
+					self->m_delay_timer.expires_at(self->m_sync_deadline);
+					co_await self->m_delay_timer.async_wait(use_awaitable | error);
+				}
+				self->m_sync_pending = false;
+				if( error )
+					co_return ;
+
+				detail::ini_commit_io_work([self]
+				{
+					error_code error; LIBGS_UNUSED(error);
+					self->sync(error, []{return false;});
+				});
+				co_return ;
+			});
+		});
+	}
+
 private:
-	[[nodiscard]] string_t parsing_group(const string_t &str, size_t line)
+	struct watch_state
+	{
+		explicit watch_state(const executor_t &exec) : timer(exec) {}
+		bool cancelled = false;
+		asio::steady_timer timer;
+#ifdef __linux__
+		std::optional<asio::posix::stream_descriptor> inotify {};
+#endif //__linux__
+	};
+
+	awaitable<void> co_watch(std::shared_ptr<watch_state> watch)
+	{
+		using namespace std::chrono_literals;
+		using namespace operators;
+		error_code error;
+#ifdef __linux__
+		int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if( fd < 0 )
+		{
+			error = error_code(errno, std::system_category());
+			for(auto &handler : m_reload_handlers)
+				handler(error);
+			co_return ;
+		}
+		watch->inotify.emplace(m_exec, fd);
+
+		// Watch the directory rather than the file: a replace by rename (ours included)
+		// leaves a watch on the old inode behind.
+		auto file_name = this->file_name();
+		if( inotify_add_watch(fd, file_name.parent_path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0 )
+		{
+			error = error_code(errno, std::system_category());
+			for(auto &handler : m_reload_handlers)
+				handler(error);
+			co_return ;
+		}
+		auto name = file_name.filename().native();
+		char buf[4096];
+		bool changed = false;
+
+		while( not watch->cancelled )
+		{
+			// Debounced: a burst of writes is read once, after it has been quiet for a while.
+			size_t size = 0;
+			if( changed )
+			{
+				error_code timer_error;
+				watch->timer.expires_after(100ms);
+				auto var = co_await (
+					watch->inotify->async_read_some(asio::buffer(buf), use_awaitable | error) or
+					watch->timer.async_wait(use_awaitable | timer_error)
+				);
+				if( watch->cancelled )
+					break;
+				else if( var.index() == 1 )
+				{
+					error = error_code();
+					changed = false;
+					reload();
+					continue;
+				}
+				size = std::get<0>(var);
+			}
+			else
+				size = co_await watch->inotify->async_read_some(asio::buffer(buf), use_awaitable | error);
+			if( error or watch->cancelled )
+				break;
+
+			for(size_t pos=0; pos + sizeof(inotify_event) <= size;)
+			{
+				uint32_t len = 0;
+				memcpy(&len, buf + pos + offsetof(inotify_event, len), sizeof(len));
+				if( len > 0 and name == buf + pos + sizeof(inotify_event) )
+					changed = true;
+				pos += sizeof(inotify_event) + len;
+			}
+		}
+#else
+		auto file_name = this->file_name();
+		auto last = std::filesystem::last_write_time(file_name, error);
+		while( not watch->cancelled )
+		{
+			watch->timer.expires_after(1s);
+			co_await watch->timer.async_wait(use_awaitable | error);
+			if( error or watch->cancelled )
+				break;
+
+			auto curr = std::filesystem::last_write_time(file_name, error);
+			if( error or curr == last )
+				continue;
+			last = curr;
+			reload();
+		}
+#endif //__linux__
+		co_return ;
+	}
+
+	void parse(std::string_view data, group_map_t &groups, error_code &error, const std::function<bool()> &cancelled)
+	{
+		error = error_code();
+		try {
+			string_t buf;
+			string_t curr_group;
+
+			for(size_t line=1; not data.empty(); line++)
+			{
+				if( cancelled() )
+				{
+					error = make_error_code(asio::error::operation_aborted);
+					return ;
+				}
+				auto pos = data.find('\n');
+				auto text = data.substr(0, pos);
+				data = pos == std::string_view::npos ? std::string_view() : data.substr(pos + 1);
+
+				if constexpr( is_char_v<CharT> )
+					buf = str_trimmed(text);
+				else
+					buf = str_trimmed(mbstowcs(text));
+
+				if( buf.empty() or
+				    buf[0] == detail::ini_keyword_char<CharT>::sharp or
+				    buf[0] == detail::ini_keyword_char<CharT>::semicolon )
+					continue;
+
+				auto list = string_list_t::from_string(buf, detail::ini_keyword_char<CharT>::sharp);
+				buf = str_trimmed(list[0]);
+
+				list = string_list_t::from_string(buf, detail::ini_keyword_char<CharT>::semicolon);
+				buf = str_trimmed(list[0]);
+
+				if( buf.starts_with(detail::ini_keyword_char<CharT>::left_bracket) )
+					curr_group = parsing_group(groups, buf, line);
+				else
+					parsing_key_value(groups, curr_group, buf, line);
+			}
+		}
+		catch(const std::system_error &ex)
+		{
+			error = ex.code();
+		}
+	}
+
+	[[nodiscard]] std::string serialize(group_map_t &groups, error_code &error, const std::function<bool()> &cancelled)
+	{
+		error = error_code();
+		std::basic_ostringstream<CharT> stream;
+		using keyword_char_t = detail::ini_keyword_char<CharT>;
+
+		for(auto &[group, keys] : groups)
+		{
+			if( cancelled() )
+			{
+				error = make_error_code(asio::error::operation_aborted);
+				return {};
+			}
+			stream << keyword_char_t::left_bracket
+				   << (is_ascii(group) ? group : to_percent_encoding(group))
+				   << keyword_char_t::right_bracket
+				   << keyword_char_t::line_break;
+
+			for(auto &[key, value] : keys)
+			{
+				if( key.empty() or value->empty() )
+					continue;
+
+				stream << (is_ascii(key) ? key : to_percent_encoding(key))
+					   << keyword_char_t::assigning;
+
+				if( value.is_rlnum() )
+				{
+					if( value->front() == 0x2B/*+*/ )
+						value = value->substr(1);
+					stream << value.to_string();
+				}
+				else
+				{
+					stream << keyword_char_t::double_quotes
+					       << (value.is_ascii() ? value.to_string() : to_percent_encoding(value.to_string()))
+					       << keyword_char_t::double_quotes;
+				}
+				stream << keyword_char_t::line_break;
+			}
+			stream << keyword_char_t::line_break;
+		}
+		if constexpr( is_char_v<CharT> )
+			return std::move(stream).str();
+		else
+			return wcstombs(stream.str());
+	}
+
+	[[nodiscard]] string_t parsing_group(group_map_t &groups, const string_t &str, size_t line)
 	{
 		if( str.size() < 3 or not str.ends_with(detail::ini_keyword_char<CharT>::right_bracket) )
 		{
@@ -525,11 +816,11 @@ private:
 				"libgs::basic_ini"
 			);
 		}
-		m_groups[group];
+		groups[group];
 		return group;
 	}
 
-	void parsing_key_value(const string_t &curr_group, const string_t &str, size_t line)
+	void parsing_key_value(group_map_t &groups, const string_t &curr_group, const string_t &str, size_t line)
 	{
 		using keyword_char = detail::ini_keyword_char<CharT>;
 		if( curr_group.empty() )
@@ -603,18 +894,32 @@ private:
 			}
 			value = value.substr(1, value.size() - 2);
 		}
-		m_groups[curr_group][key] = from_percent_encoding(value);
+		groups[curr_group][key] = from_percent_encoding(value);
 	}
 
 public:
 	executor_t m_exec {};
 	path_t m_file_name {};
+	mutable spin_mutex m_file_name_mutex {};
 	group_map_t m_groups {};
 
 	asio::steady_timer m_timer;
 	milliseconds m_sync_period {0};
+
+	asio::steady_timer m_delay_timer;
+	milliseconds m_sync_delay {0};
+	std::chrono::steady_clock::time_point m_sync_deadline {};
+	std::atomic_bool m_sync_pending {false};
 	bool m_sync_on_delete = false;
 
+	// Compared by reload on the io thread, while load and sync update it.
+	std::atomic<uint64_t> m_file_hash = 0;
+	uint64_t m_synced_hash = 0;
+
+	bool m_auto_reload = false;
+	std::shared_ptr<watch_state> m_watch {};
+	std::list<reload_handler_t> m_reload_handlers {};
+
 	std::list<std::shared_ptr<bool>> m_cancel_list {};
 };
 
@@ -711,7 +1016,15 @@ template <concepts::char_type CharT,
 		  typename GroupMap>
 basic_ini<CharT,IniKeys,Exec,GroupMap>::~basic_ini()
 {
-	if( not sync_on_delete() )
+	// The watcher holds the impl alive, stop it.
+	if( auto_reload() )
+		set_auto_reload(false);
+
+	// A delayed sync would run after the object is gone, do it now.
+	bool delayed = m_impl->m_sync_pending;
+	m_impl->m_delay_timer.cancel();
+
+	if( not sync_on_delete() and not delayed )
 		return ;
 
 	error_code error; LIBGS_UNUSED(error);
@@ -774,6 +1087,8 @@ template <concepts::char_type CharT,
 void basic_ini<CharT,IniKeys,Exec,GroupMap>::set_file_name(const path_t &file_name)
 {
 	m_impl->set_file_name(file_name);
+	if( auto_reload() )
+		m_impl->set_auto_reload(true);
 }
 
 template <concepts::char_type CharT,
@@ -783,7 +1098,7 @@ template <concepts::char_type CharT,
 typename basic_ini<CharT,IniKeys,Exec,GroupMap>::path_t
 basic_ini<CharT,IniKeys,Exec,GroupMap>::file_name() const noexcept
 {
-	return m_impl->m_file_name;
+	return m_impl->file_name();
 }
 
 template <concepts::char_type CharT,
@@ -871,6 +1186,7 @@ void basic_ini<CharT,IniKeys,Exec,GroupMap>::write
 	m_impl->m_groups[std::move(gk.group)].write (
 		std::move(gk.key), std::forward<decltype(value)>(value)
 	);
+	m_impl->touch();
 }
 
 template <concepts::char_type CharT,
@@ -1274,6 +1590,25 @@ milliseconds basic_ini<CharT,IniKeys,Exec,GroupMap>::sync_period() const noexcep
 	return m_impl->m_sync_period;
 }
 
+template <concepts::char_type CharT,
+		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
+		  concepts::execution Exec,
+		  typename GroupMap>
+template <typename Rep, typename Period>
+void basic_ini<CharT,IniKeys,Exec,GroupMap>::set_sync_delay(const duration<Rep,Period> &delay)
+{
+	m_impl->set_sync_delay(delay);
+}
+
+template <concepts::char_type CharT,
+		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
+		  concepts::execution Exec,
+		  typename GroupMap>
+milliseconds basic_ini<CharT,IniKeys,Exec,GroupMap>::sync_delay() const noexcept
+{
+	return m_impl->m_sync_delay;
+}
+
 template <concepts::char_type CharT,
 		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
 		  concepts::execution Exec,
@@ -1294,6 +1629,35 @@ void basic_ini<CharT,IniKeys,Exec,GroupMap>::cancel()
 		*flag = true;
 }
 
+template <concepts::char_type CharT,
+		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
+		  concepts::execution Exec,
+		  typename GroupMap>
+void basic_ini<CharT,IniKeys,Exec,GroupMap>::set_auto_reload(bool enable)
+{
+	m_impl->set_auto_reload(enable);
+}
+
+template <concepts::char_type CharT,
+		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
+		  concepts::execution Exec,
+		  typename GroupMap>
+bool basic_ini<CharT,IniKeys,Exec,GroupMap>::auto_reload() const noexcept
+{
+	return m_impl->m_auto_reload;
+}
+
+template <concepts::char_type CharT,
+		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
+		  concepts::execution Exec,
+		  typename GroupMap>
+void basic_ini<CharT,IniKeys,Exec,GroupMap>::on_reload(reload_handler_t handler)
+{
+	dispatch(m_impl->m_exec, [impl = m_impl, handler = std::move(handler)]() mutable {
+		impl->m_reload_handlers.emplace_back(std::move(handler));
+	});
+}
+
 template <concepts::char_type CharT,
 		  concepts::base_of_basic_ini_keys<CharT> IniKeys,
 		  concepts::execution Exec,
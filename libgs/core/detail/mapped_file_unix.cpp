@@ -0,0 +1,83 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifdef __unix__
+
+#include "mapped_file_impl.hii"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace libgs
+{
+
+void mapped_file::impl::map_native(const path_t &file_name, error_code &error) noexcept
+{
+	error = error_code();
+	int fd = ::open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+	if( fd < 0 )
+	{
+		error = error_code(errno, std::system_category());
+		return ;
+	}
+	struct stat st {};
+	if( fstat(fd, &st) < 0 )
+		error = error_code(errno, std::system_category());
+	else if( not S_ISREG(st.st_mode) )
+		error = std::make_error_code(std::errc::invalid_argument);
+
+	else if( st.st_size > 0 )
+	{
+		auto addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+		if( addr == MAP_FAILED )
+			error = error_code(errno, std::system_category());
+		else
+		{
+			// Hashing and sending read the mapping front to back.
+			madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+			m_data = static_cast<const uint8_t*>(addr);
+			m_size = static_cast<size_t>(st.st_size);
+		}
+	}
+	::close(fd);
+	m_is_open = not error;
+}
+
+void mapped_file::impl::unmap_native() noexcept
+{
+	if( m_data )
+		munmap(const_cast<uint8_t*>(m_data), m_size);
+	m_data = nullptr;
+	m_size = 0;
+	m_is_open = false;
+}
+
+} //namespace libgs
+
+#endif //__unix__
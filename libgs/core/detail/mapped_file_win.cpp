@@ -0,0 +1,93 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#if defined(__WINNT__) || defined(_WINDOWS)
+
+#include "mapped_file_impl.hii"
+
+namespace libgs
+{
+
+void mapped_file::impl::map_native(const path_t &file_name, error_code &error) noexcept
+{
+	error = error_code();
+	m_file = CreateFileW (
+		file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+	);
+	if( m_file == INVALID_HANDLE_VALUE )
+	{
+		error = error_code(static_cast<int>(GetLastError()), std::system_category());
+		return ;
+	}
+	LARGE_INTEGER size {};
+	if( not GetFileSizeEx(m_file, &size) )
+		error = error_code(static_cast<int>(GetLastError()), std::system_category());
+
+	else if( size.QuadPart > 0 )
+	{
+		m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if( m_mapping == nullptr )
+			error = error_code(static_cast<int>(GetLastError()), std::system_category());
+		else
+		{
+			auto addr = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+			if( addr == nullptr )
+				error = error_code(static_cast<int>(GetLastError()), std::system_category());
+			else
+			{
+				m_data = static_cast<const uint8_t*>(addr);
+				m_size = static_cast<size_t>(size.QuadPart);
+			}
+		}
+	}
+	if( error )
+		unmap_native();
+	else
+		m_is_open = true;
+}
+
+void mapped_file::impl::unmap_native() noexcept
+{
+	if( m_data )
+		UnmapViewOfFile(m_data);
+	if( m_mapping )
+		CloseHandle(m_mapping);
+	if( m_file != INVALID_HANDLE_VALUE )
+		CloseHandle(m_file);
+
+	m_data = nullptr;
+	m_size = 0;
+	m_mapping = nullptr;
+	m_file = INVALID_HANDLE_VALUE;
+	m_is_open = false;
+}
+
+} //namespace libgs
+
+#endif //Windows
@@ -47,6 +47,21 @@ void modules::reg_init(concepts::modules_init_func auto &&func, level_t level)
 		reg_init_p(await_init_func_t(std::forward<Func>(func)), level);
 }
 
+void modules::reg_module(std::string name, concepts::modules_init_func auto &&func, std::vector<std::string> depends)
+{
+	using Func = std::decay_t<decltype(func)>;
+	using return_t = typename function_traits<Func>::return_type;
+
+	if constexpr( std::is_same_v<return_t,void> )
+		reg_module_p(std::move(name), init_func_t(std::forward<Func>(func)), std::move(depends));
+
+	else if constexpr( std::is_same_v<return_t,std::future<void>> )
+		reg_module_p(std::move(name), future_init_func_t(std::forward<Func>(func)), std::move(depends));
+
+	else if constexpr( std::is_same_v<return_t,awaitable<void>> )
+		reg_module_p(std::move(name), await_init_func_t(std::forward<Func>(func)), std::move(depends));
+}
+
 } //namespace libgs
 
 
@@ -0,0 +1,172 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_DETAIL_RCU_PTR_H
+#define LIBGS_CORE_DETAIL_RCU_PTR_H
+
+namespace libgs
+{
+
+template <typename T>
+rcu_ptr<T>::snapshot::snapshot(const value_t *ptr) noexcept :
+	m_ptr(ptr)
+{
+
+}
+
+template <typename T>
+rcu_ptr<T>::snapshot::snapshot(snapshot &&other) noexcept :
+	m_ptr(other.m_ptr),
+	m_locked(other.m_locked)
+{
+	other.m_ptr = nullptr;
+	other.m_locked = false;
+}
+
+template <typename T>
+typename rcu_ptr<T>::snapshot &rcu_ptr<T>::snapshot::operator=(snapshot &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	release();
+	m_ptr = other.m_ptr;
+	m_locked = other.m_locked;
+	other.m_ptr = nullptr;
+	other.m_locked = false;
+	return *this;
+}
+
+template <typename T>
+rcu_ptr<T>::snapshot::~snapshot()
+{
+	release();
+}
+
+template <typename T>
+const typename rcu_ptr<T>::value_t *rcu_ptr<T>::snapshot::get() const noexcept
+{
+	return m_ptr;
+}
+
+template <typename T>
+const typename rcu_ptr<T>::value_t *rcu_ptr<T>::snapshot::operator->() const noexcept
+{
+	return m_ptr;
+}
+
+template <typename T>
+const typename rcu_ptr<T>::value_t &rcu_ptr<T>::snapshot::operator*() const noexcept
+{
+	return *m_ptr;
+}
+
+template <typename T>
+rcu_ptr<T>::snapshot::operator bool() const noexcept
+{
+	return m_ptr != nullptr;
+}
+
+template <typename T>
+void rcu_ptr<T>::snapshot::release() noexcept
+{
+	m_ptr = nullptr;
+	if( not m_locked )
+		return ;
+	m_locked = false;
+	rcu_domain::read_unlock();
+}
+
+template <typename T>
+rcu_ptr<T>::rcu_ptr(std::unique_ptr<value_t> ptr) noexcept :
+	m_ptr(ptr.release())
+{
+
+}
+
+template <typename T>
+rcu_ptr<T>::~rcu_ptr()
+{
+	publish(nullptr);
+}
+
+template <typename T>
+rcu_ptr<T>::rcu_ptr(rcu_ptr &&other) noexcept :
+	m_ptr(other.m_ptr.exchange(nullptr))
+{
+
+}
+
+template <typename T>
+rcu_ptr<T> &rcu_ptr<T>::operator=(rcu_ptr &&other) noexcept
+{
+	if( this != &other )
+		publish(other.m_ptr.exchange(nullptr));
+	return *this;
+}
+
+template <typename T>
+typename rcu_ptr<T>::snapshot rcu_ptr<T>::read() const noexcept
+{
+	rcu_domain::read_lock();
+	return snapshot(m_ptr.load(std::memory_order_seq_cst));
+}
+
+template <typename T>
+void rcu_ptr<T>::store(std::unique_ptr<value_t> ptr)
+{
+	std::unique_lock lock(m_write_mutex);
+	publish(ptr.release());
+}
+
+template <typename T>
+template <typename Func>
+void rcu_ptr<T>::update(Func &&func) requires std::is_copy_constructible_v<value_t>
+{
+	std::unique_lock lock(m_write_mutex);
+	auto old = m_ptr.load(std::memory_order_relaxed);
+
+	auto ptr = old ? std::make_unique<value_t>(*old) : std::make_unique<value_t>();
+	std::forward<Func>(func)(*ptr);
+	publish(ptr.release());
+}
+
+template <typename T>
+void rcu_ptr<T>::publish(value_t *ptr)
+{
+	auto old = m_ptr.exchange(ptr, std::memory_order_seq_cst);
+	if( old == nullptr )
+		return ;
+	rcu_domain::retire(old, [](void *ptr) {
+		delete static_cast<value_t*>(ptr);
+	});
+}
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_DETAIL_RCU_PTR_H
@@ -32,12 +32,16 @@
 #include <libgs/core/spin_mutex.h>
 #include <shared_mutex>
 
+#ifdef __linux__
+# include <sched.h>
+#endif //__linux__
+
 namespace libgs
 {
 
 inline spin_shared_mutex::~spin_shared_mutex() noexcept(false)
 {
-	if( m_read_count == 0 )
+	if( not has_readers() )
 		return ;
 	throw runtime_error (
 		"libgs::spin_shared_mutex: Destruct a spin mutex that has not yet been unlock_shared."
@@ -47,53 +51,159 @@ inline spin_shared_mutex::~spin_shared_mutex() noexcept(false)
 inline void spin_shared_mutex::lock()
 {
 	m_native_handle.lock();
+	m_writer.store(1, std::memory_order_seq_cst);
+	if( not has_readers() )
+		return ;
+
+	auto profile = m_native_handle.profile();
+	std::chrono::steady_clock::time_point start {};
+	if( profile )
+		start = std::chrono::steady_clock::now();
+
+	// Readers leaving while a writer is pending bump 'm_reader_exits', it is what we park on.
+	size_t spins = 0, parks = 0;
+	for(uint32_t backoff=1;;)
+	{
+		auto exits = m_reader_exits.load(std::memory_order_seq_cst);
+		if( not has_readers() )
+			break;
+		else if( backoff <= detail::spin_max_backoff )
+		{
+			for(uint32_t i=0; i<backoff; i++)
+				detail::cpu_relax();
+			spins += backoff;
+			backoff <<= 1;
+		}
+		else
+		{
+			m_reader_exits.wait(exits, std::memory_order_relaxed);
+			parks++;
+		}
+	}
+	detail::lock_profile_record(profile, start, spins, parks);
 }
 
 inline bool spin_shared_mutex::try_lock()
 {
-	return m_native_handle.try_lock();
+	if( not m_native_handle.try_lock() )
+		return false;
+
+	m_writer.store(1, std::memory_order_seq_cst);
+	if( not has_readers() )
+		return true;
+
+	unlock();
+	return false;
 }
 
 inline void spin_shared_mutex::unlock()
 {
+	m_writer.store(0, std::memory_order_release);
+	m_writer.notify_all();
 	m_native_handle.unlock();
 }
 
 inline void spin_shared_mutex::lock_shared()
 {
-	if( ++m_read_count == 1 )
-		m_native_handle.lock();
+	auto &slot = local_slot();
+	for(;;)
+	{
+		slot.count.fetch_add(1, std::memory_order_seq_cst);
+		if( m_writer.load(std::memory_order_seq_cst) == 0 )
+			return ;
+
+		// Step back for the writer, it may be waiting for this very count.
+		slot.count.fetch_sub(1, std::memory_order_seq_cst);
+		reader_exit();
+		wait_writer();
+	}
 }
 
 inline bool spin_shared_mutex::try_lock_shared()
 {
-	if( ++m_read_count == 1 )
-		return m_native_handle.try_lock();
-	return true;
+	auto &slot = local_slot();
+	slot.count.fetch_add(1, std::memory_order_seq_cst);
+	if( m_writer.load(std::memory_order_seq_cst) == 0 )
+		return true;
+
+	slot.count.fetch_sub(1, std::memory_order_seq_cst);
+	reader_exit();
+	return false;
 }
 
 inline void spin_shared_mutex::unlock_shared()
 {
-	auto counter = m_read_count.load();
-	/*
-		if( m_read_count == counter )
+	// Any slot will do, only the sum over all of them matters.
+	local_slot().count.fetch_sub(1, std::memory_order_seq_cst);
+	if( m_writer.load(std::memory_order_seq_cst) != 0 )
+		reader_exit();
+}
+
+inline void spin_shared_mutex::set_profile(lock_profile *profile) noexcept
+{
+	m_native_handle.set_profile(profile);
+}
+
+inline lock_profile *spin_shared_mutex::profile() const noexcept
+{
+	return m_native_handle.profile();
+}
+
+inline spin_shared_mutex::native_handle_t &spin_shared_mutex::native_handle() noexcept
+{
+	return m_native_handle;
+}
+
+inline spin_shared_mutex::reader_slot &spin_shared_mutex::local_slot() noexcept
+{
+#ifdef __linux__
+	if( auto cpu = sched_getcpu(); cpu >= 0 )
+		return m_slots[static_cast<size_t>(cpu) % slot_count];
+#endif //__linux__
+	static std::atomic_size_t next_index {0};
+	thread_local size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+	return m_slots[index % slot_count];
+}
+
+inline bool spin_shared_mutex::has_readers() const noexcept
+{
+	// A reader may leave on another core than it came in, a slot can wrap below zero.
+	uint32_t sum = 0;
+	for(auto &slot : m_slots)
+		sum += slot.count.load(std::memory_order_seq_cst);
+	return sum != 0;
+}
+
+inline void spin_shared_mutex::wait_writer()
+{
+	auto profile = m_native_handle.profile();
+	std::chrono::steady_clock::time_point start {};
+	if( profile )
+		start = std::chrono::steady_clock::now();
+
+	size_t spins = 0, parks = 0;
+	for(uint32_t backoff=1; m_writer.load(std::memory_order_acquire) != 0;)
+	{
+		if( backoff <= detail::spin_max_backoff )
 		{
-			m_read_count = counter - 1;
-			return ;
+			for(uint32_t i=0; i<backoff; i++)
+				detail::cpu_relax();
+			spins += backoff;
+			backoff <<= 1;
 		}
 		else
 		{
-			counter = m_read_count;
-			return ;
+			m_writer.wait(1, std::memory_order_acquire);
+			parks++;
 		}
-	*/
-	if( counter > 0 and m_read_count.compare_exchange_weak(counter, counter - 1) )
-		m_native_handle.unlock();
+	}
+	detail::lock_profile_record(profile, start, spins, parks);
 }
 
-inline spin_shared_mutex::native_handle_t &spin_shared_mutex::native_handle() noexcept
+inline void spin_shared_mutex::reader_exit() noexcept
 {
-	return m_native_handle;
+	m_reader_exits.fetch_add(1, std::memory_order_seq_cst);
+	m_reader_exits.notify_all();
 }
 
 } //namesapace libgs
@@ -29,12 +29,58 @@
 #ifndef LIBGS_CORE_DETAIL_SPIN_MUTEX_H
 #define LIBGS_CORE_DETAIL_SPIN_MUTEX_H
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+# include <intrin.h>
+#endif
+
 namespace libgs
 {
 
+namespace detail
+{
+
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Pauses per round double up to this, a few microseconds in all.
+constexpr uint32_t spin_max_backoff = 256;
+
+inline void lock_profile_record (
+	lock_profile *profile, std::chrono::steady_clock::time_point start, size_t spins, size_t parks
+) noexcept
+{
+	if( not profile )
+		return ;
+	auto wait = std::chrono::steady_clock::now() - start;
+	profile->contentions.fetch_add(1, std::memory_order_relaxed);
+	profile->spins.fetch_add(spins, std::memory_order_relaxed);
+	profile->parks.fetch_add(parks, std::memory_order_relaxed);
+	profile->wait_ns.fetch_add (
+		std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count(), std::memory_order_relaxed
+	);
+}
+
+} //namespace detail
+
+inline void lock_profile::reset() noexcept
+{
+	contentions = 0;
+	spins = 0;
+	parks = 0;
+	wait_ns = 0;
+}
+
 inline spin_mutex::~spin_mutex() noexcept(false)
 {
-	if( m_native_handle )
+	if( m_native_handle.load(std::memory_order_relaxed) != 0 )
 	{
 		throw runtime_error (
 			"libgs::spin_mutex: Destruct a spin mutex that has not yet been unlocked."
@@ -44,32 +90,33 @@ inline spin_mutex::~spin_mutex() noexcept(false)
 
 inline void spin_mutex::lock()
 {
-	while( m_native_handle )
-		std::this_thread::yield();
-	m_native_handle = true;
+	uint32_t expected = 0;
+	if( m_native_handle.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed) )
+		return ;
+	lock_contended();
 }
 
 inline bool spin_mutex::try_lock()
 {
-	bool flag = false;
-	/*
-		if( m_native_handle == flag )
-	 	{
-	 		m_native_handle = true;
-	 		return true;
-		}
-	 	else
-	 	{
-	 		flag = m_native_handle;
-			return false;
-	 	}
-	*/
-	return m_native_handle.compare_exchange_weak(flag, true);
+	uint32_t expected = 0;
+	return m_native_handle.load(std::memory_order_relaxed) == 0 and
+		m_native_handle.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
 }
 
 inline void spin_mutex::unlock()
 {
-	m_native_handle	= false;
+	if( m_native_handle.exchange(0, std::memory_order_release) == 2 )
+		m_native_handle.notify_one();
+}
+
+inline void spin_mutex::set_profile(lock_profile *profile) noexcept
+{
+	m_profile = profile;
+}
+
+inline lock_profile *spin_mutex::profile() const noexcept
+{
+	return m_profile;
 }
 
 inline typename spin_mutex::native_handle_t &spin_mutex::native_handle() noexcept
@@ -77,6 +124,39 @@ inline typename spin_mutex::native_handle_t &spin_mutex::native_handle() noexcep
 	return m_native_handle;
 }
 
+inline void spin_mutex::lock_contended()
+{
+	auto profile = m_profile;
+	std::chrono::steady_clock::time_point start {};
+	if( profile )
+		start = std::chrono::steady_clock::now();
+
+	// Spin on a plain load, the line stays shared until the owner writes it.
+	size_t spins = 0;
+	for(uint32_t backoff=1; backoff<=detail::spin_max_backoff; backoff<<=1)
+	{
+		for(uint32_t i=0; i<backoff; i++)
+			detail::cpu_relax();
+		spins += backoff;
+
+		uint32_t expected = 0;
+		if( m_native_handle.load(std::memory_order_relaxed) == 0 and
+			m_native_handle.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed) )
+		{
+			detail::lock_profile_record(profile, start, spins, 0);
+			return ;
+		}
+	}
+	// Taken with 2 from here on, so that unlock wakes the next sleeper.
+	size_t parks = 0;
+	while( m_native_handle.exchange(2, std::memory_order_acquire) != 0 )
+	{
+		m_native_handle.wait(2, std::memory_order_relaxed);
+		parks++;
+	}
+	detail::lock_profile_record(profile, start, spins, parks);
+}
+
 } //namespace libgs
 
 
@@ -304,12 +304,24 @@ public:
 
 	template <typename Rep, typename Period>
 	void set_sync_period(const duration<Rep,Period> &period = {});
+
+	// write() syncs once no other write() came for 'delay' (zero disables it).
+	template <typename Rep, typename Period>
+	void set_sync_delay(const duration<Rep,Period> &delay = {});
 	void set_sync_on_delete(bool enable = true) noexcept;
 
 	[[nodiscard]] milliseconds sync_period() const noexcept;
+	[[nodiscard]] milliseconds sync_delay() const noexcept;
 	[[nodiscard]] bool sync_on_delete() const noexcept;
 	void cancel();
 
+public:
+	void set_auto_reload(bool enable = true);
+	[[nodiscard]] bool auto_reload() const noexcept;
+
+	using reload_handler_t = std::function<void(const error_code&)>;
+	void on_reload(reload_handler_t handler);
+
 public:
 	[[nodiscard]] iterator find(concepts::basic_string_type<char_t> auto &&group) noexcept;
 	[[nodiscard]] const_iterator find(concepts::basic_string_type<char_t> auto &&group) const noexcept;
@@ -0,0 +1,106 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "detail/mapped_file_impl.hii"
+
+namespace libgs
+{
+
+mapped_file::mapped_file() :
+	m_impl(new impl())
+{
+
+}
+
+mapped_file::mapped_file(const path_t &file_name) :
+	m_impl(new impl())
+{
+	open(file_name);
+}
+
+mapped_file::~mapped_file()
+{
+	delete m_impl;
+}
+
+mapped_file::mapped_file(mapped_file &&other) noexcept :
+	m_impl(other.m_impl)
+{
+	other.m_impl = new impl();
+}
+
+mapped_file &mapped_file::operator=(mapped_file &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	delete m_impl;
+	m_impl = other.m_impl;
+	other.m_impl = new impl();
+	return *this;
+}
+
+void mapped_file::open(const path_t &file_name, error_code &error) noexcept
+{
+	close();
+	m_impl->map_native(file_name, error);
+}
+
+void mapped_file::open(const path_t &file_name)
+{
+	error_code error;
+	open(file_name, error);
+	if( error )
+		throw system_error(error, "Cannot map file: '{}'", file_name);
+}
+
+void mapped_file::close() noexcept
+{
+	m_impl->unmap_native();
+}
+
+const uint8_t *mapped_file::data() const noexcept
+{
+	return m_impl->m_data;
+}
+
+size_t mapped_file::size() const noexcept
+{
+	return m_impl->m_size;
+}
+
+std::string_view mapped_file::view() const noexcept
+{
+	return {reinterpret_cast<const char*>(m_impl->m_data), m_impl->m_size};
+}
+
+bool mapped_file::is_open() const noexcept
+{
+	return m_impl->m_is_open;
+}
+
+} //namespace libgs
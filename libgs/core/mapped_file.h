@@ -0,0 +1,71 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_MAPPED_FILE_H
+#define LIBGS_CORE_MAPPED_FILE_H
+
+#include <libgs/core/global.h>
+
+namespace libgs
+{
+
+// Read-only memory mapping of a whole file.
+class LIBGS_CORE_API mapped_file
+{
+	LIBGS_DISABLE_COPY(mapped_file)
+
+public:
+	using path_t = std::filesystem::path;
+
+	mapped_file();
+	explicit mapped_file(const path_t &file_name);
+	~mapped_file();
+
+	mapped_file(mapped_file &&other) noexcept;
+	mapped_file &operator=(mapped_file &&other) noexcept;
+
+public:
+	void open(const path_t &file_name, error_code &error) noexcept;
+	void open(const path_t &file_name);
+	void close() noexcept;
+
+public:
+	[[nodiscard]] const uint8_t *data() const noexcept;
+	[[nodiscard]] size_t size() const noexcept;
+	[[nodiscard]] std::string_view view() const noexcept;
+	[[nodiscard]] bool is_open() const noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+} //namespace libgs
+
+
+#endif //LIBGS_CORE_MAPPED_FILE_H
@@ -19,10 +19,260 @@ static func_map_t &init_map()
 	return map;
 }
 
+struct module_node
+{
+	std::string name;
+	func_obj_t func;
+	std::vector<std::string> depends;
+};
+
+using module_list_t = std::vector<module_node>;
+
+static module_list_t &module_list()
+{
+	static module_list_t list;
+	return list;
+}
+
+static modules::report_t &last_report()
+{
+	static modules::report_t report;
+	return report;
+}
+
+namespace
+{
+
+class module_graph
+{
+	LIBGS_DISABLE_COPY_MOVE(module_graph)
+	using clock_t = std::chrono::steady_clock;
+
+public:
+	explicit module_graph(module_list_t nodes) :
+		m_nodes(std::move(nodes)),
+		m_depends(m_nodes.size()),
+		m_dependents(m_nodes.size()),
+		m_waiting(m_nodes.size(), 0),
+		m_timings(m_nodes.size())
+	{
+		std::map<std::string_view,size_t> indexes;
+		for(size_t i=0; i<m_nodes.size(); i++)
+			indexes.emplace(m_nodes[i].name, i);
+
+		for(size_t i=0; i<m_nodes.size(); i++)
+		{
+			for(auto &name : m_nodes[i].depends)
+			{
+				auto it = indexes.find(name);
+				if( it == indexes.end() )
+				{
+					throw runtime_error (
+						"libgs::modules: Module '{}' depends on unknown module '{}'.",
+						m_nodes[i].name, name
+					);
+				}
+				m_depends[i].emplace_back(it->second);
+				m_dependents[it->second].emplace_back(i);
+				m_waiting[i]++;
+			}
+		}
+		check_cycle();
+	}
+
+public:
+	[[nodiscard]] bool empty() const noexcept {
+		return m_nodes.empty();
+	}
+
+	[[nodiscard]] awaitable<void> co_run()
+	{
+		using result_t = std::pair<size_t,std::exception_ptr>;
+		auto exec = co_await asio::this_coro::executor;
+
+		// Initializers mostly wait on I/O, so the pool is wider than the CPU count.
+		auto threads = std::max<size_t>(std::thread::hardware_concurrency() * 2, 4);
+		asio::thread_pool pool(std::min(threads, m_nodes.size()));
+		co_channel<result_t> finished;
+
+		m_begin = clock_t::now();
+		size_t running = 0;
+		std::exception_ptr error;
+
+		auto launch = [&](size_t index)
+		{
+			running++;
+			asio::co_spawn(exec, co_run_one(index, pool),
+			[&finished, index](std::exception_ptr ex) {
+				(void) finished.try_send({index, std::move(ex)});
+			});
+		};
+		for(size_t i=0; i<m_nodes.size(); i++)
+		{
+			if( m_waiting[i] == 0 )
+				launch(i);
+		}
+		while( running > 0 )
+		{
+			auto [index, ex] = *co_await finished.receive();
+			running--;
+
+			if( ex and not error )
+				error = std::move(ex);
+			if( error )
+				continue;
+
+			for(auto next : m_dependents[index])
+			{
+				if( --m_waiting[next] == 0 )
+					launch(next);
+			}
+		}
+		pool.join();
+		make_report();
+
+		if( error )
+			std::rethrow_exception(error);
+		co_return ;
+	}
+
+private:
+	[[nodiscard]] awaitable<void> co_run_one(size_t index, asio::thread_pool &pool)
+	{
+		auto &node = m_nodes[index];
+		m_timings[index].name = node.name;
+
+		if( node.func.index() == 2 )
+		{
+			auto begin = stamp_start(index);
+			co_await std::get<await_init_func_t>(node.func)();
+			stamp_finish(index, begin);
+			co_return ;
+		}
+		// Blocking work stays off the caller's executor.
+		co_await asio::co_spawn(pool, [this, &node, index]() -> awaitable<void>
+		{
+			auto begin = stamp_start(index);
+			if( node.func.index() == 0 )
+				std::get<init_func_t>(node.func)();
+			else
+				std::get<future_init_func_t>(node.func)().get();
+			stamp_finish(index, begin);
+			co_return ;
+		},
+		use_awaitable);
+		co_return ;
+	}
+
+	clock_t::time_point stamp_start(size_t index)
+	{
+		auto now = clock_t::now();
+		m_timings[index].start = std::chrono::duration_cast<std::chrono::microseconds>(now - m_begin);
+		return now;
+	}
+
+	void stamp_finish(size_t index, clock_t::time_point begin)
+	{
+		m_timings[index].elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock_t::now() - begin);
+	}
+
+	void check_cycle() const
+	{
+		// 0: unvisited, 1: on the current path, 2: done.
+		std::vector<int> state(m_nodes.size(), 0);
+		std::vector<size_t> path;
+
+		std::function<void(size_t)> visit = [&](size_t index)
+		{
+			state[index] = 1;
+			path.emplace_back(index);
+			for(auto dep : m_depends[index])
+			{
+				if( state[dep] == 1 )
+				{
+					std::string cycle;
+					auto it = std::ranges::find(path, dep);
+					for(; it != path.end(); ++it)
+						cycle += m_nodes[*it].name + " -> ";
+					throw runtime_error (
+						"libgs::modules: Circular module dependency: {}{}.", cycle, m_nodes[dep].name
+					);
+				}
+				else if( state[dep] == 0 )
+					visit(dep);
+			}
+			path.pop_back();
+			state[index] = 2;
+		};
+		for(size_t i=0; i<m_nodes.size(); i++)
+		{
+			if( state[i] == 0 )
+				visit(i);
+		}
+	}
+
+	void make_report()
+	{
+		using namespace std::chrono;
+		auto &report = last_report();
+		report = {};
+		report.total = duration_cast<microseconds>(clock_t::now() - m_begin);
+
+		// The path ends with the module finishing last, and each step goes
+		// back to the dependency that finished last, which held the next one.
+		auto end = [this](size_t index) {
+			return m_timings[index].start + m_timings[index].elapsed;
+		};
+		std::vector<size_t> path;
+		std::optional<size_t> index;
+		for(size_t i=0; i<m_nodes.size(); i++)
+		{
+			if( not m_timings[i].name.empty() and (not index or end(i) > end(*index)) )
+				index = i;
+		}
+		while( index )
+		{
+			path.emplace_back(*index);
+			m_timings[*index].critical = true;
+
+			std::optional<size_t> prev;
+			for(auto dep : m_depends[*index])
+			{
+				if( not prev or end(dep) > end(*prev) )
+					prev = dep;
+			}
+			index = prev;
+		}
+		for(auto it=path.rbegin(); it!=path.rend(); ++it)
+			report.critical_path.emplace_back(m_nodes[*it].name);
+
+		for(auto &timing : m_timings)
+		{
+			// Modules never started after a failure are left out.
+			if( not timing.name.empty() )
+				report.modules.emplace_back(std::move(timing));
+		}
+		std::ranges::sort(report.modules, {}, &modules::module_timing::start);
+	}
+
+private:
+	module_list_t m_nodes;
+	std::vector<std::vector<size_t>> m_depends;
+	std::vector<std::vector<size_t>> m_dependents;
+	std::vector<size_t> m_waiting;
+
+	std::vector<modules::module_timing> m_timings;
+	clock_t::time_point m_begin {};
+};
+
+} //namespace
+
 awaitable<void> modules::co_run_init()
 {
 	return dispatch([]() -> awaitable<void>
 	{
+		// Bad dependencies fail before any initializer runs.
+		module_graph graph(std::move(module_list()));
 		auto map = std::move(init_map());
 		for(auto &[level, func_list] : map)
 		{
@@ -39,6 +289,8 @@ awaitable<void> modules::co_run_init()
 			for(auto &futrue : future_list)
 				co_await co_wait(futrue);
 		}
+		if( not graph.empty() )
+			co_await graph.co_run();
 		co_return ;
 	},
 	use_awaitable);
@@ -46,6 +298,18 @@ awaitable<void> modules::co_run_init()
 
 void modules::run_init()
 {
+	// An awaitable module cannot run here, skipping it would start its dependents too early.
+	auto &list = module_list();
+	auto it = std::ranges::find_if(list, [](const module_node &node) {
+		return node.func.index() == 2;
+	});
+	if( it != list.end() )
+	{
+		throw runtime_error (
+			"libgs::modules::run_init: Module '{}' is awaitable, run it with co_run_init.", it->name
+		);
+	}
+	module_graph graph(std::move(list));
 	auto map = std::move(init_map());
 	for(auto &[level, func_list] : map)
 	{
@@ -60,21 +324,46 @@ void modules::run_init()
 		for(auto &futrue : future_list)
 			futrue.wait();
 	}
+	if( graph.empty() )
+		return ;
+
+	asio::io_context ioc;
+	auto future = asio::co_spawn(ioc, graph.co_run(), use_future);
+	ioc.run();
+	future.get();
+}
+
+const modules::report_t &modules::report() noexcept
+{
+	return last_report();
+}
+
+static bool is_valid(const func_obj_t &func)
+{
+	if( func.index() == 0 )
+		return std::get<0>(func) != nullptr;
+	else if( func.index() == 1 )
+		return std::get<1>(func) != nullptr;
+	return std::get<2>(func) != nullptr;
 }
 
 void modules::reg_init_p(func_obj_t func, level_t level)
 {
-	auto res = [&func]() -> bool
-	{
-		if( func.index() == 0 )
-			return std::get<0>(func) != nullptr;
-		else if( func.index() == 1 )
-			return std::get<1>(func) != nullptr;
-		return std::get<2>(func) != nullptr;
-	}();
-	if( not res )
+	if( not is_valid(func) )
 		throw std::runtime_error("libgs::modules::reg_init_p: Invalid function object.");
 	init_map()[level].emplace_back(std::move(func));
 }
 
+void modules::reg_module_p(std::string name, func_obj_t func, std::vector<std::string> depends)
+{
+	if( not is_valid(func) )
+		throw std::runtime_error("libgs::modules::reg_module_p: Invalid function object.");
+
+	auto &list = module_list();
+	auto it = std::ranges::find(list, name, &module_node::name);
+	if( it != list.end() )
+		throw runtime_error("libgs::modules::reg_module_p: Duplicate module name '{}'.", name);
+	list.emplace_back(std::move(name), std::move(func), std::move(depends));
+}
+
 } //namespace libgs
\ No newline at end of file
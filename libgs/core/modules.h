@@ -68,6 +68,21 @@ public:
 		init_func_t, future_init_func_t, await_init_func_t
 	>;
 
+	struct module_timing
+	{
+		std::string name;
+		std::chrono::microseconds start {};
+		std::chrono::microseconds elapsed {};
+		bool critical = false;
+	};
+
+	struct report_t
+	{
+		std::chrono::microseconds total {};
+		std::vector<module_timing> modules {}; // In start order.
+		std::vector<std::string> critical_path {};
+	};
+
 public:
 	/* awiatable as the return value of the initializer
 	 * must be executed by co_run_init,
@@ -75,11 +90,27 @@ public:
 	 * */
 	static void reg_init(concepts::modules_init_func auto &&func, level_t level = level_6);
 
+	/* A named module starts as soon as the modules it depends on have finished,
+	 * independent modules run concurrently: plain and future initializers on a
+	 * thread pool, awaitable ones on the executor of co_run_init.
+	 * Named modules run after all levels, unknown dependencies and cycles are
+	 * reported before anything runs, and nothing new starts after a failure.
+	 * Others depend on an awaitable module, so run_init refuses to run if one
+	 * is registered.
+	 * */
+	static void reg_module (
+		std::string name, concepts::modules_init_func auto &&func, std::vector<std::string> depends = {}
+	);
+
 	static awaitable<void> co_run_init();
 	static void run_init();
 
+	// The timing of the named modules in the last run.
+	[[nodiscard]] static const report_t &report() noexcept;
+
 private:
 	static void reg_init_p(func_obj_t func, level_t level);
+	static void reg_module_p(std::string name, func_obj_t func, std::vector<std::string> depends);
 };
 
 #define LIBGS_MODULE_INIT(_level, _func) \
@@ -87,6 +118,11 @@ private:
 		libgs::modules::reg_init(_func, static_cast<libgs::modules::level_t>(_level)); \
 	}
 
+#define LIBGS_MODULE(_name, _func, ...) \
+	LIBGS_REGISTRATION { \
+		libgs::modules::reg_module(_name, _func, {__VA_ARGS__}); \
+	}
+
 #define LIBGS_MODULE_INIT_DEF(_func) \
 	LIBGS_MODULE_INIT(libgs::modules::level_6, _func)
 
@@ -0,0 +1,163 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#include "rcu_ptr.h"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace libgs
+{
+
+namespace detail
+{
+
+struct alignas(64) rcu_reader
+{
+	// 0: outside of any read-side critical section.
+	std::atomic_uint64_t epoch {0};
+	std::atomic_bool used {true};
+	rcu_reader *next = nullptr;
+};
+
+struct rcu_retired
+{
+	void *ptr;
+	rcu_domain::deleter_t deleter;
+	uint64_t epoch;
+};
+
+static std::atomic_uint64_t g_rcu_epoch {1};
+
+// Readers are never freed, a thread that exits gives its one back for reuse.
+static std::atomic<rcu_reader*> g_rcu_readers {nullptr};
+
+static std::mutex g_rcu_retired_mutex;
+static std::vector<rcu_retired> g_rcu_retired;
+
+static rcu_reader *rcu_acquire_reader()
+{
+	for(auto reader = g_rcu_readers.load(std::memory_order_acquire); reader; reader = reader->next)
+	{
+		bool used = false;
+		if( reader->used.compare_exchange_strong(used, true, std::memory_order_acq_rel) )
+			return reader;
+	}
+	auto reader = new rcu_reader();
+	reader->next = g_rcu_readers.load(std::memory_order_relaxed);
+	while( not g_rcu_readers.compare_exchange_weak(reader->next, reader, std::memory_order_acq_rel) );
+	return reader;
+}
+
+struct rcu_local_reader
+{
+	rcu_reader *reader = nullptr;
+	size_t depth = 0;
+
+	~rcu_local_reader()
+	{
+		if( reader )
+			reader->used.store(false, std::memory_order_release);
+	}
+};
+static thread_local rcu_local_reader t_rcu_reader;
+
+// Everything retired before the returned epoch is no longer reachable by any reader.
+static uint64_t rcu_min_active_epoch() noexcept
+{
+	uint64_t min = std::numeric_limits<uint64_t>::max();
+	for(auto reader = g_rcu_readers.load(std::memory_order_acquire); reader; reader = reader->next)
+	{
+		auto epoch = reader->epoch.load(std::memory_order_seq_cst);
+		if( epoch != 0 and epoch < min )
+			min = epoch;
+	}
+	return min;
+}
+
+} //namespace detail
+
+void rcu_domain::read_lock() noexcept
+{
+	auto &local = detail::t_rcu_reader;
+	if( local.depth++ > 0 )
+		return ;
+	if( local.reader == nullptr )
+		local.reader = detail::rcu_acquire_reader();
+
+	// Paired with the seq_cst exchange + fetch_add on the writer side, any pointer
+	// loaded after this is either the new one or was retired at an epoch >= ours.
+	local.reader->epoch.store(detail::g_rcu_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+}
+
+void rcu_domain::read_unlock() noexcept
+{
+	auto &local = detail::t_rcu_reader;
+	if( --local.depth == 0 )
+		local.reader->epoch.store(0, std::memory_order_release);
+}
+
+void rcu_domain::retire(void *ptr, deleter_t deleter)
+{
+	auto epoch = detail::g_rcu_epoch.fetch_add(1, std::memory_order_seq_cst);
+	{
+		std::unique_lock lock(detail::g_rcu_retired_mutex);
+		detail::g_rcu_retired.emplace_back(ptr, deleter, epoch);
+	}
+	reclaim();
+}
+
+void rcu_domain::synchronize()
+{
+	// Must not be called inside a read-side critical section of this thread.
+	auto epoch = detail::g_rcu_epoch.fetch_add(1, std::memory_order_seq_cst);
+	while( detail::rcu_min_active_epoch() <= epoch )
+		std::this_thread::yield();
+	reclaim();
+}
+
+size_t rcu_domain::reclaim()
+{
+	auto min = detail::rcu_min_active_epoch();
+	std::vector<detail::rcu_retired> expired;
+	{
+		std::unique_lock lock(detail::g_rcu_retired_mutex);
+		auto it = std::partition(detail::g_rcu_retired.begin(), detail::g_rcu_retired.end(),
+		[min](const detail::rcu_retired &retired) {
+			return retired.epoch >= min;
+		});
+		expired.assign(it, detail::g_rcu_retired.end());
+		detail::g_rcu_retired.erase(it, detail::g_rcu_retired.end());
+	}
+	// Deleters run unlocked, they may retire again.
+	for(auto &retired : expired)
+		retired.deleter(retired.ptr);
+	return expired.size();
+}
+
+} //namespace libgs
@@ -0,0 +1,116 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_CORE_RCU_PTR_H
+#define LIBGS_CORE_RCU_PTR_H
+
+#include <libgs/core/global.h>
+#include <mutex>
+
+namespace libgs
+{
+
+// Epoch based reclamation shared by every rcu_ptr. Readers only publish the epoch
+// they entered; anything retired is deleted once no reader can still see it.
+class LIBGS_CORE_API rcu_domain
+{
+public:
+	using deleter_t = void(*)(void*);
+
+public:
+	static void read_lock() noexcept;
+	static void read_unlock() noexcept;
+
+public:
+	static void retire(void *ptr, deleter_t deleter);
+	static void synchronize();
+	static size_t reclaim();
+};
+
+template <typename T>
+class LIBGS_CORE_TAPI rcu_ptr
+{
+	LIBGS_DISABLE_COPY(rcu_ptr)
+
+public:
+	using value_t = T;
+
+	// Keeps the current thread inside a read-side critical section, never keep it across a co_await.
+	class snapshot
+	{
+		LIBGS_DISABLE_COPY(snapshot)
+
+	public:
+		snapshot(snapshot &&other) noexcept;
+		snapshot &operator=(snapshot &&other) noexcept;
+		~snapshot();
+
+	public:
+		[[nodiscard]] const value_t *get() const noexcept;
+		[[nodiscard]] const value_t *operator->() const noexcept;
+		[[nodiscard]] const value_t &operator*() const noexcept;
+		[[nodiscard]] explicit operator bool() const noexcept;
+		void release() noexcept;
+
+	private:
+		friend class rcu_ptr;
+		explicit snapshot(const value_t *ptr) noexcept;
+		const value_t *m_ptr;
+		bool m_locked = true;
+	};
+
+public:
+	rcu_ptr() = default;
+	explicit rcu_ptr(std::unique_ptr<value_t> ptr) noexcept;
+	~rcu_ptr();
+
+	// Not safe against concurrent readers of 'other'.
+	rcu_ptr(rcu_ptr &&other) noexcept;
+	rcu_ptr &operator=(rcu_ptr &&other) noexcept;
+
+public:
+	[[nodiscard]] snapshot read() const noexcept;
+	void store(std::unique_ptr<value_t> ptr);
+
+	// Copies the current value, lets 'func' modify the copy, then publishes it.
+	// Writers are serialized; if 'func' throws, nothing is published.
+	template <typename Func>
+	void update(Func &&func) requires std::is_copy_constructible_v<value_t>;
+
+private:
+	void publish(value_t *ptr);
+
+	std::atomic<value_t*> m_ptr {nullptr};
+	std::mutex m_write_mutex;
+};
+
+} //namespace libgs
+#include <libgs/core/detail/rcu_ptr.h>
+
+
+#endif //LIBGS_CORE_RCU_PTR_H
@@ -45,6 +45,8 @@ using shared_shared_timed_lock = std::shared_lock<shared_timed_mutex>;
 using shared_unique_lock = std::unique_lock<shared_mutex>;
 using shared_unique_timed_lock = std::unique_lock<shared_timed_mutex>;
 
+// Readers count themselves in per-core slots, so they don't bounce one cache
+// line between cores. Writers are preferred: a waiting writer holds new readers back.
 class LIBGS_CORE_VAPI spin_shared_mutex
 {
 	LIBGS_DISABLE_COPY_MOVE(spin_shared_mutex)
@@ -67,10 +69,26 @@ public:
 	void unlock_shared();
 
 public:
+	void set_profile(lock_profile *profile) noexcept;
+	[[nodiscard]] lock_profile *profile() const noexcept;
 	native_handle_t &native_handle() noexcept;
 
 private:
-	std::atomic_uint m_read_count {0};
+	struct alignas(64) reader_slot {
+		std::atomic_uint32_t count {0};
+	};
+	[[nodiscard]] reader_slot &local_slot() noexcept;
+	[[nodiscard]] bool has_readers() const noexcept;
+	void wait_writer();
+	void reader_exit() noexcept;
+
+	// Fixed, so the mutex stays constant-initialized (usable from other static initializers).
+	static constexpr size_t slot_count = 16;
+	reader_slot m_slots[slot_count] {};
+
+	// 1 while a writer holds or waits for the lock.
+	std::atomic_uint32_t m_writer {0};
+	std::atomic_uint32_t m_reader_exits {0};
 	native_handle_t m_native_handle;
 };
 
@@ -34,12 +34,27 @@
 namespace libgs
 {
 
+// Contention counters, may be shared by any number of locks.
+// Only the contended path touches them.
+struct LIBGS_CORE_VAPI lock_profile
+{
+	std::atomic_size_t contentions {0};
+	std::atomic_size_t spins {0};
+	std::atomic_size_t parks {0};
+	std::atomic<uint64_t> wait_ns {0};
+
+	void reset() noexcept;
+};
+
+// Test-and-test-and-set with exponential backoff, parks on the
+// state word (futex / WaitOnAddress) once spinning did not pay off.
 class LIBGS_CORE_VAPI spin_mutex
 {
 	LIBGS_DISABLE_COPY_MOVE(spin_mutex)
 
 public:
-	using native_handle_t = std::atomic_bool;
+	// 0: unlocked, 1: locked, 2: locked and there may be parked waiters.
+	using native_handle_t = std::atomic_uint32_t;
 
 public:
 	spin_mutex() = default;
@@ -51,10 +66,14 @@ public:
 	void unlock();
 
 public:
+	void set_profile(lock_profile *profile) noexcept;
+	[[nodiscard]] lock_profile *profile() const noexcept;
 	native_handle_t &native_handle() noexcept;
 
 private:
-	native_handle_t m_native_handle {false};
+	void lock_contended();
+	native_handle_t m_native_handle {0};
+	lock_profile *m_profile = nullptr;
 };
 
 using spin_unique_lock = std::unique_lock<spin_mutex>;
@@ -30,6 +30,8 @@
 #define LIBGS_HTTP_H
 
 #include <libgs/http/server.h>
+#include <libgs/http/websocket.h>
+#include <libgs/http/h2.h>
 // #include <libgs/http/client.h>
 
 #endif //LIBGS_HTTP_H
@@ -147,7 +147,13 @@ private:
 	impl *m_impl;
 };
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
 
+// The host of the url only goes into the request, see 'basic_session_pool::set_endpoint'.
+using local_client = basic_client<char, local_session_pool<asio::any_io_executor>>;
+using wlocal_client = basic_client<wchar_t, local_session_pool<asio::any_io_executor>>;
+
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
 
 
 } //namespace libgs::http
@@ -64,7 +64,7 @@ public:
 
 template <core_concepts::char_type CharT>
 basic_reply_parser<CharT>::basic_reply_parser(size_t init_buf_size) :
-	m_impl(new impl(init_buf_size))
+	m_impl(arena::make<impl>(init_buf_size))
 {
 
 }
@@ -72,14 +72,14 @@ basic_reply_parser<CharT>::basic_reply_parser(size_t init_buf_size) :
 template <core_concepts::char_type CharT>
 basic_reply_parser<CharT>::~basic_reply_parser()
 {
-	delete m_impl;
+
 }
 
 template <core_concepts::char_type CharT>
 basic_reply_parser<CharT>::basic_reply_parser(basic_reply_parser &&other) noexcept :
-	m_impl(other.m_impl)
+	m_impl(std::move(other.m_impl))
 {
-	other.m_impl = new impl(0xFFFF);
+
 }
 
 template <core_concepts::char_type CharT>
@@ -87,9 +87,7 @@ basic_reply_parser<CharT> &basic_reply_parser<CharT>::operator=(basic_reply_pars
 {
 	if( this == &other )
         return *this;
-	delete m_impl;
-	m_impl = other.m_impl;
-	other.m_impl = new impl(0xFFFF);
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
@@ -188,9 +188,7 @@ public:
 			throw runtime_error("libgs::http::client_request: request already sent.");
 		else if( m_session )
 			return ;
-		m_session = m_impl->m_pool.get (
-			{url().address(), url().port()}, error
-		);
+		m_session = m_pool.get(endpoint(), error);
 	}
 
 	[[nodiscard]] awaitable<void> co_get_session(std::string &&data, error_code &error)
@@ -201,12 +199,20 @@ public:
 			co_return ;
 
 		using namespace libgs::operators;
-		m_session = co_await m_impl->m_pool.get (
-			{url().address(), url().port()}, use_awaitable | error
-		);
+		m_session = co_await m_pool.get(endpoint(), use_awaitable | error);
 		co_return ;
 	}
 
+	[[nodiscard]] typename session_pool_t::endpoint_t endpoint()
+	{
+		if( auto &ep = m_pool.endpoint() )
+			return *ep;
+		if constexpr( is_local_stream_v<typename session_pool_t::socket_t> )
+			throw runtime_error("libgs::http::client_request: no endpoint set for the unix domain socket.");
+		else
+			return {url().address(), url().port()};
+	}
+
 	[[nodiscard]] size_t check_time_out(const auto &var, error_code &error) const
 	{
 		if( var.index() == 0 )
@@ -73,13 +73,21 @@ public:
 
 	void emplace(socket_t &&socket)
 	{
-		if( socket.is_open() )
-			m_sock_map.emplace(std::make_pair(socket.remote_endpoint(), std::move(socket)));
+		if( not socket.is_open() )
+			return ;
+		// Default constructed if the peer has already gone.
+		auto ep = socket_operation_helper<socket_t>(socket).remote_endpoint();
+		if( ep != endpoint_t() )
+			m_sock_map.emplace(std::move(ep), std::move(socket));
 	}
 
 public:
 	std::shared_ptr<bool> m_valid {new bool(true)};
-	std::map<endpoint_t,socket_t> m_sock_map;
+
+	// Several idle connections are kept per endpoint (basic_proxy).
+	std::multimap<endpoint_t,socket_t> m_sock_map;
+	socket_options m_options = socket_options::low_latency();
+	std::optional<endpoint_t> m_endpoint {};
 	executor_t m_exec;
 };
 
@@ -148,7 +156,11 @@ auto basic_session_pool<Stream,Exec>::get
 	{
 		auto sess = m_impl->get(ep, exec);
 		if( auto &helper = sess.opt_helper(); not helper.is_open() )
-			helper.connect(ep, token);
+		{
+			helper.open(ep, m_impl->m_options, token);
+			if( not token )
+				helper.connect(ep, token);
+		}
 		return sess;
 	}
 	else if constexpr( is_sync_opt_token_v<token_t> )
@@ -177,20 +189,30 @@ auto basic_session_pool<Stream,Exec>::get
 
 		return async_work<error_code,session_t>::handle(get_executor(), [
 			self_exec = get_executor(), ep = std::move(ep), sess = m_impl->get(ep, exec),
-			timeout = get_associated_redirect_time(token), ntoken = std::move(ntoken)
+			options = m_impl->m_options, timeout = get_associated_redirect_time(token), ntoken = std::move(ntoken)
 		](auto wake_up) mutable
 		{
 			using wake_up_t = std::remove_cvref_t<decltype(wake_up)>;
 			asio::co_spawn(self_exec, [
 				wake_up = std::make_shared<wake_up_t>(std::move(wake_up)), ep = std::move(ep),
-				sess = std::move(sess), timeout = std::move(timeout), ntoken = std::move(ntoken)
+				sess = std::move(sess), options = std::move(options), timeout = std::move(timeout),
+				ntoken = std::move(ntoken)
 			]() mutable -> awaitable<void>
 			{
 				auto &helper = sess.opt_helper();
 				std::error_code error;
 
 				if( helper.is_open() )
+				{
 					std::move(*wake_up)(error, std::move(sess));
+					co_return ;
+				}
+				helper.open(ep, options, error);
+				if( error )
+				{
+					std::move(*wake_up)(error, std::move(sess));
+					co_return ;
+				}
 
 				auto var = co_await (
 					helper.connect(std::move(ep), use_awaitable | error) or
@@ -220,6 +242,33 @@ void basic_session_pool<Stream,Exec>::operator<<(socket_t &&socket)
 	emplace(std::move(socket));
 }
 
+template <concepts::stream Stream, core_concepts::execution Exec>
+basic_session_pool<Stream,Exec> &basic_session_pool<Stream,Exec>::set_options(const socket_options &options)
+{
+	m_impl->m_options = options;
+	return *this;
+}
+
+template <concepts::stream Stream, core_concepts::execution Exec>
+const socket_options &basic_session_pool<Stream,Exec>::options() const noexcept
+{
+	return m_impl->m_options;
+}
+
+template <concepts::stream Stream, core_concepts::execution Exec>
+basic_session_pool<Stream,Exec> &basic_session_pool<Stream,Exec>::set_endpoint(const endpoint_t &ep)
+{
+	m_impl->m_endpoint = ep;
+	return *this;
+}
+
+template <concepts::stream Stream, core_concepts::execution Exec>
+const std::optional<typename basic_session_pool<Stream,Exec>::endpoint_t>&
+basic_session_pool<Stream,Exec>::endpoint() const noexcept
+{
+	return m_impl->m_endpoint;
+}
+
 template <concepts::stream Stream, core_concepts::execution Exec>
 typename basic_session_pool<Stream,Exec>::executor_t basic_session_pool<Stream,Exec>::get_executor() noexcept
 {
@@ -94,7 +94,7 @@ public:
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 using reply_parser = basic_reply_parser<char>;
@@ -73,6 +73,14 @@ public:
 	void emplace(socket_t &&socket);
 	void operator<<(socket_t &&socket);
 
+	// Applied to every new connection before it connects.
+	basic_session_pool &set_options(const socket_options &options);
+	[[nodiscard]] const socket_options &options() const noexcept;
+
+	// Every request connects here whatever its host is, required for Unix domain sockets.
+	basic_session_pool &set_endpoint(const endpoint_t &ep);
+	[[nodiscard]] const std::optional<endpoint_t> &endpoint() const noexcept;
+
 	[[nodiscard]] executor_t get_executor() noexcept;
 
 private:
@@ -88,6 +96,16 @@ using tcp_session_pool = basic_tcp_session_pool<asio::any_io_executor, Exec>;
 
 using session_pool = tcp_session_pool<asio::any_io_executor>;
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
+template <core_concepts::execution MainExec, core_concepts::execution SockExec>
+using basic_local_session_pool = basic_session_pool<asio::basic_stream_socket<asio::local::stream_protocol,SockExec>, MainExec>;
+
+template <core_concepts::execution Exec>
+using local_session_pool = basic_local_session_pool<asio::any_io_executor, Exec>;
+
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
 template <typename>
 struct is_session_pool : std::false_type {};
 
@@ -44,6 +44,11 @@ struct is_stream : std::false_type {};
 template <concepts::execution Exec>
 struct is_stream<asio::basic_stream_socket<asio::ip::tcp,Exec>> : std::true_type {};
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+template <concepts::execution Exec>
+struct is_stream<asio::basic_stream_socket<asio::local::stream_protocol,Exec>> : std::true_type {};
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
 #ifdef LIBGS_ENABLE_OPENSSL
 template <concepts::execution Exec>
 struct is_stream<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>> : std::true_type {};
@@ -52,6 +57,28 @@ struct is_stream<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>
 template <typename Stream>
 constexpr bool is_stream_v = is_stream<Stream>::value;
 
+template <typename>
+struct is_ssl_stream : std::false_type {};
+
+#ifdef LIBGS_ENABLE_OPENSSL
+template <concepts::execution Exec>
+struct is_ssl_stream<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>> : std::true_type {};
+#endif //LIBGS_ENABLE_OPENSSL
+
+template <typename Stream>
+constexpr bool is_ssl_stream_v = is_ssl_stream<Stream>::value;
+
+template <typename>
+struct is_local_stream : std::false_type {};
+
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+template <concepts::execution Exec>
+struct is_local_stream<asio::basic_stream_socket<asio::local::stream_protocol,Exec>> : std::true_type {};
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
+template <typename Stream>
+constexpr bool is_local_stream_v = is_local_stream<Stream>::value;
+
 template <typename Stream>
 struct is_any_exec_stream
 {
@@ -285,6 +285,104 @@ error_code file_opt_token<FS&,file_optype::multiple>::init(std::ios_base::openmo
 namespace detail
 {
 
+[[nodiscard]] inline error_code async_file_opt_token_init
+(async_file &stream, std::filesystem::path &file_name, std::ios_base::openmode mode) noexcept
+{
+	if( stream.is_open() )
+	{
+		file_name = stream.file_name();
+		return {};
+	}
+	else if( file_name.empty() )
+		return std::make_error_code(std::errc::bad_file_descriptor);
+
+	error_code error;
+	auto abs_name = app::absolute_path(error, file_name);
+	if( error )
+		return error;
+
+	file_name = std::move(abs_name);
+	if( (mode & std::ios_base::out) == 0 and not exists(file_name) )
+		return std::make_error_code(std::errc::no_such_file_or_directory);
+
+	stream.open(file_name, mode, error);
+	return error;
+}
+
+} //namespace detail
+
+inline file_opt_token<async_file,file_optype::single>::file_opt_token(fstream_t &&stream) :
+	stream(new fstream_t(std::move(stream)))
+{
+
+}
+
+inline file_opt_token<async_file,file_optype::single>::file_opt_token(fstream_t &&stream, const file_range &range) :
+	stream(new fstream_t(std::move(stream))),
+	range(range)
+{
+
+}
+
+inline file_opt_token<async_file,file_optype::single>::~file_opt_token()
+{
+	if( stream.use_count() == 1 and stream->is_open() )
+		stream->close();
+}
+
+inline error_code file_opt_token<async_file,file_optype::single>::init(std::ios_base::openmode mode) noexcept
+{
+	return detail::async_file_opt_token_init(*stream, file_name, mode);
+}
+
+inline file_opt_token<async_file,file_optype::multiple>::file_opt_token(fstream_t &&stream) :
+	stream(new fstream_t(std::move(stream)))
+{
+
+}
+
+inline file_opt_token<async_file,file_optype::multiple>::file_opt_token(fstream_t &&stream, const file_range &range) :
+	file_opt_token(std::move(stream), file_ranges{range})
+{
+
+}
+
+inline file_opt_token<async_file,file_optype::multiple>::file_opt_token(fstream_t &&stream, file_ranges ranges) :
+	stream(new fstream_t(std::move(stream))),
+	ranges(std::move(ranges))
+{
+
+}
+
+template <concepts::file_ranges_init_list...Args>
+file_opt_token<async_file,file_optype::multiple>::file_opt_token(fstream_t &&stream, Args&&...ranges) :
+	file_opt_token(std::move(stream), file_ranges{std::forward<Args>(ranges)...})
+{
+
+}
+
+inline file_opt_token<async_file,file_optype::multiple>::file_opt_token(file_opt_token<type,file_optype::single> opt) :
+	stream(std::move(opt.stream)),
+	file_name(std::move(opt.file_name))
+{
+	if( opt.range )
+		ranges.emplace_back(*opt.range);
+}
+
+inline file_opt_token<async_file,file_optype::multiple>::~file_opt_token()
+{
+	if( stream.use_count() == 1 and stream->is_open() )
+		stream->close();
+}
+
+inline error_code file_opt_token<async_file,file_optype::multiple>::init(std::ios_base::openmode mode) noexcept
+{
+	return detail::async_file_opt_token_init(*stream, file_name, mode);
+}
+
+namespace detail
+{
+
 template <typename T, typename...Args>
 auto make_file_opt_token(auto &&arg, Args&&...args) noexcept
 {
@@ -303,6 +401,41 @@ auto make_file_opt_token(auto &&arg, Args&&...args) noexcept
 		return file_opt_token<T,file_optype::multiple>(std::forward<arg_t>(arg), std::forward<Args>(args)...);
 }
 
+// Paths (strings or path tokens) become unopened async_file tokens, other arguments are forwarded as is.
+template <file_optype::type Type, typename Opt>
+[[nodiscard]] decltype(auto) to_async_file_opt_token(const asio::any_io_executor &exec, Opt &&opt)
+{
+	using opt_t = std::remove_cvref_t<Opt>;
+	using token_t = file_opt_token<async_file,Type>;
+
+	if constexpr( std::is_same_v<opt_t, async_file> )
+		return token_t(std::forward<Opt>(opt));
+
+	else if constexpr( is_string_v<opt_t> )
+	{
+		token_t token(async_file{exec});
+		token.file_name = std::forward<Opt>(opt);
+		return token;
+	}
+	else if constexpr( requires { requires std::is_same_v<typename opt_t::type, void>; } )
+	{
+		token_t token(async_file{exec});
+		token.file_name = opt.file_name;
+		if constexpr( Type == file_optype::single )
+			token.range = opt.range;
+		else if constexpr( opt_t::optype == file_optype::single )
+		{
+			if( opt.range )
+				token.ranges.emplace_back(*opt.range);
+		}
+		else
+			token.ranges = opt.ranges;
+		return token;
+	}
+	else
+		return std::forward<Opt>(opt);
+}
+
 } //namespace detail
 
 template <core_concepts::char_type CharT, typename...Args>
@@ -324,13 +457,26 @@ auto make_file_opt_token(core_concepts::fstream_wkn auto &&stream, Args&&...args
 	return detail::make_file_opt_token<fstream_t>(std::forward<fstream_t>(stream), std::forward<Args>(args)...);
 }
 
+template <typename...Args>
+auto make_file_opt_token(async_file &&file, Args&&...args) noexcept
+{
+	return detail::make_file_opt_token<async_file>(std::move(file), std::forward<Args>(args)...);
+}
+
 std::optional<size_t> file_size(concepts::file_opt_token auto &opt, io_permission::type mode)
 {
 	using opt_t = std::remove_cvref_t<decltype(opt)>;
 	using fstream_t = typename opt_t::fstream_t;
 
 	std::optional<size_t> size;
-	if constexpr( is_fstream_v<fstream_t> )
+	if constexpr( std::is_same_v<fstream_t, async_file> )
+	{
+		error_code error;
+		auto res = opt.stream->size(error);
+		if( not error )
+			size = res;
+	}
+	else if constexpr( is_fstream_v<fstream_t> )
 	{
 		if( mode & io_permission::read )
 		{
@@ -353,7 +499,7 @@ std::optional<size_t> file_size(concepts::file_opt_token auto &opt, io_permissio
 			}
 		}
 	}
-	if constexpr( is_ifstream_v<fstream_t> )
+	else if constexpr( is_ifstream_v<fstream_t> )
 	{
 		if( mode & io_permission::read )
 		{
@@ -376,15 +522,20 @@ std::optional<size_t> file_size(concepts::file_opt_token auto &opt, io_permissio
 	return size;
 }
 
-std::string mime_type(concepts::file_opt_token auto &opt)
+std::string_view mime_type(concepts::file_opt_token auto &opt)
 {
 	using opt_t = std::remove_cvref_t<decltype(opt)>;
 	using type = typename opt_t::type;
+	using fstream_t = typename opt_t::fstream_t;
 
+	// The file has been opened by init(), sniff that stream instead of opening it again.
 	if constexpr( std::is_same_v<type,void> )
-		return libgs::mime_type(opt.file_name);
-	else if constexpr( opt_t::permissions & io_permission::read )
-		return libgs::mime_type(opt.stream);
+		return libgs::mime_type_view(opt.file_name, *opt.stream);
+	else if constexpr( std::is_same_v<type,async_file> )
+		return libgs::mime_type_view(opt.file_name);
+	else if constexpr( opt_t::permissions & io_permission::read and
+					   (is_char_fstream_v<fstream_t> or is_char_ifstream_v<fstream_t>) )
+		return libgs::mime_type_view(*opt.stream);
 	else
 		return "Unknown";
 }
@@ -402,6 +553,16 @@ inline auto operator| (std::string_view file_name, file_ranges ranges)
 	return make_file_opt_token(file_name, std::move(ranges));
 }
 
+inline auto operator| (async_file &&file, const file_range &range)
+{
+	return make_file_opt_token(std::move(file), range);
+}
+
+inline auto operator| (async_file &&file, file_ranges ranges)
+{
+	return make_file_opt_token(std::move(file), std::move(ranges));
+}
+
 auto operator| (core_concepts::fstream_wkn auto &&stream, const file_range &range)
 {
 	using fstream_t = decltype(stream);
@@ -30,6 +30,7 @@
 #define LIBGS_HTTP_CXX_DETAIL_SOCKET_OPERATION_HELPER_H
 
 #include <libgs/core/coro.h>
+#include <spdlog/spdlog.h>
 
 namespace libgs::http
 {
@@ -250,9 +251,9 @@ socket_operation_helper_base<Stream>::socket() noexcept
 	return m_impl->m_socket;
 }
 
-template <core_concepts::execution Exec>
+template <typename Protocol, core_concepts::execution Exec>
 template <core_concepts::opt_token<error_code> Token>
-auto socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::
+auto socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
 connect(endpoint_t ep, Token &&token)
 {
 	using token_t = std::remove_cvref_t<Token>;
@@ -293,15 +294,32 @@ connect(endpoint_t ep, Token &&token)
 		this->socket().async_connect(std::move(ep), std::forward<Token>(token));
 }
 
-template <core_concepts::execution Exec>
-void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
+open(const endpoint_t &ep, const socket_options &options, error_code &error) noexcept
+{
+	auto &socket = this->socket();
+	if( not socket.is_open() )
+	{
+		socket.open(ep.protocol(), error);
+		if( error )
+			return ;
+	}
+	error_code _error;
+	apply_socket_options(socket, options, socket_option_stage::connect, _error);
+	if( _error )
+		spdlog::debug("libgs::http::socket_operation_helper: socket options: {}.", _error);
+}
+
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
 get_option(auto &option, error_code &error) noexcept
 {
 	this->socket().get_option(option, error);
 }
 
-template <core_concepts::execution Exec>
-void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
 get_option(auto &option)
 {
 	error_code error;
@@ -310,28 +328,28 @@ get_option(auto &option)
 		throw system_error(error, "libgs::http::socket_operation_helper::get_option");
 }
 
-template <core_concepts::execution Exec>
-void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
 non_blocking(bool mode, error_code &error) noexcept
 {
 	this->socket().non_blocking(mode, error);
 }
 
-template <core_concepts::execution Exec>
-void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
 non_blocking(bool mode) noexcept
 {
 	this->socket().non_blocking(mode);
 }
 
-template <core_concepts::execution Exec>
-bool socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::non_blocking() const
+template <typename Protocol, core_concepts::execution Exec>
+bool socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::non_blocking() const
 {
 	return this->socket().non_blocking();
 }
 
-template <core_concepts::execution Exec>
-void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::cancel() noexcept
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::cancel() noexcept
 {
 	if( this->socket().is_open() )
 	{
@@ -341,8 +359,8 @@ void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::can
 	}
 }
 
-template <core_concepts::execution Exec>
-void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::close() noexcept
+template <typename Protocol, core_concepts::execution Exec>
+void socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::close() noexcept
 {
 	if( this->socket().is_open() )
 	{
@@ -352,28 +370,73 @@ void socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::clo
 	}
 }
 
-template <core_concepts::execution Exec>
-typename socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::endpoint_t
-socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::remote_endpoint() noexcept
+template <typename Protocol, core_concepts::execution Exec>
+typename socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::endpoint_t
+socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::remote_endpoint() noexcept
 {
 	error_code error; ignore_unused(error);
 	return this->socket().remote_endpoint(error);
 }
 
-template <core_concepts::execution Exec>
-typename socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::endpoint_t
-socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::local_endpoint() noexcept
+template <typename Protocol, core_concepts::execution Exec>
+typename socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::endpoint_t
+socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::local_endpoint() noexcept
 {
 	error_code error; ignore_unused(error);
 	return this->socket().local_endpoint(error);
 }
 
-template <core_concepts::execution Exec>
-bool socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>>::is_open() noexcept
+template <typename Protocol, core_concepts::execution Exec>
+bool socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::is_open() noexcept
 {
 	return this->socket().is_open();
 }
 
+template <typename Protocol, core_concepts::execution Exec>
+peer_credentials socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
+peer_cred(error_code &error) noexcept requires is_local_stream_v<socket_t>
+{
+	peer_credentials result;
+	error = error_code();
+	[[maybe_unused]] auto handle = this->socket().native_handle();
+#if defined(SO_PEERCRED)
+	ucred cred {};
+	socklen_t size = sizeof(cred);
+	if( ::getsockopt(handle, SOL_SOCKET, SO_PEERCRED, &cred, &size) != 0 )
+		error = error_code(errno, std::system_category());
+	else
+	{
+		result.pid = cred.pid;
+		result.uid = cred.uid;
+		result.gid = cred.gid;
+	}
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+	uid_t uid = 0;
+	gid_t gid = 0;
+	if( ::getpeereid(handle, &uid, &gid) != 0 )
+		error = error_code(errno, std::system_category());
+	else
+	{
+		result.uid = uid;
+		result.gid = gid;
+	}
+#else
+	error = std::make_error_code(std::errc::operation_not_supported);
+#endif
+	return result;
+}
+
+template <typename Protocol, core_concepts::execution Exec>
+peer_credentials socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>>::
+peer_cred() requires is_local_stream_v<socket_t>
+{
+	error_code error;
+	auto result = peer_cred(error);
+	if( error )
+		throw system_error(error, "libgs::http::socket_operation_helper::peer_cred");
+	return result;
+}
+
 #ifdef LIBGS_ENABLE_OPENSSL
 
 template <core_concepts::execution Exec>
@@ -438,6 +501,23 @@ connect(endpoint_t ep, Token &&token)
 	}
 }
 
+template <core_concepts::execution Exec>
+void socket_operation_helper<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>>::
+open(const endpoint_t &ep, const socket_options &options, error_code &error) noexcept
+{
+	auto &socket = this->socket().next_layer();
+	if( not socket.is_open() )
+	{
+		socket.open(ep.protocol(), error);
+		if( error )
+			return ;
+	}
+	error_code _error;
+	apply_socket_options(socket, options, socket_option_stage::connect, _error);
+	if( _error )
+		spdlog::debug("libgs::http::socket_operation_helper: socket options: {}.", _error);
+}
+
 template <core_concepts::execution Exec>
 void socket_operation_helper<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>>::
 get_option(auto &option, error_code &error) noexcept
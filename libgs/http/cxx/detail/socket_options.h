@@ -0,0 +1,149 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_CXX_DETAIL_SOCKET_OPTIONS_H
+#define LIBGS_HTTP_CXX_DETAIL_SOCKET_OPTIONS_H
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+template <int Level, int Name>
+using bool_socket_option = asio::detail::socket_option::boolean<Level,Name>;
+
+template <int Level, int Name>
+using int_socket_option = asio::detail::socket_option::integer<Level,Name>;
+
+} //namespace detail
+
+inline socket_options socket_options::low_latency() noexcept
+{
+	socket_options options;
+	options.no_delay = true;
+	options.quick_ack = true;
+	options.reuse_address = true;
+	return options;
+}
+
+template <typename Socket>
+void apply_socket_options
+(Socket &socket, const socket_options &options, socket_option_stage stage, error_code &error) noexcept
+{
+	error = error_code();
+	auto set_option = [&](const auto &option)
+	{
+		error_code _error;
+		socket.set_option(option, _error);
+		if( _error and not error )
+			error = _error;
+	};
+	using stage_t = socket_option_stage;
+
+	// Unix domain sockets only take the buffer sizes.
+	if constexpr( std::is_same_v<typename Socket::protocol_type, asio::ip::tcp> )
+	{
+		if( stage == stage_t::listen )
+		{
+			if( options.reuse_address )
+				set_option(asio::socket_base::reuse_address(*options.reuse_address));
+#ifdef SO_REUSEPORT
+			if( options.reuse_port )
+				set_option(detail::bool_socket_option<SOL_SOCKET,SO_REUSEPORT>(*options.reuse_port));
+#endif //SO_REUSEPORT
+#ifdef TCP_DEFER_ACCEPT
+			if( options.defer_accept )
+				set_option(detail::int_socket_option<IPPROTO_TCP,TCP_DEFER_ACCEPT>(*options.defer_accept));
+#endif //TCP_DEFER_ACCEPT
+#ifdef TCP_FASTOPEN
+			if( options.fast_open )
+				set_option(detail::int_socket_option<IPPROTO_TCP,TCP_FASTOPEN>(*options.fast_open));
+#endif //TCP_FASTOPEN
+		}
+		else
+		{
+			if( options.no_delay )
+				set_option(asio::ip::tcp::no_delay(*options.no_delay));
+			if( options.keep_alive )
+				set_option(asio::socket_base::keep_alive(*options.keep_alive));
+#ifdef TCP_QUICKACK
+			if( options.quick_ack )
+				set_option(detail::bool_socket_option<IPPROTO_TCP,TCP_QUICKACK>(*options.quick_ack));
+#endif //TCP_QUICKACK
+#ifdef SO_BUSY_POLL
+			if( options.busy_poll )
+				set_option(detail::int_socket_option<SOL_SOCKET,SO_BUSY_POLL>(*options.busy_poll));
+#endif //SO_BUSY_POLL
+#ifdef TCP_FASTOPEN_CONNECT
+			if( stage == stage_t::connect and options.fast_open )
+				set_option(detail::bool_socket_option<IPPROTO_TCP,TCP_FASTOPEN_CONNECT>(*options.fast_open > 0));
+#endif //TCP_FASTOPEN_CONNECT
+		}
+	}
+
+	// Accepted sockets inherit the buffer sizes of the listener.
+	if( stage != stage_t::accept )
+	{
+		if( options.receive_buffer_size )
+			set_option(asio::socket_base::receive_buffer_size(*options.receive_buffer_size));
+		if( options.send_buffer_size )
+			set_option(asio::socket_base::send_buffer_size(*options.send_buffer_size));
+	}
+}
+
+template <typename Socket>
+void apply_socket_options(Socket &socket, const socket_options &options, socket_option_stage stage)
+{
+	error_code error;
+	apply_socket_options(socket, options, stage, error);
+	if( error )
+		throw system_error(error, "libgs::http::apply_socket_options");
+}
+
+template <typename Socket>
+void rearm_quick_ack(Socket &socket, const socket_options &options) noexcept
+{
+#ifdef TCP_QUICKACK
+	if constexpr( std::is_same_v<typename Socket::protocol_type, asio::ip::tcp> )
+	{
+		if( options.quick_ack.value_or(false) )
+		{
+			error_code error;
+			socket.set_option(detail::bool_socket_option<IPPROTO_TCP,TCP_QUICKACK>(true), error);
+		}
+	}
+#else
+	ignore_unused(socket, options);
+#endif //TCP_QUICKACK
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_CXX_DETAIL_SOCKET_OPTIONS_H
@@ -31,6 +31,7 @@
 
 #include <libgs/http/cxx/attributes.h>
 #include <libgs/http/cxx/concepts.h>
+#include <libgs/core/async_file.h>
 #include <fstream>
 
 namespace libgs::http
@@ -236,6 +237,68 @@ struct LIBGS_HTTP_TAPI file_opt_token<FS&,file_optype::multiple> : file_opt_toke
 	file_opt_token &operator=(const file_opt_token&) = default;
 };
 
+// Non-blocking variants, only the coroutine paths (co_send_file, co_save_file) accept them.
+// An unopened file is opened by init() from 'file_name'.
+template <>
+struct LIBGS_HTTP_VAPI file_opt_token<async_file,file_optype::single>
+{
+	using type = async_file;
+	using path_t = std::filesystem::path;
+	using fstream_t = async_file;
+	using pos_t = uint64_t;
+
+	static constexpr auto permissions = io_permission::read_write;
+	static constexpr auto optype = file_optype::single;
+
+	std::shared_ptr<fstream_t> stream;
+	path_t file_name;
+	std::optional<file_range> range;
+
+	file_opt_token(fstream_t &&stream);
+	file_opt_token(fstream_t &&stream, const file_range &range);
+	~file_opt_token();
+
+	[[nodiscard]] error_code init(std::ios_base::openmode mode) noexcept;
+
+	file_opt_token(file_opt_token&&) = default;
+	file_opt_token(const file_opt_token&) = default;
+	file_opt_token &operator=(file_opt_token&&) = default;
+	file_opt_token &operator=(const file_opt_token&) = default;
+};
+
+template <>
+struct LIBGS_HTTP_VAPI file_opt_token<async_file,file_optype::multiple>
+{
+	using type = async_file;
+	using path_t = std::filesystem::path;
+	using fstream_t = async_file;
+	using pos_t = uint64_t;
+
+	static constexpr auto permissions = io_permission::read_write;
+	static constexpr auto optype = file_optype::multiple;
+
+	std::shared_ptr<fstream_t> stream;
+	path_t file_name;
+	file_ranges ranges;
+
+	file_opt_token(fstream_t &&stream);
+	file_opt_token(fstream_t &&stream, const file_range &range);
+	file_opt_token(fstream_t &&stream, file_ranges ranges);
+
+	template <concepts::file_ranges_init_list...Args>
+	file_opt_token(fstream_t &&stream, Args&&...ranges);
+
+	file_opt_token(file_opt_token<type,file_optype::single> opt);
+	~file_opt_token();
+
+	[[nodiscard]] error_code init(std::ios_base::openmode mode) noexcept;
+
+	file_opt_token(file_opt_token&&) = default;
+	file_opt_token(const file_opt_token&) = default;
+	file_opt_token &operator=(file_opt_token&&) = default;
+	file_opt_token &operator=(const file_opt_token&) = default;
+};
+
 template <core_concepts::char_type CharT, typename...Args>
 [[nodiscard]] LIBGS_HTTP_TAPI auto make_file_opt_token (
 	CharT file_name, Args&&...args
@@ -251,6 +314,11 @@ template <typename...Args>
 	core_concepts::fstream_wkn auto &&stream, Args&&...args
 ) noexcept;
 
+template <typename...Args>
+[[nodiscard]] LIBGS_HTTP_TAPI auto make_file_opt_token (
+	async_file &&file, Args&&...args
+) noexcept;
+
 template <core_concepts::char_type, typename>
 struct is_basic_file_opt_token : std::false_type {};
 
@@ -268,6 +336,25 @@ struct is_basic_file_opt_token<CharT,file_opt_token<T,file_optype::multiple>>
 		std::is_same_v<CharT, typename file_opt_token<T,file_optype::single>::fstream_t::char_type>;
 };
 
+template <core_concepts::char_type CharT>
+struct is_basic_file_opt_token<CharT,file_opt_token<async_file,file_optype::single>> {
+	static constexpr bool value = std::is_same_v<CharT,char>;
+};
+
+template <core_concepts::char_type CharT>
+struct is_basic_file_opt_token<CharT,file_opt_token<async_file,file_optype::multiple>> {
+	static constexpr bool value = std::is_same_v<CharT,char>;
+};
+
+template <typename T>
+struct is_async_file_opt_token : std::false_type {};
+
+template <file_optype::type Type>
+struct is_async_file_opt_token<file_opt_token<async_file,Type>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_async_file_opt_token_v = is_async_file_opt_token<T>::value;
+
 template <core_concepts::char_type CharT, typename T>
 constexpr bool is_basic_file_opt_token_v = is_basic_file_opt_token<CharT,T>::value;
 
@@ -328,6 +415,7 @@ template <typename T, typename CharT,
 concept basic_file_opt_token_arg =
 	core_concepts::weak_string_type<T> or
 	!!(io_permissions_v<std::remove_cvref_t<T>> & Perms) or
+	(std::is_same_v<T,async_file> and std::is_same_v<CharT,char>) or
 	basic_file_opt_token<T,CharT,Types,Perms>;
 
 template <typename T,
@@ -357,7 +445,7 @@ concept file_opt_token_arg =
 	io_permission::type mode = io_permission::read_write
 );
 
-[[nodiscard]] LIBGS_CORE_TAPI std::string mime_type(
+[[nodiscard]] LIBGS_CORE_TAPI std::string_view mime_type(
 	concepts::file_opt_token auto &opt
 );
 
@@ -370,6 +458,9 @@ namespace operators
 [[nodiscard]] LIBGS_HTTP_TAPI auto operator| (core_concepts::fstream_wkn auto &&stream, const file_range &range);
 [[nodiscard]] LIBGS_HTTP_TAPI auto operator| (core_concepts::fstream_wkn auto &&stream, file_ranges ranges);
 
+[[nodiscard]] LIBGS_HTTP_VAPI auto operator| (async_file &&file, const file_range &range);
+[[nodiscard]] LIBGS_HTTP_VAPI auto operator| (async_file &&file, file_ranges ranges);
+
 template <typename T>
 [[nodiscard]] LIBGS_HTTP_TAPI file_opt_token<T,file_optype::multiple> operator|
 (file_opt_token<T,file_optype::single> opt, const file_range &range);
@@ -30,6 +30,7 @@
 #define LIBGS_HTTP_CXX_SOCKET_OPERATION_HELPER_H
 
 #include <libgs/http/cxx/opt_token.h>
+#include <libgs/http/cxx/socket_options.h>
 
 namespace libgs::http
 {
@@ -37,6 +38,14 @@ namespace libgs::http
 template <concepts::stream Stream>
 class socket_operation_helper;
 
+// Of the process on the other end of a Unix domain socket, 'pid' is 0 if the platform does not tell.
+struct LIBGS_HTTP_VAPI peer_credentials
+{
+	int64_t pid = 0;
+	uint32_t uid = 0;
+	uint32_t gid = 0;
+};
+
 template <concepts::stream Stream>
 class LIBGS_HTTP_TAPI socket_operation_helper_base
 {
@@ -68,15 +77,15 @@ private:
 	impl *m_impl;
 };
 
-template <core_concepts::execution Exec>
-class LIBGS_HTTP_TAPI socket_operation_helper<asio::basic_stream_socket<asio::ip::tcp,Exec>> :
-	public socket_operation_helper_base<asio::basic_stream_socket<asio::ip::tcp,Exec>>
+template <typename Protocol, core_concepts::execution Exec>
+class LIBGS_HTTP_TAPI socket_operation_helper<asio::basic_stream_socket<Protocol,Exec>> :
+	public socket_operation_helper_base<asio::basic_stream_socket<Protocol,Exec>>
 {
 	LIBGS_DISABLE_COPY_MOVE(socket_operation_helper)
 
 public:
 	using base_t = socket_operation_helper_base<
-		asio::basic_stream_socket<asio::ip::tcp,Exec>
+		asio::basic_stream_socket<Protocol,Exec>
 	>;
 	using base_t::base_t;
 
@@ -88,6 +97,10 @@ public:
 	template <core_concepts::opt_token<error_code> Token = use_sync_t>
 	[[nodiscard]] auto connect(endpoint_t ep, Token &&token = {});
 
+	// Opens the socket for 'ep' if needed and applies the connect stage of 'options',
+	// an option that can not be set is not an error.
+	void open(const endpoint_t &ep, const socket_options &options, error_code &error) noexcept;
+
 	void get_option(auto &option, error_code &error) noexcept;
 	void get_option(auto &option);
 
@@ -102,6 +115,10 @@ public:
 	[[nodiscard]] endpoint_t remote_endpoint() noexcept;
 	[[nodiscard]] endpoint_t local_endpoint() noexcept;
 	[[nodiscard]] bool is_open() noexcept;
+
+public:
+	[[nodiscard]] peer_credentials peer_cred(error_code &error) noexcept requires is_local_stream_v<socket_t>;
+	[[nodiscard]] peer_credentials peer_cred() requires is_local_stream_v<socket_t>;
 };
 
 #ifdef LIBGS_ENABLE_OPENSSL
@@ -126,6 +143,10 @@ public:
 	template <core_concepts::opt_token<error_code> Token = use_sync_t>
 	void connect(endpoint_t endpoint, Token &&token = {});
 
+	// Opens the socket for 'ep' if needed and applies the connect stage of 'options',
+	// an option that can not be set is not an error.
+	void open(const endpoint_t &ep, const socket_options &options, error_code &error) noexcept;
+
 	void get_option(auto &option, error_code &error) noexcept;
 	void get_option(auto &option);
 
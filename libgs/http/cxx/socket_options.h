@@ -0,0 +1,97 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_CXX_SOCKET_OPTIONS_H
+#define LIBGS_HTTP_CXX_SOCKET_OPTIONS_H
+
+#include <libgs/http/global.h>
+#include <optional>
+
+namespace libgs::http
+{
+
+// Unset options keep the system default. Options the platform lacks are skipped.
+struct LIBGS_HTTP_VAPI socket_options
+{
+	std::optional<bool> no_delay {};
+	std::optional<bool> keep_alive {};
+
+	// Linux drops TCP_QUICKACK again on its own, see rearm_quick_ack.
+	std::optional<bool> quick_ack {};
+
+	// Listener only.
+	std::optional<bool> reuse_address {};
+	std::optional<bool> reuse_port {};
+
+	// Set on the listener, accepted sockets inherit them.
+	std::optional<int> receive_buffer_size {};
+	std::optional<int> send_buffer_size {};
+
+	// SO_BUSY_POLL, in microseconds.
+	std::optional<int> busy_poll {};
+
+	// TCP_DEFER_ACCEPT, in seconds (listener).
+	std::optional<int> defer_accept {};
+
+	// TCP_FASTOPEN: the pending queue length on a listener, enables TCP_FASTOPEN_CONNECT
+	// on a client when greater than 0.
+	std::optional<int> fast_open {};
+
+	int backlog = asio::socket_base::max_listen_connections;
+
+	// TCP_NODELAY, TCP_QUICKACK and SO_REUSEADDR.
+	[[nodiscard]] static socket_options low_latency() noexcept;
+};
+
+enum class socket_option_stage
+{
+	listen,  // Acceptor, before bind.
+	accept,  // Accepted socket.
+	connect  // Client socket, opened but not connected yet.
+};
+
+// Applies what belongs to 'stage', the first failure is reported but the rest are still applied.
+template <typename Socket>
+void apply_socket_options (
+	Socket &socket, const socket_options &options, socket_option_stage stage, error_code &error
+) noexcept;
+
+template <typename Socket>
+void apply_socket_options(Socket &socket, const socket_options &options, socket_option_stage stage);
+
+// TCP_QUICKACK is not permanent, the kernel leaves quick-ack mode by itself after a while.
+// The server calls this after every HTTP/1.1 read (one setsockopt) to keep it in effect;
+// HTTP/2 connections only get it at accept. Does nothing unless 'quick_ack' is true.
+template <typename Socket>
+void rearm_quick_ack(Socket &socket, const socket_options &options) noexcept;
+
+} //namespace libgs::http
+#include <libgs/http/cxx/detail/socket_options.h>
+
+
+#endif //LIBGS_HTTP_CXX_SOCKET_OPTIONS_H
@@ -51,7 +51,7 @@ public:
 
 template <core_concepts::char_type CharT, version_t Version>
 basic_helper_base<CharT,Version>::basic_helper_base() :
-	m_impl(new impl())
+	m_impl(arena::make<impl>())
 {
 
 }
@@ -59,14 +59,14 @@ basic_helper_base<CharT,Version>::basic_helper_base() :
 template <core_concepts::char_type CharT, version_t Version>
 basic_helper_base<CharT,Version>::~basic_helper_base()
 {
-	delete m_impl;
+
 }
 
 template <core_concepts::char_type CharT, version_t Version>
 basic_helper_base<CharT,Version>::basic_helper_base(basic_helper_base &&other) noexcept :
-	m_impl(other.m_impl)
+	m_impl(std::move(other.m_impl))
 {
-	other.m_impl = new impl();
+
 }
 
 template <core_concepts::char_type CharT, version_t Version>
@@ -74,9 +74,7 @@ basic_helper_base<CharT,Version> &basic_helper_base<CharT,Version>::operator=(ba
 {
 	if( this == &other )
 		return *this;
-	delete m_impl;
-	m_impl = other.m_impl;
-	other.m_impl = new impl();
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
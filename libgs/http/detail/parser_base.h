@@ -83,9 +83,8 @@ public:
 					error = make_error_code(parse_errno::HLTL);
 				break;
 			}
-			auto line_buf = m_src_buf.substr(0, pos);
-			m_src_buf.erase(0, pos + 2);
-
+			// The line is a view into the buffer, so it is consumed only after it has been handled.
+			std::string_view line_buf(m_src_buf.data(), pos);
 			if( m_state == state::waiting_request )
 			{
 				if( not m_parse_begin )
@@ -101,31 +100,32 @@ public:
 			}
 			else if( m_state == state::reading_headers )
 			{
-				if( state_handler_reading_headers(line_buf, error) )
-					return true;
-				else if( error )
+				if( line_buf.empty() )
+				{
+					m_src_buf.erase(0, 2);
+					return set_read_body_state(error);
+				}
+				state_handler_reading_headers(line_buf, error);
+				if( error )
 					break;
 			}
+			m_src_buf.erase(0, pos + 2);
 		}
 		while( not m_src_buf.empty() );
 		return false;
 	}
 
-	[[nodiscard]] bool state_handler_reading_headers(std::string_view line_buf, error_code &error)
+	void state_handler_reading_headers(std::string_view line_buf, error_code &error)
 	{
-		if( line_buf.empty() )
-			return set_read_body_state(error);
-
 		auto colon_index = line_buf.find(':');
 		if( colon_index == std::string::npos )
 		{
 			reset();
 			error = make_error_code(parse_errno::IHL);
-			return false;
+			return ;
 		}
 		header_insert(str_to_lower(str_trimmed(line_buf.substr(0, colon_index))),
 					  from_percent_encoding(str_trimmed(line_buf.substr(colon_index + 1))), error);
-		return false;
 	}
 
 	bool set_read_body_state(error_code &error)
@@ -157,7 +157,7 @@ public:
 		auto rsize = m_partial_body.size() + m_src_buf.size();
 		rsize = rsize > m_content_length ? m_content_length - m_partial_body.size() : m_src_buf.size();
 
-		m_partial_body += std::string(m_src_buf.c_str(), rsize);
+		m_partial_body.append(m_src_buf.data(), rsize);
 		m_src_buf.clear();
 
 		m_state = m_content_length > m_partial_body.size() ? state::reading_length : state::finished;
@@ -174,16 +174,11 @@ public:
 					error = make_error_code(parse_errno::HLTL);
 				break;
 			}
-			auto line_buf = m_src_buf.substr(0, pos + 2);
-			m_src_buf.erase(0, pos + 2);
-
+			std::string_view line_buf(m_src_buf.data(), pos + 2);
 			if( m_state == state::chunked_wait_size )
 			{
-				line_buf.erase(pos);
-				pos = line_buf.find(';');
-
-				if( pos != std::string::npos )
-					line_buf.erase(pos);
+				line_buf = line_buf.substr(0, pos);
+				line_buf = line_buf.substr(0, line_buf.find(';'));
 
 				if( line_buf.size() > 16 )
 				{
@@ -201,7 +196,7 @@ public:
 			}
 			else if( m_state == state::chunked_wait_content )
 			{
-				line_buf.erase(pos);
+				line_buf = line_buf.substr(0, pos);
 				if( _size < line_buf.size() )
 					_size = line_buf.size();
 				else
@@ -225,6 +220,7 @@ public:
 				header_insert(str_to_lower(str_trimmed(line_buf.substr(0, colon_index))),
 							  from_percent_encoding(str_trimmed(line_buf.substr(colon_index + 1))), error);
 			}
+			m_src_buf.erase(0, pos + 2);
 		}
 		while( not m_src_buf.empty() );
 		return false;
@@ -292,7 +288,7 @@ public:
 		finished
 	}
 	m_state = state::waiting_request;
-	std::string m_src_buf;
+	std::pmr::string m_src_buf {arena::current()};
 
 	version_t m_version;
 	headers_t m_headers;
@@ -306,7 +302,7 @@ public:
 
 template <core_concepts::char_type CharT>
 basic_parser_base<CharT>::basic_parser_base(size_t init_buf_size) :
-	m_impl(new impl(init_buf_size))
+	m_impl(arena::make<impl>(init_buf_size))
 {
 
 }
@@ -314,14 +310,14 @@ basic_parser_base<CharT>::basic_parser_base(size_t init_buf_size) :
 template <core_concepts::char_type CharT>
 basic_parser_base<CharT>::~basic_parser_base()
 {
-	delete m_impl;
+
 }
 
 template <core_concepts::char_type CharT>
 basic_parser_base<CharT>::basic_parser_base(basic_parser_base &&other) noexcept :
-	m_impl(other.m_impl)
+	m_impl(std::move(other.m_impl))
 {
-	other.m_impl = new impl(0xFFFF);
+
 }
 
 template <core_concepts::char_type CharT>
@@ -329,9 +325,7 @@ basic_parser_base<CharT> &basic_parser_base<CharT>::operator=(basic_parser_base
 {
 	if( this == &other )
 		return *this;
-	delete m_impl;
-	m_impl = other.m_impl;
-	other.m_impl = new impl(0xFFFF);
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
@@ -359,10 +353,8 @@ template <core_concepts::char_type CharT>
 bool basic_parser_base<CharT>::append(const const_buffer &buf, error_code &error)
 {
 	using state = typename impl::state;
-	std::string str_buf(reinterpret_cast<const char*>(buf.data()), buf.size());
-
 	error = error_code();
-	if( str_buf.empty() )
+	if( buf.size() == 0 )
 	{
 		error = make_error_code(parse_errno::IDE);
 		return false;
@@ -372,7 +364,7 @@ bool basic_parser_base<CharT>::append(const const_buffer &buf, error_code &error
 		error = make_error_code(parse_errno::RE);
 		return false;
 	}
-	m_impl->m_src_buf.append(std::move(str_buf));
+	m_impl->m_src_buf.append(static_cast<const char*>(buf.data()), buf.size());
 	if( m_impl->m_state <= state::reading_headers )
 		return m_impl->parse_header(error);
 
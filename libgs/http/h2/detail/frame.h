@@ -0,0 +1,207 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_H2_DETAIL_FRAME_H
+#define LIBGS_HTTP_H2_DETAIL_FRAME_H
+
+#include <libgs/core/algorithm/base64.h>
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+class h2_error_category : public std::error_category
+{
+	LIBGS_DISABLE_COPY_MOVE(h2_error_category)
+
+public:
+	h2_error_category() = default;
+	[[nodiscard]] const char *name() const noexcept override {
+		return "libgs::http::h2_error";
+	}
+	[[nodiscard]] std::string message(int code) const override
+	{
+		switch(static_cast<h2_errno>(code))
+		{
+#define X_MACRO(e,v,d) case h2_errno::e: return d;
+			LIBGS_HTTP_H2_ERRNO
+#undef X_MACRO
+			default: break;
+		}
+		return "Unknown error.";
+	}
+	inline static h2_error_category &instance()
+	{
+		static h2_error_category category;
+		return category;
+	}
+};
+
+} //namespace detail
+
+inline void h2_frame::encode_header(const h2_frame_header &header, header_buffer_t &buf) noexcept
+{
+	buf[0] = static_cast<uint8_t>(header.length >> 16);
+	buf[1] = static_cast<uint8_t>(header.length >> 8);
+	buf[2] = static_cast<uint8_t>(header.length);
+	buf[3] = static_cast<uint8_t>(header.type);
+	buf[4] = header.flags;
+
+	const auto stream_id = header.stream_id & 0x7FFFFFFF;
+	buf[5] = static_cast<uint8_t>(stream_id >> 24);
+	buf[6] = static_cast<uint8_t>(stream_id >> 16);
+	buf[7] = static_cast<uint8_t>(stream_id >> 8);
+	buf[8] = static_cast<uint8_t>(stream_id);
+}
+
+inline void h2_frame::encode_header(const h2_frame_header &header, std::string &buf)
+{
+	header_buffer_t tmp;
+	encode_header(header, tmp);
+	buf.append(reinterpret_cast<const char*>(tmp.data()), tmp.size());
+}
+
+inline h2_frame_header h2_frame::decode_header(const header_buffer_t &buf) noexcept
+{
+	h2_frame_header header;
+	header.length = (buf[0] << 16) | (buf[1] << 8) | buf[2];
+	header.type = static_cast<h2_frame_type>(buf[3]);
+	header.flags = buf[4];
+	header.stream_id = decode_uint32(buf.data() + 5) & 0x7FFFFFFF;
+	return header;
+}
+
+inline void h2_frame::encode_setting(h2_setting_id id, uint32_t value, std::string &buf)
+{
+	const auto _id = static_cast<uint16_t>(id);
+	buf += static_cast<char>(_id >> 8);
+	buf += static_cast<char>(_id);
+	encode_uint32(value, buf);
+}
+
+inline void h2_frame::apply_settings(const const_buffer &payload, h2_settings &settings, error_code &error) noexcept
+{
+	error = error_code();
+	if( payload.size() % 6 != 0 )
+	{
+		error = make_error_code(h2_errno::FSZ);
+		return ;
+	}
+	const auto *data = static_cast<const uint8_t*>(payload.data());
+	for(size_t i=0; i<payload.size(); i+=6)
+	{
+		const auto id = static_cast<h2_setting_id>((data[i] << 8) | data[i+1]);
+		const auto value = decode_uint32(data + i + 2);
+		switch(id)
+		{
+			case h2_setting_id::header_table_size:
+				settings.header_table_size = value;
+				break;
+			case h2_setting_id::enable_push:
+				if( value > 1 )
+				{
+					error = make_error_code(h2_errno::PROTO);
+					return ;
+				}
+				settings.enable_push = value == 1;
+				break;
+			case h2_setting_id::max_concurrent_streams:
+				settings.max_concurrent_streams = value;
+				break;
+			case h2_setting_id::initial_window_size:
+				if( value > max_window_size )
+				{
+					error = make_error_code(h2_errno::FLOW);
+					return ;
+				}
+				settings.initial_window_size = value;
+				break;
+			case h2_setting_id::max_frame_size:
+				if( value < min_frame_size or value > max_frame_size )
+				{
+					error = make_error_code(h2_errno::PROTO);
+					return ;
+				}
+				settings.max_frame_size = value;
+				break;
+			case h2_setting_id::max_header_list_size:
+				settings.max_header_list_size = value;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+inline std::string h2_frame::decode_settings_header(std::string_view value, error_code &error)
+{
+	// token68 in base64url, the padding is usually left out (RFC 7540 section 3.2.1).
+	auto result = from_base64(value, error, base64_alphabet::url_safe);
+	if( error )
+		error = make_error_code(h2_errno::PROTO);
+	return result;
+}
+
+inline void h2_frame::encode_uint32(uint32_t value, std::string &buf)
+{
+	buf += static_cast<char>(value >> 24);
+	buf += static_cast<char>(value >> 16);
+	buf += static_cast<char>(value >> 8);
+	buf += static_cast<char>(value);
+}
+
+inline uint32_t h2_frame::decode_uint32(const void *data) noexcept
+{
+	const auto *ptr = static_cast<const uint8_t*>(data);
+	return (static_cast<uint32_t>(ptr[0]) << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3];
+}
+
+inline uint32_t h2_frame::wire_code(h2_errno errc) noexcept
+{
+	return static_cast<uint32_t>(errc) - static_cast<uint32_t>(h2_errno::NOE);
+}
+
+inline h2_errno h2_frame::from_wire_code(uint32_t code) noexcept
+{
+	// Unknown codes must not trigger special behavior (RFC 9113 section 7).
+	if( code > wire_code(h2_errno::H11) )
+		return h2_errno::INTL;
+	return static_cast<h2_errno>(code + static_cast<uint32_t>(h2_errno::NOE));
+}
+
+inline error_code h2_frame::make_error_code(h2_errno errc)
+{
+	return {static_cast<int>(errc), detail::h2_error_category::instance()};
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_H2_DETAIL_FRAME_H
@@ -0,0 +1,471 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_H2_DETAIL_HPACK_H
+#define LIBGS_HTTP_H2_DETAIL_HPACK_H
+
+#include <libgs/http/h2/detail/hpack_table.h>
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+constexpr size_t hpack_entry_overhead = 32;
+constexpr size_t hpack_static_table_size = std::size(hpack_static_table);
+constexpr size_t hpack_encoder_max_table_size = 4096;
+
+[[nodiscard]] inline bool hpack_indexable(std::string_view name) noexcept
+{
+	// Fields whose values rarely repeat would only churn the dynamic table.
+	constexpr std::string_view names[] {
+		":path", "age", "content-length", "content-range", "date",
+		"etag", "expires", "last-modified", "location", "set-cookie"
+	};
+	return std::ranges::find(names, name) == std::end(names);
+}
+
+} //namespace detail
+
+inline hpack_decoder::hpack_decoder(size_t max_table_size) :
+	m_capacity(max_table_size),
+	m_max_size(max_table_size)
+{
+
+}
+
+inline void hpack_decoder::decode(const const_buffer &block, hpack_fields &fields, error_code &error)
+{
+	error = error_code();
+	const auto *begin = static_cast<const uint8_t*>(block.data());
+	const auto *end = begin + block.size();
+	bool field_decoded = false;
+
+	auto compression_error = [&]
+	{
+		error = h2_frame::make_error_code(h2_errno::COMP);
+	};
+	while( begin < end )
+	{
+		const uint8_t byte = *begin;
+		if( byte & 0x80 )
+		{
+			// Indexed header field.
+			auto index = hpack::decode_integer(begin, end, 7, error);
+			if( error )
+				return ;
+
+			std::string_view name, value;
+			if( not lookup(index, name, value) )
+				return compression_error();
+
+			fields.emplace_back(std::string(name), std::string(value));
+			field_decoded = true;
+			continue;
+		}
+		else if( (byte & 0xE0) == 0x20 )
+		{
+			// Dynamic table size update, only allowed at the beginning of a block.
+			if( field_decoded )
+				return compression_error();
+
+			auto size = hpack::decode_integer(begin, end, 5, error);
+			if( error )
+				return ;
+			else if( size > m_max_size )
+				return compression_error();
+
+			m_capacity = size;
+			evict(m_capacity);
+			continue;
+		}
+		const bool incremental = byte & 0x40;
+		const bool sensitive = not incremental and (byte & 0x10);
+
+		auto index = hpack::decode_integer(begin, end, incremental ? 6 : 4, error);
+		if( error )
+			return ;
+
+		hpack_field field;
+		field.sensitive = sensitive;
+		if( index == 0 )
+		{
+			field.name = hpack::decode_string(begin, end, error);
+			if( error )
+				return ;
+		}
+		else
+		{
+			std::string_view name, value;
+			if( not lookup(index, name, value) )
+				return compression_error();
+			field.name = name;
+		}
+		field.value = hpack::decode_string(begin, end, error);
+		if( error )
+			return ;
+
+		if( incremental )
+			insert(field.name, field.value);
+		fields.emplace_back(std::move(field));
+		field_decoded = true;
+	}
+}
+
+inline void hpack_decoder::set_max_table_size(size_t size) noexcept
+{
+	m_max_size = size;
+	if( m_capacity > size )
+	{
+		m_capacity = size;
+		evict(size);
+	}
+}
+
+inline size_t hpack_decoder::max_table_size() const noexcept
+{
+	return m_max_size;
+}
+
+inline size_t hpack_decoder::table_size() const noexcept
+{
+	return m_size;
+}
+
+inline bool hpack_decoder::lookup(size_t index, std::string_view &name, std::string_view &value) const noexcept
+{
+	if( index == 0 )
+		return false;
+
+	else if( index <= detail::hpack_static_table_size )
+	{
+		auto &entry = detail::hpack_static_table[index - 1];
+		name = entry.name;
+		value = entry.value;
+		return true;
+	}
+	index -= detail::hpack_static_table_size + 1;
+	if( index >= m_table.size() )
+		return false;
+
+	auto &entry = m_table[index];
+	name = entry.name;
+	value = entry.value;
+	return true;
+}
+
+inline void hpack_decoder::insert(std::string name, std::string value)
+{
+	const auto size = name.size() + value.size() + detail::hpack_entry_overhead;
+	if( size > m_capacity )
+	{
+		m_table.clear();
+		m_size = 0;
+		return ;
+	}
+	evict(m_capacity - size);
+	m_table.emplace_front(std::move(name), std::move(value));
+	m_size += size;
+}
+
+inline void hpack_decoder::evict(size_t capacity)
+{
+	while( m_size > capacity and not m_table.empty() )
+	{
+		auto &entry = m_table.back();
+		m_size -= entry.name.size() + entry.value.size() + detail::hpack_entry_overhead;
+		m_table.pop_back();
+	}
+}
+
+inline hpack_encoder::hpack_encoder(size_t max_table_size) :
+	m_capacity(std::min(max_table_size, detail::hpack_encoder_max_table_size))
+{
+
+}
+
+inline void hpack_encoder::encode(std::string_view name, std::string_view value, std::string &buf, bool sensitive)
+{
+	if( m_size_update )
+	{
+		hpack::encode_integer(m_capacity, 5, 0x20, buf);
+		m_size_update = false;
+	}
+	size_t name_index = 0;
+	for(size_t i=0; i<detail::hpack_static_table_size; i++)
+	{
+		auto &entry = detail::hpack_static_table[i];
+		if( entry.name != name )
+			continue;
+		else if( not sensitive and entry.value == value )
+			return hpack::encode_integer(i + 1, 7, 0x80, buf);
+		else if( name_index == 0 )
+			name_index = i + 1;
+	}
+	if( not sensitive )
+	{
+		for(size_t i=0; i<m_table.size(); i++)
+		{
+			auto &entry = m_table[i];
+			if( entry.name != name )
+				continue;
+			else if( entry.value == value )
+				return hpack::encode_integer(detail::hpack_static_table_size + 1 + i, 7, 0x80, buf);
+			else if( name_index == 0 )
+				name_index = detail::hpack_static_table_size + 1 + i;
+		}
+	}
+	bool incremental = false;
+	if( sensitive )
+		hpack::encode_integer(name_index, 4, 0x10, buf);
+
+	else if( detail::hpack_indexable(name) and
+			 name.size() + value.size() + detail::hpack_entry_overhead <= m_capacity )
+	{
+		hpack::encode_integer(name_index, 6, 0x40, buf);
+		incremental = true;
+	}
+	else
+		hpack::encode_integer(name_index, 4, 0x00, buf);
+
+	if( name_index == 0 )
+		hpack::encode_string(name, buf);
+	hpack::encode_string(value, buf);
+
+	if( incremental )
+		insert(name, value);
+}
+
+inline void hpack_encoder::set_max_table_size(size_t size) noexcept
+{
+	size = std::min(size, detail::hpack_encoder_max_table_size);
+	if( size == m_capacity )
+		return ;
+
+	m_capacity = size;
+	m_size_update = true;
+	evict(size);
+}
+
+inline size_t hpack_encoder::table_size() const noexcept
+{
+	return m_size;
+}
+
+inline void hpack_encoder::insert(std::string_view name, std::string_view value)
+{
+	const auto size = name.size() + value.size() + detail::hpack_entry_overhead;
+	evict(m_capacity - size);
+	m_table.emplace_front(std::string(name), std::string(value));
+	m_size += size;
+}
+
+inline void hpack_encoder::evict(size_t capacity)
+{
+	while( m_size > capacity and not m_table.empty() )
+	{
+		auto &entry = m_table.back();
+		m_size -= entry.name.size() + entry.value.size() + detail::hpack_entry_overhead;
+		m_table.pop_back();
+	}
+}
+
+namespace hpack
+{
+
+inline void encode_integer(size_t value, uint8_t prefix_bits, uint8_t flags, std::string &buf)
+{
+	const size_t max_prefix = (size_t(1) << prefix_bits) - 1;
+	if( value < max_prefix )
+	{
+		buf += static_cast<char>(flags | value);
+		return ;
+	}
+	buf += static_cast<char>(flags | max_prefix);
+	value -= max_prefix;
+
+	while( value >= 0x80 )
+	{
+		buf += static_cast<char>((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	buf += static_cast<char>(value);
+}
+
+inline size_t decode_integer(const uint8_t *&begin, const uint8_t *end, uint8_t prefix_bits, error_code &error)
+{
+	error = error_code();
+	if( begin >= end )
+	{
+		error = h2_frame::make_error_code(h2_errno::COMP);
+		return 0;
+	}
+	const size_t max_prefix = (size_t(1) << prefix_bits) - 1;
+	size_t value = *begin++ & max_prefix;
+	if( value < max_prefix )
+		return value;
+
+	for(size_t shift=0;; shift+=7)
+	{
+		// More than 4 continuation bytes can't be a sane length or index.
+		if( begin >= end or shift > 28 )
+		{
+			error = h2_frame::make_error_code(h2_errno::COMP);
+			return 0;
+		}
+		const uint8_t byte = *begin++;
+		value += static_cast<size_t>(byte & 0x7F) << shift;
+		if( (byte & 0x80) == 0 )
+			break;
+	}
+	return value;
+}
+
+inline void encode_string(std::string_view str, std::string &buf)
+{
+	const auto size = huffman_size(str);
+	if( size < str.size() )
+	{
+		encode_integer(size, 7, 0x80, buf);
+		huffman_encode(str, buf);
+	}
+	else
+	{
+		encode_integer(str.size(), 7, 0x00, buf);
+		buf.append(str);
+	}
+}
+
+inline std::string decode_string(const uint8_t *&begin, const uint8_t *end, error_code &error)
+{
+	if( begin >= end )
+	{
+		error = h2_frame::make_error_code(h2_errno::COMP);
+		return {};
+	}
+	const bool huffman = *begin & 0x80;
+	auto size = decode_integer(begin, end, 7, error);
+	if( error )
+		return {};
+	else if( size > static_cast<size_t>(end - begin) )
+	{
+		error = h2_frame::make_error_code(h2_errno::COMP);
+		return {};
+	}
+	const auto *data = begin;
+	begin += size;
+
+	if( huffman )
+		return huffman_decode(data, size, error);
+	return {reinterpret_cast<const char*>(data), size};
+}
+
+inline size_t huffman_size(std::string_view str) noexcept
+{
+	size_t bits = 0;
+	for(auto c : str)
+		bits += detail::hpack_huffman_lengths[static_cast<uint8_t>(c)];
+	return (bits + 7) >> 3;
+}
+
+inline void huffman_encode(std::string_view str, std::string &buf)
+{
+	uint64_t bits = 0;
+	size_t count = 0;
+
+	for(auto c : str)
+	{
+		const auto sym = static_cast<uint8_t>(c);
+		const auto length = detail::hpack_huffman_lengths[sym];
+
+		bits = (bits << length) | detail::hpack_huffman_codes[sym];
+		count += length;
+		while( count >= 8 )
+		{
+			count -= 8;
+			buf += static_cast<char>(bits >> count);
+		}
+		bits &= (uint64_t(1) << count) - 1;
+	}
+	// Pad with the most significant bits of EOS.
+	if( count > 0 )
+		buf += static_cast<char>((bits << (8 - count)) | (0xFF >> count));
+}
+
+inline std::string huffman_decode(const uint8_t *data, size_t size, error_code &error)
+{
+	error = error_code();
+	std::string result;
+	result.reserve(size * 8 / 5);
+
+	constexpr size_t max_length = std::size(detail::hpack_huffman_limits) - 1;
+	uint32_t code = 0;
+	size_t length = 0;
+
+	for(size_t i=0; i<size; i++)
+	{
+		for(int bit=7; bit>=0; bit--)
+		{
+			code = (code << 1) | ((data[i] >> bit) & 0x01);
+			if( ++length > max_length )
+			{
+				error = h2_frame::make_error_code(h2_errno::COMP);
+				return {};
+			}
+			auto &limit = detail::hpack_huffman_limits[length];
+			if( code - limit.first_code >= limit.count )
+				continue;
+
+			const auto sym = detail::hpack_huffman_symbols[limit.first_index + code - limit.first_code];
+			if( sym == 256 )
+			{
+				// EOS in a string literal.
+				error = h2_frame::make_error_code(h2_errno::COMP);
+				return {};
+			}
+			result += static_cast<char>(sym);
+			code = 0;
+			length = 0;
+		}
+	}
+	// Padding must be shorter than 8 bits and a prefix of EOS (all ones).
+	if( length > 7 or code != (uint32_t(1) << length) - 1 )
+	{
+		error = h2_frame::make_error_code(h2_errno::COMP);
+		return {};
+	}
+	return result;
+}
+
+} //namespace hpack
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_H2_DETAIL_HPACK_H
@@ -0,0 +1,167 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_H2_FRAME_H
+#define LIBGS_HTTP_H2_FRAME_H
+
+#include <libgs/http/types.h>
+#include <array>
+
+namespace libgs::http
+{
+
+// The value is 10300 + the RFC 9113 error code carried by RST_STREAM / GOAWAY.
+#define LIBGS_HTTP_H2_ERRNO \
+X_MACRO( NOE   , 10300 , "No error."                              ) \
+X_MACRO( PROTO , 10301 , "Protocol error."                        ) \
+X_MACRO( INTL  , 10302 , "Internal error."                        ) \
+X_MACRO( FLOW  , 10303 , "Flow control error."                    ) \
+X_MACRO( STMO  , 10304 , "Settings timeout."                      ) \
+X_MACRO( STCL  , 10305 , "Stream closed."                         ) \
+X_MACRO( FSZ   , 10306 , "Frame size error."                      ) \
+X_MACRO( RFS   , 10307 , "Refused stream."                        ) \
+X_MACRO( CNCL  , 10308 , "Stream cancelled."                      ) \
+X_MACRO( COMP  , 10309 , "Compression error."                     ) \
+X_MACRO( CONN  , 10310 , "Connect error."                         ) \
+X_MACRO( CALM  , 10311 , "Enhance your calm."                     ) \
+X_MACRO( INSEC , 10312 , "Inadequate security."                   ) \
+X_MACRO( H11   , 10313 , "HTTP/1.1 required."                     )
+
+enum class h2_errno
+{
+#define X_MACRO(e,v,d) e=(v),
+	LIBGS_HTTP_H2_ERRNO
+#undef X_MACRO
+};
+
+#define LIBGS_HTTP_H2_FRAME_TYPE_TABLE \
+X_MACRO( data          , 0x0 ) \
+X_MACRO( headers       , 0x1 ) \
+X_MACRO( priority      , 0x2 ) \
+X_MACRO( rst_stream    , 0x3 ) \
+X_MACRO( settings      , 0x4 ) \
+X_MACRO( push_promise  , 0x5 ) \
+X_MACRO( ping          , 0x6 ) \
+X_MACRO( goaway        , 0x7 ) \
+X_MACRO( window_update , 0x8 ) \
+X_MACRO( continuation  , 0x9 )
+
+enum class h2_frame_type : uint8_t
+{
+#define X_MACRO(e,v) e=(v),
+	LIBGS_HTTP_H2_FRAME_TYPE_TABLE
+#undef X_MACRO
+};
+
+struct LIBGS_HTTP_VAPI h2_frame_flag
+{
+	using type = uint8_t;
+	static constexpr type end_stream  = 0x01;
+	static constexpr type ack         = 0x01;
+	static constexpr type end_headers = 0x04;
+	static constexpr type padded      = 0x08;
+	static constexpr type priority    = 0x20;
+};
+using h2_frame_flag_t = h2_frame_flag::type;
+
+#define LIBGS_HTTP_H2_SETTING_TABLE \
+X_MACRO( header_table_size      , 0x1 ) \
+X_MACRO( enable_push            , 0x2 ) \
+X_MACRO( max_concurrent_streams , 0x3 ) \
+X_MACRO( initial_window_size    , 0x4 ) \
+X_MACRO( max_frame_size         , 0x5 ) \
+X_MACRO( max_header_list_size   , 0x6 )
+
+enum class h2_setting_id : uint16_t
+{
+#define X_MACRO(e,v) e=(v),
+	LIBGS_HTTP_H2_SETTING_TABLE
+#undef X_MACRO
+};
+
+struct LIBGS_HTTP_VAPI h2_frame_header
+{
+	uint32_t length = 0;
+	h2_frame_type type = h2_frame_type::data;
+	h2_frame_flag_t flags = 0;
+	uint32_t stream_id = 0;
+};
+
+// Initial values as defined by RFC 9113 section 6.5.2.
+struct LIBGS_HTTP_VAPI h2_settings
+{
+	uint32_t header_table_size = 4096;
+	bool enable_push = true;
+	uint32_t max_concurrent_streams = std::numeric_limits<uint32_t>::max();
+	uint32_t initial_window_size = 65535;
+	uint32_t max_frame_size = 16384;
+	uint32_t max_header_list_size = std::numeric_limits<uint32_t>::max();
+};
+
+class LIBGS_HTTP_VAPI h2_frame
+{
+public:
+	static constexpr size_t header_size = 9;
+	static constexpr std::string_view preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+	static constexpr uint32_t default_window_size = 65535;
+	static constexpr uint32_t max_window_size = 0x7FFFFFFF;
+	static constexpr uint32_t min_frame_size = 16384;
+	static constexpr uint32_t max_frame_size = 0xFFFFFF;
+	using header_buffer_t = std::array<uint8_t,header_size>;
+
+public:
+	static void encode_header(const h2_frame_header &header, header_buffer_t &buf) noexcept;
+	static void encode_header(const h2_frame_header &header, std::string &buf);
+	[[nodiscard]] static h2_frame_header decode_header(const header_buffer_t &buf) noexcept;
+
+public:
+	// Appends one identifier/value pair of a SETTINGS payload.
+	static void encode_setting(h2_setting_id id, uint32_t value, std::string &buf);
+
+	// Applies a SETTINGS payload, unknown identifiers are ignored.
+	static void apply_settings(const const_buffer &payload, h2_settings &settings, error_code &error) noexcept;
+
+	// Decodes the token68 value of the 'HTTP2-Settings' header (h2c upgrade).
+	[[nodiscard]] static std::string decode_settings_header(std::string_view value, error_code &error);
+
+public:
+	static void encode_uint32(uint32_t value, std::string &buf);
+	[[nodiscard]] static uint32_t decode_uint32(const void *data) noexcept;
+
+public:
+	[[nodiscard]] static uint32_t wire_code(h2_errno errc) noexcept;
+	[[nodiscard]] static h2_errno from_wire_code(uint32_t code) noexcept;
+	[[nodiscard]] static error_code make_error_code(h2_errno errc);
+};
+
+} //namespace libgs::http
+#include <libgs/http/h2/detail/frame.h>
+
+
+#endif //LIBGS_HTTP_H2_FRAME_H
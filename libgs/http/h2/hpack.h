@@ -0,0 +1,126 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_H2_HPACK_H
+#define LIBGS_HTTP_H2_HPACK_H
+
+#include <libgs/http/h2/frame.h>
+#include <deque>
+
+namespace libgs::http
+{
+
+struct LIBGS_HTTP_VAPI hpack_field
+{
+	std::string name;
+	std::string value;
+	bool sensitive = false; // never indexed
+};
+using hpack_fields = std::vector<hpack_field>;
+
+class LIBGS_HTTP_VAPI hpack_decoder
+{
+public:
+	explicit hpack_decoder(size_t max_table_size = 4096);
+
+public:
+	// Decodes a complete header block (HEADERS + CONTINUATION), fields are appended.
+	void decode(const const_buffer &block, hpack_fields &fields, error_code &error);
+
+	// The SETTINGS_HEADER_TABLE_SIZE announced to the peer.
+	void set_max_table_size(size_t size) noexcept;
+	[[nodiscard]] size_t max_table_size() const noexcept;
+	[[nodiscard]] size_t table_size() const noexcept;
+
+private:
+	struct entry
+	{
+		std::string name;
+		std::string value;
+	};
+	[[nodiscard]] bool lookup(size_t index, std::string_view &name, std::string_view &value) const noexcept;
+	void insert(std::string name, std::string value);
+	void evict(size_t capacity);
+
+private:
+	std::deque<entry> m_table {};
+	size_t m_size = 0;
+	size_t m_capacity;
+	size_t m_max_size;
+};
+
+class LIBGS_HTTP_VAPI hpack_encoder
+{
+public:
+	explicit hpack_encoder(size_t max_table_size = 4096);
+
+public:
+	// Appends the representation of one field to 'buf'.
+	void encode(std::string_view name, std::string_view value, std::string &buf, bool sensitive = false);
+
+	// The SETTINGS_HEADER_TABLE_SIZE announced by the peer,
+	// a dynamic table size update is emitted before the next field.
+	void set_max_table_size(size_t size) noexcept;
+	[[nodiscard]] size_t table_size() const noexcept;
+
+private:
+	struct entry
+	{
+		std::string name;
+		std::string value;
+	};
+	void insert(std::string_view name, std::string_view value);
+	void evict(size_t capacity);
+
+private:
+	std::deque<entry> m_table {};
+	size_t m_size = 0;
+	size_t m_capacity;
+	bool m_size_update = false;
+};
+
+namespace hpack
+{
+
+LIBGS_HTTP_VAPI void encode_integer(size_t value, uint8_t prefix_bits, uint8_t flags, std::string &buf);
+[[nodiscard]] LIBGS_HTTP_VAPI size_t decode_integer(const uint8_t *&begin, const uint8_t *end, uint8_t prefix_bits, error_code &error);
+
+LIBGS_HTTP_VAPI void encode_string(std::string_view str, std::string &buf);
+[[nodiscard]] LIBGS_HTTP_VAPI std::string decode_string(const uint8_t *&begin, const uint8_t *end, error_code &error);
+
+[[nodiscard]] LIBGS_HTTP_VAPI size_t huffman_size(std::string_view str) noexcept;
+LIBGS_HTTP_VAPI void huffman_encode(std::string_view str, std::string &buf);
+[[nodiscard]] LIBGS_HTTP_VAPI std::string huffman_decode(const uint8_t *data, size_t size, error_code &error);
+
+} //namespace hpack
+
+} //namespace libgs::http
+#include <libgs/http/h2/detail/hpack.h>
+
+
+#endif //LIBGS_HTTP_H2_HPACK_H
@@ -43,6 +43,7 @@ struct basic_header;
 	static constexpr const _type *accept_ranges     = __VA_ARGS__##"Accept-Ranges"; \
 	static constexpr const _type *accept            = __VA_ARGS__##"Accept"; \
 	static constexpr const _type *age               = __VA_ARGS__##"Age"; \
+	static constexpr const _type *authorization     = __VA_ARGS__##"Authorization"; \
 	static constexpr const _type *content_encoding  = __VA_ARGS__##"Content-Encoding"; \
 	static constexpr const _type *content_length    = __VA_ARGS__##"Content-Length"; \
 	static constexpr const _type *cache_control     = __VA_ARGS__##"Cache-Control"; \
@@ -51,13 +52,21 @@ struct basic_header;
 	static constexpr const _type *connection        = __VA_ARGS__##"Connection"; \
 	static constexpr const _type *expires           = __VA_ARGS__##"Expires"; \
 	static constexpr const _type *host              = __VA_ARGS__##"Host"; \
+	static constexpr const _type *http2_settings    = __VA_ARGS__##"HTTP2-Settings"; \
 	static constexpr const _type *last_modified     = __VA_ARGS__##"Last-Modified"; \
 	static constexpr const _type *location          = __VA_ARGS__##"Location"; \
 	static constexpr const _type *origin            = __VA_ARGS__##"Origin"; \
 	static constexpr const _type *referer           = __VA_ARGS__##"Referer"; \
 	static constexpr const _type *range             = __VA_ARGS__##"Range"; \
+	static constexpr const _type *retry_after       = __VA_ARGS__##"Retry-After"; \
+	static constexpr const _type *sec_websocket_accept     = __VA_ARGS__##"Sec-WebSocket-Accept"; \
+	static constexpr const _type *sec_websocket_extensions = __VA_ARGS__##"Sec-WebSocket-Extensions"; \
+	static constexpr const _type *sec_websocket_key        = __VA_ARGS__##"Sec-WebSocket-Key"; \
+	static constexpr const _type *sec_websocket_protocol   = __VA_ARGS__##"Sec-WebSocket-Protocol"; \
+	static constexpr const _type *sec_websocket_version    = __VA_ARGS__##"Sec-WebSocket-Version"; \
 	static constexpr const _type *transfer_encoding = __VA_ARGS__##"Transfer-Encoding"; \
 	static constexpr const _type *user_agent        = __VA_ARGS__##"User-Agent"; \
+	static constexpr const _type *vary              = __VA_ARGS__##"Vary"; \
 	static constexpr const _type *upgrade           = __VA_ARGS__##"Upgrade"
 
 template <> struct basic_header<char> { LIBGS_HTTP_HEADER_KEY(char); };
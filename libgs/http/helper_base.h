@@ -110,7 +110,7 @@ public:
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 } //namespace libgs::http
@@ -111,7 +111,7 @@ public:
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 using parser_base = basic_parser_base<char>;
@@ -30,5 +30,9 @@
 #define LIBGS_HTTP_SERVER_H
 
 #include <libgs/http/server/server.h>
+#include <libgs/http/server/cache_aop.h>
+#include <libgs/http/server/proxy.h>
+#include <libgs/http/server/sse.h>
+#include <libgs/http/server/multipart.h>
 
 #endif //LIBGS_HTTP_SERVER_H
\ No newline at end of file
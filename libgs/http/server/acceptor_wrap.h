@@ -29,20 +29,20 @@
 #ifndef LIBGS_HTTP_SERVER_ACCEPTOR_WRAP_H
 #define LIBGS_HTTP_SERVER_ACCEPTOR_WRAP_H
 
-#include <libgs/http/global.h>
+#include <libgs/http/cxx/socket_options.h>
 #include <libgs/core/coro.h>
 
 namespace libgs::http { namespace detail
 {
 
-template <core_concepts::execution Exec>
+template <typename Protocol, core_concepts::execution Exec>
 class LIBGS_HTTP_VAPI acceptor_wrap
 {
 	LIBGS_DISABLE_COPY(acceptor_wrap)
 
 public:
 	using executor_t = Exec;
-	using acceptor_t = asio::basic_socket_acceptor<asio::ip::tcp,executor_t>;
+	using acceptor_t = asio::basic_socket_acceptor<Protocol,executor_t>;
 
 public:
 	acceptor_wrap(acceptor_t &&acceptor);
@@ -52,17 +52,27 @@ public:
 	acceptor_wrap &operator=(acceptor_wrap &&other) noexcept = default;
 
 	template <core_concepts::execution Exec0>
-	acceptor_wrap(acceptor_wrap<Exec0> &&other) noexcept;
+	acceptor_wrap(acceptor_wrap<Protocol,Exec0> &&other) noexcept;
 
 	template <core_concepts::execution Exec0>
-	acceptor_wrap &operator=(acceptor_wrap<Exec0> &&other) noexcept;
+	acceptor_wrap &operator=(acceptor_wrap<Protocol,Exec0> &&other) noexcept;
 
 public:
 	const acceptor_t &acceptor() const;
 	acceptor_t &acceptor();
 
+public:
+	// Applied by the server on bind, and to every accepted socket.
+	acceptor_wrap &set_options(const socket_options &options);
+	[[nodiscard]] const socket_options &options() const noexcept;
+
+protected:
+	template <typename Socket>
+	void apply_accept_options(Socket &socket) noexcept;
+
 protected:
 	acceptor_t m_acceptor;
+	socket_options m_options = socket_options::low_latency();
 };
 
 } //namespace detail
@@ -70,19 +80,19 @@ protected:
 template <typename Stream>
 class basic_acceptor_wrap;
 
-template <core_concepts::execution Exec>
-class LIBGS_HTTP_TAPI basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>> :
-	public detail::acceptor_wrap<Exec>
+template <typename Protocol, core_concepts::execution Exec>
+class LIBGS_HTTP_TAPI basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>> :
+	public detail::acceptor_wrap<Protocol,Exec>
 {
 	LIBGS_DISABLE_COPY(basic_acceptor_wrap)
 
 public:
-	using base_t = detail::acceptor_wrap<Exec>;
+	using base_t = detail::acceptor_wrap<Protocol,Exec>;
 	using executor_t = typename base_t::executor_t;
 	using acceptor_t = typename base_t::acceptor_t;
 
 	template <typename Exec0>
-	using basic_socket_t = asio::basic_stream_socket<asio::ip::tcp,Exec0>;
+	using basic_socket_t = asio::basic_stream_socket<Protocol,Exec0>;
 	using socket_t = basic_socket_t<executor_t>;
 
 public:
@@ -106,12 +116,12 @@ public:
 
 template <core_concepts::execution Exec>
 class LIBGS_HTTP_TAPI basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>> :
-	public detail::acceptor_wrap<Exec>
+	public detail::acceptor_wrap<asio::ip::tcp,Exec>
 {
 	LIBGS_DISABLE_COPY(basic_acceptor_wrap)
 
 public:
-	using base_t = detail::acceptor_wrap<Exec>;
+	using base_t = detail::acceptor_wrap<asio::ip::tcp,Exec>;
 	using executor_t = typename base_t::executor_t;
 	using acceptor_t = typename base_t::acceptor_t;
 
@@ -134,6 +144,7 @@ public:
 
 public:
 	[[nodiscard]] awaitable<socket_t> accept(core_concepts::execution auto &service_exec);
+	[[nodiscard]] asio::ssl::context &ssl_context() noexcept;
 
 protected:
 	asio::ssl::context *m_ssl;
@@ -0,0 +1,124 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_ACCESS_LOG_H
+#define LIBGS_HTTP_SERVER_ACCESS_LOG_H
+
+#include <libgs/http/types.h>
+#include <libgs/http/version.h>
+
+namespace libgs::http
+{
+
+enum class access_log_format
+{
+	// host - - [time] "method path version" status bytes
+	common,
+	// One object per line.
+	json
+};
+
+struct LIBGS_HTTP_VAPI access_log_option
+{
+	std::filesystem::path file_name;
+	access_log_format format = access_log_format::common;
+
+	// Records an io thread can hold before the writer drains them, beyond it they are dropped.
+	size_t ring_capacity = 4096;
+	milliseconds flush_interval {200};
+
+	// Zero disables rotation. Otherwise the file becomes '<file_name>.1' once it
+	// reaches the size, and at most 'max_files' of them are kept.
+	size_t max_file_size = 0;
+	size_t max_files = 5;
+};
+
+struct LIBGS_HTTP_VAPI access_log_statistics
+{
+	size_t written = 0;
+	size_t dropped = 0;
+	size_t rotations = 0;
+	size_t write_errors = 0;
+};
+
+// Fixed size, filled in on the io thread and formatted by the writer.
+struct LIBGS_HTTP_VAPI access_log_record
+{
+	static constexpr size_t max_path_size = 128;
+
+	std::chrono::system_clock::time_point time {};
+	std::chrono::nanoseconds latency {};
+	uint64_t bytes = 0;
+	status_t status = 0;
+
+	// Zero if no route matched.
+	uint32_t route = 0;
+	method_t method = method::GET;
+	version_t version = version::v11;
+
+	asio::ip::address peer {};
+	uint16_t port = 0;
+
+	void set_path(std::string_view path) noexcept;
+	[[nodiscard]] std::string_view path() const noexcept;
+
+private:
+	char m_path[max_path_size] {};
+	uint8_t m_path_size = 0;
+};
+
+// Per thread SPSC rings drained by a background writer, pushing never blocks.
+class LIBGS_HTTP_VAPI access_log
+{
+	LIBGS_DISABLE_COPY_MOVE(access_log)
+
+public:
+	explicit access_log(const access_log_option &option);
+	~access_log();
+
+public:
+	// Ids are handed out once per rule and resolved by the writer.
+	[[nodiscard]] uint32_t route_id(std::string_view rule);
+
+	// False if the calling thread's ring is full, the record is dropped.
+	bool push(const access_log_record &record) noexcept;
+	[[nodiscard]] const access_log_option &option() const noexcept;
+
+public:
+	[[nodiscard]] access_log_statistics stats() const noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/access_log.h>
+
+
+#endif //LIBGS_HTTP_SERVER_ACCESS_LOG_H
@@ -0,0 +1,137 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_ADMISSION_H
+#define LIBGS_HTTP_SERVER_ADMISSION_H
+
+#include <libgs/http/global.h>
+
+namespace libgs::http
+{
+
+struct LIBGS_HTTP_VAPI admission_option
+{
+	// Zero is unlimited.
+	size_t max_connections = 0;
+	size_t max_requests = 0;
+
+	// In-flight requests per route (path rule), beyond it the answer is '429'.
+	size_t max_route_requests = 0;
+
+	// How long a request may wait for a free slot before it is answered with '503'.
+	milliseconds queue_timeout {1000};
+
+	// CoDel: once the time spent in the queue stays above 'target' for a whole
+	// 'interval', requests that would have to wait are shed until it drains.
+	milliseconds codel_target {5};
+	milliseconds codel_interval {100};
+
+	// Gradient: the request limit follows the ratio of the long-term latency to the
+	// recent one, between 'min_requests' and 'max_requests' (which must be set).
+	bool adaptive = false;
+	size_t min_requests = 4;
+
+	std::chrono::seconds retry_after {1};
+};
+
+struct LIBGS_HTTP_VAPI admission_statistics
+{
+	size_t connections = 0;
+	size_t requests = 0;
+	size_t queued = 0;
+	size_t limit = 0;
+
+	size_t shed_connections = 0;
+	size_t shed_overload = 0;
+	size_t shed_timeout = 0;
+	size_t shed_route = 0;
+};
+
+// Load shedding in front of the handlers, shared by every connection of a server.
+class LIBGS_HTTP_VAPI admission_control
+{
+	LIBGS_DISABLE_COPY_MOVE(admission_control)
+
+public:
+	using clock_t = std::chrono::steady_clock;
+
+	// An admitted request (or route) slot, given back on destruction.
+	class slot
+	{
+		LIBGS_DISABLE_COPY(slot)
+
+	public:
+		slot() = default;
+		slot(slot &&other) noexcept;
+		slot &operator=(slot &&other) noexcept;
+		~slot();
+
+	public:
+		[[nodiscard]] explicit operator bool() const noexcept;
+		void release() noexcept;
+
+	private:
+		friend class admission_control;
+		admission_control *m_ctrl = nullptr;
+		std::atomic_size_t *m_route = nullptr;
+		clock_t::time_point m_start {};
+	};
+
+public:
+	explicit admission_control(const admission_option &option = {});
+	~admission_control();
+
+public:
+	void set_option(const admission_option &option);
+	[[nodiscard]] admission_option option() const;
+
+public:
+	// The connection must be given back by 'release_connection' when accepted.
+	[[nodiscard]] bool acquire_connection() noexcept;
+	void release_connection() noexcept;
+
+	// Waits up to 'queue_timeout' for a slot, an empty one means '503'.
+	[[nodiscard]] awaitable<slot> co_acquire();
+
+	// 'in_flight' is the route's own counter, an empty slot means '429'.
+	[[nodiscard]] slot acquire_route(std::atomic_size_t &in_flight) noexcept;
+
+public:
+	[[nodiscard]] admission_statistics stats() const noexcept;
+
+private:
+	void release(clock_t::time_point start) noexcept;
+	class impl;
+	impl *m_impl;
+};
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/admission.h>
+
+
+#endif //LIBGS_HTTP_SERVER_ADMISSION_H
@@ -30,6 +30,7 @@
 #define LIBGS_HTTP_SERVER_AOP_H
 
 #include <libgs/http/server/context.h>
+#include <libgs/http/websocket/websocket.h>
 
 namespace libgs::http
 {
@@ -0,0 +1,110 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+#ifndef LIBGS_HTTP_SERVER_CACHE_AOP_H
+#define LIBGS_HTTP_SERVER_CACHE_AOP_H
+
+#include <libgs/http/server/aop.h>
+
+namespace libgs::http
+{
+
+template <core_concepts::char_type CharT>
+struct LIBGS_HTTP_TAPI basic_cache_option
+{
+	using string_t = std::basic_string<CharT>;
+
+	milliseconds ttl {1000};
+	size_t max_memory = 0x4000000;
+	size_t max_entry_size = 0x100000;
+
+	// How long a request waits for the one generating the same key.
+	milliseconds lock_timeout {5000};
+
+	// Query parameters and request headers that take part in the key.
+	std::vector<string_t> parameters {};
+	std::vector<string_t> vary {};
+};
+
+using cache_option = basic_cache_option<char>;
+using wcache_option = basic_cache_option<wchar_t>;
+
+// Micro-cache for GET/HEAD: complete serialized responses are kept for 'ttl' and
+// replayed in one gathered write. While a key is being generated, other requests
+// for it wait for the result instead of running the handler again (single-flight).
+// HTTP/2 streams, requests carrying 'Authorization' or 'Range', and responses with
+// cookies, 'Cache-Control: no-store/private' or a 'Vary' naming a header (or '*')
+// missing from 'option.vary' are passed through. The key includes the 'Host'.
+template <concepts::stream Stream, core_concepts::char_type CharT>
+class LIBGS_HTTP_TAPI basic_cache_aop : public basic_aop<Stream,CharT>
+{
+public:
+	using char_t = CharT;
+	using context_t = basic_service_context<Stream,char_t>;
+	using option_t = basic_cache_option<char_t>;
+
+	struct statistics
+	{
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t coalesced = 0;
+		size_t entries = 0;
+		size_t memory = 0;
+	};
+
+public:
+	explicit basic_cache_aop(option_t option = {});
+	~basic_cache_aop() override;
+
+public:
+	[[nodiscard]] awaitable<bool> before(context_t &context) override;
+	[[nodiscard]] awaitable<bool> after(context_t &context) override;
+	[[nodiscard]] bool exception(context_t &context, const std::exception &ex) override;
+
+public:
+	[[nodiscard]] statistics stats() const noexcept;
+	void clear() noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+template <core_concepts::execution Exec>
+using basic_tcp_cache_aop = basic_cache_aop<asio::basic_stream_socket<asio::ip::tcp,Exec>,char>;
+
+template <core_concepts::execution Exec>
+using wbasic_tcp_cache_aop = basic_cache_aop<asio::basic_stream_socket<asio::ip::tcp,Exec>,wchar_t>;
+
+using tcp_cache_aop = basic_tcp_cache_aop<asio::any_io_executor>;
+using wtcp_cache_aop = wbasic_tcp_cache_aop<asio::any_io_executor>;
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/cache_aop.h>
+
+
+#endif //LIBGS_HTTP_SERVER_CACHE_AOP_H
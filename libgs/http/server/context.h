@@ -51,9 +51,10 @@ public:
 
 	using session_t = basic_session<char_t>;
 	using session_ptr = basic_session_ptr<char_t>;
+	using transport_t = typename request_t::transport_t;
 
 public:
-	basic_service_context(stream_t &&stream, parser_t &parser, session_set &sss);
+	basic_service_context(stream_t &&stream, parser_t &parser, session_set &sss, transport_t *transport = nullptr);
 	~basic_service_context();
 
 	basic_service_context(basic_service_context &&other) noexcept;
@@ -76,6 +77,14 @@ public:
 
 	[[nodiscard]] executor_t get_executor() noexcept;
 
+public:
+	// Null unless the request is traced (basic_server::set_tracer).
+	[[nodiscard]] request_trace *trace() noexcept;
+
+	// A custom span, ended when the scope goes away. Costs nothing if the request isn't traced.
+	[[nodiscard]] request_trace::scope span(std::string_view name) noexcept;
+	void set_trace(request_trace *trace) noexcept;
+
 public: // Fucking msvc !!!
 	template <typename Session, typename...Args>
 	[[nodiscard]] std::shared_ptr<Session> session(Args&&...args) requires
@@ -98,7 +107,7 @@ public: // Fucking msvc !!!
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 template <core_concepts::execution Exec>
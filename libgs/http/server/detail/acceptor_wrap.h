@@ -35,74 +35,102 @@
 namespace libgs::http { namespace detail
 {
 
-template <core_concepts::execution Exec>
-acceptor_wrap<Exec>::acceptor_wrap(acceptor_t &&acceptor) :
+template <typename Protocol, core_concepts::execution Exec>
+acceptor_wrap<Protocol,Exec>::acceptor_wrap(acceptor_t &&acceptor) :
 	m_acceptor(std::move(acceptor))
 {
 
 }
 
-template <core_concepts::execution Exec>
-const typename acceptor_wrap<Exec>::acceptor_t &acceptor_wrap<Exec>::acceptor() const
+template <typename Protocol, core_concepts::execution Exec>
+const typename acceptor_wrap<Protocol,Exec>::acceptor_t &acceptor_wrap<Protocol,Exec>::acceptor() const
 {
 	return m_acceptor;
 }
 
-template <core_concepts::execution Exec>
-typename acceptor_wrap<Exec>::acceptor_t &acceptor_wrap<Exec>::acceptor()
+template <typename Protocol, core_concepts::execution Exec>
+typename acceptor_wrap<Protocol,Exec>::acceptor_t &acceptor_wrap<Protocol,Exec>::acceptor()
 {
 	return m_acceptor;
 }
 
-template <core_concepts::execution Exec>
+template <typename Protocol, core_concepts::execution Exec>
 template <core_concepts::execution Exec0>
-acceptor_wrap<Exec>::acceptor_wrap(acceptor_wrap<Exec0> &&other) noexcept :
-	m_acceptor(std::move(other.m_acceptor))
+acceptor_wrap<Protocol,Exec>::acceptor_wrap(acceptor_wrap<Protocol,Exec0> &&other) noexcept :
+	m_acceptor(std::move(other.m_acceptor)),
+	m_options(std::move(other.m_options))
 {
 
 }
 
-template <core_concepts::execution Exec>
+template <typename Protocol, core_concepts::execution Exec>
 template <core_concepts::execution Exec0>
-acceptor_wrap<Exec> &acceptor_wrap<Exec>::operator=(acceptor_wrap<Exec0> &&other) noexcept
+acceptor_wrap<Protocol,Exec> &acceptor_wrap<Protocol,Exec>::operator=(acceptor_wrap<Protocol,Exec0> &&other) noexcept
 {
 	m_acceptor = std::move(other.m_acceptor);
+	m_options = std::move(other.m_options);
 	return *this;
 }
 
+template <typename Protocol, core_concepts::execution Exec>
+acceptor_wrap<Protocol,Exec> &acceptor_wrap<Protocol,Exec>::set_options(const socket_options &options)
+{
+	m_options = options;
+	return *this;
+}
+
+template <typename Protocol, core_concepts::execution Exec>
+const socket_options &acceptor_wrap<Protocol,Exec>::options() const noexcept
+{
+	return m_options;
+}
+
+template <typename Protocol, core_concepts::execution Exec>
+template <typename Socket>
+void acceptor_wrap<Protocol,Exec>::apply_accept_options(Socket &socket) noexcept
+{
+	error_code error;
+	apply_socket_options(socket, m_options, socket_option_stage::accept, error);
+	if( error )
+		spdlog::debug("libgs::http::server: socket options: {}.", error);
+}
+
 } //namespace detail
 
-template <core_concepts::execution Exec>
-basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>>::basic_acceptor_wrap(acceptor_t &&acceptor) :
+template <typename Protocol, core_concepts::execution Exec>
+basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>>::basic_acceptor_wrap(acceptor_t &&acceptor) :
 	base_t(std::move(acceptor))
 {
 
 }
 
-template <core_concepts::execution Exec>
+template <typename Protocol, core_concepts::execution Exec>
 template <core_concepts::execution Exec0>
-basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>>::basic_acceptor_wrap
+basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>>::basic_acceptor_wrap
 (basic_acceptor_wrap<basic_socket_t<Exec0>> &&other) noexcept :
 	base_t(std::move(other.m_acceptor))
 {
-
+	this->m_options = other.m_options;
 }
 
-template <core_concepts::execution Exec>
+template <typename Protocol, core_concepts::execution Exec>
 template <core_concepts::execution Exec0>
-basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>>&
-basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>>::operator=
+basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>>&
+basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>>::operator=
 (basic_acceptor_wrap<basic_socket_t<Exec0>> &&other) noexcept
 {
 	base_t::operator=(std::move(other.m_acceptor));
+	this->m_options = other.m_options;
 	return *this;
 }
 
-template <core_concepts::execution Exec>
-awaitable<typename basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>>::socket_t>
-basic_acceptor_wrap<asio::basic_stream_socket<asio::ip::tcp,Exec>>::accept(core_concepts::execution auto &service_exec)
+template <typename Protocol, core_concepts::execution Exec>
+awaitable<typename basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>>::socket_t>
+basic_acceptor_wrap<asio::basic_stream_socket<Protocol,Exec>>::accept(core_concepts::execution auto &service_exec)
 {
-	co_return co_await this->m_acceptor.async_accept(service_exec, use_awaitable);
+	auto socket = co_await this->m_acceptor.async_accept(service_exec, use_awaitable);
+	this->apply_accept_options(socket);
+	co_return socket;
 }
 
 #ifdef LIBGS_ENABLE_OPENSSL
@@ -120,6 +148,7 @@ basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Ex
 (basic_acceptor_wrap &&other) noexcept :
 	base_t(std::move(other.m_acceptor))
 {
+	this->m_options = other.m_options;
 	m_ssl = other.m_ssl;
 }
 
@@ -129,6 +158,7 @@ basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Ex
 (basic_acceptor_wrap &&other) noexcept
 {
 	base_t::operator=(std::move(other.m_acceptor));
+	this->m_options = other.m_options;
 	m_ssl = other.other.m_ssl;
 	return *this;
 }
@@ -139,6 +169,7 @@ basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Ex
 (basic_acceptor_wrap<basic_socket_t<Exec0>> &&other) noexcept :
 	base_t(std::move(other.m_acceptor))
 {
+	this->m_options = other.m_options;
 	m_ssl = other.m_ssl;
 }
 
@@ -149,6 +180,7 @@ basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Ex
 	(basic_acceptor_wrap<basic_socket_t<Exec0>> &&other) noexcept
 {
 	base_t::operator=(std::move(other.m_acceptor));
+	this->m_options = other.m_options;
 	m_ssl = other.other.m_ssl;
 	return *this;
 }
@@ -158,6 +190,7 @@ awaitable<typename basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_sock
 basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>>::accept(core_concepts::execution auto &service_exec)
 {
 	auto tcp_socket = co_await this->m_acceptor.async_accept(service_exec, use_awaitable);
+	this->apply_accept_options(tcp_socket);
 	socket_t ssl_socket(std::move(tcp_socket), *m_ssl);
 
 	error_code error;
@@ -170,6 +203,12 @@ basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Ex
 	co_return ssl_socket;
 }
 
+template <core_concepts::execution Exec>
+asio::ssl::context &basic_acceptor_wrap<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>>::ssl_context() noexcept
+{
+	return *m_ssl;
+}
+
 #endif //LIBGS_ENABLE_OPENSSL
 
 } //namespace libgs::http
@@ -0,0 +1,227 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_ACCESS_LOG_H
+#define LIBGS_HTTP_SERVER_DETAIL_ACCESS_LOG_H
+
+#include <libgs/http/server/detail/record_writer.h>
+#include <bit>
+
+namespace libgs::http
+{
+
+inline void access_log_record::set_path(std::string_view path) noexcept
+{
+	m_path_size = static_cast<uint8_t>(std::min(path.size(), max_path_size));
+	memcpy(m_path, path.data(), m_path_size);
+}
+
+inline std::string_view access_log_record::path() const noexcept
+{
+	return {m_path, m_path_size};
+}
+
+class access_log::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+	explicit impl(const access_log_option &option) :
+		m_option(normalize(option)),
+		m_writer({
+			.owner = "libgs::http::access_log",
+			.file_name = m_option.file_name,
+			.ring_capacity = m_option.ring_capacity,
+			.flush_interval = m_option.flush_interval,
+			.max_file_size = m_option.max_file_size,
+			.max_files = m_option.max_files
+		})
+	{
+		m_writer.start([this](std::vector<access_log_record> &batch, std::string &buffer) {
+			format(batch, buffer);
+		});
+	}
+
+public:
+	[[nodiscard]] uint32_t route_id(std::string_view rule)
+	{
+		std::unique_lock lock(m_route_mutex);
+		auto it = std::find(m_routes.begin(), m_routes.end(), rule);
+		if( it == m_routes.end() )
+			it = m_routes.emplace(m_routes.end(), rule);
+		return static_cast<uint32_t>(it - m_routes.begin() + 1);
+	}
+
+	bool push(const access_log_record &record) noexcept {
+		return m_writer.push(record);
+	}
+
+	[[nodiscard]] access_log_statistics stats() const noexcept
+	{
+		auto stats = m_writer.stats();
+		return {
+			.written = stats.written,
+			.dropped = stats.dropped,
+			.rotations = stats.rotations,
+			.write_errors = stats.write_errors
+		};
+	}
+
+private:
+	[[nodiscard]] static access_log_option normalize(access_log_option option)
+	{
+		option.ring_capacity = std::bit_ceil(std::max<size_t>(option.ring_capacity, 2));
+		if( option.flush_interval <= milliseconds(0) )
+			option.flush_interval = milliseconds(200);
+		return option;
+	}
+
+	void format(std::vector<access_log_record> &batch, std::string &buffer)
+	{
+		// Rings are drained one after another, put the threads back in order.
+		std::ranges::stable_sort(batch, {}, &access_log_record::time);
+
+		std::unique_lock lock(m_route_mutex);
+		for(auto &record : batch)
+		{
+			if( m_option.format == access_log_format::json )
+				format_json(record, buffer);
+			else
+				format_common(record, buffer);
+		}
+	}
+
+	static void format_common(const access_log_record &record, std::string &buffer)
+	{
+		auto out = std::back_inserter(buffer);
+		if( record.peer.is_unspecified() )
+			buffer += '-';
+		else
+			buffer += record.peer.to_string();
+
+		std::format_to(out, " - - [{:%d/%b/%Y:%H:%M:%S} +0000] \"{} ",
+			std::chrono::floor<std::chrono::seconds>(record.time), method_string(record.method)
+		);
+		escape(record.path(), buffer);
+		std::format_to(out, " HTTP/{}\" {} {}\n",
+			version_string(record.version), record.status, record.bytes
+		);
+	}
+
+	void format_json(const access_log_record &record, std::string &buffer)
+	{
+		auto out = std::back_inserter(buffer);
+		std::format_to(out, R"({{"time":"{:%FT%T}Z","peer":")",
+			std::chrono::floor<std::chrono::milliseconds>(record.time)
+		);
+		if( not record.peer.is_unspecified() )
+			buffer += record.peer.to_string();
+
+		std::format_to(out, R"(","port":{},"method":"{}","path":")",
+			record.port, method_string(record.method)
+		);
+		escape(record.path(), buffer);
+		buffer += R"(","route":)";
+
+		if( record.route > 0 and record.route <= m_routes.size() )
+		{
+			buffer += '"';
+			escape(m_routes[record.route - 1], buffer);
+			buffer += '"';
+		}
+		else
+			buffer += "null";
+
+		std::format_to(out, R"(,"version":"{}","status":{},"bytes":{},"latency_us":{}}})" "\n",
+			version_string(record.version), record.status, record.bytes,
+			std::chrono::duration_cast<std::chrono::microseconds>(record.latency).count()
+		);
+	}
+
+	static void escape(std::string_view str, std::string &buffer)
+	{
+		for(auto c : str)
+		{
+			if( c == '"' or c == '\\' )
+			{
+				buffer += '\\';
+				buffer += c;
+			}
+			else if( static_cast<unsigned char>(c) < 0x20 )
+				std::format_to(std::back_inserter(buffer), "\\u{:04x}", static_cast<int>(c));
+			else
+				buffer += c;
+		}
+	}
+
+public:
+	access_log_option m_option;
+
+private:
+	std::mutex m_route_mutex;
+	std::vector<std::string> m_routes;
+
+	// Last, its thread is stopped before the routes go away.
+	detail::record_writer<access_log_record> m_writer;
+};
+
+inline access_log::access_log(const access_log_option &option) :
+	m_impl(new impl(option))
+{
+
+}
+
+inline access_log::~access_log()
+{
+	delete m_impl;
+}
+
+inline uint32_t access_log::route_id(std::string_view rule)
+{
+	return m_impl->route_id(rule);
+}
+
+inline bool access_log::push(const access_log_record &record) noexcept
+{
+	return m_impl->push(record);
+}
+
+inline const access_log_option &access_log::option() const noexcept
+{
+	return m_impl->m_option;
+}
+
+inline access_log_statistics access_log::stats() const noexcept
+{
+	return m_impl->stats();
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_ACCESS_LOG_H
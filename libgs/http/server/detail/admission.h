@@ -0,0 +1,397 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_ADMISSION_H
+#define LIBGS_HTTP_SERVER_DETAIL_ADMISSION_H
+
+#include <libgs/core/spin_mutex.h>
+#include <list>
+#include <cmath>
+
+#ifdef LIBGS_USING_BOOST_ASIO
+# include <boost/asio/experimental/concurrent_channel.hpp>
+#else
+# include <asio/experimental/concurrent_channel.hpp>
+#endif //LIBGS_USING_BOOST_ASIO
+
+namespace libgs::http
+{
+
+class admission_control::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+	using channel_t = asio::experimental::concurrent_channel<void(error_code)>;
+
+public:
+	struct waiter
+	{
+		waiter(const auto &exec, clock_t::time_point time) :
+			channel(exec, 1), time(time) {}
+
+		// Buffered, so the grant is not lost if the waiter is not receiving yet.
+		channel_t channel;
+		clock_t::time_point time;
+		std::list<std::shared_ptr<waiter>>::iterator it {};
+		bool granted = false;
+	};
+	using waiter_ptr = std::shared_ptr<waiter>;
+
+public:
+	explicit impl(const admission_option &option) {
+		set_option(option);
+	}
+
+public:
+	void set_option(const admission_option &option)
+	{
+		m_option = option;
+		auto max = static_cast<double>(m_option.max_requests);
+
+		if( m_option.adaptive and m_option.max_requests > 0 )
+		{
+			m_option.min_requests = std::clamp<size_t>(m_option.min_requests, 1, m_option.max_requests);
+			m_limit_f = m_limit_f == 0 ? max : std::clamp(m_limit_f, static_cast<double>(m_option.min_requests), max);
+		}
+		else
+		{
+			m_option.adaptive = false;
+			m_limit_f = max;
+		}
+		m_limit = static_cast<size_t>(m_limit_f);
+		m_adaptive = m_option.adaptive;
+		m_max_connections = m_option.max_connections;
+		m_max_route_requests = m_option.max_route_requests;
+	}
+
+	[[nodiscard]] bool try_acquire() noexcept
+	{
+		auto limit = m_limit.load(std::memory_order_relaxed);
+		auto count = m_requests.load(std::memory_order_relaxed);
+		do {
+			if( limit > 0 and count >= limit )
+				return false;
+		}
+		while( not m_requests.compare_exchange_weak(count, count + 1) );
+		return true;
+	}
+
+	// Under the lock.
+	void grant(clock_t::time_point now) noexcept
+	{
+		while( not m_waiters.empty() and try_acquire() )
+		{
+			auto wait = std::move(m_waiters.front());
+			m_waiters.pop_front();
+			--m_queued;
+
+			codel(now - wait->time, now);
+			wait->granted = true;
+			wait->channel.try_send(error_code());
+		}
+		// The standing queue is gone.
+		if( m_waiters.empty() )
+		{
+			m_first_above = {};
+			m_dropping = false;
+		}
+	}
+
+	// Under the lock.
+	void codel(clock_t::duration sojourn, clock_t::time_point now) noexcept
+	{
+		if( sojourn < m_option.codel_target )
+		{
+			m_first_above = {};
+			m_dropping = false;
+		}
+		else if( m_first_above == clock_t::time_point() )
+			m_first_above = now + m_option.codel_interval;
+		else if( now >= m_first_above )
+			m_dropping = true;
+	}
+
+	// Under the lock, 'in_flight' is the count before this request was released.
+	void sample(clock_t::duration rtt, size_t in_flight) noexcept
+	{
+		m_max_in_flight = std::max(m_max_in_flight, in_flight);
+		m_sample_sum += std::chrono::duration<double,std::micro>(rtt).count();
+		if( ++m_sample_count < std::max<size_t>(m_limit, 10) )
+			return ;
+
+		auto short_rtt = std::max(m_sample_sum / static_cast<double>(m_sample_count), 1.0);
+		m_sample_sum = 0;
+		m_sample_count = 0;
+
+		m_long_rtt = m_long_rtt == 0 ? short_rtt : m_long_rtt * 0.95 + short_rtt * 0.05;
+		// Let the long term follow a lasting drop quickly (e.g. after a burst).
+		if( m_long_rtt / short_rtt > 2 )
+			m_long_rtt *= 0.95;
+
+		// Application limited, nothing says the limit is too low.
+		auto max_in_flight = std::exchange(m_max_in_flight, 0);
+		if( static_cast<double>(max_in_flight) < m_limit_f / 2 )
+			return ;
+
+		auto gradient = std::clamp(m_long_rtt / short_rtt, 0.5, 1.0);
+		auto limit = m_limit_f * gradient + std::sqrt(m_limit_f);
+
+		m_limit_f = std::clamp (
+			m_limit_f * 0.8 + limit * 0.2,
+			static_cast<double>(m_option.min_requests),
+			static_cast<double>(m_option.max_requests)
+		);
+		m_limit = static_cast<size_t>(m_limit_f);
+	}
+
+public:
+	mutable spin_mutex m_mutex;
+	admission_option m_option {};
+	std::list<waiter_ptr> m_waiters {};
+
+	clock_t::time_point m_first_above {};
+	bool m_dropping = false;
+
+	double m_limit_f = 0;
+	double m_long_rtt = 0;
+	double m_sample_sum = 0;
+	size_t m_sample_count = 0;
+	size_t m_max_in_flight = 0;
+
+	std::atomic_size_t m_limit {0};
+	std::atomic_bool m_adaptive {false};
+	std::atomic_size_t m_max_connections {0};
+	std::atomic_size_t m_max_route_requests {0};
+
+	std::atomic_size_t m_connections {0};
+	std::atomic_size_t m_requests {0};
+	std::atomic_size_t m_queued {0};
+
+	std::atomic_size_t m_shed_connections {0};
+	std::atomic_size_t m_shed_overload {0};
+	std::atomic_size_t m_shed_timeout {0};
+	std::atomic_size_t m_shed_route {0};
+};
+
+inline admission_control::slot::slot(slot &&other) noexcept :
+	m_ctrl(other.m_ctrl), m_route(other.m_route), m_start(other.m_start)
+{
+	other.m_ctrl = nullptr;
+	other.m_route = nullptr;
+}
+
+inline admission_control::slot &admission_control::slot::operator=(slot &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	release();
+	m_ctrl = std::exchange(other.m_ctrl, nullptr);
+	m_route = std::exchange(other.m_route, nullptr);
+	m_start = other.m_start;
+	return *this;
+}
+
+inline admission_control::slot::~slot()
+{
+	release();
+}
+
+inline admission_control::slot::operator bool() const noexcept
+{
+	return m_ctrl != nullptr;
+}
+
+inline void admission_control::slot::release() noexcept
+{
+	if( not m_ctrl )
+		return ;
+	else if( m_route )
+		m_route->fetch_sub(1, std::memory_order_relaxed);
+	else
+		m_ctrl->release(m_start);
+	m_ctrl = nullptr;
+	m_route = nullptr;
+}
+
+inline admission_control::admission_control(const admission_option &option) :
+	m_impl(new impl(option))
+{
+
+}
+
+inline admission_control::~admission_control()
+{
+	delete m_impl;
+}
+
+inline void admission_control::set_option(const admission_option &option)
+{
+	spin_unique_lock lock(m_impl->m_mutex);
+	m_impl->set_option(option);
+	m_impl->grant(clock_t::now());
+}
+
+inline admission_option admission_control::option() const
+{
+	spin_unique_lock lock(m_impl->m_mutex);
+	return m_impl->m_option;
+}
+
+inline bool admission_control::acquire_connection() noexcept
+{
+	auto max = m_impl->m_max_connections.load(std::memory_order_relaxed);
+	auto count = m_impl->m_connections.load(std::memory_order_relaxed);
+	do {
+		if( max > 0 and count >= max )
+		{
+			m_impl->m_shed_connections.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	}
+	while( not m_impl->m_connections.compare_exchange_weak(count, count + 1) );
+	return true;
+}
+
+inline void admission_control::release_connection() noexcept
+{
+	m_impl->m_connections.fetch_sub(1, std::memory_order_relaxed);
+}
+
+inline awaitable<admission_control::slot> admission_control::co_acquire()
+{
+	slot result;
+	if( m_impl->try_acquire() )
+	{
+		result.m_ctrl = this;
+		result.m_start = clock_t::now();
+		co_return result;
+	}
+	auto exec = co_await asio::this_coro::executor;
+	auto now = clock_t::now();
+	impl::waiter_ptr wait;
+	milliseconds timeout {};
+	{
+		spin_unique_lock lock(m_impl->m_mutex);
+		// Counted before the retry, so a concurrent release() either frees the
+		// slot for the retry or sees the waiter and grants it.
+		++m_impl->m_queued;
+		if( m_impl->try_acquire() )
+		{
+			--m_impl->m_queued;
+			result.m_ctrl = this;
+			result.m_start = now;
+			co_return result;
+		}
+		if( m_impl->m_waiters.empty() )
+		{
+			m_impl->m_first_above = {};
+			m_impl->m_dropping = false;
+		}
+		if( m_impl->m_option.queue_timeout <= milliseconds(0) or m_impl->m_dropping )
+		{
+			--m_impl->m_queued;
+			m_impl->m_shed_overload.fetch_add(1, std::memory_order_relaxed);
+			co_return result;
+		}
+		timeout = m_impl->m_option.queue_timeout;
+		wait = std::make_shared<impl::waiter>(exec, now);
+		wait->it = m_impl->m_waiters.emplace(m_impl->m_waiters.end(), wait);
+	}
+	using namespace libgs::operators;
+	error_code error;
+	co_await (
+		wait->channel.async_receive(use_awaitable | error) or
+		sleep_for(exec, timeout)
+	);
+	now = clock_t::now();
+	spin_unique_lock lock(m_impl->m_mutex);
+	if( wait->granted )
+	{
+		result.m_ctrl = this;
+		result.m_start = now;
+	}
+	else
+	{
+		m_impl->m_waiters.erase(wait->it);
+		--m_impl->m_queued;
+		m_impl->codel(now - wait->time, now);
+		m_impl->m_shed_timeout.fetch_add(1, std::memory_order_relaxed);
+	}
+	co_return result;
+}
+
+inline admission_control::slot admission_control::acquire_route(std::atomic_size_t &in_flight) noexcept
+{
+	slot result;
+	auto max = m_impl->m_max_route_requests.load(std::memory_order_relaxed);
+	auto count = in_flight.load(std::memory_order_relaxed);
+	do {
+		if( max > 0 and count >= max )
+		{
+			m_impl->m_shed_route.fetch_add(1, std::memory_order_relaxed);
+			return result;
+		}
+	}
+	while( not in_flight.compare_exchange_weak(count, count + 1) );
+	result.m_ctrl = this;
+	result.m_route = &in_flight;
+	return result;
+}
+
+inline admission_statistics admission_control::stats() const noexcept
+{
+	admission_statistics result;
+	result.connections = m_impl->m_connections.load(std::memory_order_relaxed);
+	result.requests = m_impl->m_requests.load(std::memory_order_relaxed);
+	result.queued = m_impl->m_queued.load(std::memory_order_relaxed);
+	result.limit = m_impl->m_limit.load(std::memory_order_relaxed);
+
+	result.shed_connections = m_impl->m_shed_connections.load(std::memory_order_relaxed);
+	result.shed_overload = m_impl->m_shed_overload.load(std::memory_order_relaxed);
+	result.shed_timeout = m_impl->m_shed_timeout.load(std::memory_order_relaxed);
+	result.shed_route = m_impl->m_shed_route.load(std::memory_order_relaxed);
+	return result;
+}
+
+inline void admission_control::release(clock_t::time_point start) noexcept
+{
+	// Pairs with the waiter's 'm_queued' increment in co_acquire().
+	auto in_flight = m_impl->m_requests.fetch_sub(1);
+	if( m_impl->m_queued.load() == 0 and not m_impl->m_adaptive.load(std::memory_order_relaxed) )
+		return ;
+
+	auto now = clock_t::now();
+	spin_unique_lock lock(m_impl->m_mutex);
+	if( m_impl->m_option.adaptive )
+		m_impl->sample(now - start, in_flight);
+	m_impl->grant(now);
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_ADMISSION_H
@@ -74,6 +74,13 @@ concept request_handler = requires(Func &&func, basic_service_context<Stream,Cha
 	std::is_same_v<awaitable_return_type_t<decltype(func(context))>,void>;
 };
 
+template <typename Func, typename Stream, typename CharT>
+concept websocket_handler = requires (
+	Func &&func, basic_service_context<Stream,CharT> &context, basic_websocket<Stream> &websocket
+) {
+	std::is_same_v<awaitable_return_type_t<decltype(func(context, websocket))>,void>;
+};
+
 }} //namespace libgs::http::detail::concepts
 
 
@@ -0,0 +1,440 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+#ifndef LIBGS_HTTP_SERVER_DETAIL_CACHE_AOP_H
+#define LIBGS_HTTP_SERVER_DETAIL_CACHE_AOP_H
+
+#include <libgs/core/spin_mutex.h>
+#include <unordered_map>
+#include <list>
+
+#ifdef LIBGS_USING_BOOST_ASIO
+# include <boost/asio/experimental/concurrent_channel.hpp>
+#else
+# include <asio/experimental/concurrent_channel.hpp>
+#endif //LIBGS_USING_BOOST_ASIO
+
+namespace libgs::http
+{
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+class basic_cache_aop<Stream,CharT>::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+	using clock_t = std::chrono::steady_clock;
+	using channel_t = asio::experimental::concurrent_channel<void(error_code)>;
+	using header_t = basic_header<char_t>;
+
+	struct entry
+	{
+		std::string data;
+		size_t head_size = 0;
+		clock_t::time_point time {};
+
+		// The handler's answer can not be cached, skip the waiting for a while.
+		bool pass = false;
+	};
+	using entry_ptr = std::shared_ptr<const entry>;
+
+	struct node
+	{
+		entry_ptr value;
+		clock_t::time_point expiry;
+		typename std::list<const std::string*>::iterator lru;
+	};
+
+	struct flight
+	{
+		flight(const auto &exec, clock_t::time_point deadline) :
+			channel(exec), deadline(deadline) {}
+
+		// Closed once the result is in, which wakes up every waiter.
+		channel_t channel;
+		clock_t::time_point deadline;
+	};
+	using flight_ptr = std::shared_ptr<flight>;
+
+	struct record
+	{
+		std::string key;
+		std::string data;
+		flight_ptr flight;
+	};
+
+public:
+	explicit impl(option_t option) : m_option(std::move(option))
+	{
+		for(auto &name : m_option.vary)
+			m_vary.emplace_back(str_to_lower(xxtombs(name)));
+	}
+
+public:
+	[[nodiscard]] bool make_key(context_t &context, std::string &key) const
+	{
+		auto &request = context.request();
+		if( request.transport() )
+			return false;
+
+		auto method = request.method();
+		if( method != method_t::GET and method != method_t::HEAD )
+			return false;
+
+		auto &headers = request.headers();
+		if( headers.contains(header_t::authorization) or headers.contains(header_t::range) or
+			headers.contains(header_t::upgrade) )
+			return false;
+
+		key.reserve(128);
+		key += method_string(method);
+		key += ' ';
+		key += version_string(request.version());
+		key += ' ';
+
+		// The same path on two virtual hosts is two resources.
+		if( auto it = headers.find(header_t::host); it != headers.end() )
+			key += str_to_lower(xxtombs(it->second.to_string()));
+		key += xxtombs(request.path());
+
+		// An absent value and an empty one are different keys.
+		auto &parameters = request.parameters();
+		for(auto &name : m_option.parameters)
+		{
+			key += '\n';
+			key += xxtombs(name);
+			if( auto it = parameters.find(name); it != parameters.end() )
+				key += '=' + xxtombs(it->second.to_string());
+		}
+		for(auto &name : m_option.vary)
+		{
+			key += '\r';
+			key += xxtombs(name);
+			if( auto it = headers.find(name); it != headers.end() )
+				key += ':' + xxtombs(it->second.to_string());
+		}
+		return true;
+	}
+
+	[[nodiscard]] entry_ptr find(const std::string &key, clock_t::time_point now)
+	{
+		auto it = m_entries.find(key);
+		if( it == m_entries.end() )
+			return {};
+		else if( it->second.expiry <= now )
+		{
+			erase(it);
+			return {};
+		}
+		m_lru.splice(m_lru.end(), m_lru, it->second.lru);
+		return it->second.value;
+	}
+
+	void insert(const std::string &key, entry_ptr value, clock_t::time_point expiry)
+	{
+		if( auto it = m_entries.find(key); it != m_entries.end() )
+			erase(it);
+
+		auto size = value->data.size() + key.size();
+		while( not m_lru.empty() and m_memory + size > m_option.max_memory )
+			erase(m_entries.find(*m_lru.front()));
+
+		auto [it, _] = m_entries.emplace(key, node{std::move(value), expiry, {}});
+		it->second.lru = m_lru.insert(m_lru.end(), &it->first);
+		m_memory += size;
+	}
+
+	void erase(typename std::unordered_map<std::string,node>::iterator it)
+	{
+		m_memory -= it->second.value->data.size() + it->first.size();
+		m_lru.erase(it->second.lru);
+		m_entries.erase(it);
+	}
+
+	[[nodiscard]] bool cacheable(context_t &context, const std::string &data) const
+	{
+		auto &response = context.response();
+		if( not response.is_finished() or data.size() > m_option.max_entry_size or
+			not response.cookies().empty() )
+			return false;
+
+		// Heuristically cacheable status codes (RFC 9111 section 4.2.2).
+		switch( response.status() )
+		{
+		case status::ok:
+		case status::non_authoritative_information:
+		case status::no_content:
+		case status::multiple_choices:
+		case status::moved_permanently:
+		case status::not_found:
+		case status::method_not_allowed:
+		case status::gone:
+		case status::uri_too_long:
+		case status::not_implemented:
+			break;
+		default:
+			return false;
+		}
+		auto &headers = response.headers();
+		if( auto it = headers.find(header_t::cache_control); it != headers.end() )
+		{
+			auto value = str_to_lower(xxtombs(it->second.to_string()));
+			if( value.find("no-store") != std::string::npos or value.find("private") != std::string::npos )
+				return false;
+		}
+		if( auto it = headers.find(header_t::vary); it != headers.end() )
+		{
+			// Only the request headers in 'option.vary' are part of the key, a response
+			// varying on any other one (or on '*') would be replayed to the wrong requests.
+			auto value = str_to_lower(xxtombs(it->second.to_string()));
+			for(size_t pos=0; pos<value.size();)
+			{
+				auto end = std::min(value.find(',', pos), value.size());
+				auto name = str_trimmed(std::string_view(value).substr(pos, end - pos));
+				pos = end + 1;
+
+				if( not name.empty() and std::ranges::find(m_vary, name) == m_vary.end() )
+					return false;
+			}
+		}
+		return true;
+	}
+
+	[[nodiscard]] awaitable<void> replay(context_t &context, const entry &value)
+	{
+		auto age = std::chrono::duration_cast<std::chrono::seconds>(clock_t::now() - value.time);
+		auto age_line = std::format("{}: {}\r\n\r\n", header::age, age.count());
+
+		// The head is stored with its blank line, 'age' goes in front of it.
+		const_buffer buffers[] {
+			buffer(value.data.data(), value.head_size - 2),
+			buffer(age_line.data(), age_line.size()),
+			buffer(value.data.data() + value.head_size, value.data.size() - value.head_size)
+		};
+		using namespace libgs::operators;
+		error_code error;
+		co_await context.response().write_serialized(buffers, use_awaitable | error);
+		co_return ;
+	}
+
+	void finish(context_t &context, bool store)
+	{
+		auto &response = context.response();
+		spin_unique_lock lock(m_mutex);
+
+		auto it = m_records.find(&context);
+		if( it == m_records.end() )
+			return ;
+
+		auto rec = std::move(it->second);
+		m_records.erase(it);
+		lock.unlock();
+
+		// The response stops recording past 'max_entry_size'.
+		bool complete = response.recorder() != nullptr;
+		response.set_recorder(nullptr);
+
+		auto value = std::make_shared<entry>();
+		value->time = clock_t::now();
+
+		if( store and complete and cacheable(context, rec.data) )
+		{
+			auto pos = rec.data.find("\r\n\r\n");
+			if( pos != std::string::npos )
+			{
+				value->head_size = pos + 4;
+				value->data = std::move(rec.data);
+			}
+			else
+				value->pass = true;
+		}
+		else
+			value->pass = true;
+
+		lock.lock();
+		insert(rec.key, std::move(value), clock_t::now() + m_option.ttl);
+		if( auto fit = m_flights.find(rec.key); fit != m_flights.end() and fit->second == rec.flight )
+			m_flights.erase(fit);
+		lock.unlock();
+		rec.flight->channel.close();
+	}
+
+	// The handler was torn down without after() or exception(), nothing is stored
+	// but its waiters are released.
+	void abandon(const void *context) noexcept
+	{
+		spin_unique_lock lock(m_mutex);
+		auto it = m_records.find(context);
+		if( it == m_records.end() )
+			return ;
+
+		auto rec = std::move(it->second);
+		m_records.erase(it);
+		if( auto fit = m_flights.find(rec.key); fit != m_flights.end() and fit->second == rec.flight )
+			m_flights.erase(fit);
+		lock.unlock();
+		rec.flight->channel.close();
+	}
+
+public:
+	option_t m_option;
+	std::vector<std::string> m_vary;
+	mutable spin_mutex m_mutex;
+
+	std::unordered_map<std::string,node> m_entries;
+	std::list<const std::string*> m_lru;
+	size_t m_memory = 0;
+
+	std::unordered_map<std::string,flight_ptr> m_flights;
+	std::unordered_map<const void*,record> m_records;
+
+	std::atomic_size_t m_hits {0};
+	std::atomic_size_t m_misses {0};
+	std::atomic_size_t m_coalesced {0};
+};
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_cache_aop<Stream,CharT>::basic_cache_aop(option_t option) :
+	m_impl(new impl(std::move(option)))
+{
+
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_cache_aop<Stream,CharT>::~basic_cache_aop()
+{
+	delete m_impl;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<bool> basic_cache_aop<Stream,CharT>::before(context_t &context)
+{
+	std::string key;
+	if( not m_impl->make_key(context, key) )
+		co_return false;
+
+	using clock_t = typename impl::clock_t;
+	for(bool waited = false;;)
+	{
+		typename impl::entry_ptr hit;
+		typename impl::flight_ptr wait;
+		std::string *record = nullptr;
+		auto now = clock_t::now();
+		{
+			spin_unique_lock lock(m_impl->m_mutex);
+			hit = m_impl->find(key, now);
+			if( not hit )
+			{
+				auto &flight = m_impl->m_flights[key];
+				if( flight and flight->deadline > now and not waited )
+					wait = flight;
+				else if( not flight or flight->deadline <= now )
+				{
+					// This request runs the handler, the response is recorded for after().
+					flight = std::make_shared<typename impl::flight>(
+						context.response().get_executor(), now + m_impl->m_option.lock_timeout
+					);
+					auto &rec = m_impl->m_records[&context];
+					rec = {key, {}, flight};
+					record = &rec.data;
+				}
+			}
+		}
+		if( record )
+		{
+			// Released with the response if neither after() nor exception() comes.
+			std::shared_ptr<void> guard(nullptr, [impl = m_impl, ptr = &context](void*){
+				impl->abandon(ptr);
+			});
+			context.response().set_recorder(record, m_impl->m_option.max_entry_size, std::move(guard));
+		}
+		if( hit and not hit->pass )
+		{
+			++m_impl->m_hits;
+			co_await m_impl->replay(context, *hit);
+			co_return true;
+		}
+		else if( not wait )
+		{
+			++m_impl->m_misses;
+			co_return false;
+		}
+		++m_impl->m_coalesced;
+		waited = true;
+
+		using namespace libgs::operators;
+		error_code error;
+		co_await (
+			wait->channel.async_receive(use_awaitable | error) or
+			sleep_for(co_await asio::this_coro::executor,
+				std::chrono::duration_cast<milliseconds>(wait->deadline - now))
+		);
+	}
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<bool> basic_cache_aop<Stream,CharT>::after(context_t &context)
+{
+	m_impl->finish(context, true);
+	co_return false;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_cache_aop<Stream,CharT>::exception(context_t &context, const std::exception &ex)
+{
+	ignore_unused(ex);
+	m_impl->finish(context, false);
+	return false;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+typename basic_cache_aop<Stream,CharT>::statistics basic_cache_aop<Stream,CharT>::stats() const noexcept
+{
+	statistics result;
+	result.hits = m_impl->m_hits;
+	result.misses = m_impl->m_misses;
+	result.coalesced = m_impl->m_coalesced;
+
+	spin_unique_lock lock(m_impl->m_mutex);
+	result.entries = m_impl->m_entries.size();
+	result.memory = m_impl->m_memory;
+	return result;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+void basic_cache_aop<Stream,CharT>::clear() noexcept
+{
+	spin_unique_lock lock(m_impl->m_mutex);
+	m_impl->m_entries.clear();
+	m_impl->m_lru.clear();
+	m_impl->m_memory = 0;
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_CACHE_AOP_H
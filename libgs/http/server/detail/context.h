@@ -38,39 +38,43 @@ class basic_service_context<Stream,CharT>::impl
 	LIBGS_DISABLE_COPY(impl)
 
 public:
-	impl(stream_t &&stream, parser_t &parser, session_set &sss) :
-		m_response(request_t(std::move(stream), parser)), m_sss(&sss) {}
+	impl(stream_t &&stream, parser_t &parser, session_set &sss, transport_t *transport) :
+		m_response(request_t(std::move(stream), parser, transport)), m_sss(&sss) {}
 
 	template<typename Stream0>
 	impl(typename basic_service_context<Stream0,char_t>::impl &&other) noexcept :
-		m_response(std::move(other)), m_sss(other.m_sss) {}
+		m_response(std::move(other.m_response)), m_sss(other.m_sss), m_trace(other.m_trace) {}
 
 	impl(impl &&other) noexcept :
-		m_response(std::move(other)), m_sss(other.m_sss) {}
+		m_response(std::move(other.m_response)), m_sss(other.m_sss), m_trace(other.m_trace) {}
 
 	template<typename Stream0>
 	impl &operator=(typename basic_service_context<Stream0,char_t>::impl &&other) noexcept
 	{
-		m_response = std::move(other);
+		m_response = std::move(other.m_response);
 		m_sss = other.m_sss;
+		m_trace = other.m_trace;
 		return *this;
 	}
 
 	impl &operator=(impl &&other) noexcept
 	{
-		m_response = std::move(other);
+		m_response = std::move(other.m_response);
 		m_sss = other.m_sss;
+		m_trace = other.m_trace;
 		return *this;
 	}
 
 public:
 	response_t m_response;
 	session_set *m_sss;
+	request_trace *m_trace = nullptr;
 };
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
-basic_service_context<Stream,CharT>::basic_service_context(stream_t &&stream, parser_t &parser, session_set &sss) :
-	m_impl(new impl(std::move(stream), parser, sss))
+basic_service_context<Stream,CharT>::basic_service_context
+(stream_t &&stream, parser_t &parser, session_set &sss, transport_t *transport) :
+	m_impl(arena::make<impl>(std::move(stream), parser, sss, transport))
 {
 
 }
@@ -78,12 +82,12 @@ basic_service_context<Stream,CharT>::basic_service_context(stream_t &&stream, pa
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_service_context<Stream,CharT>::~basic_service_context()
 {
-	delete m_impl;
+
 }
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_service_context<Stream,CharT>::basic_service_context(basic_service_context &&other) noexcept :
-	m_impl(new impl(*other.m_impl))
+	m_impl(std::move(other.m_impl))
 {
 
 }
@@ -92,8 +96,9 @@ template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_service_context<Stream,CharT> &basic_service_context<Stream,CharT>::operator=
 (basic_service_context &&other) noexcept
 {
-	if( this != &other )
-		*m_impl = *other.m_impl;
+	if( this == &other )
+		return *this;
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
@@ -101,7 +106,7 @@ template <concepts::stream Stream, core_concepts::char_type CharT>
 template<typename Stream0>
 basic_service_context<Stream,CharT>::basic_service_context(basic_service_context<Stream0,char_t> &&other) noexcept
 	requires core_concepts::constructible<Stream,Stream0&&> :
-	m_impl(new impl(*other.m_impl))
+	m_impl(arena::make<impl>(std::move(*other.m_impl)))
 {
 
 }
@@ -111,8 +116,7 @@ template<typename Stream0>
 basic_service_context<Stream,CharT> &basic_service_context<Stream,CharT>::operator=
 (basic_service_context<Stream0,CharT> &&other) noexcept requires core_concepts::assignable<Stream,Stream0&&>
 {
-	if( this != &other )
-		*m_impl = *other.m_impl;
+	*m_impl = std::move(*other.m_impl);
 	return *this;
 }
 
@@ -147,6 +151,27 @@ basic_service_context<Stream,CharT>::get_executor() noexcept
 	return request().get_executor();
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+request_trace *basic_service_context<Stream,CharT>::trace() noexcept
+{
+	return m_impl->m_trace;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+request_trace::scope basic_service_context<Stream,CharT>::span(std::string_view name) noexcept
+{
+	if( m_impl->m_trace )
+		return m_impl->m_trace->span(name);
+	return {};
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+void basic_service_context<Stream,CharT>::set_trace(request_trace *trace) noexcept
+{
+	m_impl->m_trace = trace;
+	response().set_trace(trace);
+}
+
 template <concepts::stream Stream, core_concepts::char_type CharT>
 template <typename Session, typename...Args>
 std::shared_ptr<Session> basic_service_context<Stream,CharT>::session(Args&&...args) requires
@@ -0,0 +1,1430 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_H2_CONNECTION_H
+#define LIBGS_HTTP_SERVER_DETAIL_H2_CONNECTION_H
+
+#include <charconv>
+
+namespace libgs::http
+{
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+class basic_h2_connection<Stream,CharT>::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+	using sock_helper_t = socket_operation_helper<next_layer_t>;
+	using endpoint_t = typename sock_helper_t::endpoint_t;
+	using executor_t = typename next_layer_t::executor_type;
+	using strand_t = asio::strand<executor_t>;
+
+	using header_t = basic_header<char_t>;
+	using transport_t = basic_server_transport<next_layer_t>;
+	using fields_t = std::vector<std::pair<std::string,std::string>>;
+
+public:
+	static constexpr size_t read_block_size = 0x10000;
+	static constexpr size_t write_high_water = 0x40000;
+	static constexpr size_t max_response_line = 0x2000;
+
+	enum class response_state
+	{
+		head, length, raw, chunk_size, chunk_data, chunk_crlf, trailers, done
+	};
+
+	class stream final : public transport_t
+	{
+		LIBGS_DISABLE_COPY_MOVE(stream)
+
+	public:
+		stream(impl &conn, uint32_t id) :
+			m_conn(&conn),
+			id(id),
+			send_window(conn.m_peer.initial_window_size),
+			recv_window(conn.m_option.initial_window_size),
+			signal(conn.m_strand, asio::steady_timer::time_point::max()) {}
+
+	public:
+		[[nodiscard]] awaitable<size_t> co_read(const mutable_buffer &buf, error_code &error) noexcept override {
+			return m_conn->co_stream_read(*this, buf, error);
+		}
+		[[nodiscard]] awaitable<size_t> co_write(std::string_view data, error_code &error) noexcept override {
+			return m_conn->co_stream_write(*this, data, error);
+		}
+		[[nodiscard]] endpoint_t remote_endpoint() const override {
+			return sock_helper_t(*m_conn->m_next_layer).remote_endpoint();
+		}
+		[[nodiscard]] endpoint_t local_endpoint() const override {
+			return sock_helper_t(*m_conn->m_next_layer).local_endpoint();
+		}
+		[[nodiscard]] peer_credentials peer_cred(error_code &error) const noexcept override
+		{
+			if constexpr( is_local_stream_v<next_layer_t> )
+				return sock_helper_t(*m_conn->m_next_layer).peer_cred(error);
+			else
+				return transport_t::peer_cred(error);
+		}
+		void cancel() noexcept override {
+			m_conn->reset_stream(*this, h2_errno::CNCL);
+		}
+
+	private:
+		impl *m_conn;
+
+	public:
+		const uint32_t id;
+		parser_t parser {};
+		std::string head {};
+
+		int64_t send_window;
+		int64_t recv_window;
+		size_t recv_consumed = 0;
+
+		std::string body {};
+		size_t body_pos = 0;
+
+		bool remote_closed = false;
+		bool local_closed = false;
+		bool buffered = false;
+		bool dispatched = false;
+
+		// Set once the stream is reset (by either side) or the connection goes away.
+		error_code error {};
+		asio::steady_timer signal;
+
+		response_state rstate = response_state::head;
+		std::string rline {};
+		size_t rremaining = 0;
+		fields_t trailers {};
+	};
+	using stream_ptr = std::shared_ptr<stream>;
+
+public:
+	impl(next_layer_t &next_layer, session_set &sss, const h2_option &option) :
+		m_next_layer(&next_layer),
+		m_sss(&sss),
+		m_option(option),
+		m_strand(asio::make_strand(next_layer.get_executor())),
+		m_decoder(option.header_table_size),
+		// SETTINGS only apply to streams, the connection window always starts at the default.
+		m_recv_window(std::max<uint32_t>(h2_frame::default_window_size, option.initial_window_size)),
+		m_write_signal(m_strand, asio::steady_timer::time_point::max()),
+		m_drain_signal(m_strand, asio::steady_timer::time_point::max()),
+		m_window_signal(m_strand, asio::steady_timer::time_point::max()),
+		m_idle_signal(m_strand, asio::steady_timer::time_point::max())
+	{
+		m_option.max_frame_size = std::clamp(m_option.max_frame_size, h2_frame::min_frame_size, h2_frame::max_frame_size);
+		m_option.initial_window_size = std::min(m_option.initial_window_size, h2_frame::max_window_size);
+		if( m_option.max_concurrent_streams == 0 )
+			m_option.max_concurrent_streams = 1;
+	}
+
+public:
+	[[nodiscard]] awaitable<void> co_run(std::string_view data)
+	{
+		m_rbuf.assign(data);
+		co_await asio::co_spawn(m_strand, [this]() -> awaitable<void>
+		{
+			send_preface();
+			for(auto &[id, stream] : m_streams)
+				dispatch(stream);
+
+			co_await (co_read_loop() and co_write_loop());
+			while( m_active > 0 )
+				co_await co_wait_signal(m_idle_signal);
+			co_return ;
+		},
+		use_awaitable);
+	}
+
+	[[nodiscard]] awaitable<bool> co_upgrade(parser_t &parser)
+	{
+		error_code error;
+		auto it = parser.headers().find(header_t::http2_settings);
+		if( it != parser.headers().end() )
+		{
+			auto payload = h2_frame::decode_settings_header(xxtombs(it->second.to_string()), error);
+			if( not error )
+				h2_frame::apply_settings(buffer(payload), m_peer, error);
+		}
+		if( it == parser.headers().end() or error )
+			co_return false;
+
+		m_encoder.set_max_table_size(m_peer.header_table_size);
+		m_wbuf = "HTTP/1.1 101 Switching Protocols\r\nConnection: Upgrade\r\nUpgrade: h2c\r\n\r\n";
+
+		// The upgrade request is half-closed (remote) stream 1.
+		auto stream = std::make_shared<impl::stream>(*this, 1);
+		stream->parser = std::move(parser);
+		stream->remote_closed = true;
+
+		m_streams.emplace(1, std::move(stream));
+		m_last_stream_id = 1;
+		co_await co_run({});
+		co_return true;
+	}
+
+private:
+	[[nodiscard]] awaitable<bool> co_wait_signal(asio::steady_timer &signal)
+	{
+		using namespace libgs::operators;
+		error_code error;
+		co_await signal.async_wait(use_awaitable | error);
+		auto state = co_await asio::this_coro::cancellation_state;
+		co_return state.cancelled() == asio::cancellation_type::none;
+	}
+
+	[[nodiscard]] awaitable<bool> co_fill(size_t size, error_code &error)
+	{
+		using namespace libgs::operators;
+		while( m_rbuf.size() - m_rpos < size )
+		{
+			if( m_rpos > 0 )
+			{
+				m_rbuf.erase(0, m_rpos);
+				m_rpos = 0;
+			}
+			const auto old_size = m_rbuf.size();
+			m_rbuf.resize(old_size + read_block_size);
+			auto buf = buffer(m_rbuf.data() + old_size, read_block_size);
+
+			size_t res = 0;
+			if( m_streams.empty() and m_idle_timeout > milliseconds(0) )
+			{
+				auto var = co_await (
+					m_next_layer->async_read_some(buf, use_awaitable | error) or
+					sleep_for(m_next_layer->get_executor(), m_idle_timeout)
+				);
+				if( var.index() == 1 )
+				{
+					m_rbuf.resize(old_size);
+					error = make_error_code(errc::timed_out);
+					co_return false;
+				}
+				res = std::get<0>(var);
+			}
+			else
+				res = co_await m_next_layer->async_read_some(buf, use_awaitable | error);
+
+			m_rbuf.resize(old_size + res);
+			if( error )
+				co_return false;
+			else if( res == 0 )
+			{
+				error = make_error_code(errc::eof);
+				co_return false;
+			}
+		}
+		co_return true;
+	}
+
+	[[nodiscard]] awaitable<void> co_read_loop()
+	{
+		error_code error;
+		do {
+			if( not co_await co_fill(h2_frame::preface.size(), error) )
+				break;
+			else if( std::string_view(m_rbuf).substr(m_rpos, h2_frame::preface.size()) != h2_frame::preface )
+			{
+				error = h2_frame::make_error_code(h2_errno::PROTO);
+				break;
+			}
+			m_rpos += h2_frame::preface.size();
+			while( not m_closing )
+			{
+				if( not co_await co_fill(h2_frame::header_size, error) )
+					break;
+
+				h2_frame::header_buffer_t header_buf;
+				memcpy(header_buf.data(), m_rbuf.data() + m_rpos, header_buf.size());
+
+				auto header = h2_frame::decode_header(header_buf);
+				if( header.length > m_option.max_frame_size )
+				{
+					error = h2_frame::make_error_code(h2_errno::FSZ);
+					break;
+				}
+				if( not co_await co_fill(h2_frame::header_size + header.length, error) )
+					break;
+
+				std::string_view payload(m_rbuf.data() + m_rpos + h2_frame::header_size, header.length);
+				m_rpos += h2_frame::header_size + header.length;
+
+				on_frame(header, payload, error);
+				if( error or (m_goaway and m_streams.empty()) )
+					break;
+			}
+		}
+		while(false);
+		terminate(error);
+		co_return ;
+	}
+
+	[[nodiscard]] awaitable<void> co_write_loop()
+	{
+		using namespace libgs::operators;
+		std::string buf;
+		for(;;)
+		{
+			if( m_wbuf.empty() )
+			{
+				if( m_closing )
+					break;
+				co_await co_wait_signal(m_write_signal);
+				continue;
+			}
+			buf.clear();
+			buf.swap(m_wbuf);
+
+			error_code error;
+			co_await asio::async_write(*m_next_layer, buffer(buf), use_awaitable | error);
+			m_drain_signal.cancel();
+			if( error )
+			{
+				// Wakes the reader up, it tears the connection down.
+				m_wbuf.clear();
+				sock_helper_t(*m_next_layer).cancel();
+				break;
+			}
+		}
+		co_return ;
+	}
+
+	void terminate(const error_code &error)
+	{
+		if( m_closing )
+			return ;
+		if( error.category() == detail::h2_error_category::instance() )
+			send_goaway(static_cast<h2_errno>(error.value()));
+		else if( error == errc::timed_out )
+			send_goaway(h2_errno::NOE);
+
+		m_closing = true;
+		m_error = error ? error : std::make_error_code(std::errc::connection_aborted);
+
+		for(auto it=m_streams.begin(); it!=m_streams.end();)
+		{
+			auto &stream = *it->second;
+			if( not stream.error )
+				stream.error = m_error;
+			stream.signal.cancel();
+
+			if( stream.dispatched )
+				++it;
+			else
+				it = m_streams.erase(it);
+		}
+		m_write_signal.cancel();
+		m_drain_signal.cancel();
+		m_window_signal.cancel();
+	}
+
+private:
+	void on_frame(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		// A header block must not be interleaved with any other frame.
+		if( m_header_stream_id != 0 and
+			(header.type != h2_frame_type::continuation or header.stream_id != m_header_stream_id) )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		switch( header.type )
+		{
+			case h2_frame_type::data:
+				return on_data(header, payload, error);
+			case h2_frame_type::headers:
+				return on_headers(header, payload, error);
+			case h2_frame_type::continuation:
+				return on_continuation(header, payload, error);
+			case h2_frame_type::settings:
+				return on_settings(header, payload, error);
+			case h2_frame_type::window_update:
+				return on_window_update(header, payload, error);
+			case h2_frame_type::rst_stream:
+				return on_rst_stream(header, payload, error);
+			case h2_frame_type::ping:
+				return on_ping(header, payload, error);
+			case h2_frame_type::goaway:
+				if( header.stream_id != 0 )
+					error = h2_frame::make_error_code(h2_errno::PROTO);
+				m_goaway = true;
+				return ;
+			case h2_frame_type::priority:
+				if( header.stream_id == 0 )
+					error = h2_frame::make_error_code(h2_errno::PROTO);
+				return ;
+			case h2_frame_type::push_promise:
+				error = h2_frame::make_error_code(h2_errno::PROTO);
+				return ;
+			default:
+				// Unknown frame types must be ignored.
+				return ;
+		}
+	}
+
+	void on_data(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( header.stream_id == 0 )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		// Flow control covers the whole payload, padding included.
+		const size_t size = payload.size();
+		if( static_cast<int64_t>(size) > m_recv_window )
+		{
+			error = h2_frame::make_error_code(h2_errno::FLOW);
+			return ;
+		}
+		m_recv_window -= static_cast<int64_t>(size);
+
+		if( not strip_padding(header, payload, error) )
+			return ;
+
+		auto stream = find_stream(header.stream_id);
+		if( not stream or stream->remote_closed or stream->error )
+		{
+			consume(nullptr, size);
+			if( header.stream_id > m_last_stream_id )
+				error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		else if( static_cast<int64_t>(size) > stream->recv_window )
+		{
+			consume(nullptr, size);
+			reset_stream(*stream, h2_errno::FLOW);
+			return ;
+		}
+		stream->recv_window -= static_cast<int64_t>(size);
+		if( header.flags & h2_frame_flag::end_stream )
+			stream->remote_closed = true;
+
+		if( stream->buffered )
+		{
+			// Not backpressured by a reader, the window is handed back right away.
+			if( stream->body.size() + payload.size() > m_option.max_buffered_body )
+			{
+				consume(nullptr, size);
+				send_headers(stream->id, {{":status", "413"}}, true);
+				reset_stream(*stream, h2_errno::NOE);
+				return ;
+			}
+			stream->body.append(payload);
+			consume(stream.get(), size);
+			if( stream->remote_closed )
+				dispatch(stream);
+			return ;
+		}
+		stream->body.append(payload);
+		consume(stream.get(), size - payload.size());
+		stream->signal.cancel();
+	}
+
+	void on_headers(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( header.stream_id == 0 )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		if( not strip_padding(header, payload, error) )
+			return ;
+
+		if( header.flags & h2_frame_flag::priority )
+		{
+			if( payload.size() < 5 )
+			{
+				error = h2_frame::make_error_code(h2_errno::FSZ);
+				return ;
+			}
+			payload.remove_prefix(5);
+		}
+		m_header_block.assign(payload);
+		m_header_stream_id = header.stream_id;
+		m_header_flags = header.flags;
+
+		if( header.flags & h2_frame_flag::end_headers )
+			on_header_block(error);
+	}
+
+	void on_continuation(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( m_header_stream_id == 0 )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		m_header_block.append(payload);
+		if( m_header_block.size() > m_option.max_header_list_size * 2 + m_option.max_frame_size )
+		{
+			error = h2_frame::make_error_code(h2_errno::CALM);
+			return ;
+		}
+		if( header.flags & h2_frame_flag::end_headers )
+			on_header_block(error);
+	}
+
+	void on_header_block(error_code &error)
+	{
+		const auto stream_id = std::exchange(m_header_stream_id, 0);
+		const bool end_stream = m_header_flags & h2_frame_flag::end_stream;
+
+		hpack_fields fields;
+		m_decoder.decode(buffer(m_header_block), fields, error);
+		m_header_block.clear();
+		if( error )
+			return ;
+
+		if( auto stream = find_stream(stream_id) )
+		{
+			// Trailers, they are not part of the HTTP/1.1 view of the request.
+			if( stream->remote_closed or stream->error )
+				reset_stream(*stream, h2_errno::STCL);
+			else if( not end_stream )
+				reset_stream(*stream, h2_errno::PROTO);
+			else
+			{
+				stream->remote_closed = true;
+				if( stream->buffered )
+					dispatch(stream);
+				stream->signal.cancel();
+			}
+			return ;
+		}
+		else if( stream_id % 2 == 0 )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		else if( stream_id <= m_last_stream_id )
+		{
+			send_rst_stream(stream_id, h2_errno::STCL);
+			return ;
+		}
+		m_last_stream_id = stream_id;
+		if( m_goaway )
+			return ;
+		else if( m_streams.size() >= m_option.max_concurrent_streams )
+		{
+			send_rst_stream(stream_id, h2_errno::RFS);
+			return ;
+		}
+		auto stream = std::make_shared<impl::stream>(*this, stream_id);
+		bool has_length = false;
+
+		auto res = make_request_head(fields, stream->head, has_length);
+		if( res == status::request_header_fields_too_large )
+		{
+			send_headers(stream_id, {{":status", "431"}}, true);
+			return ;
+		}
+		else if( res != status::ok )
+		{
+			send_rst_stream(stream_id, h2_errno::PROTO);
+			return ;
+		}
+		stream->remote_closed = end_stream;
+		m_streams.emplace(stream_id, stream);
+
+		if( has_length or end_stream )
+			dispatch(stream);
+		else
+			stream->buffered = true;
+	}
+
+	void on_settings(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( header.stream_id != 0 )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		else if( header.flags & h2_frame_flag::ack )
+		{
+			if( not payload.empty() )
+				error = h2_frame::make_error_code(h2_errno::FSZ);
+			return ;
+		}
+		auto settings = m_peer;
+		h2_frame::apply_settings(buffer(payload), settings, error);
+		if( error )
+			return ;
+
+		const auto delta = static_cast<int64_t>(settings.initial_window_size) -
+						   static_cast<int64_t>(m_peer.initial_window_size);
+		for(auto &[id, stream] : m_streams)
+		{
+			stream->send_window += delta;
+			if( stream->send_window > h2_frame::max_window_size )
+			{
+				error = h2_frame::make_error_code(h2_errno::FLOW);
+				return ;
+			}
+		}
+		if( settings.header_table_size != m_peer.header_table_size )
+			m_encoder.set_max_table_size(settings.header_table_size);
+
+		m_peer = settings;
+		send_frame(h2_frame_type::settings, h2_frame_flag::ack, 0, {});
+		m_window_signal.cancel();
+	}
+
+	void on_window_update(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( payload.size() != 4 )
+		{
+			error = h2_frame::make_error_code(h2_errno::FSZ);
+			return ;
+		}
+		const auto increment = h2_frame::decode_uint32(payload.data()) & 0x7FFFFFFF;
+		if( header.stream_id == 0 )
+		{
+			m_send_window += increment;
+			if( increment == 0 )
+				error = h2_frame::make_error_code(h2_errno::PROTO);
+			else if( m_send_window > h2_frame::max_window_size )
+				error = h2_frame::make_error_code(h2_errno::FLOW);
+		}
+		else if( auto stream = find_stream(header.stream_id) )
+		{
+			stream->send_window += increment;
+			if( increment == 0 )
+				reset_stream(*stream, h2_errno::PROTO);
+			else if( stream->send_window > h2_frame::max_window_size )
+				reset_stream(*stream, h2_errno::FLOW);
+		}
+		m_window_signal.cancel();
+	}
+
+	void on_rst_stream(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( header.stream_id == 0 or header.stream_id > m_last_stream_id )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return ;
+		}
+		else if( payload.size() != 4 )
+		{
+			error = h2_frame::make_error_code(h2_errno::FSZ);
+			return ;
+		}
+		auto stream = find_stream(header.stream_id);
+		if( not stream )
+			return ;
+
+		const auto code = h2_frame::from_wire_code(h2_frame::decode_uint32(payload.data()));
+		if( not stream->error )
+			stream->error = h2_frame::make_error_code(code);
+
+		if( not stream->dispatched )
+			m_streams.erase(stream->id);
+		stream->signal.cancel();
+		m_window_signal.cancel();
+	}
+
+	void on_ping(const h2_frame_header &header, std::string_view payload, error_code &error)
+	{
+		if( header.stream_id != 0 )
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+		else if( payload.size() != 8 )
+			error = h2_frame::make_error_code(h2_errno::FSZ);
+		else if( not (header.flags & h2_frame_flag::ack) )
+			send_frame(h2_frame_type::ping, h2_frame_flag::ack, 0, payload);
+	}
+
+	[[nodiscard]] bool strip_padding(const h2_frame_header &header, std::string_view &payload, error_code &error)
+	{
+		if( not (header.flags & h2_frame_flag::padded) )
+			return true;
+		else if( payload.empty() )
+		{
+			error = h2_frame::make_error_code(h2_errno::FSZ);
+			return false;
+		}
+		const auto padding = static_cast<uint8_t>(payload[0]);
+		if( padding >= payload.size() )
+		{
+			error = h2_frame::make_error_code(h2_errno::PROTO);
+			return false;
+		}
+		payload = payload.substr(1, payload.size() - 1 - padding);
+		return true;
+	}
+
+private:
+	[[nodiscard]] status_t make_request_head(const hpack_fields &fields, std::string &head, bool &has_length)
+	{
+		std::string_view method, scheme, path, authority;
+		std::string headers, cookie;
+		size_t list_size = 0;
+		bool regular = false;
+
+		auto valid = [](std::string_view str, bool name)
+		{
+			return std::ranges::none_of(str, [name](char c) {
+				return c == '\r' or c == '\n' or c == '\0' or (name and c >= 'A' and c <= 'Z');
+			});
+		};
+		for(auto &field : fields)
+		{
+			list_size += field.name.size() + field.value.size() + 32;
+			if( field.name.empty() or not valid(field.name, true) or not valid(field.value, false) )
+				return status::bad_request;
+
+			else if( field.name[0] == ':' )
+			{
+				std::string_view *pseudo = nullptr;
+				if( field.name == ":method" )
+					pseudo = &method;
+				else if( field.name == ":scheme" )
+					pseudo = &scheme;
+				else if( field.name == ":path" )
+					pseudo = &path;
+				else if( field.name == ":authority" )
+					pseudo = &authority;
+
+				// Pseudo-headers come first, once each.
+				if( regular or not pseudo or not pseudo->empty() )
+					return status::bad_request;
+				*pseudo = field.value;
+				continue;
+			}
+			regular = true;
+			if( field.name == "connection" or field.name == "keep-alive" or field.name == "proxy-connection" or
+				field.name == "transfer-encoding" or field.name == "upgrade" or
+				(field.name == "te" and field.value != "trailers") )
+				return status::bad_request;
+
+			else if( field.name == "cookie" )
+			{
+				if( not cookie.empty() )
+					cookie += "; ";
+				cookie += field.value;
+				continue;
+			}
+			else if( field.name == "host" and not authority.empty() )
+				continue;
+			else if( field.name == "content-length" )
+				has_length = true;
+			headers += field.name + ": " + field.value + "\r\n";
+		}
+		if( list_size > m_option.max_header_list_size )
+			return status::request_header_fields_too_large;
+
+		else if( method.empty() or scheme.empty() or path.empty() or path.find(' ') != std::string_view::npos )
+			return status::bad_request;
+
+		head.reserve(method.size() + path.size() + authority.size() + headers.size() + cookie.size() + 48);
+		head.append(method).append(" ").append(path).append(" HTTP/2.0\r\n");
+		if( not authority.empty() )
+			head.append("host: ").append(authority).append("\r\n");
+
+		head += headers;
+		if( not cookie.empty() )
+			head.append("cookie: ").append(cookie).append("\r\n");
+		return status::ok;
+	}
+
+	void dispatch(const stream_ptr &stream)
+	{
+		if( stream->dispatched )
+			return ;
+		stream->dispatched = true;
+
+		// The upgraded stream 1 comes with a parsed request.
+		if( not stream->head.empty() )
+		{
+			if( stream->buffered )
+				stream->head += std::format("content-length: {}\r\n\r\n", stream->body.size()) + stream->body;
+			else
+				stream->head += "\r\n";
+
+			std::string().swap(stream->body);
+			error_code error;
+
+			bool res = stream->parser.append(buffer(stream->head), error);
+			std::string().swap(stream->head);
+			if( error or not res )
+			{
+				reset_stream(*stream, h2_errno::PROTO);
+				m_streams.erase(stream->id);
+				return ;
+			}
+		}
+		++m_active;
+		asio::co_spawn(m_strand, [this, stream]() -> awaitable<void>
+		{
+			co_await co_service(stream);
+			m_streams.erase(stream->id);
+			if( --m_active == 0 )
+				m_idle_signal.cancel();
+			co_return ;
+		},
+		asio::detached);
+	}
+
+	[[nodiscard]] awaitable<void> co_service(const stream_ptr &stream)
+	{
+		try {
+			context_t context(make_stream_socket(), stream->parser, *m_sss, stream.get());
+			co_await m_handler(context);
+		}
+		catch(const std::exception &ex)
+		{
+			spdlog::error("libgs::http::server: h2: Unhandled exception: {}.", ex);
+			reset_stream(*stream, h2_errno::INTL);
+		}
+		if( not stream->error and not stream->local_closed )
+		{
+			// Ends a response whose length was not known up front.
+			error_code error;
+			co_await co_send_data(*stream, {}, true, error);
+		}
+		// The rest of the request body is no longer wanted.
+		if( not stream->error and not stream->remote_closed )
+			send_rst_stream(stream->id, h2_errno::NOE);
+		co_return ;
+	}
+
+	[[nodiscard]] next_layer_t make_stream_socket()
+	{
+		// Never opened, the stream is carried by the transport.
+#ifdef LIBGS_ENABLE_OPENSSL
+		if constexpr( is_ssl_stream_v<next_layer_t> )
+			return next_layer_t(m_next_layer->get_executor(), *m_ssl);
+		else
+#endif //LIBGS_ENABLE_OPENSSL
+			return next_layer_t(m_next_layer->get_executor());
+	}
+
+	[[nodiscard]] stream_ptr find_stream(uint32_t id)
+	{
+		auto it = m_streams.find(id);
+		return it == m_streams.end() ? nullptr : it->second;
+	}
+
+private:
+	[[nodiscard]] awaitable<size_t> co_stream_read(stream &stream, const mutable_buffer &buf, error_code &error)
+	{
+		error = error_code();
+		if( buf.size() == 0 )
+			co_return 0;
+		for(;;)
+		{
+			if( stream.error )
+			{
+				error = stream.error;
+				co_return 0;
+			}
+			else if( stream.body_pos < stream.body.size() )
+			{
+				const auto size = std::min(buf.size(), stream.body.size() - stream.body_pos);
+				memcpy(buf.data(), stream.body.data() + stream.body_pos, size);
+
+				stream.body_pos += size;
+				if( stream.body_pos == stream.body.size() )
+				{
+					stream.body.clear();
+					stream.body_pos = 0;
+				}
+				consume(&stream, size);
+				co_return size;
+			}
+			else if( stream.remote_closed )
+				co_return 0;
+
+			else if( not co_await co_wait_signal(stream.signal) )
+			{
+				error = std::make_error_code(std::errc::operation_canceled);
+				co_return 0;
+			}
+		}
+	}
+
+	[[nodiscard]] awaitable<size_t> co_stream_write(stream &stream, std::string_view data, error_code &error)
+	{
+		error = error_code();
+		const size_t size = data.size();
+
+		while( not data.empty() and not error )
+		{
+			if( stream.error )
+			{
+				error = stream.error;
+				break;
+			}
+			switch( stream.rstate )
+			{
+				case response_state::head:
+				{
+					const auto old_size = stream.rline.size();
+					stream.rline.append(data);
+
+					auto pos = stream.rline.find("\r\n\r\n", old_size < 3 ? 0 : old_size - 3);
+					if( pos == std::string::npos )
+					{
+						if( stream.rline.size() > max_response_line * 8 )
+							error = h2_frame::make_error_code(h2_errno::INTL);
+						data = {};
+						break;
+					}
+					data.remove_prefix(pos + 4 - old_size);
+					stream.rline.resize(pos + 2);
+
+					co_await co_send_response_head(stream, error);
+					stream.rline.clear();
+					break;
+				}
+				case response_state::length:
+				{
+					const auto _size = std::min(data.size(), stream.rremaining);
+					stream.rremaining -= _size;
+
+					co_await co_send_data(stream, data.substr(0, _size), stream.rremaining == 0, error);
+					data.remove_prefix(_size);
+					if( stream.rremaining == 0 )
+						stream.rstate = response_state::done;
+					break;
+				}
+				case response_state::raw:
+					co_await co_send_data(stream, data, false, error);
+					data = {};
+					break;
+
+				case response_state::chunk_size:
+				{
+					if( not take_line(stream, data, error) )
+						break;
+
+					std::string_view line = stream.rline;
+					line = line.substr(0, line.find(';'));
+					while( not line.empty() and (line.back() == ' ' or line.back() == '\t') )
+						line.remove_suffix(1);
+
+					size_t chunk_size = 0;
+					auto res = std::from_chars(line.data(), line.data() + line.size(), chunk_size, 16);
+					if( line.empty() or res.ec != std::errc() or res.ptr != line.data() + line.size() )
+					{
+						error = h2_frame::make_error_code(h2_errno::INTL);
+						break;
+					}
+					stream.rline.clear();
+					stream.rremaining = chunk_size;
+					stream.rstate = chunk_size == 0 ? response_state::trailers : response_state::chunk_data;
+					break;
+				}
+				case response_state::chunk_data:
+				{
+					const auto _size = std::min(data.size(), stream.rremaining);
+					co_await co_send_data(stream, data.substr(0, _size), false, error);
+
+					data.remove_prefix(_size);
+					stream.rremaining -= _size;
+					if( stream.rremaining == 0 )
+					{
+						stream.rremaining = 2;
+						stream.rstate = response_state::chunk_crlf;
+					}
+					break;
+				}
+				case response_state::chunk_crlf:
+				{
+					const auto _size = std::min(data.size(), stream.rremaining);
+					data.remove_prefix(_size);
+					stream.rremaining -= _size;
+					if( stream.rremaining == 0 )
+						stream.rstate = response_state::chunk_size;
+					break;
+				}
+				case response_state::trailers:
+				{
+					if( not take_line(stream, data, error) )
+						break;
+					else if( not stream.rline.empty() )
+					{
+						auto pos = stream.rline.find(':');
+						if( pos != std::string::npos )
+						{
+							std::string_view line = stream.rline;
+							stream.trailers.emplace_back (
+								str_to_lower(str_trimmed(line.substr(0, pos))),
+								str_trimmed(line.substr(pos + 1))
+							);
+						}
+						stream.rline.clear();
+						break;
+					}
+					stream.rstate = response_state::done;
+					if( stream.trailers.empty() )
+						co_await co_send_data(stream, {}, true, error);
+					else if( co_await co_wait_writable(stream, error) )
+					{
+						send_headers(stream.id, stream.trailers, true);
+						stream.local_closed = true;
+					}
+					break;
+				}
+				default:
+					data = {};
+					break;
+			}
+		}
+		co_return error ? 0 : size;
+	}
+
+	[[nodiscard]] bool take_line(stream &stream, std::string_view &data, error_code &error)
+	{
+		// The CRLF may have been split by the previous write.
+		if( stream.rline.ends_with('\r') and data.starts_with('\n') )
+		{
+			stream.rline.pop_back();
+			data.remove_prefix(1);
+			return true;
+		}
+		auto pos = data.find("\r\n");
+		if( pos == std::string_view::npos )
+		{
+			stream.rline.append(data);
+			data = {};
+			if( stream.rline.size() > max_response_line )
+				error = h2_frame::make_error_code(h2_errno::INTL);
+			return false;
+		}
+		stream.rline.append(data.substr(0, pos));
+		data.remove_prefix(pos + 2);
+		return true;
+	}
+
+	[[nodiscard]] awaitable<void> co_send_response_head(stream &stream, error_code &error)
+	{
+		// "HTTP/x.y code reason\r\n" followed by "key: value\r\n" lines.
+		std::string_view head = stream.rline;
+		auto pos = head.find("\r\n");
+
+		auto status_line = head.substr(0, pos);
+		head.remove_prefix(pos + 2);
+
+		pos = status_line.find(' ');
+		if( pos == std::string_view::npos or status_line.size() < pos + 4 )
+		{
+			error = h2_frame::make_error_code(h2_errno::INTL);
+			co_return ;
+		}
+		fields_t fields {{":status", std::string(status_line.substr(pos + 1, 3))}};
+		std::optional<size_t> length;
+		bool chunked = false;
+
+		while( not head.empty() )
+		{
+			pos = head.find("\r\n");
+			auto line = head.substr(0, pos);
+			head.remove_prefix(std::min(pos + 2, head.size()));
+
+			pos = line.find(':');
+			if( pos == std::string_view::npos )
+				continue;
+
+			auto name = str_to_lower(str_trimmed(line.substr(0, pos)));
+			auto value = str_trimmed(line.substr(pos + 1));
+
+			// Connection-specific fields are not allowed in HTTP/2.
+			if( name == "transfer-encoding" )
+			{
+				chunked = str_to_lower(value).find("chunked") != std::string::npos;
+				continue;
+			}
+			else if( name == "connection" or name == "keep-alive" or
+					 name == "proxy-connection" or name == "upgrade" )
+				continue;
+
+			else if( name == "content-length" )
+			{
+				size_t _length = 0;
+				auto res = std::from_chars(value.data(), value.data() + value.size(), _length);
+				if( res.ec == std::errc() )
+					length = _length;
+			}
+			fields.emplace_back(std::move(name), std::move(value));
+		}
+		if( chunked )
+		{
+			std::erase_if(fields, [](auto &field) { return field.first == "content-length"; });
+			stream.rstate = response_state::chunk_size;
+		}
+		else if( length )
+		{
+			stream.rremaining = *length;
+			stream.rstate = *length == 0 ? response_state::done : response_state::length;
+		}
+		else
+			stream.rstate = response_state::raw;
+
+		if( not co_await co_wait_writable(stream, error) )
+			co_return ;
+
+		const bool end_stream = stream.rstate == response_state::done;
+		send_headers(stream.id, fields, end_stream);
+		stream.local_closed = end_stream;
+	}
+
+	[[nodiscard]] awaitable<bool> co_wait_writable(stream &stream, error_code &error)
+	{
+		for(;;)
+		{
+			if( stream.error )
+			{
+				error = stream.error;
+				co_return false;
+			}
+			else if( m_closing )
+			{
+				error = m_error;
+				co_return false;
+			}
+			else if( m_wbuf.size() < write_high_water )
+				co_return true;
+
+			else if( not co_await co_wait_signal(m_drain_signal) )
+			{
+				error = std::make_error_code(std::errc::operation_canceled);
+				co_return false;
+			}
+		}
+	}
+
+	[[nodiscard]] awaitable<void> co_send_data(stream &stream, std::string_view data, bool end_stream, error_code &error)
+	{
+		if( data.empty() and not end_stream )
+			co_return ;
+		for(;;)
+		{
+			if( not co_await co_wait_writable(stream, error) or stream.local_closed )
+				co_return ;
+
+			const auto window = std::min(m_send_window, stream.send_window);
+			if( not data.empty() and window <= 0 )
+			{
+				if( not co_await co_wait_signal(m_window_signal) )
+				{
+					error = std::make_error_code(std::errc::operation_canceled);
+					co_return ;
+				}
+				continue;
+			}
+			const auto size = std::min({
+				data.size(), static_cast<size_t>(std::max<int64_t>(window, 0)),
+				static_cast<size_t>(m_peer.max_frame_size)
+			});
+			const bool last = size == data.size();
+
+			send_frame (
+				h2_frame_type::data, last and end_stream ? h2_frame_flag::end_stream : 0,
+				stream.id, data.substr(0, size)
+			);
+			m_send_window -= static_cast<int64_t>(size);
+			stream.send_window -= static_cast<int64_t>(size);
+			data.remove_prefix(size);
+
+			if( last )
+			{
+				stream.local_closed = end_stream;
+				co_return ;
+			}
+		}
+	}
+
+private:
+	void consume(stream *stream, size_t size)
+	{
+		// Window updates are sent once half of a window has been consumed.
+		m_recv_consumed += size;
+		if( m_recv_consumed >= m_option.initial_window_size / 2 )
+		{
+			send_window_update(0, static_cast<uint32_t>(m_recv_consumed));
+			m_recv_window += static_cast<int64_t>(m_recv_consumed);
+			m_recv_consumed = 0;
+		}
+		if( not stream or stream->remote_closed )
+			return ;
+
+		stream->recv_consumed += size;
+		if( stream->recv_consumed >= m_option.initial_window_size / 2 )
+		{
+			send_window_update(stream->id, static_cast<uint32_t>(stream->recv_consumed));
+			stream->recv_window += static_cast<int64_t>(stream->recv_consumed);
+			stream->recv_consumed = 0;
+		}
+	}
+
+	void reset_stream(stream &stream, h2_errno errc)
+	{
+		if( stream.error )
+			return ;
+		stream.error = h2_frame::make_error_code(errc);
+		send_rst_stream(stream.id, errc);
+
+		if( not stream.dispatched )
+			m_streams.erase(stream.id);
+		stream.signal.cancel();
+		m_window_signal.cancel();
+	}
+
+	void send_preface()
+	{
+		std::string payload;
+		h2_frame::encode_setting(h2_setting_id::enable_push, 0, payload);
+		h2_frame::encode_setting(h2_setting_id::max_concurrent_streams, m_option.max_concurrent_streams, payload);
+		h2_frame::encode_setting(h2_setting_id::initial_window_size, m_option.initial_window_size, payload);
+		h2_frame::encode_setting(h2_setting_id::max_frame_size, m_option.max_frame_size, payload);
+		h2_frame::encode_setting(h2_setting_id::max_header_list_size, m_option.max_header_list_size, payload);
+		if( m_option.header_table_size != 4096 )
+			h2_frame::encode_setting(h2_setting_id::header_table_size, m_option.header_table_size, payload);
+
+		send_frame(h2_frame_type::settings, 0, 0, payload);
+		if( m_option.initial_window_size > h2_frame::default_window_size )
+			send_window_update(0, m_option.initial_window_size - h2_frame::default_window_size);
+	}
+
+	void send_headers(uint32_t stream_id, const fields_t &fields, bool end_stream)
+	{
+		// Encoded and queued in one go, the HPACK state depends on the order.
+		std::string block;
+		for(auto &[name, value] : fields)
+			m_encoder.encode(name, value, block);
+
+		std::string_view rest = block;
+		auto type = h2_frame_type::headers;
+		h2_frame_flag_t flags = end_stream ? h2_frame_flag::end_stream : 0;
+		do {
+			auto payload = rest.substr(0, m_peer.max_frame_size);
+			rest.remove_prefix(payload.size());
+			if( rest.empty() )
+				flags |= h2_frame_flag::end_headers;
+
+			send_frame(type, flags, stream_id, payload);
+			type = h2_frame_type::continuation;
+			flags = 0;
+		}
+		while( not rest.empty() );
+	}
+
+	void send_rst_stream(uint32_t stream_id, h2_errno errc)
+	{
+		std::string payload;
+		h2_frame::encode_uint32(h2_frame::wire_code(errc), payload);
+		send_frame(h2_frame_type::rst_stream, 0, stream_id, payload);
+	}
+
+	void send_window_update(uint32_t stream_id, uint32_t increment)
+	{
+		std::string payload;
+		h2_frame::encode_uint32(increment, payload);
+		send_frame(h2_frame_type::window_update, 0, stream_id, payload);
+	}
+
+	void send_goaway(h2_errno errc)
+	{
+		std::string payload;
+		h2_frame::encode_uint32(m_last_stream_id, payload);
+		h2_frame::encode_uint32(h2_frame::wire_code(errc), payload);
+		send_frame(h2_frame_type::goaway, 0, 0, payload);
+	}
+
+	void send_frame(h2_frame_type type, h2_frame_flag_t flags, uint32_t stream_id, std::string_view payload)
+	{
+		if( m_closing )
+			return ;
+		h2_frame::encode_header({static_cast<uint32_t>(payload.size()), type, flags, stream_id}, m_wbuf);
+		m_wbuf.append(payload);
+		m_write_signal.cancel();
+	}
+
+public:
+	next_layer_t *m_next_layer;
+#ifdef LIBGS_ENABLE_OPENSSL
+	asio::ssl::context *m_ssl = nullptr;
+#endif //LIBGS_ENABLE_OPENSSL
+	session_set *m_sss;
+	h2_option m_option;
+	strand_t m_strand;
+
+	handler_t m_handler {};
+	milliseconds m_idle_timeout {0};
+
+	h2_settings m_peer {};
+	hpack_decoder m_decoder;
+	hpack_encoder m_encoder {};
+
+	std::unordered_map<uint32_t, stream_ptr> m_streams {};
+	uint32_t m_last_stream_id = 0;
+	size_t m_active = 0;
+
+	int64_t m_send_window = h2_frame::default_window_size;
+	int64_t m_recv_window;
+	size_t m_recv_consumed = 0;
+
+	std::string m_rbuf {};
+	size_t m_rpos = 0;
+
+	std::string m_header_block {};
+	uint32_t m_header_stream_id = 0;
+	h2_frame_flag_t m_header_flags = 0;
+
+	std::string m_wbuf {};
+	bool m_goaway = false;
+	bool m_closing = false;
+	error_code m_error {};
+
+	asio::steady_timer m_write_signal;
+	asio::steady_timer m_drain_signal;
+	asio::steady_timer m_window_signal;
+	asio::steady_timer m_idle_signal;
+};
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_h2_connection<Stream,CharT>::basic_h2_connection
+(next_layer_t &next_layer, session_set &sss, const h2_option &option)
+	requires (not is_ssl_stream_v<next_layer_t>) :
+	m_impl(arena::make<impl>(next_layer, sss, option))
+{
+
+}
+
+#ifdef LIBGS_ENABLE_OPENSSL
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_h2_connection<Stream,CharT>::basic_h2_connection
+(next_layer_t &next_layer, asio::ssl::context &ssl, session_set &sss, const h2_option &option)
+	requires is_ssl_stream_v<next_layer_t> :
+	m_impl(arena::make<impl>(next_layer, sss, option))
+{
+	m_impl->m_ssl = &ssl;
+}
+#endif //LIBGS_ENABLE_OPENSSL
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_h2_connection<Stream,CharT>::~basic_h2_connection()
+{
+
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<void> basic_h2_connection<Stream,CharT>::co_run
+(std::string_view data, handler_t handler, const milliseconds &idle_timeout)
+{
+	m_impl->m_handler = std::move(handler);
+	m_impl->m_idle_timeout = idle_timeout;
+	co_await m_impl->co_run(data);
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<bool> basic_h2_connection<Stream,CharT>::co_upgrade
+(parser_t &parser, handler_t handler, const milliseconds &idle_timeout)
+{
+	m_impl->m_handler = std::move(handler);
+	m_impl->m_idle_timeout = idle_timeout;
+	co_return co_await m_impl->co_upgrade(parser);
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_h2_connection<Stream,CharT>::is_preface(std::string_view data) noexcept
+{
+	// "PRI" is not a method, a partial preface is enough to tell.
+	if( data.size() < 4 )
+		return false;
+	return h2_frame::preface.starts_with(data.substr(0, h2_frame::preface.size()));
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_h2_connection<Stream,CharT>::is_upgrade(const parser_t &parser) noexcept
+{
+	// h2c is cleartext only, over TLS the protocol is chosen by ALPN.
+	if constexpr( is_ssl_stream_v<next_layer_t> )
+		return false;
+	else
+	{
+		using header_t = basic_header<char_t>;
+		auto &headers = parser.headers();
+
+		if( parser.version() != version::v11 or not parser.is_eof() or
+			not headers.contains(header_t::http2_settings) )
+			return false;
+
+		auto it = headers.find(header_t::upgrade);
+		if( it == headers.end() )
+			return false;
+
+		for(auto &token : string_list::from_string(str_to_lower(xxtombs(it->second.to_string())), ','))
+		{
+			if( str_trimmed(token) == "h2c" )
+				return true;
+		}
+		return false;
+	}
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_h2_connection<Stream,CharT>::alpn_selected([[maybe_unused]] next_layer_t &next_layer) noexcept
+{
+#ifdef LIBGS_ENABLE_OPENSSL
+	if constexpr( is_ssl_stream_v<next_layer_t> )
+	{
+		const unsigned char *data = nullptr;
+		unsigned int size = 0;
+		SSL_get0_alpn_selected(next_layer.native_handle(), &data, &size);
+		return std::string_view(reinterpret_cast<const char*>(data), size) == "h2";
+	}
+#endif //LIBGS_ENABLE_OPENSSL
+	return false;
+}
+
+#ifdef LIBGS_ENABLE_OPENSSL
+
+inline void set_h2_alpn(asio::ssl::context &ssl)
+{
+	SSL_CTX_set_alpn_select_cb(ssl.native_handle(),
+	[](SSL*, const unsigned char **out, unsigned char *out_size,
+	   const unsigned char *in, unsigned int in_size, void*) -> int
+	{
+		static constexpr unsigned char protocols[] = "\x02h2\x08http/1.1";
+		auto res = SSL_select_next_proto (
+			const_cast<unsigned char**>(out), out_size,
+			protocols, sizeof(protocols) - 1, in, in_size
+		);
+		return res == OPENSSL_NPN_NEGOTIATED ? SSL_TLSEXT_ERR_OK : SSL_TLSEXT_ERR_NOACK;
+	},
+	nullptr);
+}
+
+#endif //LIBGS_ENABLE_OPENSSL
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_H2_CONNECTION_H
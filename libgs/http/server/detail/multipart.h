@@ -0,0 +1,713 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_MULTIPART_H
+#define LIBGS_HTTP_SERVER_DETAIL_MULTIPART_H
+
+#include <libgs/core/algorithm/base.h>
+#include <libgs/core/string_list.h>
+#include <functional>
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+class multipart_error_category : public std::error_category
+{
+	LIBGS_DISABLE_COPY_MOVE(multipart_error_category)
+
+public:
+	multipart_error_category() = default;
+	[[nodiscard]] const char *name() const noexcept override {
+		return "libgs::http::multipart_error";
+	}
+	[[nodiscard]] std::string message(int code) const override
+	{
+		switch(static_cast<multipart_errno>(code))
+		{
+#define X_MACRO(e,v,d) case multipart_errno::e: return d;
+			LIBGS_HTTP_MULTIPART_ERRNO
+#undef X_MACRO
+			default: break;
+		}
+		return "Unknown error.";
+	}
+	inline static multipart_error_category &instance()
+	{
+		static multipart_error_category category;
+		return category;
+	}
+};
+
+[[nodiscard]] inline error_code make_multipart_error_code(multipart_errno errc) noexcept {
+	return error_code(static_cast<int>(errc), multipart_error_category::instance());
+}
+
+} //namespace detail
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+class LIBGS_HTTP_TAPI basic_multipart_reader<Stream,CharT>::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+	using searcher_t = std::boyer_moore_horspool_searcher<std::string::const_iterator>;
+
+public:
+	static constexpr size_t read_block_size = 0x10000;
+	enum class state
+	{
+		preamble, delimiter, body, done
+	};
+
+public:
+	impl(request_t &request, const multipart_limits &limits) :
+		m_request(&request), m_limits(limits)
+	{
+		auto boundary = parse_boundary(*m_request);
+		if( boundary.empty() )
+			return ;
+
+		// The body usually starts with the delimiter directly, a leading CRLF makes
+		// the first delimiter look like all the following ones.
+		m_delim = "\r\n--" + boundary;
+		m_searcher.emplace(m_delim.cbegin(), m_delim.cend());
+		m_buf = "\r\n";
+	}
+
+public:
+	[[nodiscard]] static std::string parse_boundary(const request_t &request)
+	{
+		auto &headers = request.headers();
+		auto it = headers.find(basic_header<char_t>::content_type);
+		if( it == headers.end() )
+			return {};
+
+		auto content_type = xxtombs(it->second.to_string());
+		auto params = string_list::from_string(content_type, ';');
+		if( params.empty() or str_to_lower(str_trimmed(params[0])) != "multipart/form-data" )
+			return {};
+
+		for(size_t i=1; i<params.size(); i++)
+		{
+			auto param = str_trimmed(params[i]);
+			auto pos = param.find('=');
+			if( pos == std::string::npos or str_to_lower(str_trimmed(param.substr(0,pos))) != "boundary" )
+				continue;
+
+			std::string boundary = str_trimmed(param.substr(pos + 1));
+			if( boundary.size() >= 2 and boundary.front() == '"' and boundary.back() == '"' )
+				boundary = boundary.substr(1, boundary.size() - 2);
+
+			// RFC 2046: 1*70 characters.
+			if( boundary.size() > 70 )
+				return {};
+			return boundary;
+		}
+		return {};
+	}
+
+	void parse_disposition(std::string_view value)
+	{
+		for(auto &param : string_list::from_string(value, ';'))
+		{
+			auto pos = param.find('=');
+			if( pos == std::string::npos )
+				continue;
+
+			auto key = str_to_lower(str_trimmed(param.substr(0,pos)));
+			std::string data = str_trimmed(param.substr(pos + 1));
+			if( data.size() >= 2 and data.front() == '"' and data.back() == '"' )
+				data = data.substr(1, data.size() - 2);
+
+			if( key == "name" )
+				m_name = mbstoxx<char_t>(data);
+			else if( key == "filename" )
+			{
+				// Some clients send the full client side path.
+				auto slash = data.find_last_of("/\\");
+				if( slash != std::string::npos )
+					data = data.substr(slash + 1);
+				m_file_name = mbstoxx<char_t>(data);
+				m_is_file = true;
+			}
+		}
+	}
+
+	[[nodiscard]] bool parse_headers(std::string_view block)
+	{
+		m_headers.clear();
+		m_name.clear();
+		m_file_name.clear();
+		m_is_file = false;
+
+		for(auto &line : string_list::from_string(block, "\r\n"))
+		{
+			auto colon = line.find(':');
+			if( colon == std::string::npos or colon == 0 )
+				return false;
+
+			auto key = str_trimmed(line.substr(0, colon));
+			auto value = str_trimmed(line.substr(colon + 1));
+
+			if( str_to_lower(key) == "content-disposition" )
+				parse_disposition(value);
+			m_headers[mbstoxx<char_t>(key)] = mbstoxx<char_t>(value);
+		}
+		return true;
+	}
+
+public:
+	[[nodiscard]] awaitable<void> co_fill(error_code &error)
+	{
+		using namespace libgs::operators;
+		if( m_pos > 0 )
+		{
+			m_buf.erase(0, m_pos);
+			m_match = m_match == std::string::npos ? m_match : m_match - m_pos;
+			m_search_from = m_search_from > m_pos ? m_search_from - m_pos : 0;
+			m_pos = 0;
+		}
+		if( not m_request->can_read_body() )
+		{
+			error = detail::make_multipart_error_code(multipart_errno::UEOF);
+			co_return ;
+		}
+		auto size = m_buf.size();
+		m_buf.resize(size + read_block_size);
+
+		auto res = co_await m_request->read(buffer(m_buf.data() + size, read_block_size), use_awaitable | error);
+		m_buf.resize(size + res);
+		if( res == 0 )
+		{
+			if( not error )
+				error = detail::make_multipart_error_code(multipart_errno::UEOF);
+			co_return ;
+		}
+		error = error_code();
+
+		m_body_size += res;
+		if( m_limits.max_body_size > 0 and m_body_size > m_limits.max_body_size )
+			error = detail::make_multipart_error_code(multipart_errno::BTL);
+		co_return ;
+	}
+
+	// Searches for the delimiter in the buffered data, bytes already known not to start
+	// a match are never scanned twice.
+	[[nodiscard]] size_t find_delimiter() noexcept
+	{
+		if( m_match != std::string::npos )
+			return m_match;
+
+		auto begin = m_buf.cbegin() + static_cast<std::ptrdiff_t>(std::max(m_pos, m_search_from));
+		auto [it, end] = (*m_searcher)(begin, m_buf.cend());
+		if( it != m_buf.cend() )
+			return m_match = static_cast<size_t>(it - m_buf.cbegin());
+
+		if( m_buf.size() >= m_delim.size() )
+			m_search_from = m_buf.size() - m_delim.size() + 1;
+		return std::string::npos;
+	}
+
+	[[nodiscard]] awaitable<void> co_skip_preamble(error_code &error)
+	{
+		for(;;)
+		{
+			auto pos = find_delimiter();
+			if( pos != std::string::npos )
+			{
+				consume_delimiter(pos);
+				co_return ;
+			}
+			// The preamble is ignored, keep only what may be the start of a delimiter.
+			m_pos = std::max(m_pos, m_search_from);
+			co_await co_fill(error);
+			if( error )
+				co_return ;
+		}
+	}
+
+	void consume_delimiter(size_t pos) noexcept
+	{
+		m_pos = pos + m_delim.size();
+		m_search_from = m_pos;
+		m_match = std::string::npos;
+		m_state = state::delimiter;
+	}
+
+	[[nodiscard]] awaitable<bool> co_read_headers(error_code &error)
+	{
+		// After the delimiter: "--" closes the body, otherwise optional whitespace and CRLF.
+		for(;;)
+		{
+			std::string_view tail(m_buf.data() + m_pos, m_buf.size() - m_pos);
+			if( tail.starts_with("--") )
+			{
+				m_state = state::done;
+				co_return false;
+			}
+			auto crlf = tail.find("\r\n");
+			if( crlf != std::string_view::npos )
+			{
+				if( tail.find_first_not_of(" \t") != crlf )
+				{
+					error = detail::make_multipart_error_code(multipart_errno::IFMT);
+					co_return false;
+				}
+				m_pos += crlf;
+				break;
+			}
+			else if( m_limits.max_header_size > 0 and tail.size() > m_limits.max_header_size )
+			{
+				error = detail::make_multipart_error_code(multipart_errno::IFMT);
+				co_return false;
+			}
+			co_await co_fill(error);
+			if( error )
+				co_return false;
+		}
+		// m_pos is at the CRLF that ends the delimiter line.
+		for(;;)
+		{
+			std::string_view tail(m_buf.data() + m_pos, m_buf.size() - m_pos);
+			auto end = tail.find("\r\n\r\n");
+			if( end != std::string_view::npos )
+			{
+				if( m_limits.max_header_size > 0 and end > m_limits.max_header_size )
+				{
+					error = detail::make_multipart_error_code(multipart_errno::HTL);
+					co_return false;
+				}
+				else if( not parse_headers(end < 2 ? std::string_view() : tail.substr(2, end - 2)) )
+				{
+					error = detail::make_multipart_error_code(multipart_errno::IFMT);
+					co_return false;
+				}
+				m_pos += end + 4;
+				m_search_from = m_pos;
+				m_match = std::string::npos;
+				break;
+			}
+			else if( m_limits.max_header_size > 0 and tail.size() > m_limits.max_header_size + 4 )
+			{
+				error = detail::make_multipart_error_code(multipart_errno::HTL);
+				co_return false;
+			}
+			co_await co_fill(error);
+			if( error )
+				co_return false;
+		}
+		if( m_limits.max_parts > 0 and m_part_count >= m_limits.max_parts )
+		{
+			error = detail::make_multipart_error_code(multipart_errno::TMP);
+			co_return false;
+		}
+		m_part_count++;
+		m_part_size = 0;
+		m_state = state::body;
+		co_return true;
+	}
+
+	// Returns a view of the next chunk of the current part's body (at most 'max' bytes),
+	// it is valid until the next call. An empty view means the end of the part.
+	[[nodiscard]] awaitable<std::string_view> co_next_chunk(size_t max, error_code &error)
+	{
+		error = error_code();
+		if( m_state != state::body or max == 0 )
+			co_return std::string_view();
+		for(;;)
+		{
+			size_t avail = 0;
+			auto pos = find_delimiter();
+			if( pos != std::string::npos )
+			{
+				avail = pos - m_pos;
+				if( avail == 0 )
+				{
+					consume_delimiter(pos);
+					co_return std::string_view();
+				}
+			}
+			else if( m_search_from > m_pos )
+				avail = m_search_from - m_pos;
+
+			if( avail > 0 )
+			{
+				avail = std::min(avail, max);
+				m_part_size += avail;
+				if( m_limits.max_part_size > 0 and m_part_size > m_limits.max_part_size )
+				{
+					error = detail::make_multipart_error_code(multipart_errno::PTL);
+					co_return std::string_view();
+				}
+				std::string_view chunk(m_buf.data() + m_pos, avail);
+				m_pos += avail;
+				co_return chunk;
+			}
+			co_await co_fill(error);
+			if( error )
+				co_return std::string_view();
+		}
+	}
+
+	[[nodiscard]] awaitable<bool> co_next_part(error_code &error)
+	{
+		error = error_code();
+		if( m_delim.empty() )
+		{
+			error = detail::make_multipart_error_code(multipart_errno::NBD);
+			co_return false;
+		}
+		while( m_state == state::body )
+		{
+			// Skip the rest of the current part.
+			auto chunk = co_await co_next_chunk(read_block_size, error);
+			if( error )
+				co_return false;
+			else if( chunk.empty() )
+				break;
+		}
+		if( m_state == state::preamble )
+		{
+			co_await co_skip_preamble(error);
+			if( error )
+				co_return false;
+		}
+		if( m_state == state::done )
+			co_return false;
+		co_return co_await co_read_headers(error);
+	}
+
+	template <typename Opt>
+	[[nodiscard]] auto file_opt_token_helper(Opt &&opt, error_code &error)
+	{
+		if constexpr( is_char_v<Opt> or is_char_string_v<Opt> or
+					  is_fstream_v<Opt> or is_ofstream_v<Opt> )
+		{
+			auto token = make_file_opt_token(std::forward<Opt>(opt));
+			error = token.init(std::ios::out | std::ios::binary | std::ios::trunc);
+			return token;
+		}
+		else if constexpr( is_async_file_opt_token_v<std::remove_cvref_t<Opt>> )
+		{
+			error = opt.init(std::ios::out | std::ios::binary);
+			return std::forward<Opt>(opt);
+		}
+		else
+		{
+			error = opt.init(std::ios::out | std::ios::binary);
+			if( not error and opt.range )
+				opt.stream->seekp(opt.range->begin, std::ios::beg);
+			return std::forward<Opt>(opt);
+		}
+	}
+
+public:
+	request_t *m_request;
+	multipart_limits m_limits;
+
+	std::string m_delim;
+	std::optional<searcher_t> m_searcher;
+
+	std::string m_buf;
+	size_t m_pos = 0;
+	size_t m_search_from = 0;
+	size_t m_match = std::string::npos;
+	size_t m_body_size = 0;
+
+	state m_state = state::preamble;
+	headers_t m_headers;
+	string_t m_name;
+	string_t m_file_name;
+	bool m_is_file = false;
+
+	size_t m_part_count = 0;
+	size_t m_part_size = 0;
+};
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_multipart_reader<Stream,CharT>::basic_multipart_reader(request_t &request, const multipart_limits &limits) :
+	m_impl(arena::make<impl>(request, limits))
+{
+
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_multipart_reader<Stream,CharT>::~basic_multipart_reader()
+{
+
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_multipart_reader<Stream,CharT>::basic_multipart_reader(basic_multipart_reader &&other) noexcept :
+	m_impl(std::move(other.m_impl))
+{
+
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_multipart_reader<Stream,CharT> &basic_multipart_reader<Stream,CharT>::operator=
+(basic_multipart_reader &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	m_impl = std::move(other.m_impl);
+	return *this;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_multipart_reader<Stream,CharT>::is_multipart(const request_t &request) noexcept
+{
+	try {
+		return not impl::parse_boundary(request).empty();
+	}
+	catch(...) {
+		return false;
+	}
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<bool> basic_multipart_reader<Stream,CharT>::co_next_part(error_code &error)
+{
+	co_return co_await m_impl->co_next_part(error);
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<bool> basic_multipart_reader<Stream,CharT>::co_next_part()
+{
+	error_code error;
+	auto res = co_await co_next_part(error);
+	if( error )
+		throw system_error(error, "libgs::http::multipart_reader::co_next_part");
+	co_return res;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+const typename basic_multipart_reader<Stream,CharT>::headers_t&
+basic_multipart_reader<Stream,CharT>::part_headers() const noexcept
+{
+	return m_impl->m_headers;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+typename basic_multipart_reader<Stream,CharT>::string_view_t
+basic_multipart_reader<Stream,CharT>::part_name() const noexcept
+{
+	return m_impl->m_name;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+typename basic_multipart_reader<Stream,CharT>::string_view_t
+basic_multipart_reader<Stream,CharT>::part_file_name() const noexcept
+{
+	return m_impl->m_file_name;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_multipart_reader<Stream,CharT>::part_is_file() const noexcept
+{
+	return m_impl->m_is_file;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+size_t basic_multipart_reader<Stream,CharT>::part_count() const noexcept
+{
+	return m_impl->m_part_count;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+size_t basic_multipart_reader<Stream,CharT>::part_size() const noexcept
+{
+	return m_impl->m_part_size;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+bool basic_multipart_reader<Stream,CharT>::is_done() const noexcept
+{
+	return m_impl->m_state == impl::state::done;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<size_t> basic_multipart_reader<Stream,CharT>::co_read_part(const mutable_buffer &buf, error_code &error)
+{
+	auto chunk = co_await m_impl->co_next_chunk(buf.size(), error);
+	if( not chunk.empty() )
+		memcpy(buf.data(), chunk.data(), chunk.size());
+	co_return chunk.size();
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<size_t> basic_multipart_reader<Stream,CharT>::co_read_part(const mutable_buffer &buf)
+{
+	error_code error;
+	auto res = co_await co_read_part(buf, error);
+	if( error )
+		throw system_error(error, "libgs::http::multipart_reader::co_read_part");
+	co_return res;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<std::string> basic_multipart_reader<Stream,CharT>::co_read_part(error_code &error)
+{
+	std::string sum;
+	co_await co_read_part([&](std::string_view chunk){
+		sum.append(chunk);
+	},
+	error);
+	co_return sum;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<std::string> basic_multipart_reader<Stream,CharT>::co_read_part()
+{
+	error_code error;
+	auto res = co_await co_read_part(error);
+	if( error )
+		throw system_error(error, "libgs::http::multipart_reader::co_read_part");
+	co_return res;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+template <concepts::multipart_sink Func>
+awaitable<size_t> basic_multipart_reader<Stream,CharT>::co_read_part(Func &&sink, error_code &error)
+{
+	size_t sum = 0;
+	for(;;)
+	{
+		// The chunks are handed out straight from the internal buffer.
+		auto chunk = co_await m_impl->co_next_chunk(impl::read_block_size, error);
+		if( error or chunk.empty() )
+			break;
+
+		sum += chunk.size();
+		if constexpr( std::is_void_v<std::invoke_result_t<Func,std::string_view>> )
+			sink(chunk);
+		else
+			co_await sink(chunk);
+	}
+	co_return sum;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+template <concepts::multipart_sink Func>
+awaitable<size_t> basic_multipart_reader<Stream,CharT>::co_read_part(Func &&sink)
+{
+	error_code error;
+	auto res = co_await co_read_part(std::forward<Func>(sink), error);
+	if( error )
+		throw system_error(error, "libgs::http::multipart_reader::co_read_part");
+	co_return res;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<size_t> basic_multipart_reader<Stream,CharT>::co_save_part
+(concepts::char_file_opt_token_arg<file_optype::single, io_permission::write> auto &&opt, error_code &error)
+{
+	using opt_t = decltype(opt);
+
+	// Files named by path are written through async_file, the io threads never wait on the disk.
+	auto token = m_impl->file_opt_token_helper (
+		detail::to_async_file_opt_token<file_optype::single>(m_impl->m_request->get_executor(), std::forward<opt_t>(opt)),
+		error
+	);
+	if( error )
+		co_return 0;
+
+	size_t total = token.range ? token.range->total : 0;
+	size_t sum = 0;
+
+	// Bytes past the range are still consumed so the next part can be reached.
+	auto clip = [&](std::string_view chunk)
+	{
+		if( total > 0 )
+			chunk = chunk.substr(0, sum >= total ? 0 : total - sum);
+		return chunk;
+	};
+	if constexpr( is_async_file_opt_token_v<decltype(token)> )
+	{
+		uint64_t offset = token.range ? token.range->begin : 0;
+		error_code write_error;
+
+		co_await co_read_part([&](std::string_view chunk) -> awaitable<void>
+		{
+			chunk = clip(chunk);
+			if( chunk.empty() or write_error )
+				co_return ;
+			co_await token.stream->co_write_at(offset + sum, buffer(chunk.data(), chunk.size()), write_error);
+			sum += chunk.size();
+		},
+		error);
+
+		if( not error )
+			error = write_error;
+	}
+	else
+	{
+		using pos_t = typename decltype(token)::pos_t;
+		co_await co_read_part([&](std::string_view chunk)
+		{
+			chunk = clip(chunk);
+			token.stream->write(chunk.data(), static_cast<pos_t>(chunk.size()));
+			sum += chunk.size();
+		},
+		error);
+
+		if( not error and not *token.stream )
+			error = make_error_code(std::errc::io_error);
+	}
+	co_return sum;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<size_t> basic_multipart_reader<Stream,CharT>::co_save_part
+(concepts::char_file_opt_token_arg<file_optype::single, io_permission::write> auto &&opt)
+{
+	using opt_t = decltype(opt);
+	error_code error;
+	auto res = co_await co_save_part(std::forward<opt_t>(opt), error);
+	if( error )
+		throw system_error(error, "libgs::http::multipart_reader::co_save_part");
+	co_return res;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+const multipart_limits &basic_multipart_reader<Stream,CharT>::limits() const noexcept
+{
+	return m_impl->m_limits;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+typename basic_multipart_reader<Stream,CharT>::request_t &basic_multipart_reader<Stream,CharT>::request() noexcept
+{
+	return *m_impl->m_request;
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_MULTIPART_H
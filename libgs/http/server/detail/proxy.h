@@ -0,0 +1,904 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_PROXY_H
+#define LIBGS_HTTP_SERVER_DETAIL_PROXY_H
+
+#include <libgs/core/algorithm/misc.h>
+#include <spdlog/spdlog.h>
+#include <charconv>
+#include <set>
+
+#ifdef __linux__
+# include <fcntl.h>
+# include <unistd.h>
+#endif //__linux__
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+// Follows the chunked framing of a body relayed as is and reports the payload.
+class proxy_chunk_scanner
+{
+public:
+	// Returns how many bytes belong to the body, 'func' gets the payload pieces.
+	size_t consume(std::string_view data, auto &&func, error_code &error)
+	{
+		size_t pos = 0;
+		while( pos < data.size() and m_state != state::done )
+		{
+			char c = data[pos];
+			switch( m_state )
+			{
+			case state::size:
+				if( auto value = hex_value(c); value >= 0 )
+				{
+					if( m_size > (std::numeric_limits<size_t>::max() >> 4) )
+						return failed(pos, error);
+					m_size = (m_size << 4) | static_cast<size_t>(value);
+					m_digits++;
+				}
+				else if( m_digits == 0 )
+					return failed(pos, error);
+				else
+					m_state = c == '\r' ? state::size_lf : state::extension;
+				pos++;
+				break;
+
+			case state::extension:
+				if( c == '\r' )
+					m_state = state::size_lf;
+				pos++;
+				break;
+
+			case state::size_lf:
+				if( c != '\n' )
+					return failed(pos, error);
+				m_state = m_size == 0 ? state::trailer : state::data;
+				m_digits = 0;
+				pos++;
+				break;
+
+			case state::data:
+			{
+				auto size = std::min(m_size, data.size() - pos);
+				func(data.substr(pos, size));
+				m_size -= size;
+				pos += size;
+				if( m_size == 0 )
+					m_state = state::data_cr;
+				break;
+			}
+			case state::data_cr:
+				if( c != '\r' )
+					return failed(pos, error);
+				m_state = state::data_lf;
+				pos++;
+				break;
+
+			case state::data_lf:
+				if( c != '\n' )
+					return failed(pos, error);
+				m_state = state::size;
+				pos++;
+				break;
+
+			case state::trailer: // At the beginning of a trailer line.
+				m_state = c == '\r' ? state::end_lf : state::trailer_line;
+				pos++;
+				break;
+
+			case state::trailer_line:
+				if( c == '\n' )
+					m_state = state::trailer;
+				pos++;
+				break;
+
+			case state::end_lf:
+				if( c != '\n' )
+					return failed(pos, error);
+				m_state = state::done;
+				pos++;
+				break;
+
+			default: break;
+			}
+		}
+		return pos;
+	}
+
+	[[nodiscard]] bool is_done() const noexcept {
+		return m_state == state::done;
+	}
+
+private:
+	[[nodiscard]] static int hex_value(char c) noexcept
+	{
+		if( c >= '0' and c <= '9' )
+			return c - '0';
+		else if( c >= 'a' and c <= 'f' )
+			return c - 'a' + 10;
+		else if( c >= 'A' and c <= 'F' )
+			return c - 'A' + 10;
+		return -1;
+	}
+
+	[[nodiscard]] static size_t failed(size_t pos, error_code &error) noexcept
+	{
+		error = std::make_error_code(std::errc::protocol_error);
+		return pos;
+	}
+
+private:
+	enum class state {
+		size, extension, size_lf, data, data_cr, data_lf, trailer, trailer_line, end_lf, done
+	}
+	m_state = state::size;
+	size_t m_size = 0;
+	size_t m_digits = 0;
+};
+
+} //namespace detail
+
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool>
+class basic_proxy<Stream,CharT,SessionPool>::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+	using request_t = typename context_t::request_t;
+	using header_t = basic_header<char_t>;
+	using session_t = typename session_pool_t::session_t;
+	using upstream_socket_t = typename session_pool_t::socket_t;
+
+	static constexpr size_t max_head_size = 0x10000;
+
+#ifdef __linux__
+	static constexpr bool can_splice_v =
+		not is_ssl_stream_v<Stream> and not is_ssl_stream_v<upstream_socket_t>;
+#else
+	static constexpr bool can_splice_v = false;
+#endif //__linux__
+
+	struct upstream
+	{
+		endpoint_t endpoint {};
+		std::atomic_size_t outstanding {0};
+	};
+
+	struct outstanding_guard
+	{
+		explicit outstanding_guard(std::atomic_size_t &counter) : counter(counter) {
+			counter.fetch_add(1, std::memory_order_relaxed);
+		}
+		~outstanding_guard() {
+			counter.fetch_sub(1, std::memory_order_relaxed);
+		}
+		std::atomic_size_t &counter;
+	};
+
+	enum class framing {
+		none, length, chunked, close
+	};
+
+	struct reply
+	{
+		status_t status {};
+		std::string reason {};
+		std::string fields {};
+
+		framing body = framing::close;
+		std::optional<size_t> length {};
+		bool keep_alive = true;
+	};
+
+	// Turns what the upstream sends into what goes downstream, piece by piece.
+	struct body_state
+	{
+		framing mode = framing::none;
+		size_t remaining = 0;
+		detail::proxy_chunk_scanner scanner {};
+
+		bool dechunk = false;
+		bool rechunk = false;
+		bool extra = false;
+		bool done = false;
+		std::string scratch {};
+
+		[[nodiscard]] std::string_view next(std::string_view data, bool eof, error_code &error)
+		{
+			switch( mode )
+			{
+			case framing::length:
+			{
+				auto size = std::min(remaining, data.size());
+				extra = data.size() > size;
+				remaining -= size;
+				done = remaining == 0;
+				return data.substr(0, size);
+			}
+			case framing::chunked:
+			{
+				scratch.clear();
+				auto size = scanner.consume(data, [this](std::string_view payload) {
+					if( dechunk )
+						scratch.append(payload);
+				},
+				error);
+				extra = not error and size < data.size();
+				done = scanner.is_done();
+				return dechunk ? std::string_view(scratch) : data.substr(0, size);
+			}
+			case framing::close:
+				if( eof )
+				{
+					done = true;
+					return rechunk ? "0\r\n\r\n" : "";
+				}
+				else if( not rechunk )
+					return data;
+				scratch = std::format("{:X}\r\n", data.size());
+				scratch.append(data).append("\r\n");
+				return scratch;
+
+			default:
+				extra = not data.empty();
+				done = true;
+				return {};
+			}
+		}
+	};
+
+public:
+	impl(session_pool_t &pool, std::vector<endpoint_t> upstreams, proxy_option option) :
+		m_pool(pool), m_upstreams(upstreams.size()), m_option(std::move(option))
+	{
+		if( upstreams.empty() )
+			throw runtime_error("libgs::http::proxy: no upstream.");
+		for(size_t i=0; i<upstreams.size(); i++)
+			m_upstreams[i].endpoint = std::move(upstreams[i]);
+		if( m_option.buffer_size == 0 )
+			m_option.buffer_size = 0x10000;
+	}
+
+public:
+	[[nodiscard]] awaitable<void> service(context_t &context)
+	{
+		using namespace libgs::operators;
+		m_requests.fetch_add(1, std::memory_order_relaxed);
+
+		auto &request = context.request();
+		auto method = request.method();
+		bool chunked = request.is_chunked();
+		error_code error;
+
+		// The first piece of the body goes out with the head, a body that fits
+		// in it is complete and the request can still be sent elsewhere.
+		std::string body;
+		if( request.can_read_body() )
+		{
+			body = co_await co_read_body(request, chunked, error);
+			if( error )
+			{
+				spdlog::debug("libgs::http::proxy: request body: {}.", error);
+				co_return ;
+			}
+		}
+		bool complete = not request.can_read_body();
+		bool idempotent = method != method_t::POST and method != method_t::PATCH;
+		size_t last = m_upstreams.size();
+
+		for(size_t attempt=0;; attempt++)
+		{
+			auto index = select(last);
+			auto &upstream = m_upstreams[last = index];
+			outstanding_guard guard(upstream.outstanding);
+
+			bool retry = complete and attempt < m_option.retries;
+			auto sess = co_await m_pool.get(upstream.endpoint, use_awaitable | m_option.connect_timeout | error);
+			if( not error )
+			{
+				auto &socket = sess.socket();
+				auto head = request_head(request, upstream.endpoint);
+
+				std::array<const_buffer,2> buffers { buffer(head), buffer(body) };
+				co_await asio::async_write(socket, buffers, use_awaitable | error);
+				if( not error and not complete )
+					co_await co_relay_request(request, socket, chunked, error);
+				if( not error )
+				{
+					bool received = false;
+					co_await co_relay_reply(context, sess, received, error);
+					if( not error )
+						co_return ;
+					else if( context.response().is_finished() )
+					{
+						m_failures.fetch_add(1, std::memory_order_relaxed);
+						co_return ;
+					}
+
+					// A pooled connection the upstream has closed meanwhile reads nothing at all.
+					retry = retry and idempotent and not received;
+				}
+			}
+			sess.opt_helper().close();
+			if( retry )
+			{
+				spdlog::debug("libgs::http::proxy: upstream '{}': {}, retrying.", upstream.endpoint, error);
+				m_retries.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+			m_failures.fetch_add(1, std::memory_order_relaxed);
+			co_await co_fail(context, upstream.endpoint, error);
+			co_return ;
+		}
+	}
+
+private:
+	[[nodiscard]] size_t select(size_t last) noexcept
+	{
+		auto count = m_upstreams.size();
+		auto index = m_next.fetch_add(1, std::memory_order_relaxed) % count;
+
+		if( m_option.balance == proxy_balance::least_outstanding )
+		{
+			auto least = std::numeric_limits<size_t>::max();
+			for(size_t i=0, j=index; i<count; i++, j=(j+1)%count)
+			{
+				auto outstanding = m_upstreams[j].outstanding.load(std::memory_order_relaxed);
+				if( outstanding < least and (j != last or count == 1) )
+				{
+					least = outstanding;
+					index = j;
+				}
+			}
+		}
+		else if( index == last and count > 1 )
+			index = (index + 1) % count;
+		return index;
+	}
+
+	[[nodiscard]] std::string request_head(const request_t &request, const endpoint_t &ep) const
+	{
+		std::string head = std::format (
+			"{} {} HTTP/1.1\r\n", method_string(request.method()), request.target()
+		);
+		auto &headers = request.headers();
+		std::set<std::string> tokens;
+		std::string host, forwarded_for;
+
+		if( auto it = headers.find(header_t::connection); it != headers.end() )
+			tokens = connection_tokens(xxtombs(it->second.to_string()));
+
+		for(auto &[key,value] : headers)
+		{
+			std::string name = xxtombs(key);
+			std::string text = xxtombs(value.to_string());
+
+			if( is_hop_by_hop(name) or tokens.contains(name) or
+				name == "content-length" or name == "expect" )
+				continue;
+			else if( name == "host" )
+				host = std::move(text);
+			else if( m_option.forwarded_headers and name == "x-forwarded-for" )
+				forwarded_for = std::move(text);
+			else if( not m_option.forwarded_headers or not name.starts_with("x-forwarded-") )
+				head += std::format("{}: {}\r\n", name, text);
+		}
+		if( not m_option.preserve_host or host.empty() )
+			head += std::format("host: {}\r\n", ep);
+		else
+			head += std::format("host: {}\r\n", host);
+
+		if( m_option.forwarded_headers )
+		{
+			if constexpr( requires { request.remote_endpoint().address(); } )
+			{
+				auto address = request.remote_endpoint().address().to_string();
+				forwarded_for = forwarded_for.empty() ? address : forwarded_for + ", " + address;
+			}
+			if( not forwarded_for.empty() )
+				head += std::format("x-forwarded-for: {}\r\n", forwarded_for);
+			if( not host.empty() )
+				head += std::format("x-forwarded-host: {}\r\n", host);
+			head += std::format("x-forwarded-proto: {}\r\n", is_ssl_stream_v<Stream> ? "https" : "http");
+		}
+		if( auto cookie = request.cookie_header(); not cookie.empty() )
+			head += std::format("cookie: {}\r\n", cookie);
+		if( request.is_chunked() )
+			head += "transfer-encoding: chunked\r\n";
+		else if( auto it = headers.find(header_t::content_length); it != headers.end() )
+			head += std::format("content-length: {}\r\n", it->second.template get<size_t>());
+		return head + "\r\n";
+	}
+
+	[[nodiscard]] static bool is_hop_by_hop(std::string_view name) noexcept
+	{
+		constexpr std::string_view names[] {
+			"connection", "keep-alive", "proxy-connection", "proxy-authenticate",
+			"proxy-authorization", "te", "trailer", "transfer-encoding", "upgrade"
+		};
+		return std::ranges::find(names, name) != std::end(names);
+	}
+
+	[[nodiscard]] static std::set<std::string> connection_tokens(std::string_view value)
+	{
+		std::set<std::string> tokens;
+		for(auto &token : string_list::from_string(value, ','))
+			tokens.emplace(str_to_lower(str_trimmed(token)));
+		return tokens;
+	}
+
+private:
+	[[nodiscard]] awaitable<std::string> co_read_body(request_t &request, bool chunked, error_code &error)
+	{
+		using namespace libgs::operators;
+		std::string body(m_option.buffer_size, '\0');
+
+		auto size = co_await request.read(buffer(body), use_awaitable | error);
+		body.resize(size);
+		if( chunked )
+		{
+			if( size > 0 )
+				body = std::format("{:X}\r\n", size) + body + "\r\n";
+			if( not request.can_read_body() )
+				body += "0\r\n\r\n";
+		}
+		co_return body;
+	}
+
+	[[nodiscard]] awaitable<void> co_relay_request
+	(request_t &request, upstream_socket_t &socket, bool chunked, error_code &error)
+	{
+		using namespace libgs::operators;
+		while( request.can_read_body() )
+		{
+			auto body = co_await co_read_body(request, chunked, error);
+			if( error or body.empty() )
+				co_return ;
+
+			co_await asio::async_write(socket, buffer(body), use_awaitable | error);
+			if( error )
+				co_return ;
+			m_copied.fetch_add(body.size(), std::memory_order_relaxed);
+		}
+		co_return ;
+	}
+
+	[[nodiscard]] awaitable<void> co_relay_reply(context_t &context, session_t &sess, bool &received, error_code &error)
+	{
+		using namespace libgs::operators;
+		auto &request = context.request();
+		auto &socket = sess.socket();
+
+		std::string buf;
+		size_t head_size = 0;
+		reply reply;
+
+		for(;;)
+		{
+			auto pos = buf.find("\r\n\r\n");
+			if( pos == std::string::npos )
+			{
+				if( buf.size() >= max_head_size )
+				{
+					error = std::make_error_code(std::errc::message_size);
+					co_return ;
+				}
+				co_await co_read_upstream(socket, buf, error);
+				if( error )
+					co_return ;
+				received = true;
+				continue;
+			}
+			if( not parse_reply({buf.data(), pos + 4}, request.method(), reply, error) )
+				co_return ;
+
+			// Interim responses are swallowed, protocol switching is not relayed.
+			else if( reply.status >= 100 and reply.status < 200 )
+			{
+				if( reply.status == status::switching_protocols )
+				{
+					error = std::make_error_code(std::errc::operation_not_supported);
+					co_return ;
+				}
+				buf.erase(0, pos + 4);
+				continue;
+			}
+			head_size = pos + 4;
+			break;
+		}
+		bool v10 = request.version() == version::v10;
+		bool close = not request.keep_alive();
+
+		body_state body;
+		body.mode = reply.body;
+		body.remaining = reply.length.value_or(0);
+		body.done = reply.body == framing::none or (reply.body == framing::length and body.remaining == 0);
+
+		// HTTP/1.0 knows no chunks, the end of such a body is the end of the connection.
+		if( v10 and (reply.body == framing::chunked or reply.body == framing::close) )
+		{
+			body.dechunk = reply.body == framing::chunked;
+			close = true;
+		}
+		else
+			body.rechunk = reply.body == framing::close;
+
+		auto head = std::format("HTTP/{} {}\r\n", v10 ? "1.0" : "1.1", reply.reason) + reply.fields;
+		if( reply.length and reply.body != framing::chunked )
+			head += std::format("content-length: {}\r\n", *reply.length);
+		else if( (reply.body == framing::chunked and not v10) or body.rechunk )
+			head += "transfer-encoding: chunked\r\n";
+		if( close )
+			head += "connection: close\r\n";
+		head += "\r\n";
+
+		std::string_view rest(buf.data() + head_size, buf.size() - head_size);
+		auto piece = rest.empty() ? std::string_view() : body.next(rest, false, error);
+		if( error )
+			co_return ;
+
+		std::array<const_buffer,2> buffers { buffer(head), buffer(piece.data(), piece.size()) };
+		co_await context.response().write_serialized(buffers, use_awaitable | error);
+		m_copied.fetch_add(piece.size(), std::memory_order_relaxed);
+
+		if constexpr( can_splice_v )
+		{
+			if( not error and not body.done and reply.body == framing::length and
+				m_option.splice and not request.transport() )
+			{
+				auto size = co_await co_splice(socket, request.next_layer(), body.remaining, error);
+				m_spliced.fetch_add(size, std::memory_order_relaxed);
+				body.done = not error;
+			}
+		}
+		while( not error and not body.done )
+		{
+			buf.clear();
+			co_await co_read_upstream(socket, buf, error);
+			if( error == errc::eof and reply.body == framing::close )
+			{
+				error = error_code();
+				piece = body.next({}, true, error);
+			}
+			else if( error )
+				break;
+			else
+				piece = body.next(buf, false, error);
+
+			if( error or piece.empty() )
+				continue;
+			co_await co_write_downstream(context, piece, error);
+			m_copied.fetch_add(piece.size(), std::memory_order_relaxed);
+		}
+		if( error or body.extra or not reply.keep_alive )
+			sess.opt_helper().close();
+		if( error )
+		{
+			// Too late for an error response, the client sees the body cut short.
+			spdlog::debug("libgs::http::proxy: relaying the body: {}.", error);
+			abort(context);
+		}
+		else if( close and not request.transport() )
+			socket_operation_helper<Stream>(request.next_layer()).close();
+		co_return ;
+	}
+
+	[[nodiscard]] static bool parse_reply(std::string_view head, method_t method, reply &reply, error_code &error)
+	{
+		// HTTP/1.1 200 OK
+		auto pos = head.find("\r\n");
+		auto line = head.substr(0, pos);
+		head.remove_prefix(pos + 2);
+
+		int status = 0;
+		if( not line.starts_with("HTTP/1.") or line.size() < 12 or line[8] != ' ' or
+			std::from_chars(line.data() + 9, line.data() + 12, status).ec != std::errc() )
+		{
+			error = std::make_error_code(std::errc::protocol_error);
+			return false;
+		}
+		reply = {};
+		reply.status = static_cast<status_t>(status);
+		reply.reason = line.substr(9);
+		reply.keep_alive = line[7] != '0';
+
+		using lines_t = std::vector<std::pair<std::string,std::string_view>>;
+		lines_t lines;
+		std::set<std::string> tokens;
+		bool chunked = false, coded = false;
+
+		while( head.size() > 2 )
+		{
+			pos = head.find("\r\n");
+			line = head.substr(0, pos);
+			head.remove_prefix(pos + 2);
+
+			pos = line.find(':');
+			if( pos == std::string_view::npos )
+				continue;
+
+			auto name = str_to_lower(str_trimmed(line.substr(0, pos)));
+			auto value = str_trimmed(line.substr(pos + 1));
+
+			if( name == "connection" )
+			{
+				auto _tokens = connection_tokens(value);
+				if( _tokens.contains("close") )
+					reply.keep_alive = false;
+				else if( _tokens.contains("keep-alive") )
+					reply.keep_alive = true;
+				tokens.merge(_tokens);
+			}
+			else if( name == "transfer-encoding" )
+			{
+				coded = true;
+				chunked = str_to_lower(value).ends_with("chunked");
+			}
+			else if( name == "content-length" )
+			{
+				size_t length = 0;
+				if( std::from_chars(value.data(), value.data() + value.size(), length).ec != std::errc() )
+				{
+					error = std::make_error_code(std::errc::protocol_error);
+					return false;
+				}
+				reply.length = length;
+			}
+			else if( not is_hop_by_hop(name) )
+				lines.emplace_back(std::move(name), line);
+		}
+		for(auto &[name,_line] : lines)
+		{
+			if( not tokens.contains(name) )
+				reply.fields.append(_line).append("\r\n");
+		}
+		if( method == method_t::HEAD or reply.status < 200 or
+			reply.status == status::no_content or reply.status == status::not_modified )
+			reply.body = framing::none;
+		else if( chunked )
+		{
+			reply.body = framing::chunked;
+			reply.length.reset();
+		}
+		else if( reply.length and not coded )
+			reply.body = framing::length;
+		else
+		{
+			reply.body = framing::close;
+			reply.length.reset();
+			reply.keep_alive = false;
+		}
+		return true;
+	}
+
+private:
+	[[nodiscard]] awaitable<void> co_read_upstream(upstream_socket_t &socket, std::string &buf, error_code &error)
+	{
+		using namespace libgs::operators;
+		auto size = buf.size();
+		buf.resize(size + m_option.buffer_size);
+
+		auto var = co_await (
+			socket.async_read_some(buffer(buf.data() + size, m_option.buffer_size), use_awaitable | error) or
+			sleep_for(socket.get_executor(), m_option.read_timeout)
+		);
+		if( var.index() == 0 )
+			buf.resize(size + std::get<0>(var));
+		else
+		{
+			buf.resize(size);
+			error = make_error_code(errc::timed_out);
+		}
+		co_return ;
+	}
+
+	[[nodiscard]] static awaitable<void> co_write_downstream(context_t &context, std::string_view data, error_code &error)
+	{
+		using namespace libgs::operators;
+		auto &request = context.request();
+
+		if( auto transport = request.transport() )
+			co_await transport->co_write(data, error);
+		else
+			co_await asio::async_write(request.next_layer(), buffer(data.data(), data.size()), use_awaitable | error);
+		co_return ;
+	}
+
+#ifdef __linux__
+	// Moves 'size' bytes from the upstream to the client socket through a pipe,
+	// they never enter user space.
+	[[nodiscard]] awaitable<size_t> co_splice(upstream_socket_t &src, Stream &dst, size_t size, error_code &error)
+	{
+		using namespace libgs::operators;
+		constexpr size_t pipe_size = 0x10000;
+
+		int fds[2] {-1,-1};
+		if( ::pipe2(fds, O_NONBLOCK | O_CLOEXEC) < 0 )
+		{
+			error = error_code(errno, std::system_category());
+			co_return 0;
+		}
+		struct pipe_closer
+		{
+			int *fds;
+			~pipe_closer() {
+				::close(fds[0]);
+				::close(fds[1]);
+			}
+		}
+		closer {fds};
+
+		src.native_non_blocking(true, error);
+		if( not error )
+			dst.native_non_blocking(true, error);
+		if( error )
+			co_return 0;
+
+		size_t sum = 0, buffered = 0;
+		while( sum < size )
+		{
+			if( buffered < pipe_size and sum + buffered < size )
+			{
+				auto res = ::splice (
+					src.native_handle(), nullptr, fds[1], nullptr,
+					std::min(pipe_size - buffered, size - sum - buffered),
+					SPLICE_F_MOVE | SPLICE_F_NONBLOCK
+				);
+				if( res > 0 )
+					buffered += static_cast<size_t>(res);
+				else if( res == 0 )
+				{
+					error = errc::eof;
+					break;
+				}
+				else if( errno != EAGAIN and errno != EWOULDBLOCK )
+				{
+					error = error_code(errno, std::system_category());
+					break;
+				}
+				else if( buffered == 0 )
+				{
+					auto var = co_await (
+						src.async_wait(asio::socket_base::wait_read, use_awaitable | error) or
+						sleep_for(src.get_executor(), m_option.read_timeout)
+					);
+					if( var.index() == 1 )
+						error = make_error_code(errc::timed_out);
+					if( error )
+						break;
+					continue;
+				}
+			}
+			auto res = ::splice (
+				fds[0], nullptr, dst.native_handle(), nullptr, buffered,
+				SPLICE_F_MOVE | SPLICE_F_NONBLOCK
+			);
+			if( res > 0 )
+			{
+				buffered -= static_cast<size_t>(res);
+				sum += static_cast<size_t>(res);
+			}
+			else if( res < 0 and errno != EAGAIN and errno != EWOULDBLOCK )
+			{
+				error = error_code(errno, std::system_category());
+				break;
+			}
+			else
+			{
+				co_await dst.async_wait(asio::socket_base::wait_write, use_awaitable | error);
+				if( error )
+					break;
+			}
+		}
+		co_return sum;
+	}
+#endif //__linux__
+
+private:
+	[[nodiscard]] static awaitable<void> co_fail(context_t &context, const endpoint_t &ep, const error_code &error)
+	{
+		using namespace libgs::operators;
+		spdlog::debug("libgs::http::proxy: upstream '{}': {}.", ep, error);
+
+		auto status = error == errc::timed_out ? status::gateway_timeout : status::bad_gateway;
+		auto text = std::format("{} ({})", status_description(status), status);
+
+		error_code _error;
+		co_await context.response().set_status(status).write(buffer(text), use_awaitable | _error);
+		co_return ;
+	}
+
+	static void abort(context_t &context) noexcept
+	{
+		auto &request = context.request();
+		if( auto transport = request.transport() )
+			transport->cancel();
+		else
+			socket_operation_helper<Stream>(request.next_layer()).close();
+	}
+
+public:
+	session_pool_t &m_pool;
+	std::vector<upstream> m_upstreams;
+	proxy_option m_option;
+	std::atomic_size_t m_next {0};
+
+	std::atomic_size_t m_requests {0};
+	std::atomic_size_t m_retries {0};
+	std::atomic_size_t m_failures {0};
+	std::atomic_size_t m_spliced {0};
+	std::atomic_size_t m_copied {0};
+};
+
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool>
+basic_proxy<Stream,CharT,SessionPool>::basic_proxy
+(session_pool_t &pool, std::vector<endpoint_t> upstreams, proxy_option option) :
+	m_impl(new impl(pool, std::move(upstreams), std::move(option)))
+{
+
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool>
+basic_proxy<Stream,CharT,SessionPool>::~basic_proxy()
+{
+	delete m_impl;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool>
+awaitable<void> basic_proxy<Stream,CharT,SessionPool>::service(context_t &context)
+{
+	return m_impl->service(context);
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool>
+const proxy_option &basic_proxy<Stream,CharT,SessionPool>::option() const noexcept
+{
+	return m_impl->m_option;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool>
+typename basic_proxy<Stream,CharT,SessionPool>::statistics
+basic_proxy<Stream,CharT,SessionPool>::stats() const noexcept
+{
+	return {
+		.requests = m_impl->m_requests.load(std::memory_order_relaxed),
+		.retries  = m_impl->m_retries.load(std::memory_order_relaxed),
+		.failures = m_impl->m_failures.load(std::memory_order_relaxed),
+		.spliced  = m_impl->m_spliced.load(std::memory_order_relaxed),
+		.copied   = m_impl->m_copied.load(std::memory_order_relaxed)
+	};
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_PROXY_H
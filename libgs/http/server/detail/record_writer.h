@@ -0,0 +1,396 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_RECORD_WRITER_H
+#define LIBGS_HTTP_SERVER_DETAIL_RECORD_WRITER_H
+
+#include <libgs/http/global.h>
+#include <spdlog/spdlog.h>
+#include <condition_variable>
+#include <fstream>
+#include <deque>
+#include <thread>
+
+namespace libgs::http::detail
+{
+
+struct record_writer_option
+{
+	// Prefixes the errors it logs.
+	std::string_view owner;
+	std::filesystem::path file_name;
+
+	// A power of two.
+	size_t ring_capacity = 0;
+	milliseconds flush_interval {0};
+
+	// Zero disables rotation.
+	size_t max_file_size = 0;
+	size_t max_files = 0;
+
+	// Written at the start of an empty file.
+	std::string_view header {};
+};
+
+struct record_writer_statistics
+{
+	size_t written = 0;
+	size_t dropped = 0;
+	size_t rotations = 0;
+	size_t write_errors = 0;
+};
+
+// Shared by the access log and the tracer: per thread SPSC rings of fixed size records,
+// drained by a background thread which formats each batch and appends it to the file.
+template <typename Record>
+class record_writer
+{
+	LIBGS_DISABLE_COPY_MOVE(record_writer)
+
+	struct ring
+	{
+		explicit ring(size_t capacity) :
+			records(capacity), mask(capacity - 1) {}
+
+		std::vector<Record> records;
+		const size_t mask;
+
+		// Written by the writer thread.
+		alignas(64) std::atomic_size_t head {0};
+
+		// Written by the owning io thread.
+		alignas(64) std::atomic_size_t tail {0};
+
+		// Rings are only ever added, in front.
+		ring *next = nullptr;
+	};
+
+public:
+	// Appends a batch to the buffer, records are in the order the rings were drained.
+	using format_t = std::function<void(std::vector<Record> &batch, std::string &buffer)>;
+
+	explicit record_writer(const record_writer_option &option) :
+		m_option(option) {}
+
+	~record_writer()
+	{
+		{
+			std::unique_lock lock(m_mutex);
+			m_stop = true;
+		}
+		m_cond.notify_one();
+		if( m_thread.joinable() )
+			m_thread.join();
+
+		for(auto ring = m_rings.load(); ring;)
+			delete std::exchange(ring, ring->next);
+	}
+
+public:
+	void start(format_t format)
+	{
+		m_format = std::move(format);
+		open();
+		m_thread = std::thread([this]{ run(); });
+	}
+
+	// False if the calling thread's ring is full, the record is dropped.
+	bool push(const Record &record) noexcept
+	{
+		auto ring = local_ring();
+		if( not ring )
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		auto tail = ring->tail.load(std::memory_order_relaxed);
+		auto size = tail - ring->head.load(std::memory_order_acquire);
+		if( size > ring->mask )
+		{
+			m_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		ring->records[tail & ring->mask] = record;
+		ring->tail.store(tail + 1, std::memory_order_release);
+
+		// Wake the writer early on a burst instead of waiting for the interval.
+		if( size == (ring->mask >> 1) )
+			m_cond.notify_one();
+		return true;
+	}
+
+	[[nodiscard]] record_writer_statistics stats() const noexcept
+	{
+		return {
+			.written = m_written.load(std::memory_order_relaxed),
+			.dropped = m_dropped.load(std::memory_order_relaxed),
+			.rotations = m_rotations.load(std::memory_order_relaxed),
+			.write_errors = m_write_errors.load(std::memory_order_relaxed)
+		};
+	}
+
+private:
+	[[nodiscard]] ring *local_ring() noexcept
+	{
+		struct entry
+		{
+			uint64_t id;
+			ring *ptr;
+		};
+		// Instance ids are never reused, so entries of destroyed writers are never matched.
+		static thread_local std::vector<entry> t_rings;
+		for(auto &[id, ptr] : t_rings)
+		{
+			if( id == m_id )
+				return ptr;
+		}
+		try {
+			auto ptr = std::make_unique<ring>(m_option.ring_capacity);
+			t_rings.reserve(t_rings.size() + 1);
+			t_rings.push_back({m_id, ptr.get()});
+
+			// Lock free, the writer may be in the middle of a drain.
+			ptr->next = m_rings.load();
+			while( not m_rings.compare_exchange_weak(ptr->next, ptr.get()) );
+			return ptr.release();
+		}
+		catch(...) {
+			return nullptr;
+		}
+	}
+
+	void run()
+	{
+		std::unique_lock lock(m_mutex);
+		while( not m_stop )
+		{
+			m_cond.wait_for(lock, m_option.flush_interval);
+			lock.unlock();
+			drain();
+			lock.lock();
+		}
+		lock.unlock();
+		drain();
+	}
+
+	void drain()
+	{
+		m_batch.clear();
+		for(auto ring = m_rings.load(std::memory_order_acquire); ring; ring = ring->next)
+		{
+			auto head = ring->head.load(std::memory_order_relaxed);
+			auto tail = ring->tail.load(std::memory_order_acquire);
+			for(; head != tail; head++)
+				m_batch.emplace_back(ring->records[head & ring->mask]);
+			ring->head.store(head, std::memory_order_release);
+		}
+		if( m_batch.empty() )
+			return ;
+
+		m_buffer.clear();
+		m_format(m_batch, m_buffer);
+		write(m_buffer, m_batch.size());
+	}
+
+	void open()
+	{
+		error_code error;
+		auto dir = m_option.file_name.parent_path();
+		if( not dir.empty() )
+			std::filesystem::create_directories(dir, error);
+
+		m_file.open(m_option.file_name, std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+		if( not m_file )
+		{
+			spdlog::error("{}: Cannot open '{}'.", m_option.owner, m_option.file_name.string());
+			return ;
+		}
+		m_file_size = std::filesystem::file_size(m_option.file_name, error);
+		if( error )
+			m_file_size = 0;
+
+		if( m_file_size == 0 and not m_option.header.empty() )
+		{
+			m_file << m_option.header;
+			m_file_size = m_option.header.size();
+		}
+	}
+
+	void rotate()
+	{
+		m_file.close();
+		auto name = [this](size_t index) {
+			auto file_name = m_option.file_name;
+			return file_name += std::format(".{}", index);
+		};
+		error_code error;
+		if( m_option.max_files == 0 )
+			std::filesystem::remove(m_option.file_name, error);
+		else
+		{
+			std::filesystem::remove(name(m_option.max_files), error);
+			for(auto i=m_option.max_files; i>1; i--)
+				std::filesystem::rename(name(i - 1), name(i), error);
+			std::filesystem::rename(m_option.file_name, name(1), error);
+		}
+		m_rotations.fetch_add(1, std::memory_order_relaxed);
+		open();
+	}
+
+	void write(std::string_view data, size_t count)
+	{
+		if( m_option.max_file_size > 0 and m_file_size > m_option.header.size() and
+			m_file_size + data.size() > m_option.max_file_size )
+			rotate();
+
+		if( not m_file.is_open() )
+			open();
+
+		// The whole batch in one write.
+		if( m_file.write(data.data(), static_cast<std::streamsize>(data.size())) and m_file.flush() )
+		{
+			m_file_size += data.size();
+			m_written.fetch_add(count, std::memory_order_relaxed);
+			return ;
+		}
+		m_write_errors.fetch_add(1, std::memory_order_relaxed);
+		m_file.close();
+	}
+
+private:
+	record_writer_option m_option;
+	format_t m_format {};
+
+	inline static std::atomic_uint64_t s_next_id {1};
+	const uint64_t m_id = s_next_id.fetch_add(1, std::memory_order_relaxed);
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::atomic<ring*> m_rings {nullptr};
+	bool m_stop = false;
+
+	std::vector<Record> m_batch;
+	std::string m_buffer;
+
+	std::ofstream m_file;
+	size_t m_file_size = 0;
+
+	std::atomic_size_t m_written {0};
+	std::atomic_size_t m_dropped {0};
+	std::atomic_size_t m_rotations {0};
+	std::atomic_size_t m_write_errors {0};
+
+	std::thread m_thread;
+};
+
+// The last reference to an access log or a tracer can go away on an io thread, their
+// destructor would then join the writer thread after the final drain and write. The
+// objects made here are handed to a background thread to be destroyed instead.
+class record_reaper
+{
+	LIBGS_DISABLE_COPY_MOVE(record_reaper)
+
+	record_reaper() :
+		m_thread([this]{ run(); }) {}
+
+public:
+	~record_reaper()
+	{
+		{
+			std::unique_lock lock(m_mutex);
+			m_stop = true;
+		}
+		m_cond.notify_one();
+		m_thread.join();
+		s_closed = true;
+	}
+
+public:
+	template <typename T, typename...Args>
+	[[nodiscard]] static std::shared_ptr<T> make_shared(Args&&...args)
+	{
+		// Constructed before the object, so it is still there when the object goes.
+		auto &reaper = instance();
+		return std::shared_ptr<T>(new T(std::forward<Args>(args)...), [&reaper](T *ptr)
+		{
+			if( s_closed )
+			{
+				delete ptr;
+				return ;
+			}
+			std::unique_lock lock(reaper.m_mutex);
+			if( reaper.m_stop )
+			{
+				lock.unlock();
+				delete ptr;
+				return ;
+			}
+			reaper.m_queue.emplace_back([ptr]{ delete ptr; });
+			lock.unlock();
+			reaper.m_cond.notify_one();
+		});
+	}
+
+private:
+	[[nodiscard]] static record_reaper &instance()
+	{
+		static record_reaper reaper;
+		return reaper;
+	}
+
+	void run()
+	{
+		std::unique_lock lock(m_mutex);
+		for(;;)
+		{
+			m_cond.wait(lock, [this]{ return m_stop or not m_queue.empty(); });
+			if( m_queue.empty() )
+				break;
+
+			auto destroy = std::move(m_queue.front());
+			m_queue.pop_front();
+			lock.unlock();
+			destroy();
+			lock.lock();
+		}
+	}
+
+private:
+	inline static std::atomic_bool s_closed {false};
+
+	std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::deque<std::function<void()>> m_queue;
+	bool m_stop = false;
+	std::thread m_thread;
+};
+
+} //namespace libgs::http::detail
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_RECORD_WRITER_H
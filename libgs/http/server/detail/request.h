@@ -42,21 +42,22 @@ class basic_server_request<Stream,CharT>::impl
 
 public:
 	template <typename Native>
-	impl(Native &&next_layer, parser_t &parser) :
-		m_next_layer(std::forward<Native>(next_layer)), m_parser(&parser) {}
+	impl(Native &&next_layer, parser_t &parser, transport_t *transport) :
+		m_next_layer(std::forward<Native>(next_layer)), m_parser(&parser), m_transport(transport) {}
 
 	template <typename Stream0>
 	impl(typename basic_server_request<Stream0,char_t>::impl &&other) noexcept :
-		m_next_layer(std::move(other.m_next_layer)), m_parser(other.m_parser) {}
+		m_next_layer(std::move(other.m_next_layer)), m_parser(other.m_parser), m_transport(other.m_transport) {}
 
 	impl(impl &&other) noexcept :
-		m_next_layer(std::move(other.m_next_layer)), m_parser(other.m_parser) {}
+		m_next_layer(std::move(other.m_next_layer)), m_parser(other.m_parser), m_transport(other.m_transport) {}
 
 	template <typename Stream0>
 	impl &operator=(typename basic_server_request<Stream0,char_t>::impl &&other) noexcept
 	{
 		m_next_layer = std::move(other.m_next_layer);
 		m_parser = other.m_parser;
+		m_transport = other.m_transport;
 		return *this;
 	}
 
@@ -64,12 +65,13 @@ public:
 	{
 		m_next_layer = std::move(other.m_next_layer);
 		m_parser = other.m_parser;
+		m_transport = other.m_transport;
 		return *this;
 	}
 
 	~impl()
 	{
-		if( m_parser->version() == version::v10 )
+		if( not m_transport and m_parser->version() == version::v10 )
 			socket_operation_helper<next_layer_t>(m_next_layer).close();
 	}
 
@@ -87,6 +89,11 @@ public:
 			error = std::make_error_code(static_cast<std::errc>(errc::eof));
 			return sum;
 		}
+		else if( m_transport )
+		{
+			error = std::make_error_code(std::errc::operation_not_supported);
+			return sum;
+		}
 		sock_helper_t sock_helper(m_next_layer);
 
 		asio::socket_base::receive_buffer_size op;
@@ -96,10 +103,10 @@ public:
 
 		auto dst_buf = reinterpret_cast<char*>(buf.data());
 		do {
-			auto body = m_parser->take_partial_body(buf_size);
+			auto body = m_parser->take_partial_body(buf_size - sum);
+			memcpy(dst_buf + sum, body.c_str(), body.size());
 			sum += body.size();
 
-			memcpy(dst_buf + sum, body.c_str(), body.size());
 			if( sum == buf_size or not m_parser->can_read_from_device() )
 				break;
 
@@ -143,29 +150,44 @@ public:
 		sock_helper_t sock_helper(m_next_layer);
 
 		asio::socket_base::receive_buffer_size op;
-		sock_helper.get_option(op, error);
-		if( error )
-			co_return sum;
+		if( m_transport )
+			op = asio::socket_base::receive_buffer_size(0xFFFF);
+		else
+		{
+			sock_helper.get_option(op, error);
+			if( error )
+				co_return sum;
+		}
+		auto device_read = [&,this](const mutable_buffer &_buf) -> awaitable<size_t>
+		{
+			if( m_transport )
+				co_return co_await m_transport->co_read(_buf, error);
+			co_return co_await sock_helper.read(_buf, use_awaitable | error);
+		};
 
 		auto read_task = [&,this]() mutable -> awaitable<size_t>
 		{
 			auto dst_buf = reinterpret_cast<char*>(buf.data());
 			do {
-				auto body = m_parser->take_partial_body(buf_size);
+				auto body = m_parser->take_partial_body(buf_size - sum);
+				memcpy(dst_buf + sum, body.c_str(), body.size());
 				sum += body.size();
 
-				memcpy(dst_buf + sum, body.c_str(), body.size());
 				if( sum == buf_size or not m_parser->can_read_from_device() )
 					break;
 
 				body = std::string(op.value(),'\0');
 				for(;;)
 				{
-					auto tmp_sum = co_await sock_helper.read (
-						{body.data(), body.size()}, use_awaitable | error
-					);
+					auto tmp_sum = co_await device_read({body.data(), body.size()});
 					if( error )
 						co_return sum;
+					else if( tmp_sum == 0 and m_transport )
+					{
+						// The stream ended before the announced content length.
+						error = std::make_error_code(static_cast<std::errc>(errc::eof));
+						co_return sum;
+					}
 
 					bool res = m_parser->append({body.data(), tmp_sum}, error);
 					if( error )
@@ -187,6 +209,10 @@ public:
 	template <typename Opt>
 	[[nodiscard]] size_t save_file(Opt &&opt, error_code &error) noexcept
 	{
+		static_assert(not std::is_same_v<std::remove_cvref_t<Opt>, async_file> and
+					  not is_async_file_opt_token_v<std::remove_cvref_t<Opt>>,
+			"libgs::http::server_request::save_file: async_file is only supported by the asynchronous overloads."
+		);
 		std::size_t sum = 0;
 		auto token = file_opt_token_helper(std::forward<Opt>(opt), error);
 		if( error )
@@ -234,44 +260,90 @@ public:
 	[[nodiscard]] awaitable<size_t> co_save_file(Opt &&opt, error_code &error) noexcept
 	{
 		std::size_t sum = 0;
-		auto token = file_opt_token_helper(std::forward<Opt>(opt), error);
+
+		// Files named by path are written through async_file, the io threads never wait on the disk.
+		auto token = file_opt_token_helper (
+			detail::to_async_file_opt_token<file_optype::single>(get_executor(), std::forward<Opt>(opt)),
+			error
+		);
 		if( error )
 			co_return sum;
+		if constexpr( is_async_file_opt_token_v<decltype(token)> )
+			sum = co_await co_save_async_file(*token.stream, token.range->begin, token.range->total, error);
+		else
+		{
+			constexpr size_t tcp_buf_size = 0xFFFF;
+			char buf[tcp_buf_size] {0};
 
-		constexpr size_t tcp_buf_size = 0xFFFF;
-		char buf[tcp_buf_size] {0};
+			using pos_t = typename Opt::pos_t;
+			if( token.range->total == 0 )
+			{
+				while( can_read_body() )
+				{
+					auto size = co_await co_read(buffer(buf, tcp_buf_size), error);
+					if( error )
+						break;
 
-		using pos_t = typename Opt::pos_t;
-		if( token.range->total == 0 )
-		{
-			while( can_read_body() )
+					sum += size;
+					token.stream->write(buf, static_cast<pos_t>(size));
+					// sleep_for(512us);
+				}
+			}
+			else
 			{
-				auto size = co_await co_read(buffer(buf, tcp_buf_size), error);
-				if( error )
-					break;
+				auto total = token.range->total;
+				while( can_read_body() )
+				{
+					auto size = co_await co_read(buffer(buf, std::min(tcp_buf_size, total)), error);
+					if( error )
+						break;
 
-				sum += size;
-				token.stream->write(buf, static_cast<pos_t>(size));
-				// sleep_for(512us);
+					sum += size;
+					token.stream->write(buf, static_cast<pos_t>(size));
+
+					total -= size;
+					if( total == 0 )
+						break;
+					// co_await sleep_for(get_executor(), 512us);
+				}
 			}
 		}
-		else
-		{
-			auto total = token.range->total;
-			while( can_read_body() )
-			{
-				auto size = co_await co_read(buffer(buf, std::min(tcp_buf_size, total)), error);
-				if( error )
-					break;
+		co_return sum;
+	}
 
-				sum += size;
-				token.stream->write(buf, static_cast<pos_t>(size));
+	// Double buffered: the next chunk is read from the socket while the last one is written to the disk.
+	[[nodiscard]] awaitable<size_t> co_save_async_file
+	(async_file &file, uint64_t offset, size_t total, error_code &error) noexcept
+	{
+		constexpr size_t tcp_buf_size = 0xFFFF;
+		char bufs[2][tcp_buf_size];
+		size_t sum = 0;
 
-				total -= size;
-				if( total == 0 )
-					break;
-				// co_await sleep_for(get_executor(), 512us);
+		// A zero total reads up to the end of the body.
+		auto next_size = [&]{
+			return total == 0 ? tcp_buf_size : std::min(tcp_buf_size, total - sum);
+		};
+		if( not can_read_body() )
+			co_return sum;
+
+		auto size = co_await co_read(buffer(bufs[0], next_size()), error);
+		for(size_t i=0; not error and size > 0; i ^= 1)
+		{
+			sum += size;
+			if( not can_read_body() or sum == total )
+			{
+				co_await file.co_write_at(offset, buffer(bufs[i], size), error);
+				break;
 			}
+			error_code write_error;
+			auto [written, next] = co_await (
+				file.co_write_at(offset, buffer(bufs[i], size), write_error) and
+				co_read(buffer(bufs[i ^ 1], next_size()), error)
+			);
+			offset += written;
+			size = next;
+			if( not error )
+				error = write_error;
 		}
 		co_return sum;
 	}
@@ -308,6 +380,21 @@ private:
 			token.stream->seekp(0, std::ios::beg);
 			return token;
 		}
+		else if constexpr( is_async_file_opt_token_v<std::remove_cvref_t<Opt>> )
+		{
+			error = opt.init(std::ios::out | std::ios::binary);
+			if( error )
+				return std::forward<Opt>(opt);
+
+			auto size = file_size(opt, io_permission::write);
+			if( not size )
+				error = make_error_code(std::errc::permission_denied);
+			else if( not opt.range )
+				opt.range = file_range(0,0);
+			else if( opt.range->begin > *size )
+				error = make_error_code(std::errc::invalid_seek);
+			return std::forward<Opt>(opt);
+		}
 		else
 		{
 			error = opt.init(std::ios::out | std::ios::binary);
@@ -334,20 +421,25 @@ private:
 	}
 
 public:
-	void set_blocking(error_code &error) {
-		socket_operation_helper<next_layer_t>(m_next_layer).non_blocking(false, error);
+	void set_blocking(error_code &error)
+	{
+		if( m_transport )
+			error = std::make_error_code(std::errc::operation_not_supported);
+		else
+			socket_operation_helper<next_layer_t>(m_next_layer).non_blocking(false, error);
 	}
 
 public:
 	next_layer_t m_next_layer;
 	parser_t *m_parser = nullptr;
+	transport_t *m_transport = nullptr;
 };
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
 template <typename NextLayer>
-basic_server_request<Stream,CharT>::basic_server_request(NextLayer &&next_layer, parser_t &parser)
+basic_server_request<Stream,CharT>::basic_server_request(NextLayer &&next_layer, parser_t &parser, transport_t *transport)
 	requires core_concepts::constructible<next_layer_t,NextLayer&&> :
-	m_impl(new impl(std::forward<NextLayer>(next_layer), parser))
+	m_impl(arena::make<impl>(std::forward<NextLayer>(next_layer), parser, transport))
 {
 
 }
@@ -355,12 +447,12 @@ basic_server_request<Stream,CharT>::basic_server_request(NextLayer &&next_layer,
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_request<Stream,CharT>::~basic_server_request()
 {
-	delete m_impl;
+
 }
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_request<Stream,CharT>::basic_server_request(basic_server_request &&other) noexcept :
-	m_impl(new impl(std::move(*other.m_impl)))
+	m_impl(std::move(other.m_impl))
 {
 
 }
@@ -368,8 +460,9 @@ basic_server_request<Stream,CharT>::basic_server_request(basic_server_request &&
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_request<Stream,CharT> &basic_server_request<Stream,CharT>::operator=(basic_server_request &&other) noexcept
 {
-	if( this != &other )
-		*m_impl = std::move(*other.m_impl);
+	if( this == &other )
+		return *this;
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
@@ -377,7 +470,7 @@ template <concepts::stream Stream, core_concepts::char_type CharT>
 template <typename Stream0>
 basic_server_request<Stream,CharT>::basic_server_request(basic_server_request<Stream0,char_t> &&other) noexcept
 	requires core_concepts::constructible<Stream,Stream0&&> :
-	m_impl(new impl(std::move(*other.m_impl)))
+	m_impl(arena::make<impl>(std::move(*other.m_impl)))
 {
 
 }
@@ -409,6 +502,12 @@ std::basic_string_view<CharT> basic_server_request<Stream,CharT>::path() const n
 	return m_impl->m_parser->path();
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+std::string_view basic_server_request<Stream,CharT>::target() const noexcept
+{
+	return m_impl->m_parser->target();
+}
+
 template <concepts::stream Stream, core_concepts::char_type CharT>
 const typename basic_server_request<Stream,CharT>::parameters_t&
 basic_server_request<Stream,CharT>::parameters() const noexcept
@@ -437,6 +536,12 @@ basic_server_request<Stream,CharT>::cookies() const noexcept
 	return m_impl->m_parser->cookies();
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+std::string_view basic_server_request<Stream,CharT>::cookie_header() const noexcept
+{
+	return m_impl->m_parser->cookie_header();
+}
+
 template <concepts::stream Stream, core_concepts::char_type CharT>
 template <core_concepts::basic_text_arg<CharT> T>
 decltype(auto) basic_server_request<Stream,CharT>::parameter
@@ -823,8 +928,9 @@ bool basic_server_request<Stream,CharT>::is_chunked() const noexcept
 {
 	if( version() < http::version::v11 )
 		return false;
-	auto it = m_impl->m_headers.find(header_t::transfer_encoding);
-	return it != m_impl->m_headers.end() and str_to_lower(it->second) == detail::string_pool<char_t>::chunked;
+	auto &headers = m_impl->m_parser->headers();
+	auto it = headers.find(header_t::transfer_encoding);
+	return it != headers.end() and str_to_lower(it->second.to_string()) == detail::string_pool<char_t>::chunked;
 }
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
@@ -842,15 +948,38 @@ bool basic_server_request<Stream,CharT>::is_eof() const noexcept
 template <concepts::stream Stream, core_concepts::char_type CharT>
 typename basic_server_request<Stream,CharT>::endpoint_t basic_server_request<Stream,CharT>::remote_endpoint() const
 {
+	if( m_impl->m_transport )
+		return m_impl->m_transport->remote_endpoint();
 	return socket_operation_helper<next_layer_t>(m_impl->m_next_layer).remote_endpoint();
 }
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
 typename basic_server_request<Stream,CharT>::endpoint_t basic_server_request<Stream,CharT>::local_endpoint() const
 {
+	if( m_impl->m_transport )
+		return m_impl->m_transport->local_endpoint();
 	return socket_operation_helper<next_layer_t>(m_impl->m_next_layer).local_endpoint();
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+peer_credentials basic_server_request<Stream,CharT>::peer_cred(error_code &error) const noexcept
+	requires is_local_stream_v<next_layer_t>
+{
+	if( m_impl->m_transport )
+		return m_impl->m_transport->peer_cred(error);
+	return socket_operation_helper<next_layer_t>(m_impl->m_next_layer).peer_cred(error);
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+peer_credentials basic_server_request<Stream,CharT>::peer_cred() const requires is_local_stream_v<next_layer_t>
+{
+	error_code error;
+	auto result = peer_cred(error);
+	if( error )
+		throw system_error(error, "libgs::http::server_request::peer_cred");
+	return result;
+}
+
 template <concepts::stream Stream, core_concepts::char_type CharT>
 typename basic_server_request<Stream,CharT>::executor_t basic_server_request<Stream,CharT>::get_executor() noexcept
 {
@@ -860,7 +989,10 @@ typename basic_server_request<Stream,CharT>::executor_t basic_server_request<Str
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_request<Stream,CharT> &basic_server_request<Stream,CharT>::cancel() noexcept
 {
-	m_impl->m_next_layer.cancel();
+	if( m_impl->m_transport )
+		m_impl->m_transport->cancel();
+	else
+		m_impl->m_next_layer.cancel();
 	return *this;
 }
 
@@ -878,6 +1010,13 @@ basic_server_request<Stream,CharT>::next_layer() noexcept
 	return m_impl->m_next_layer;
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+typename basic_server_request<Stream,CharT>::transport_t*
+basic_server_request<Stream,CharT>::transport() const noexcept
+{
+	return m_impl->m_transport;
+}
+
 } //namespace libgs::http
 
 
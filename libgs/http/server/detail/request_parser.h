@@ -89,6 +89,7 @@ public:
 			}
 			m_method = method;
 			version = version_number(request_line_parts[2].substr(5,3));
+			m_target = request_line_parts[1];
 
 			auto url_line = from_percent_encoding(request_line_parts[1]);
 			auto pos = url_line.find('?');
@@ -126,6 +127,10 @@ public:
 		})
 		.on_parse_cookie([this](std::string_view line_buf, error_code &error)
 		{
+			if( not m_cookie_header.empty() )
+				m_cookie_header += "; ";
+			m_cookie_header += line_buf;
+
 			auto list = string_list::from_string(line_buf, ';');
 			for(auto &statement : list)
 			{
@@ -175,9 +180,11 @@ public:
 	method_t m_method = method_t::GET;
 
 	string_t m_path {};
+	std::string m_target {};
 	parameters_t m_parameters {};
 	path_args_t m_path_args {};
 	cookies_t m_cookies {};
+	std::string m_cookie_header {};
 
 	bool m_keep_alive = true;
 	bool m_support_gzip = false;
@@ -185,7 +192,7 @@ public:
 
 template <core_concepts::char_type CharT>
 basic_request_parser<CharT>::basic_request_parser(size_t init_buf_size) :
-	m_impl(new impl(init_buf_size))
+	m_impl(arena::make<impl>(init_buf_size))
 {
 
 }
@@ -193,14 +200,14 @@ basic_request_parser<CharT>::basic_request_parser(size_t init_buf_size) :
 template <core_concepts::char_type CharT>
 basic_request_parser<CharT>::~basic_request_parser()
 {
-	delete m_impl;
+
 }
 
 template <core_concepts::char_type CharT>
 basic_request_parser<CharT>::basic_request_parser(basic_request_parser &&other) noexcept :
-	m_impl(other.m_impl)
+	m_impl(std::move(other.m_impl))
 {
-	other.m_impl = new impl(0xFFFF);
+
 }
 
 template <core_concepts::char_type CharT>
@@ -208,9 +215,7 @@ basic_request_parser<CharT> &basic_request_parser<CharT>::operator=(basic_reques
 {
 	if( this == &other )
 		return *this;
-	delete m_impl;
-	m_impl = other.m_impl;
-	other.m_impl = new impl(0xFFFF);
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
@@ -325,6 +330,12 @@ version_t basic_request_parser<CharT>::version() const noexcept
 	return m_impl->m_parser.version();
 }
 
+template <core_concepts::char_type CharT>
+std::string_view basic_request_parser<CharT>::target() const noexcept
+{
+	return m_impl->m_target;
+}
+
 template <core_concepts::char_type CharT>
 const typename basic_request_parser<CharT>::parameters_t&
 basic_request_parser<CharT>::parameters() const noexcept
@@ -353,6 +364,12 @@ basic_request_parser<CharT>::cookies() const noexcept
 	return m_impl->m_cookies;
 }
 
+template <core_concepts::char_type CharT>
+std::string_view basic_request_parser<CharT>::cookie_header() const noexcept
+{
+	return m_impl->m_cookie_header;
+}
+
 template <core_concepts::char_type CharT>
 bool basic_request_parser<CharT>::keep_alive() const noexcept
 {
@@ -400,8 +417,11 @@ basic_request_parser<CharT> &basic_request_parser<CharT>::reset()
 {
 	m_impl->m_parser.reset();
 	m_impl->m_path.clear();
+	m_impl->m_target.clear();
 	m_impl->m_parameters.clear();
+	m_impl->m_path_args.clear();
 	m_impl->m_cookies.clear();
+	m_impl->m_cookie_header.clear();
 	return *this;
 }
 
@@ -57,6 +57,12 @@ public:
 	{
 		m_helper = std::move(other.m_helper);
 		m_next_layer = std::move(other.m_next_layer);
+		m_recorder = std::exchange(other.m_recorder, nullptr);
+		m_recorder_limit = other.m_recorder_limit;
+		m_recorder_guard = std::move(other.m_recorder_guard);
+		m_trace = std::exchange(other.m_trace, nullptr);
+		m_serialized = std::exchange(other.m_serialized, false);
+		m_sent = std::exchange(other.m_sent, 0);
 		return *this;
 	}
 
@@ -64,6 +70,12 @@ public:
 	{
 		m_helper = std::move(other.m_helper);
 		m_next_layer = std::move(other.m_next_layer);
+		m_recorder = std::exchange(other.m_recorder, nullptr);
+		m_recorder_limit = other.m_recorder_limit;
+		m_recorder_guard = std::move(other.m_recorder_guard);
+		m_trace = std::exchange(other.m_trace, nullptr);
+		m_serialized = std::exchange(other.m_serialized, false);
+		m_sent = std::exchange(other.m_sent, 0);
 		return *this;
 	}
 
@@ -73,7 +85,7 @@ public:
 	}
 
 	[[nodiscard]] auto pro_state() const noexcept {
-		return m_helper.pro_state();
+		return m_serialized ? pro_state_t::finish : m_helper.pro_state();
 	}
 
 public:
@@ -124,7 +136,7 @@ private:
 
 	struct fot_data
 	{
-		std::string mtype;
+		std::string_view mtype;
 		size_t fsize = 0;
 	};
 
@@ -132,6 +144,9 @@ public:
 	template <typename Opt>
 	[[nodiscard]] size_t send_file(Opt &&opt, error_code &error)
 	{
+		static_assert(not is_async_file_opt<Opt>,
+			"libgs::http::server_response::send_file: async_file is only supported by the asynchronous overloads."
+		);
 		if( pro_state() != pro_state_t::header )
 			return 0;
 
@@ -167,7 +182,13 @@ public:
 			co_return 0;
 
 		fot_data data;
-		auto token = file_opt_token_helper(std::forward<Opt>(opt), data, error);
+		// Files named by path are read through async_file, the io threads never wait on the disk.
+		auto token = file_opt_token_helper (
+			detail::to_async_file_opt_token<file_optype::multiple>(
+				co_await asio::this_coro::executor, std::forward<Opt>(opt)
+			),
+			data, error
+		);
 		if( error )
 			co_return 0;
 
@@ -191,6 +212,57 @@ public:
 		co_return co_await co_range_transfer(token, ranges, data, error);
 	}
 
+public:
+	[[nodiscard]] size_t write_serialized(std::span<const const_buffer> buffers, error_code &error) noexcept
+	{
+		if( pro_state() != pro_state_t::header )
+			return 0;
+		else if( m_next_layer.transport() )
+		{
+			error = std::make_error_code(std::errc::operation_not_supported);
+			return 0;
+		}
+		sock_helper_t sock_helper(m_next_layer.next_layer());
+		sock_helper.non_blocking(false, error);
+		if( error )
+			return 0;
+
+		m_serialized = true;
+		auto start = trace_now();
+		auto sent = asio::write(m_next_layer.next_layer(), buffers, error);
+		m_sent += sent;
+		trace_write(start);
+		return sent;
+	}
+
+	[[nodiscard]] awaitable<size_t> co_write_serialized(std::span<const const_buffer> buffers, error_code &error) noexcept
+	{
+		if( pro_state() != pro_state_t::header )
+			co_return 0;
+
+		m_serialized = true;
+		auto start = trace_now();
+		if( auto transport = m_next_layer.transport() )
+		{
+			// The transport takes HTTP/1.x bytes apart itself.
+			size_t sum = 0;
+			for(auto &buf : buffers)
+			{
+				sum += co_await transport->co_write({static_cast<const char*>(buf.data()), buf.size()}, error);
+				if( error )
+					break;
+			}
+			m_sent += sum;
+			trace_write(start);
+			co_return sum;
+		}
+		using namespace libgs::operators;
+		auto sent = co_await asio::async_write(m_next_layer.next_layer(), buffers, use_awaitable | error);
+		m_sent += sent;
+		trace_write(start);
+		co_return sent;
+	}
+
 public:
 	[[nodiscard]] size_t chunk_end(const map_helper_t &headers, error_code &error)
 	{
@@ -225,7 +297,6 @@ private:
 	template <typename Opt>
 	[[nodiscard]] size_t default_transfer(Opt &&opt, const fot_data &data, error_code &error) noexcept
 	{
-		spdlog::debug("resource mime-type: {}.", data.mtype);
 		size_t sum = 0;
 		if( data.fsize == 0 )
 			return sum;
@@ -257,7 +328,6 @@ private:
 	template <typename Opt>
 	[[nodiscard]] awaitable<size_t> co_default_transfer(Opt &&opt, const fot_data &data, error_code &error) noexcept
 	{
-		spdlog::debug("resource mime-type: {}.", data.mtype);
 		size_t sum = 0;
 		if( data.fsize == 0 )
 			co_return sum;
@@ -286,6 +356,22 @@ private:
 		co_return sum;
 	}
 
+	[[nodiscard]] awaitable<size_t> co_default_transfer
+	(file_opt_token<async_file,file_optype::multiple> &opt, const fot_data &data, error_code &error) noexcept
+	{
+		size_t sum = 0;
+		if( data.fsize == 0 )
+			co_return sum;
+
+		m_helper.set_header(header_t::content_type, mbstoxx<char_t>(data.mtype));
+		sum += co_await co_write_header(data.fsize, error);
+		if( error )
+			co_return sum;
+
+		sum += co_await co_transfer_file(*opt.stream, 0, data.fsize, false, error);
+		co_return sum;
+	}
+
 public:
 	[[nodiscard]] size_t range_transfer
 	(auto &&opt, const std::list<range_value> &ranges, const fot_data &data, error_code &error)
@@ -295,7 +381,7 @@ public:
 		{
 			auto &range = ranges.back();
 			m_helper.set_header(header_t::accept_ranges, static_string::bytes);
-			m_helper.set_header(header_t::content_type, mbstoxx<char_t>(mime_type));
+			m_helper.set_header(header_t::content_type, mbstoxx<char_t>(data.mtype));
 			m_helper.set_header(header_t::content_length, range.total);
 			m_helper.set_header(header_t::content_range, value_t {
 				static_string::content_range_format, range.begin, range.end, range.total
@@ -594,6 +680,88 @@ private:
 		co_return sum;
 	}
 
+	[[nodiscard]] awaitable<size_t> co_send_range(
+		std::shared_ptr<async_file> &stream, std::string_view boundary, std::string_view ct_line,
+		std::list<range_value> ranges, error_code &error
+	) noexcept
+	{
+		assert(not ranges.empty());
+		auto sum = co_await co_write_header(0, error);
+		if( error )
+			co_return sum;
+
+		if( ranges.size() == 1 )
+		{
+			auto &value = ranges.back();
+			sum += co_await co_transfer_file(*stream, value.begin, value.total, false, error);
+			co_return sum;
+		}
+		for(auto &value : ranges)
+		{
+			std::string body;
+			body.reserve(2 + boundary.size() + 2 +
+						 ct_line.size() + 2 +
+						 value.cr_line.size() + 2 +
+						 2);
+
+			body.append("--").append(boundary).append("\r\n")
+				.append(ct_line).append("\r\n")
+				.append(value.cr_line).append("\r\n"
+											  "\r\n");
+
+			sum += co_await co_write_body(buffer(body, body.size()), error);
+			if( error )
+				co_return sum;
+
+			sum += co_await co_transfer_file(*stream, value.begin, value.total, true, error);
+			if( error )
+				co_return sum;
+		}
+		auto abuf = "--" + std::string(boundary.data(), boundary.size()) + "--\r\n";
+		sum += co_await co_write_body(buffer(abuf, abuf.size()), error);
+		co_return sum;
+	}
+
+	// Double buffered: the next chunk is read from the disk while the current one is on the wire.
+	[[nodiscard]] awaitable<size_t> co_transfer_file
+	(async_file &file, uint64_t offset, size_t total, bool crlf, error_code &error) noexcept
+	{
+		constexpr size_t buf_size = 0xFFFF;
+
+		// Two more bytes for the <CR><LF> closing a multipart range.
+		char bufs[2][buf_size + 2];
+		size_t sum = 0;
+
+		auto size = co_await file.co_read_at(offset, buffer(bufs[0], std::min(buf_size, total)), error);
+		for(size_t i=0; not error and size > 0; i ^= 1)
+		{
+			offset += size;
+			total -= size;
+
+			auto wsize = size;
+			if( total == 0 and crlf )
+			{
+				bufs[i][wsize++] = '\r';
+				bufs[i][wsize++] = '\n';
+			}
+			if( total == 0 )
+			{
+				sum += co_await co_write_body(buffer(bufs[i], wsize), error);
+				break;
+			}
+			error_code read_error;
+			auto [written, next] = co_await (
+				co_write_body(buffer(bufs[i], wsize), error) and
+				file.co_read_at(offset, buffer(bufs[i ^ 1], std::min(buf_size, total)), read_error)
+			);
+			sum += written;
+			size = next;
+			if( not error )
+				error = read_error;
+		}
+		co_return sum;
+	}
+
 private:
 	[[nodiscard]] status_t range_text_parsing
 	(string_view_t range_str_view, size_t file_size, std::list<range_value> &ranges)
@@ -728,27 +896,76 @@ private:
 	[[nodiscard]] size_t base_write(std::string &&data, error_code &error)
 	{
 		size_t sent = 0;
+		if( m_next_layer.transport() )
+		{
+			error = std::make_error_code(std::errc::operation_not_supported);
+			return sent;
+		}
 		sock_helper_t sock_helper(m_next_layer.next_layer());
 
 		sock_helper.non_blocking(false, error);
 		if( error )
 			return sent;
 
+		auto start = trace_now();
 		sent += sock_helper.write(data, error);
+		m_sent += sent;
+		record(data, sent);
+		trace_write(start);
 		return sent;
 	}
 
 	[[nodiscard]] awaitable<size_t> co_base_write(std::string &&data, error_code &error)
 	{
-		sock_helper_t sock_helper(m_next_layer.next_layer());
 		size_t sent = 0;
+		auto start = trace_now();
+		if( auto transport = m_next_layer.transport() )
+		{
+			sent = co_await transport->co_write(data, error);
+			m_sent += sent;
+			trace_write(start);
+			co_return sent;
+		}
+		sock_helper_t sock_helper(m_next_layer.next_layer());
 
 		using namespace libgs::operators;
 		sent += co_await sock_helper.write(data, use_awaitable | error);
+		m_sent += sent;
+		record(data, sent);
+		trace_write(start);
 		co_return sent;
 	}
 
+	void record(const std::string &data, size_t sent)
+	{
+		if( not m_recorder )
+			return ;
+		else if( m_recorder->size() + sent <= m_recorder_limit )
+			m_recorder->append(data, 0, sent);
+		else
+		{
+			// Too large to be kept, the owner finds the recording stopped.
+			std::string().swap(*m_recorder);
+			m_recorder = nullptr;
+		}
+	}
+
+	[[nodiscard]] request_trace::time_point trace_now() const noexcept {
+		return m_trace ? request_trace::clock_t::now() : request_trace::time_point();
+	}
+
+	void trace_write(request_trace::time_point start) noexcept
+	{
+		if( m_trace )
+			m_trace->extend("write", start);
+	}
+
 private:
+	template <typename Opt>
+	static constexpr bool is_async_file_opt =
+		std::is_same_v<std::remove_cvref_t<Opt>, async_file> or
+		is_async_file_opt_token_v<std::remove_cvref_t<Opt>>;
+
 	template <typename Opt>
 	[[nodiscard]] auto file_opt_token_helper(Opt &&opt, fot_data &data, error_code &error)
 	{
@@ -803,11 +1020,21 @@ private:
 public:
 	helper_t m_helper;
 	next_layer_t m_next_layer;
+
+	// Everything written to the socket is appended here (basic_cache_aop).
+	std::string *m_recorder = nullptr;
+	size_t m_recorder_limit = 0;
+	std::shared_ptr<void> m_recorder_guard;
+	request_trace *m_trace = nullptr;
+	bool m_serialized = false;
+
+	// Head included, for the access log.
+	size_t m_sent = 0;
 };
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_response<Stream,CharT>::basic_server_response(next_layer_t &&next_layer) :
-	m_impl(new impl(std::move(next_layer)))
+	m_impl(arena::make<impl>(std::move(next_layer)))
 {
 
 }
@@ -815,12 +1042,12 @@ basic_server_response<Stream,CharT>::basic_server_response(next_layer_t &&next_l
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_response<Stream,CharT>::~basic_server_response()
 {
-	delete m_impl;
+
 }
 
 template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_response<Stream,CharT>::basic_server_response(basic_server_response &&other) noexcept :
-	m_impl(new impl(std::move(*other.m_impl)))
+	m_impl(std::move(other.m_impl))
 {
 
 }
@@ -829,8 +1056,9 @@ template <concepts::stream Stream, core_concepts::char_type CharT>
 basic_server_response<Stream,CharT> &basic_server_response<Stream,CharT>::operator=
 (basic_server_response &&other) noexcept
 {
-	if( this != &other )
-		*m_impl = std::move(*other.m_impl);
+	if( this == &other )
+		return *this;
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
@@ -839,7 +1067,7 @@ template <typename Stream0>
 basic_server_response<Stream,CharT>::basic_server_response
 (basic_server_response<Stream0,char_t> &&other) noexcept
 	requires core_concepts::constructible<next_layer_t,basic_server_request<Stream0,char_t>&&> :
-	m_impl(new impl(this, std::move(*other.m_impl)))
+	m_impl(arena::make<impl>(this, std::move(*other.m_impl)))
 {
 
 }
@@ -1162,6 +1390,82 @@ auto basic_server_response<Stream,CharT>::chunk_end(Token &&token)
 	return chunk_end({}, std::forward<Token>(token));
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+template <core_concepts::dis_func_tf_opt_token Token>
+auto basic_server_response<Stream,CharT>::write_serialized(std::span<const const_buffer> buffers, Token &&token)
+{
+	using token_t = std::remove_cvref_t<Token>;
+	if constexpr( std::is_same_v<token_t, error_code> )
+		return token ? 0 : m_impl->write_serialized(buffers, token);
+
+	else if constexpr( is_sync_opt_token_v<token_t> )
+	{
+		error_code error;
+		auto res = write_serialized(buffers, error);
+		if( error )
+			throw system_error(error, "libgs::http::server_response::write_serialized");
+		return res;
+	}
+#ifdef LIBGS_USING_BOOST_ASIO
+	else if constexpr( is_yield_context_v<token_t> )
+	{
+		// TODO ... ...
+	}
+#endif //LIBGS_USING_BOOST_ASIO
+	else if constexpr( is_redirect_time_v<std::remove_cvref_t<Token>> )
+	{
+		auto ntoken = unbound_redirect_time(token);
+		return asio::co_spawn(get_executor(),
+		[this, buffers, ntoken, timeout = get_associated_redirect_time(token)]() mutable -> awaitable<size_t>
+		{
+			error_code error;
+			auto var = co_await (
+				m_impl->co_write_serialized(buffers, error) or
+				sleep_for(get_executor(), timeout)
+			);
+			auto res = m_impl->check_time_out(var, error);
+
+			check_error(remove_const(ntoken), error, "libgs::http::server_response::write_serialized");
+			co_return res;
+		},
+		ntoken);
+	}
+	else
+	{
+		return asio::co_spawn(get_executor(), [this, buffers, token]() mutable -> awaitable<size_t>
+		{
+			error_code error;
+			auto res = co_await m_impl->co_write_serialized(buffers, error);
+			check_error(remove_const(token), error, "libgs::http::server_response::write_serialized");
+			co_return res;
+		},
+		token);
+	}
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_server_response<Stream,CharT> &basic_server_response<Stream,CharT>::set_recorder
+(std::string *buf, size_t max_size, std::shared_ptr<void> guard) noexcept
+{
+	m_impl->m_recorder = buf;
+	m_impl->m_recorder_limit = max_size;
+	m_impl->m_recorder_guard = std::move(guard);
+	return *this;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+const std::string *basic_server_response<Stream,CharT>::recorder() const noexcept
+{
+	return m_impl->m_recorder;
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+basic_server_response<Stream,CharT> &basic_server_response<Stream,CharT>::set_trace(request_trace *trace) noexcept
+{
+	m_impl->m_trace = trace;
+	return *this;
+}
+
 template <concepts::stream Stream, core_concepts::char_type CharT>
 typename basic_server_response<Stream,CharT>::string_view_t
 basic_server_response<Stream,CharT>::version() const noexcept
@@ -1195,6 +1499,12 @@ bool basic_server_response<Stream,CharT>::is_finished() const noexcept
 	return m_impl->pro_state() == helper_t::pro_state_t::finish;
 }
 
+template <concepts::stream Stream, core_concepts::char_type CharT>
+size_t basic_server_response<Stream,CharT>::bytes_sent() const noexcept
+{
+	return m_impl->m_sent;
+}
+
 template <concepts::stream Stream, core_concepts::char_type CharT>
 typename basic_server_response<Stream,CharT>::executor_t
 basic_server_response<Stream,CharT>::get_executor() noexcept
@@ -99,14 +99,14 @@ public:
 
 template <core_concepts::char_type CharT>
 basic_response_helper<CharT>::basic_response_helper(version_t version, const headers_t &request_headers) :
-	m_impl(new impl(version, request_headers))
+	m_impl(arena::make<impl>(version, request_headers))
 {
 
 }
 
 template <core_concepts::char_type CharT>
 basic_response_helper<CharT>::basic_response_helper(const headers_t &request_headers) :
-	m_impl(new impl(detail::string_pool<char_t>::v_1_1, request_headers))
+	m_impl(arena::make<impl>(detail::string_pool<char_t>::v_1_1, request_headers))
 {
 
 }
@@ -114,15 +114,14 @@ basic_response_helper<CharT>::basic_response_helper(const headers_t &request_hea
 template <core_concepts::char_type CharT>
 basic_response_helper<CharT>::~basic_response_helper()
 {
-	delete m_impl;
+
 }
 
 template <core_concepts::char_type CharT>
 basic_response_helper<CharT>::basic_response_helper(basic_response_helper &&other) noexcept :
-	m_impl(other.m_impl)
+	m_impl(std::move(other.m_impl))
 {
-	other.m_impl = new impl();
-	other.m_impl->m_request_headers = m_impl->m_request_headers;
+
 }
 
 template <core_concepts::char_type CharT>
@@ -130,10 +129,7 @@ basic_response_helper<CharT> &basic_response_helper<CharT>::operator=(basic_resp
 {
 	if( this == &other )
 		return *this;
-	delete m_impl;
-	m_impl = other.m_impl;
-	other.m_impl = new impl();
-	other.m_impl->m_request_headers = m_impl->m_request_headers;
+	m_impl = std::move(other.m_impl);
 	return *this;
 }
 
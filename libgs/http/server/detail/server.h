@@ -37,6 +37,7 @@ class basic_server<CharT,Stream,Exec>::impl : public std::enable_shared_from_thi
 {
 	LIBGS_DISABLE_COPY(impl)
 	using request_handler_t = std::function<awaitable<void>(context_t&)>;
+	using websocket_handler_t = std::function<awaitable<void>(context_t&,websocket_t&)>;
 
 public:
 	explicit impl(basic_acceptor_wrap<socket_t> &&next_layer, const service_exec_t &service_exec) :
@@ -47,7 +48,13 @@ public:
 		m_next_layer(std::move(other.m_next_layer)),
 		m_service_exec(other.m_service_exec),
 		m_request_handler_map(std::move(other.m_request_handler_map)),
+		m_websocket_handler_map(std::move(other.m_websocket_handler_map)),
+		m_websocket_deflate(other.m_websocket_deflate),
+		m_h2_option(other.m_h2_option),
 		m_sss(std::move(other.m_sss)),
+		m_admission(other.m_admission.exchange(nullptr)),
+		m_access_log(other.m_access_log.exchange(nullptr)),
+		m_tracer(other.m_tracer.exchange(nullptr)),
 		m_default_handler(std::move(other.m_default_handler)),
 		m_server_error_handler(std::move(other.m_server_error_handler)),
 		m_service_error_handler(std::move(other.m_service_error_handler)),
@@ -62,7 +69,13 @@ public:
 		m_next_layer(std::move(other.m_next_layer)),
 		m_service_exec(other.m_service_exec),
 		m_request_handler_map(std::move(other.m_request_handler_map)),
+		m_websocket_handler_map(std::move(other.m_websocket_handler_map)),
+		m_websocket_deflate(other.m_websocket_deflate),
+		m_h2_option(other.m_h2_option),
 		m_sss(std::move(other.m_sss)),
+		m_admission(other.m_admission.exchange(nullptr)),
+		m_access_log(other.m_access_log.exchange(nullptr)),
+		m_tracer(other.m_tracer.exchange(nullptr)),
 		m_default_handler(std::move(other.m_default_handler)),
 		m_server_error_handler(std::move(other.m_server_error_handler)),
 		m_service_error_handler(std::move(other.m_service_error_handler)),
@@ -80,7 +93,13 @@ public:
 		m_service_exec = other.m_service_exec;
 
 		m_request_handler_map = std::move(other.m_request_handler_map);
+		m_websocket_handler_map = std::move(other.m_websocket_handler_map);
+		m_websocket_deflate = other.m_websocket_deflate;
+		m_h2_option = other.m_h2_option;
 		m_sss = std::move(other.m_sss);
+		m_admission = other.m_admission.exchange(nullptr);
+		m_access_log = other.m_access_log.exchange(nullptr);
+		m_tracer = other.m_tracer.exchange(nullptr);
 
 		m_default_handler = std::move(other.m_default_handler);
 		m_server_error_handler = std::move(other.m_server_error_handler);
@@ -100,7 +119,13 @@ public:
 		m_service_exec = other.m_service_exec;
 
 		m_request_handler_map = std::move(other.m_request_handler_map);
+		m_websocket_handler_map = std::move(other.m_websocket_handler_map);
+		m_websocket_deflate = other.m_websocket_deflate;
+		m_h2_option = other.m_h2_option;
 		m_sss = std::move(other.m_sss);
+		m_admission = other.m_admission.exchange(nullptr);
+		m_access_log = other.m_access_log.exchange(nullptr);
+		m_tracer = other.m_tracer.exchange(nullptr);
 
 		m_default_handler = std::move(other.m_default_handler);
 		m_server_error_handler = std::move(other.m_server_error_handler);
@@ -174,13 +199,27 @@ private:
 			if( not socket_operation_helper<socket_t>(socket).is_open() )
 				continue;
 
+			auto admission = m_admission.load();
+			if( admission and not admission->acquire_connection() )
+			{
+				libgs::dispatch(m_service_exec,
+				[socket = std::move(socket), retry_after = admission->option().retry_after]
+				() mutable -> awaitable<void>
+				{
+					co_await co_shed_connection(socket, retry_after);
+					socket_operation_helper<socket_t>(socket).close();
+					co_return ;
+				});
+				continue;
+			}
 			libgs::dispatch(m_service_exec,
-			[self = this->shared_from_this(), socket = std::move(socket), ktime = m_keepalive_timeout]
+			[self = this->shared_from_this(), socket = std::move(socket), ktime = m_keepalive_timeout,
+			 admission = std::move(admission), accepted = request_trace::clock_t::now()]
 			() mutable -> awaitable<void>
 			{
 				bool abd = false;
 				try {
-					co_await self->do_tcp_service(socket, ktime);
+					co_await self->do_tcp_service(socket, ktime, accepted);
 				}
 				catch(const std::exception &ex)
 				{
@@ -193,6 +232,8 @@ private:
 					abd = true;
 				}
 				socket_operation_helper<socket_t>(socket).close();
+				if( admission )
+					admission->release_connection();
 				if( abd )
 					forced_termination();
 				co_return ;
@@ -208,16 +249,36 @@ private:
 		co_return ;
 	}
 
-	[[nodiscard]] awaitable<void> do_tcp_service(socket_t &socket, const milliseconds &keepalive_time)
+	[[nodiscard]] awaitable<void> do_tcp_service
+	(socket_t &socket, const milliseconds &keepalive_time, request_trace::time_point accepted)
 	{
 		using namespace std::chrono_literals;
 		const auto *time = &m_first_reading_time;
+		const auto started = request_trace::clock_t::now();
+
+		// Every request of the connection reuses it, allocated once tracing is on.
+		std::unique_ptr<request_trace> trace_buf;
 
-		parser_t parser;
+		// Per-request impl objects are pooled per connection, the parser and its buffers included.
+		arena conn_arena;
+		auto parser = [&]
+		{
+			arena::scope scope(conn_arena);
+			return parser_t(0x1000);
+		}();
 		constexpr size_t buf_size = 0xFFFF;
 		char buf[buf_size] = {0};
+		size_t preface_size = 0;
+
+		// The TLS handshake already picked the protocol.
+		if( m_h2_option.enable and h2_connection_t::alpn_selected(socket) )
+		{
+			co_await make_h2_connection(socket).co_run({}, h2_handler(), keepalive_time);
+			co_return ;
+		}
 		for(;;)
 		{
+			request_trace *trace = nullptr;
 			try {
 				auto var = co_await (
 					socket.async_read_some(buffer(buf, buf_size), use_awaitable) or
@@ -229,9 +290,26 @@ private:
 				auto size = std::get<0>(var);
 				if( size == 0 )
 					break;
+				rearm_quick_ack(socket.lowest_layer(), m_next_layer.options());
 
+				// HTTP/2 with prior knowledge.
+				if( m_h2_option.enable and time == &m_first_reading_time and
+					h2_connection_t::is_preface({buf, size}) )
+				{
+					preface_size = size;
+					break;
+				}
+				trace = begin_trace(trace_buf, time == &m_first_reading_time ? accepted : request_trace::clock_t::now());
+				if( trace and time == &m_first_reading_time )
+				{
+					trace->add("accept", accepted, started);
+					trace->add("first_read", started);
+				}
+				auto parse_start = trace ? request_trace::clock_t::now() : request_trace::time_point();
 				error_code error;
 				parser.append({buf, size}, error);
+				if( trace )
+					trace->add("parse", parse_start);
 				if( error )
 				{
 					spdlog::warn("libgs::http::server: {}.", error);
@@ -245,12 +323,23 @@ private:
 					break;
 				call_on_server_error(ex.code());
 			}
-			context_t context(std::move(socket), parser, m_sss);
-			co_await call_on_request(context);
-
-			if( not context.response().is_finished() )
-				co_await call_on_default(context);
+			// A malformed upgrade is ignored, the request is then served over HTTP/1.1.
+			if( m_h2_option.enable and h2_connection_t::is_upgrade(parser) and
+				co_await make_h2_connection(socket).co_upgrade(parser, h2_handler(), keepalive_time) )
+				break;
+			auto context = [&]
+			{
+				arena::scope scope(conn_arena);
+				return context_t(std::move(socket), parser, m_sss);
+			}();
+			// The connection is taken over by the websocket (or closed if the upgrade is rejected).
+			if( websocket_t::is_upgrade(context.request().method(), context.request().headers()) and
+				co_await call_on_websocket(context) )
+				break;
 
+			// Shed with '503', the connection is closed to take the load off.
+			if( not co_await co_dispatch(context, trace) )
+				break;
 			if( not context.request().keep_alive() )
 				break;
 			time = &keepalive_time;
@@ -260,17 +349,144 @@ private:
 			parser.reset();
 			socket = std::move(context.request().next_layer());
 		}
+		if( preface_size > 0 )
+			co_await make_h2_connection(socket).co_run({buf, preface_size}, h2_handler(), keepalive_time);
 		co_return ;
 	}
 
+	[[nodiscard]] h2_connection_t make_h2_connection(socket_t &socket)
+	{
+#ifdef LIBGS_ENABLE_OPENSSL
+		if constexpr( is_ssl_stream_v<socket_t> )
+			return h2_connection_t(socket, m_next_layer.ssl_context(), m_sss, m_h2_option);
+		else
+#endif //LIBGS_ENABLE_OPENSSL
+			return h2_connection_t(socket, m_sss, m_h2_option);
+	}
+
+	[[nodiscard]] typename h2_connection_t::handler_t h2_handler()
+	{
+		// Every stream goes through the same dispatching as an HTTP/1.1 request.
+		return [this](context_t &context) -> awaitable<void>
+		{
+			// Stays empty unless the tracer wants this stream timed.
+			std::unique_ptr<request_trace> trace;
+			co_await co_dispatch(context, begin_trace(trace, request_trace::clock_t::now()));
+		};
+	}
+
+	[[nodiscard]] awaitable<bool> co_dispatch(context_t &context, request_trace *trace = nullptr)
+	{
+		// Keeps the controller and the log alive even if the server is moved meanwhile.
+		auto admission = m_admission.load();
+		auto access_log = m_access_log.load();
+		auto tracer = m_tracer.load();
+		if( trace )
+			context.set_trace(trace);
+
+		std::chrono::steady_clock::time_point start {};
+		if( access_log )
+			start = std::chrono::steady_clock::now();
+
+		bool admitted = true;
+		uint32_t route_id = 0;
+
+		admission_control::slot slot;
+		if( admission )
+		{
+			auto stage = context.span("admission");
+			slot = co_await admission->co_acquire();
+			stage.end();
+			if( not slot )
+			{
+				co_await co_shed(context, status::service_unavailable, admission->option().retry_after);
+				admitted = false;
+			}
+		}
+		if( admitted )
+		{
+			co_await call_on_request(context, route_id);
+			if( not context.response().is_finished() )
+			{
+				auto stage = context.span("default");
+				co_await call_on_default(context);
+			}
+		}
+		if( access_log )
+			push_access_log(*access_log, context, route_id, start);
+		if( trace and tracer )
+		{
+			push_trace(*tracer, *trace, context);
+			context.set_trace(nullptr);
+		}
+		co_return admitted;
+	}
+
+	// Null if there is no tracer or the request needs no timing.
+	[[nodiscard]] request_trace *begin_trace(std::unique_ptr<request_trace> &trace, request_trace::time_point start) noexcept
+	{
+		auto tracer = m_tracer.load();
+		return tracer ? tracer->begin(trace, start) : nullptr;
+	}
+
+	static void push_trace(tracer &tracer, request_trace &trace, context_t &context) noexcept
+	{
+		auto &request = context.request();
+		if constexpr( is_char_v<char_t> )
+			trace.finish(request.method(), context.response().status(), request.path());
+		else
+			trace.finish(request.method(), context.response().status(), wcstombs(request.path()));
+		tracer.push(trace);
+	}
+
+	static void push_access_log (
+		access_log &log, context_t &context, uint32_t route_id, std::chrono::steady_clock::time_point start
+	) noexcept
+	{
+		auto &request = context.request();
+		access_log_record record;
+
+		record.latency = std::chrono::steady_clock::now() - start;
+		record.time = std::chrono::system_clock::now() -
+			std::chrono::duration_cast<std::chrono::system_clock::duration>(record.latency);
+
+		record.bytes = context.response().bytes_sent();
+		record.status = context.response().status();
+		record.route = route_id;
+		record.method = request.method();
+		record.version = request.version();
+
+		if constexpr( is_char_v<char_t> )
+			record.set_path(request.path());
+		else
+			record.set_path(wcstombs(request.path()));
+
+		if constexpr( requires { request.remote_endpoint().address(); } )
+		{
+			try {
+				auto ep = request.remote_endpoint();
+				record.peer = ep.address();
+				record.port = ep.port();
+			}
+			catch(...) {}
+		}
+		log.push(record);
+	}
+
 private:
-	[[nodiscard]] awaitable<void> call_on_request(context_t &context)
+	template <typename Map>
+	[[nodiscard]] typename Map::mapped_type match_handler(const rcu_ptr<Map> &handlers, context_t &context)
 	{
-		tk_handler_ptr handler {};
+		typename Map::mapped_type handler {};
 		int32_t weight = std::numeric_limits<int32_t>::max();
 		size_t path_length = std::numeric_limits<size_t>::min();
 
-		for(auto &[rule, _handler] : m_request_handler_map)
+		// Left before anything is awaited, the matched handler lives on through its shared_ptr.
+		auto map = handlers.read();
+		if( not map )
+			return handler;
+
+		for(auto &[rule, _handler] : *map)
 		{
 			auto _path_length = context.request().path().length();
 			auto _weight = context.request().path_match(rule);
@@ -287,11 +503,20 @@ private:
 				weight = _weight;
 			}
 		}
+		return handler;
+	}
+
+	[[nodiscard]] awaitable<void> call_on_request(context_t &context, uint32_t &route_id)
+	{
+		auto stage = context.span("route");
+		auto handler = match_handler(m_request_handler_map, context);
+		stage.end();
 		if( not handler )
 		{
 			context.response().set_status(status::not_found);
 			co_return ;
 		}
+		route_id = handler->route_id.load(std::memory_order_relaxed);
 		auto method = context.request().method();
 		if( (handler->method & method) == 0 )
 		{
@@ -311,12 +536,28 @@ private:
 				context.response().set_status(status::method_not_allowed);
 			co_return ;
 		}
+		admission_control::slot slot;
+		if( auto admission = m_admission.load() )
+		{
+			slot = admission->acquire_route(handler->in_flight);
+			if( not slot )
+			{
+				co_await co_shed(context, status::tooMany_requests, admission->option().retry_after);
+				co_return ;
+			}
+		}
 		try
 		{
+			stage = context.span("before");
 			if( co_await handler->aop->before(context) )
 				co_return ;
 
+			stage.end();
+			stage = context.span("service");
 			co_await handler->aop->service(context);
+
+			stage.end();
+			stage = context.span("after");
 			co_await handler->aop->after(context);
 		}
 		catch(const std::exception &ex)
@@ -328,6 +569,54 @@ private:
 		co_return ;
 	}
 
+	[[nodiscard]] awaitable<bool> call_on_websocket(context_t &context)
+	{
+		auto handler = match_handler(m_websocket_handler_map, context);
+		if( not handler )
+			co_return false;
+		try
+		{
+			for(auto &aop : handler->aops)
+			{
+				if( not co_await aop->before(context) )
+					continue;
+				if( not context.response().is_finished() )
+					co_await call_on_default(context);
+				co_return true;
+			}
+			websocket_t websocket (
+				std::move(context.request().next_layer()), websocket_role::server, m_websocket_deflate
+			);
+			co_await websocket.co_accept(context.request().headers());
+			co_await handler->func(context, websocket);
+
+			if( websocket.is_open() )
+			{
+				error_code error;
+				co_await websocket.co_close(websocket_close_code::normal, {}, error);
+			}
+			for(auto &aop : handler->aops)
+			{
+				if( co_await aop->after(context) )
+					break;
+			}
+		}
+		catch(const std::exception &ex)
+		{
+			for(auto &aop : handler->aops)
+			{
+				if( aop->exception(context, ex) )
+					co_return true;
+			}
+			// The peer going away is the normal end of a websocket session.
+			if( dynamic_cast<const std::system_error*>(&ex) )
+				spdlog::debug("libgs::http::server: websocket: {}.", ex);
+			else
+				call_on_service_error(context, ex);
+		}
+		co_return true;
+	}
+
 	[[nodiscard]] awaitable<void> call_on_default(context_t &context)
 	{
 		try {
@@ -380,6 +669,51 @@ private:
 	}
 
 private:
+	[[nodiscard]] static std::string shed_response(status_t status, std::chrono::seconds retry_after)
+	{
+		// Written as is, no header helper nor default body is involved.
+		return std::format (
+			"HTTP/1.1 {} {}\r\n{}: 0\r\n{}: {}\r\n{}",
+			status, status_description(status), header::content_length, header::retry_after, retry_after.count(),
+			status == status::service_unavailable ? "Connection: close\r\n\r\n" : "\r\n"
+		);
+	}
+
+	[[nodiscard]] static awaitable<void> co_shed_connection(socket_t &socket, std::chrono::seconds retry_after)
+	{
+		using namespace std::chrono_literals;
+		using namespace libgs::operators;
+
+		auto data = shed_response(status::service_unavailable, retry_after);
+		error_code error;
+		co_await (
+			asio::async_write(socket, buffer(data), use_awaitable | error) or
+			sleep_for(socket.get_executor(), 1000ms)
+		);
+		co_return ;
+	}
+
+	[[nodiscard]] awaitable<void> co_shed(context_t &context, status_t status, std::chrono::seconds retry_after)
+	{
+		using namespace libgs::operators;
+		auto &response = context.response();
+		error_code error;
+
+		// HTTP/2: only the stream is refused.
+		if( context.request().transport() )
+		{
+			co_await response
+				.set_status(status)
+				.set_header(basic_header<char_t>::retry_after, retry_after.count())
+				.write(use_awaitable | error);
+			co_return ;
+		}
+		auto data = shed_response(status, retry_after);
+		const_buffer buffers[] { buffer(data) };
+		co_await response.write_serialized(buffers, use_awaitable | error);
+		co_return ;
+	}
+
 	void call_on_server_error(const error_code &error)
 	{
 		if( m_server_error_handler )
@@ -483,16 +817,41 @@ public:
 		}
 		methods method {};
 		ctrlr_aop_ptr_t aop {};
+		std::atomic_size_t in_flight {0};
+		std::atomic_uint32_t route_id {0};
 	};
 	using tk_handler_ptr = std::shared_ptr<tk_handler>;
 
+	struct ws_handler
+	{
+		std::vector<aop_ptr_t> aops {};
+		websocket_handler_t func {};
+	};
+	using ws_handler_ptr = std::shared_ptr<ws_handler>;
+
+	void bind_route(const string_t &rule, tk_handler &handler)
+	{
+		if( auto access_log = m_access_log.load() )
+			handler.route_id = access_log->route_id(xxtombs(rule));
+	}
+
 public:
 	next_layer_t m_next_layer;
 	service_exec_t m_service_exec;
 
-	std::map<string_t, tk_handler_ptr> m_request_handler_map;
+	// Swapped as a whole by on_request/unbound_*, requests match against a snapshot without locking.
+	rcu_ptr<std::map<string_t, tk_handler_ptr>> m_request_handler_map;
+	rcu_ptr<std::map<string_t, ws_handler_ptr>> m_websocket_handler_map;
+	websocket_deflate_option m_websocket_deflate {};
+	h2_option m_h2_option {};
 	session_set m_sss;
 
+	// Replaced by their setters while connections are served, so they are only ever
+	// loaded into a local copy, which keeps them alive for as long as they are used.
+	std::atomic<std::shared_ptr<admission_control>> m_admission {};
+	std::atomic<std::shared_ptr<access_log>> m_access_log {};
+	std::atomic<std::shared_ptr<tracer>> m_tracer {};
+
 	request_handler_t m_default_handler {};
 	server_error_handler_t m_server_error_handler {};
 	service_error_handler_t m_service_error_handler {};
@@ -528,7 +887,7 @@ basic_server<CharT,Stream,Exec>::~basic_server()
 template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
 template <typename Stream0, typename Exec0>
 basic_server<CharT,Stream,Exec>::basic_server(basic_server<CharT,Stream0,Exec0> &&other) noexcept
-	requires core_concepts::constructible<next_layer_t,asio::basic_socket_acceptor<asio::ip::tcp,Exec0>&&> and
+	requires core_concepts::constructible<next_layer_t,asio::basic_socket_acceptor<protocol_t,Exec0>&&> and
 			 core_concepts::constructible<service_exec_t,typename Stream::executor_type> :
 	m_impl(new impl(std::move(*other.m_impl)))
 {
@@ -539,7 +898,7 @@ template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core
 template <typename Stream0, typename Exec0>
 basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::operator=
 (basic_server<CharT,Stream0,Exec0> &&other) noexcept
-	requires core_concepts::assignable<next_layer_t,asio::basic_socket_acceptor<asio::ip::tcp,Exec0>&&> and
+	requires core_concepts::assignable<next_layer_t,asio::basic_socket_acceptor<protocol_t,Exec0>&&> and
 			 core_concepts::assignable<service_exec_t,typename Stream::executor_type>
 {
 	if( this != &other )
@@ -564,14 +923,36 @@ basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::bind
 	auto &acceptor = m_impl->m_next_layer.acceptor();
 	if( not acceptor.is_open() )
 	{
-		if( ep->address().is_v4())
-			acceptor.open(asio::ip::tcp::v4(), error);
-		else
-			acceptor.open(asio::ip::tcp::v6(), error);
+		acceptor.open(ep->protocol(), error);
 		if( error )
 			return *this;
 	}
-	acceptor.set_option(asio::socket_base::reuse_address(true), error);
+	if constexpr( is_local_stream_v<socket_t> )
+	{
+		// A socket file left by a previous run would make the bind fail. It is only removed
+		// when nobody listens on it any more, a live server keeps its address.
+		auto path = ep->path();
+		error_code _error;
+		if( not path.empty() and path.front() != '\0' and std::filesystem::is_socket(path, _error) )
+		{
+			// Non-blocking, a server with a full backlog answers with 'would_block'.
+			socket_t probe(acceptor.get_executor());
+			probe.open(ep->protocol(), _error);
+			if( not _error )
+				probe.non_blocking(true, _error);
+			if( not _error )
+				probe.connect(*ep, _error);
+
+			if( _error == asio::error::connection_refused )
+				std::filesystem::remove(path, _error);
+			else if( not _error or _error == asio::error::would_block )
+			{
+				error = make_error_code(asio::error::address_in_use);
+				return *this;
+			}
+		}
+	}
+	apply_socket_options(acceptor, m_impl->m_next_layer.options(), socket_option_stage::listen, error);
 	if( error )
 		return *this;
 
@@ -579,6 +960,12 @@ basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::bind
 	return *this;
 }
 
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::start()
+{
+	return start(static_cast<size_t>(m_impl->m_next_layer.options().backlog));
+}
+
 template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
 basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::start(size_t max)
 {
@@ -601,7 +988,7 @@ template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core
 basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::start
 (error_code &error) noexcept
 {
-	return start(asio::socket_base::max_listen_connections, error);
+	return start(static_cast<size_t>(m_impl->m_next_layer.options().backlog), error);
 }
 
 template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
@@ -618,14 +1005,17 @@ basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::on_request
 
 		string_t rule(path_rule.data(), path_rule.size());
 		m_impl->rule_path_check(rule);
-		auto [it, res] = m_impl->m_request_handler_map.emplace(rule, nullptr);
-
-		if( not res )
-			throw runtime_error("libgs::http::server::on_request: path_rule duplication.");
-
-		auto aop = new typename impl::multi_ctrlr_aop(func, aops...);
-		it->second = std::make_shared<typename impl::tk_handler>(ctrlr_aop_ptr_t(aop));
-		it->second->template bind_method<Method...>();
+		m_impl->m_request_handler_map.update([&](auto &map)
+		{
+			auto [it, res] = map.emplace(rule, nullptr);
+			if( not res )
+				throw runtime_error("libgs::http::server::on_request: path_rule duplication.");
+
+			auto aop = new typename impl::multi_ctrlr_aop(func, aops...);
+			it->second = std::make_shared<typename impl::tk_handler>(ctrlr_aop_ptr_t(aop));
+			it->second->template bind_method<Method...>();
+			m_impl->bind_route(rule, *it->second);
+		});
 	}
 	return *this;
 }
@@ -642,13 +1032,16 @@ basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::on_request
 
 		string_t rule(path_rule.data(), path_rule.size());
 		m_impl->rule_path_check(rule);
-		auto [it, res] = m_impl->m_request_handler_map.emplace(rule, nullptr);
-
-		if( not res )
-			throw runtime_error("libgs::http::server::on_request: path_rule duplication.");
+		m_impl->m_request_handler_map.update([&](auto &map)
+		{
+			auto [it, res] = map.emplace(rule, nullptr);
+			if( not res )
+				throw runtime_error("libgs::http::server::on_request: path_rule duplication.");
 
-		it->second = std::make_shared<typename impl::tk_handler>(std::move(ctrlr));
-		it->second->template bind_method<Method...>();
+			it->second = std::make_shared<typename impl::tk_handler>(std::move(ctrlr));
+			it->second->template bind_method<Method...>();
+			m_impl->bind_route(rule, *it->second);
+		});
 	}
 	return *this;
 }
@@ -665,13 +1058,44 @@ basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::on_request
 
 		string_t rule(path_rule.data(), path_rule.size());
 		m_impl->rule_path_check(rule);
-		auto [it, res] = m_impl->m_request_handler_map.emplace(rule, nullptr);
+		m_impl->m_request_handler_map.update([&](auto &map)
+		{
+			auto [it, res] = map.emplace(rule, nullptr);
+			if( not res )
+				throw runtime_error("libgs::http::server::on_request: path_rule duplication.");
+
+			it->second = std::make_shared<typename impl::tk_handler>(ctrlr_aop_ptr_t(ctrlr));
+			it->second->template bind_method<Method...>();
+			m_impl->bind_route(rule, *it->second);
+		});
+	}
+	return *this;
+}
 
-		if( not res )
-			throw runtime_error("libgs::http::server::on_request: path_rule duplication.");
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+template <typename Func, typename...AopPtrs>
+basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::on_websocket
+(const path_opt_token_t &path_rules, Func &&func, AopPtrs&&...aops) requires
+	detail::concepts::websocket_handler<Func,socket_t,char_t> and
+	detail::concepts::aop_ptr_list<socket_t,char_t,AopPtrs...>
+{
+	for(auto &path_rule : path_rules.paths)
+	{
+		if( path_rule.empty() )
+			throw runtime_error("libgs::http::server::on_websocket: path_rule is empty.");
+
+		string_t rule(path_rule.data(), path_rule.size());
+		m_impl->rule_path_check(rule);
+		m_impl->m_websocket_handler_map.update([&](auto &map)
+		{
+			auto [it, res] = map.emplace(rule, nullptr);
+			if( not res )
+				throw runtime_error("libgs::http::server::on_websocket: path_rule duplication.");
 
-		it->second = std::make_shared<typename impl::tk_handler>(ctrlr_aop_ptr_t(ctrlr));
-		it->second->template bind_method<Method...>();
+			it->second = std::make_shared<typename impl::ws_handler>();
+			it->second->aops = {aop_ptr_t(aops)...};
+			it->second->func = func;
+		});
 	}
 	return *this;
 }
@@ -707,7 +1131,21 @@ basic_server<CharT,Stream,Exec>::unbound_request(string_view_t path_rule)
 {
 	if( path_rule.empty() )
 		throw runtime_error("libgs::http::server::unbound_request: path_rule is empty.");
-	m_impl->m_request_handler_map.erase({path_rule.data(), path_rule.size()});
+	m_impl->m_request_handler_map.update([&](auto &map) {
+		map.erase({path_rule.data(), path_rule.size()});
+	});
+	return *this;
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec>&
+basic_server<CharT,Stream,Exec>::unbound_websocket(string_view_t path_rule)
+{
+	if( path_rule.empty() )
+		throw runtime_error("libgs::http::server::unbound_websocket: path_rule is empty.");
+	m_impl->m_websocket_handler_map.update([&](auto &map) {
+		map.erase({path_rule.data(), path_rule.size()});
+	});
 	return *this;
 }
 
@@ -747,6 +1185,64 @@ basic_server<CharT,Stream,Exec>::set_keepalive_time(const duration<Rep,Period> &
 	return *this;
 }
 
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec>&
+basic_server<CharT,Stream,Exec>::set_websocket_deflate(const websocket_deflate_option &option)
+{
+	m_impl->m_websocket_deflate = option;
+	return *this;
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec>&
+basic_server<CharT,Stream,Exec>::set_h2_option(const h2_option &option)
+{
+	m_impl->m_h2_option = option;
+	return *this;
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec>&
+basic_server<CharT,Stream,Exec>::set_admission_option(const admission_option &option)
+{
+	// Requests in flight keep their slots, only the limits change.
+	auto admission = m_impl->m_admission.load();
+	if( admission )
+		admission->set_option(option);
+	else
+	{
+		// Should another first call get in first, its controller takes this option as well.
+		auto desired = std::make_shared<admission_control>(option);
+		if( not m_impl->m_admission.compare_exchange_strong(admission, desired) )
+			admission->set_option(option);
+	}
+	return *this;
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec>&
+basic_server<CharT,Stream,Exec>::set_access_log(const access_log_option &option)
+{
+	// Requests in flight finish on the previous log, it is flushed once they are done,
+	// by the reaper thread rather than the io thread which happens to drop it.
+	m_impl->m_access_log.store(detail::record_reaper::make_shared<access_log>(option));
+	if( auto map = m_impl->m_request_handler_map.read() )
+	{
+		for(auto &[rule, handler] : *map)
+			m_impl->bind_route(rule, *handler);
+	}
+	return *this;
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+basic_server<CharT,Stream,Exec>&
+basic_server<CharT,Stream,Exec>::set_tracer(const trace_option &option)
+{
+	// Like the access log, requests in flight push to the previous tracer.
+	m_impl->m_tracer.store(detail::record_reaper::make_shared<tracer>(option));
+	return *this;
+}
+
 template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
 awaitable<void> basic_server<CharT,Stream,Exec>::co_stop() noexcept
 {
@@ -761,6 +1257,30 @@ basic_server<CharT,Stream,Exec>::get_executor() noexcept
 	return m_impl->m_next_layer.acceptor().get_executor();
 }
 
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+admission_statistics basic_server<CharT,Stream,Exec>::admission_stats() const noexcept
+{
+	if( auto admission = m_impl->m_admission.load() )
+		return admission->stats();
+	return {};
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+access_log_statistics basic_server<CharT,Stream,Exec>::access_log_stats() const noexcept
+{
+	if( auto access_log = m_impl->m_access_log.load() )
+		return access_log->stats();
+	return {};
+}
+
+template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
+trace_statistics basic_server<CharT,Stream,Exec>::tracer_stats() const noexcept
+{
+	if( auto tracer = m_impl->m_tracer.load() )
+		return tracer->stats();
+	return {};
+}
+
 template <core_concepts::char_type CharT, concepts::any_exec_stream Stream, core_concepts::execution Exec>
 basic_server<CharT,Stream,Exec> &basic_server<CharT,Stream,Exec>::stop() noexcept
 {
@@ -0,0 +1,429 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_SSE_H
+#define LIBGS_HTTP_SERVER_DETAIL_SSE_H
+
+#include <libgs/core/spin_mutex.h>
+#include <charconv>
+#include <deque>
+#include <list>
+#include <map>
+
+#ifdef LIBGS_USING_BOOST_ASIO
+# include <boost/asio/experimental/concurrent_channel.hpp>
+#else
+# include <asio/experimental/concurrent_channel.hpp>
+#endif //LIBGS_USING_BOOST_ASIO
+
+namespace libgs::http
+{
+
+class sse_hub::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+	using channel_t = asio::experimental::concurrent_channel<void(error_code)>;
+
+public:
+	struct frame
+	{
+		uint64_t id = 0;
+		std::string event {};
+
+		// "<size>\r\n<payload>\r\n", HTTP/1.0 clients get the payload alone.
+		std::string wire {};
+		size_t offset = 0;
+		size_t size = 0;
+
+		[[nodiscard]] const_buffer chunk() const noexcept {
+			return buffer(wire.data(), wire.size());
+		}
+		[[nodiscard]] const_buffer payload() const noexcept {
+			return buffer(wire.data() + offset, size);
+		}
+	};
+	using frame_ptr = std::shared_ptr<const frame>;
+
+	struct subscriber
+	{
+		explicit subscriber(const auto &exec) : channel(exec, 1) {}
+
+		// Buffered, so a wake up is not lost while the subscriber is writing.
+		channel_t channel;
+		spin_mutex mutex {};
+		std::deque<frame_ptr> pending {};
+		bool closed = false;
+		std::list<std::shared_ptr<subscriber>>::iterator it {};
+	};
+	using subscriber_ptr = std::shared_ptr<subscriber>;
+
+	struct topic
+	{
+		std::deque<frame_ptr> ring {};
+		std::list<subscriber_ptr> subscribers {};
+	};
+
+public:
+	explicit impl(const sse_option &option) : m_option(option)
+	{
+		using namespace std::chrono_literals;
+		m_option.max_pending = std::max<size_t>(m_option.max_pending, 1);
+		if( m_option.keepalive == 0ms )
+			m_option.keepalive = 24h;
+	}
+
+public:
+	uint64_t publish(std::string_view name, std::string_view data, std::string_view event)
+	{
+		std::lock_guard lock(m_mutex);
+		auto id = ++m_last_id;
+		auto frame = encode(id, data, event);
+
+		auto &topic = m_topics.try_emplace(std::string(name)).first->second;
+		if( m_option.replay_size > 0 )
+		{
+			if( topic.ring.size() >= m_option.replay_size )
+				topic.ring.pop_front();
+			topic.ring.emplace_back(frame);
+		}
+		for(auto &sub : topic.subscribers)
+			deliver(*sub, frame);
+
+		m_published.fetch_add(1, std::memory_order_relaxed);
+		return id;
+	}
+
+	[[nodiscard]] std::pair<subscriber_ptr, std::vector<frame_ptr>>
+	subscribe(std::string_view name, const auto &exec, std::optional<uint64_t> last_id)
+	{
+		std::lock_guard lock(m_mutex);
+		if( m_closed )
+			return {};
+
+		auto &topic = m_topics.try_emplace(std::string(name)).first->second;
+		auto sub = std::make_shared<subscriber>(exec);
+		sub->it = topic.subscribers.emplace(topic.subscribers.end(), sub);
+
+		std::vector<frame_ptr> replay;
+		if( last_id )
+		{
+			for(auto &frame : topic.ring)
+			{
+				if( frame->id > *last_id )
+					replay.emplace_back(frame);
+			}
+		}
+		m_subscribers++;
+		return {std::move(sub), std::move(replay)};
+	}
+
+	void unsubscribe(std::string_view name, subscriber &sub) noexcept
+	{
+		std::lock_guard lock(m_mutex);
+		auto it = m_topics.find(name);
+		if( it == m_topics.end() )
+			return ;
+
+		it->second.subscribers.erase(sub.it);
+		if( it->second.subscribers.empty() and it->second.ring.empty() )
+			m_topics.erase(it);
+		m_subscribers--;
+	}
+
+	void close() noexcept
+	{
+		std::lock_guard lock(m_mutex);
+		m_closed = true;
+
+		for(auto &[name,topic] : m_topics)
+		{
+			for(auto &sub : topic.subscribers)
+			{
+				std::lock_guard sub_lock(sub->mutex);
+				sub->closed = true;
+				sub->channel.try_send(error_code());
+			}
+		}
+	}
+
+public:
+	[[nodiscard]] static std::string chunk(std::string_view payload) {
+		return std::format("{:X}\r\n{}\r\n", payload.size(), payload);
+	}
+
+	template <typename Request>
+	[[nodiscard]] static awaitable<void> co_write(Request &request, const std::vector<const_buffer> &buffers, error_code &error)
+	{
+		using namespace libgs::operators;
+		if( auto transport = request.transport() )
+		{
+			for(auto &buf : buffers)
+			{
+				co_await transport->co_write({static_cast<const char*>(buf.data()), buf.size()}, error);
+				if( error )
+					break;
+			}
+		}
+		else
+			co_await asio::async_write(request.next_layer(), buffers, use_awaitable | error);
+		co_return ;
+	}
+
+private:
+	[[nodiscard]] static frame_ptr encode(uint64_t id, std::string_view data, std::string_view event)
+	{
+		// A line break would end the field early.
+		event = event.substr(0, event.find_first_of("\r\n"));
+
+		std::string payload = std::format("id: {}\n", id);
+		if( not event.empty() )
+			payload += std::format("event: {}\n", event);
+
+		// Every line of the data is a field of its own.
+		for(;;)
+		{
+			auto pos = data.find('\n');
+			auto line = data.substr(0, pos);
+			if( line.ends_with('\r') )
+				line.remove_suffix(1);
+
+			payload.append("data: ").append(line).append("\n");
+			if( pos == std::string_view::npos )
+				break;
+			data.remove_prefix(pos + 1);
+		}
+		payload += "\n";
+
+		auto result = std::make_shared<frame>();
+		result->id = id;
+		result->event = event;
+		result->wire = std::format("{:X}\r\n", payload.size());
+		result->offset = result->wire.size();
+		result->size = payload.size();
+		result->wire.append(payload).append("\r\n");
+		return result;
+	}
+
+	void deliver(subscriber &sub, const frame_ptr &frame) noexcept
+	{
+		{
+			std::lock_guard lock(sub.mutex);
+			if( sub.closed )
+				return ;
+			else if( sub.pending.size() >= m_option.max_pending )
+			{
+				if( m_option.overflow == sse_overflow::drop )
+				{
+					m_dropped.fetch_add(1, std::memory_order_relaxed);
+					return ;
+				}
+				else if( m_option.overflow == sse_overflow::coalesce )
+				{
+					auto it = std::ranges::find_if(sub.pending, [&](const frame_ptr &queued) {
+						return queued->event == frame->event;
+					});
+					sub.pending.erase(it == sub.pending.end() ? sub.pending.begin() : it);
+					m_coalesced.fetch_add(1, std::memory_order_relaxed);
+				}
+				else
+				{
+					sub.closed = true;
+					m_disconnected.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			if( not sub.closed )
+				sub.pending.emplace_back(frame);
+		}
+		sub.channel.try_send(error_code());
+	}
+
+public:
+	sse_option m_option;
+	mutable std::mutex m_mutex;
+	std::map<std::string,topic,std::less<>> m_topics;
+
+	uint64_t m_last_id = 0;
+	size_t m_subscribers = 0;
+	bool m_closed = false;
+
+	std::atomic_size_t m_published {0};
+	std::atomic_size_t m_dropped {0};
+	std::atomic_size_t m_coalesced {0};
+	std::atomic_size_t m_disconnected {0};
+};
+
+inline sse_hub::sse_hub(const sse_option &option) :
+	m_impl(new impl(option))
+{
+
+}
+
+inline sse_hub::~sse_hub()
+{
+	delete m_impl;
+}
+
+inline uint64_t sse_hub::publish(std::string_view topic, std::string_view data, std::string_view event)
+{
+	return m_impl->publish(topic, data, event);
+}
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+awaitable<void> sse_hub::co_subscribe(basic_service_context<Stream,CharT> &context, std::string_view topic)
+{
+	using namespace libgs::operators;
+	auto &request = context.request();
+	auto &response = context.response();
+
+	std::optional<uint64_t> last_id;
+	{
+		using string_t = std::basic_string<CharT>;
+		auto &headers = request.headers();
+
+		auto it = headers.find(string_t(mbstoxx<CharT>(std::string_view("last-event-id"))));
+		if( it != headers.end() )
+		{
+			std::string text = xxtombs(it->second.to_string());
+			uint64_t id = 0;
+			if( std::from_chars(text.data(), text.data() + text.size(), id).ec == std::errc() )
+				last_id = id;
+		}
+	}
+	auto [sub, replay] = m_impl->subscribe(topic, context.get_executor(), last_id);
+	error_code error;
+	if( not sub )
+	{
+		auto text = std::format("{} ({})", status_description(status::service_unavailable), status::service_unavailable);
+		co_await response.set_status(status::service_unavailable).write(buffer(text), use_awaitable | error);
+		co_return ;
+	}
+	// Leaves the topic however the coroutine ends.
+	std::shared_ptr<void> guard(nullptr, [&](void*){
+		m_impl->unsubscribe(topic, *sub);
+	});
+	bool v10 = request.version() == version::v10;
+	auto head = std::format (
+		"HTTP/{} 200 OK\r\n"
+		"content-type: text/event-stream\r\n"
+		"cache-control: no-cache\r\n"
+		"x-accel-buffering: no\r\n"
+		"{}\r\n",
+		v10 ? "1.0" : "1.1", v10 ? "connection: close\r\n" : "transfer-encoding: chunked\r\n"
+	);
+	std::string retry;
+	if( m_impl->m_option.retry.count() > 0 )
+	{
+		retry = std::format("retry: {}\n\n", m_impl->m_option.retry.count());
+		if( not v10 )
+			retry = impl::chunk(retry);
+	}
+	std::vector<const_buffer> buffers { buffer(head), buffer(retry) };
+	for(auto &frame : replay)
+		buffers.emplace_back(v10 ? frame->payload() : frame->chunk());
+
+	co_await response.write_serialized(buffers, use_awaitable | error);
+	replay.clear();
+
+	static const std::string ping = ":\n\n";
+	static const std::string chunked_ping = impl::chunk(ping);
+	std::deque<impl::frame_ptr> pending;
+
+	while( not error )
+	{
+		// The receive is cancelled whenever the keepalive wins, that is no error of the stream.
+		error_code receive_error;
+		auto var = co_await (
+			sub->channel.async_receive(use_awaitable | receive_error) or
+			sleep_for(context.get_executor(), m_impl->m_option.keepalive)
+		);
+		if( var.index() == 0 and receive_error )
+		{
+			error = receive_error;
+			break;
+		}
+
+		bool closed = false;
+		pending.clear();
+		{
+			std::lock_guard lock(sub->mutex);
+			pending.swap(sub->pending);
+			closed = sub->closed;
+		}
+		buffers.clear();
+		for(auto &frame : pending)
+			buffers.emplace_back(v10 ? frame->payload() : frame->chunk());
+
+		if( var.index() == 1 and buffers.empty() and not closed )
+			buffers.emplace_back(buffer(v10 ? ping : chunked_ping));
+		if( closed and not v10 )
+			buffers.emplace_back(buffer("0\r\n\r\n", 5));
+
+		if( not buffers.empty() )
+			co_await impl::co_write(request, buffers, error);
+		if( closed )
+			break;
+	}
+	if( v10 or error )
+	{
+		if( auto transport = request.transport() )
+			transport->cancel();
+		else
+			socket_operation_helper<Stream>(request.next_layer()).close();
+	}
+	co_return ;
+}
+
+inline void sse_hub::close() noexcept
+{
+	m_impl->close();
+}
+
+inline const sse_option &sse_hub::option() const noexcept
+{
+	return m_impl->m_option;
+}
+
+inline sse_statistics sse_hub::stats() const noexcept
+{
+	sse_statistics result;
+	{
+		std::lock_guard lock(m_impl->m_mutex);
+		result.topics = m_impl->m_topics.size();
+		result.subscribers = m_impl->m_subscribers;
+	}
+	result.published = m_impl->m_published.load(std::memory_order_relaxed);
+	result.dropped = m_impl->m_dropped.load(std::memory_order_relaxed);
+	result.coalesced = m_impl->m_coalesced.load(std::memory_order_relaxed);
+	result.disconnected = m_impl->m_disconnected.load(std::memory_order_relaxed);
+	return result;
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_SSE_H
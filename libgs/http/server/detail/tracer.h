@@ -0,0 +1,478 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_DETAIL_TRACER_H
+#define LIBGS_HTTP_SERVER_DETAIL_TRACER_H
+
+#include <libgs/http/server/detail/record_writer.h>
+#include <random>
+#include <bit>
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+inline uint8_t trace_copy_name(char *dst, size_t max, std::string_view src) noexcept
+{
+	auto size = std::min(src.size(), max);
+	memcpy(dst, src.data(), size);
+	return static_cast<uint8_t>(size);
+}
+
+} //namespace detail
+
+inline std::string_view request_trace::span_record::name() const noexcept
+{
+	return {name_data, name_size};
+}
+
+inline request_trace::scope::scope(request_trace *trace, size_t index) noexcept :
+	m_trace(trace), m_index(index)
+{
+
+}
+
+inline request_trace::scope::~scope()
+{
+	end();
+}
+
+inline request_trace::scope::scope(scope &&other) noexcept :
+	m_trace(std::exchange(other.m_trace, nullptr)),
+	m_index(std::exchange(other.m_index, npos))
+{
+
+}
+
+inline request_trace::scope &request_trace::scope::operator=(scope &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	end();
+	m_trace = std::exchange(other.m_trace, nullptr);
+	m_index = std::exchange(other.m_index, npos);
+	return *this;
+}
+
+inline void request_trace::scope::end() noexcept
+{
+	if( m_trace and m_index != npos )
+		m_trace->end(m_index);
+	m_trace = nullptr;
+	m_index = npos;
+}
+
+inline void request_trace::reset(time_point start) noexcept
+{
+	m_count = 0;
+	m_current = -1;
+	m_sampled = false;
+	m_start = start;
+	m_end = {};
+	m_method = method::GET;
+	m_status = 0;
+	m_path_size = 0;
+}
+
+inline request_trace::scope request_trace::span(std::string_view name) noexcept
+{
+	return {this, begin(name)};
+}
+
+inline size_t request_trace::begin(std::string_view name) noexcept
+{
+	if( m_count == max_spans )
+		return npos;
+	auto &span = m_spans[m_count];
+	span.start = clock_t::now();
+	span.end = {};
+	span.parent = m_current;
+	span.name_size = detail::trace_copy_name(span.name_data, max_name_size, name);
+	m_current = static_cast<int8_t>(m_count);
+	return m_count++;
+}
+
+inline void request_trace::end(size_t index) noexcept
+{
+	if( index >= m_count )
+		return ;
+	auto &span = m_spans[index];
+	span.end = clock_t::now();
+	if( m_current == static_cast<int8_t>(index) )
+		m_current = span.parent;
+}
+
+inline void request_trace::add(std::string_view name, time_point start, time_point end) noexcept
+{
+	if( m_count == max_spans )
+		return ;
+	auto &span = m_spans[m_count++];
+	span.start = start;
+	span.end = end;
+	span.parent = m_current;
+	span.name_size = detail::trace_copy_name(span.name_data, max_name_size, name);
+}
+
+inline void request_trace::extend(std::string_view name, time_point start, time_point end) noexcept
+{
+	for(size_t i=m_count; i>0; i--)
+	{
+		auto &span = m_spans[i - 1];
+		if( span.name() != name )
+			continue;
+		span.start = std::min(span.start, start);
+		span.end = std::max(span.end, end);
+		return ;
+	}
+	add(name, start, end);
+}
+
+inline void request_trace::finish(method_t method, status_t status, std::string_view path, time_point end) noexcept
+{
+	m_method = method;
+	m_status = status;
+	m_path_size = detail::trace_copy_name(m_path, max_path_size, path);
+	m_end = end;
+}
+
+inline void request_trace::set_sampled(bool sampled) noexcept
+{
+	m_sampled = sampled;
+}
+
+inline request_trace::time_point request_trace::start() const noexcept
+{
+	return m_start;
+}
+
+inline request_trace::time_point request_trace::end() const noexcept
+{
+	return m_end;
+}
+
+inline std::span<const request_trace::span_record> request_trace::spans() const noexcept
+{
+	return {m_spans, m_count};
+}
+
+inline method_t request_trace::method() const noexcept
+{
+	return m_method;
+}
+
+inline status_t request_trace::status() const noexcept
+{
+	return m_status;
+}
+
+inline std::string_view request_trace::path() const noexcept
+{
+	return {m_path, m_path_size};
+}
+
+inline bool request_trace::is_sampled() const noexcept
+{
+	return m_sampled;
+}
+
+class tracer::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+
+public:
+	explicit impl(const trace_option &option) :
+		m_option(normalize(option)),
+		m_writer({
+			.owner = "libgs::http::tracer",
+			.file_name = m_option.file_name,
+			.ring_capacity = m_option.ring_capacity,
+			.flush_interval = m_option.flush_interval,
+			// The closing ']' is optional in the array format, so events are only ever appended.
+			.header = m_option.format == trace_format::chrome ? "[\n" : ""
+		})
+	{
+		using namespace std::chrono;
+
+		// Spans are timed on the steady clock, exported as wall clock time.
+		m_wall_offset = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()) -
+			duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
+
+		m_writer.start([this](std::vector<request_trace> &batch, std::string &buffer) {
+			format(batch, buffer);
+		});
+	}
+
+public:
+	[[nodiscard]] bool begin(request_trace &trace, request_trace::time_point start) noexcept
+	{
+		trace.reset(start);
+		trace.set_sampled(sample());
+		return trace.is_sampled() or m_option.tail_latency.count() > 0;
+	}
+
+	[[nodiscard]] request_trace *begin(std::unique_ptr<request_trace> &trace, request_trace::time_point start) noexcept
+	{
+		bool sampled = sample();
+		if( not sampled and m_option.tail_latency.count() == 0 )
+			return nullptr;
+		if( not trace )
+		{
+			trace.reset(new(std::nothrow) request_trace());
+			if( not trace )
+				return nullptr;
+		}
+		trace->reset(start);
+		trace->set_sampled(sampled);
+		return trace.get();
+	}
+
+	bool push(const request_trace &trace) noexcept
+	{
+		bool keep = trace.is_sampled() or (
+			m_option.tail_latency.count() > 0 and trace.end() - trace.start() >= m_option.tail_latency
+		);
+		if( not keep )
+		{
+			m_sampled_out.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return m_writer.push(trace);
+	}
+
+	[[nodiscard]] trace_statistics stats() const noexcept
+	{
+		auto stats = m_writer.stats();
+		return {
+			.written = stats.written,
+			.sampled_out = m_sampled_out.load(std::memory_order_relaxed),
+			.dropped = stats.dropped,
+			.write_errors = stats.write_errors
+		};
+	}
+
+private:
+	[[nodiscard]] static trace_option normalize(trace_option option)
+	{
+		option.ring_capacity = std::bit_ceil(std::max<size_t>(option.ring_capacity, 2));
+		if( option.flush_interval <= milliseconds(0) )
+			option.flush_interval = milliseconds(1000);
+		return option;
+	}
+
+	[[nodiscard]] bool sample() const noexcept
+	{
+		if( m_option.sample_rate >= 1.0 )
+			return true;
+		else if( m_option.sample_rate <= 0.0 )
+			return false;
+
+		// xorshift64*, good enough to pick requests and far cheaper than <random>.
+		static thread_local uint64_t t_state = [] {
+			auto seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+			return (seed ^ std::hash<std::thread::id>()(std::this_thread::get_id())) | 1;
+		}();
+		t_state ^= t_state >> 12;
+		t_state ^= t_state << 25;
+		t_state ^= t_state >> 27;
+		auto value = (t_state * 0x2545F4914F6CDD1DULL) >> 11;
+		return static_cast<double>(value) * 0x1.0p-53 < m_option.sample_rate;
+	}
+
+	void format(std::vector<request_trace> &batch, std::string &buffer)
+	{
+		std::ranges::stable_sort(batch, {}, &request_trace::start);
+		if( m_option.format == trace_format::otlp )
+			format_otlp(batch, buffer);
+		else
+		{
+			for(auto &trace : batch)
+				format_chrome(trace, buffer);
+		}
+	}
+
+	void format_chrome(const request_trace &trace, std::string &buffer)
+	{
+		// Every request gets its own row.
+		auto tid = ++m_sequence;
+		auto out = std::back_inserter(buffer);
+
+		buffer += R"({"name":")";
+		escape(method_string(trace.method()), buffer);
+		buffer += ' ';
+		escape(trace.path(), buffer);
+		std::format_to(out, R"(","cat":"http","ph":"X","ts":{},"dur":{},"pid":1,"tid":{},"args":{{"status":{}}}}},)" "\n",
+			micros(wall_time(trace.start())), micros(trace.end() - trace.start()), tid, trace.status()
+		);
+		for(auto &span : trace.spans())
+		{
+			auto end = span.end == request_trace::time_point() ? trace.end() : span.end;
+			buffer += R"({"name":")";
+			escape(span.name(), buffer);
+			std::format_to(out, R"(","cat":"stage","ph":"X","ts":{},"dur":{},"pid":1,"tid":{}}},)" "\n",
+				micros(wall_time(span.start)), micros(end - span.start), tid
+			);
+		}
+	}
+
+	void format_otlp(const std::vector<request_trace> &batch, std::string &buffer)
+	{
+		buffer += R"({"resourceSpans":[{"resource":{"attributes":[{"key":"service.name","value":{"stringValue":")";
+		escape(m_option.service_name, buffer);
+		buffer += R"("}}]},"scopeSpans":[{"scope":{"name":"libgs.http"},"spans":[)";
+
+		bool first = true;
+		auto out = std::back_inserter(buffer);
+		for(auto &trace : batch)
+		{
+			auto trace_id = std::format("{:016x}{:016x}", m_random(), m_random());
+			auto root_id = m_random();
+
+			m_span_ids.resize(trace.spans().size());
+			for(auto &id : m_span_ids)
+				id = m_random();
+
+			std::format_to(out, R"({}{{"traceId":"{}","spanId":"{:016x}","name":")",
+				first ? "" : ",", trace_id, root_id
+			);
+			first = false;
+			escape(method_string(trace.method()), buffer);
+			buffer += ' ';
+			escape(trace.path(), buffer);
+
+			std::format_to(out, R"(","kind":2,"startTimeUnixNano":"{}","endTimeUnixNano":"{}","attributes":[)"
+				R"({{"key":"http.request.method","value":{{"stringValue":"{}"}}}},)"
+				R"({{"key":"http.response.status_code","value":{{"intValue":"{}"}}}},)"
+				R"({{"key":"url.path","value":{{"stringValue":")",
+				wall_time(trace.start()).count(), wall_time(trace.end()).count(),
+				method_string(trace.method()), trace.status()
+			);
+			escape(trace.path(), buffer);
+			buffer += R"("}}]})";
+
+			auto spans = trace.spans();
+			for(size_t i=0; i<spans.size(); i++)
+			{
+				auto &span = spans[i];
+				auto end = span.end == request_trace::time_point() ? trace.end() : span.end;
+				auto parent = span.parent < 0 ? root_id : m_span_ids[static_cast<size_t>(span.parent)];
+
+				std::format_to(out, R"(,{{"traceId":"{}","spanId":"{:016x}","parentSpanId":"{:016x}","name":")",
+					trace_id, m_span_ids[i], parent
+				);
+				escape(span.name(), buffer);
+				std::format_to(out, R"(","kind":1,"startTimeUnixNano":"{}","endTimeUnixNano":"{}"}})",
+					wall_time(span.start).count(), wall_time(end).count()
+				);
+			}
+		}
+		buffer += "]}]}]}\n";
+	}
+
+	[[nodiscard]] std::chrono::nanoseconds wall_time(request_trace::time_point time) const noexcept {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()) + m_wall_offset;
+	}
+
+	// Chrome wants microseconds, keeps the nanoseconds as a fraction.
+	[[nodiscard]] static std::string micros(std::chrono::nanoseconds time)
+	{
+		auto ns = std::max<int64_t>(time.count(), 0);
+		return std::format("{}.{:03}", ns / 1000, ns % 1000);
+	}
+
+	static void escape(std::string_view str, std::string &buffer)
+	{
+		for(auto c : str)
+		{
+			if( c == '"' or c == '\\' )
+			{
+				buffer += '\\';
+				buffer += c;
+			}
+			else if( static_cast<unsigned char>(c) < 0x20 )
+				std::format_to(std::back_inserter(buffer), "\\u{:04x}", static_cast<int>(c));
+			else
+				buffer += c;
+		}
+	}
+
+public:
+	trace_option m_option;
+
+private:
+	std::vector<uint64_t> m_span_ids;
+	std::chrono::nanoseconds m_wall_offset {};
+	std::mt19937_64 m_random {std::random_device()()};
+	uint64_t m_sequence = 0;
+	std::atomic_size_t m_sampled_out {0};
+
+	// Last, its thread is stopped before what the formatters use goes away.
+	detail::record_writer<request_trace> m_writer;
+};
+
+inline tracer::tracer(const trace_option &option) :
+	m_impl(new impl(option))
+{
+
+}
+
+inline tracer::~tracer()
+{
+	delete m_impl;
+}
+
+inline bool tracer::begin(request_trace &trace, request_trace::time_point start) noexcept
+{
+	return m_impl->begin(trace, start);
+}
+
+inline request_trace *tracer::begin(std::unique_ptr<request_trace> &trace, request_trace::time_point start) noexcept
+{
+	return m_impl->begin(trace, start);
+}
+
+inline bool tracer::push(const request_trace &trace) noexcept
+{
+	return m_impl->push(trace);
+}
+
+inline const trace_option &tracer::option() const noexcept
+{
+	return m_impl->m_option;
+}
+
+inline trace_statistics tracer::stats() const noexcept
+{
+	return m_impl->stats();
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_DETAIL_TRACER_H
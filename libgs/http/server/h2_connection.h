@@ -0,0 +1,110 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_H2_CONNECTION_H
+#define LIBGS_HTTP_SERVER_H2_CONNECTION_H
+
+#include <libgs/http/h2/hpack.h>
+#include <libgs/http/server/context.h>
+
+namespace libgs::http
+{
+
+struct LIBGS_HTTP_VAPI h2_option
+{
+	bool enable = true;
+	uint32_t max_concurrent_streams = 100;
+	uint32_t initial_window_size = 0x100000;
+	uint32_t max_frame_size = 0x4000;
+	uint32_t header_table_size = 4096;
+	uint32_t max_header_list_size = 0x10000;
+
+	// Request bodies without 'content-length' are buffered before dispatching.
+	size_t max_buffered_body = 0x800000;
+};
+
+// Serves one HTTP/2 connection, every stream gets its own context and is
+// dispatched to the handler concurrently. The request/response objects keep
+// their HTTP/1.1 interface and are carried over the stream by a transport.
+template <concepts::stream Stream, core_concepts::char_type CharT>
+class LIBGS_HTTP_TAPI basic_h2_connection
+{
+	LIBGS_DISABLE_COPY_MOVE(basic_h2_connection)
+
+public:
+	using next_layer_t = Stream;
+	using char_t = CharT;
+
+	using context_t = basic_service_context<next_layer_t,char_t>;
+	using parser_t = typename context_t::parser_t;
+	using handler_t = std::function<awaitable<void>(context_t&)>;
+
+public:
+	basic_h2_connection(next_layer_t &next_layer, session_set &sss, const h2_option &option = {})
+		requires (not is_ssl_stream_v<next_layer_t>);
+
+#ifdef LIBGS_ENABLE_OPENSSL
+	// 'ssl' is the context of the server that accepted 'next_layer'.
+	basic_h2_connection(next_layer_t &next_layer, asio::ssl::context &ssl, session_set &sss, const h2_option &option = {})
+		requires is_ssl_stream_v<next_layer_t>;
+#endif //LIBGS_ENABLE_OPENSSL
+	~basic_h2_connection();
+
+public:
+	// Prior knowledge or ALPN, 'data' is what has already been read from the stream.
+	[[nodiscard]] awaitable<void> co_run (
+		std::string_view data, handler_t handler, const milliseconds &idle_timeout
+	);
+
+	// h2c upgrade, the request held by 'parser' becomes stream 1.
+	// Returns false, leaving the connection untouched, if 'HTTP2-Settings' is malformed,
+	// the request is then to be served over HTTP/1.1 (RFC 7540 3.2).
+	[[nodiscard]] awaitable<bool> co_upgrade (
+		parser_t &parser, handler_t handler, const milliseconds &idle_timeout
+	);
+
+public:
+	[[nodiscard]] static bool is_preface(std::string_view data) noexcept;
+	[[nodiscard]] static bool is_upgrade(const parser_t &parser) noexcept;
+	[[nodiscard]] static bool alpn_selected(next_layer_t &next_layer) noexcept;
+
+private:
+	class impl;
+	arena::ptr<impl> m_impl;
+};
+
+#ifdef LIBGS_ENABLE_OPENSSL
+// Lets the TLS handshake negotiate "h2" (falling back to "http/1.1") via ALPN.
+LIBGS_HTTP_VAPI void set_h2_alpn(asio::ssl::context &ssl);
+#endif //LIBGS_ENABLE_OPENSSL
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/h2_connection.h>
+
+
+#endif //LIBGS_HTTP_SERVER_H2_CONNECTION_H
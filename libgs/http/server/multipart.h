@@ -0,0 +1,155 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_MULTIPART_H
+#define LIBGS_HTTP_SERVER_MULTIPART_H
+
+#include <libgs/http/server/request.h>
+
+namespace libgs::http
+{
+
+#define LIBGS_HTTP_MULTIPART_ERRNO \
+X_MACRO( NBD   , 10200 , "The request is not multipart or has no boundary." ) \
+X_MACRO( TMP   , 10201 , "Too many parts."                                   ) \
+X_MACRO( PTL   , 10202 , "Part too large."                                   ) \
+X_MACRO( HTL   , 10203 , "Part headers too large."                           ) \
+X_MACRO( BTL   , 10204 , "Multipart body too large."                         ) \
+X_MACRO( IFMT  , 10205 , "Invalid multipart format."                         ) \
+X_MACRO( UEOF  , 10206 , "Unexpected end of multipart body."                 )
+
+enum class multipart_errno
+{
+#define X_MACRO(e,v,d) e=(v),
+	LIBGS_HTTP_MULTIPART_ERRNO
+#undef X_MACRO
+};
+
+struct LIBGS_HTTP_VAPI multipart_limits
+{
+	// Zero means unlimited.
+	size_t max_parts = 128;
+	size_t max_part_size = 0;
+	size_t max_header_size = 0x2000;
+	size_t max_body_size = 0;
+};
+
+namespace concepts
+{
+
+template <typename Func>
+concept multipart_sink =
+	std::is_invocable_v<Func, std::string_view> and (
+		std::is_void_v<std::invoke_result_t<Func, std::string_view>> or
+		std::is_same_v<std::invoke_result_t<Func, std::string_view>, awaitable<void>>
+	);
+
+} //namespace concepts
+
+template <concepts::stream Stream, core_concepts::char_type CharT>
+class LIBGS_HTTP_TAPI basic_multipart_reader
+{
+	LIBGS_DISABLE_COPY(basic_multipart_reader)
+
+public:
+	using request_t = basic_server_request<Stream,CharT>;
+	using char_t = CharT;
+	using string_t = std::basic_string<char_t>;
+	using string_view_t = std::basic_string_view<char_t>;
+	using headers_t = basic_headers<char_t>;
+
+public:
+	explicit basic_multipart_reader(request_t &request, const multipart_limits &limits = {});
+	~basic_multipart_reader();
+
+	basic_multipart_reader(basic_multipart_reader &&other) noexcept;
+	basic_multipart_reader &operator=(basic_multipart_reader &&other) noexcept;
+
+public:
+	[[nodiscard]] static bool is_multipart(const request_t &request) noexcept;
+
+	[[nodiscard]] awaitable<bool> co_next_part(error_code &error);
+	[[nodiscard]] awaitable<bool> co_next_part();
+
+public:
+	[[nodiscard]] const headers_t &part_headers() const noexcept;
+	[[nodiscard]] string_view_t part_name() const noexcept;
+	[[nodiscard]] string_view_t part_file_name() const noexcept;
+	[[nodiscard]] bool part_is_file() const noexcept;
+
+	[[nodiscard]] size_t part_count() const noexcept;
+	[[nodiscard]] size_t part_size() const noexcept;
+	[[nodiscard]] bool is_done() const noexcept;
+
+public:
+	[[nodiscard]] awaitable<size_t> co_read_part(const mutable_buffer &buf, error_code &error);
+	[[nodiscard]] awaitable<size_t> co_read_part(const mutable_buffer &buf);
+
+	[[nodiscard]] awaitable<std::string> co_read_part(error_code &error);
+	[[nodiscard]] awaitable<std::string> co_read_part();
+
+	template <concepts::multipart_sink Func>
+	awaitable<size_t> co_read_part(Func &&sink, error_code &error);
+
+	template <concepts::multipart_sink Func>
+	awaitable<size_t> co_read_part(Func &&sink);
+
+	awaitable<size_t> co_save_part (
+		concepts::char_file_opt_token_arg<file_optype::single, io_permission::write> auto &&opt,
+		error_code &error
+	);
+	awaitable<size_t> co_save_part (
+		concepts::char_file_opt_token_arg<file_optype::single, io_permission::write> auto &&opt
+	);
+
+public:
+	[[nodiscard]] const multipart_limits &limits() const noexcept;
+	[[nodiscard]] request_t &request() noexcept;
+
+private:
+	class impl;
+	arena::ptr<impl> m_impl;
+};
+
+template <core_concepts::execution Exec>
+using basic_tcp_multipart_reader = basic_multipart_reader<asio::basic_stream_socket<asio::ip::tcp,Exec>,char>;
+
+template <core_concepts::execution Exec>
+using wbasic_tcp_multipart_reader = basic_multipart_reader<asio::basic_stream_socket<asio::ip::tcp,Exec>,wchar_t>;
+
+using tcp_multipart_reader = basic_tcp_multipart_reader<asio::any_io_executor>;
+using wtcp_multipart_reader = wbasic_tcp_multipart_reader<asio::any_io_executor>;
+
+using multipart_reader = tcp_multipart_reader;
+using wmultipart_reader = wtcp_multipart_reader;
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/multipart.h>
+
+
+#endif //LIBGS_HTTP_SERVER_MULTIPART_H
@@ -0,0 +1,116 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_PROXY_H
+#define LIBGS_HTTP_SERVER_PROXY_H
+
+#include <libgs/http/server/aop.h>
+#include <libgs/http/client/session_pool.h>
+
+namespace libgs::http
+{
+
+enum class proxy_balance
+{
+	round_robin,
+	least_outstanding
+};
+
+struct LIBGS_HTTP_VAPI proxy_option
+{
+	proxy_balance balance = proxy_balance::round_robin;
+
+	milliseconds connect_timeout {3000};
+	milliseconds read_timeout {30000};
+
+	// Relay buffer, also the largest request body that can still be retried.
+	size_t buffer_size = 0x10000;
+
+	// Another upstream is tried while nothing of the request body is lost
+	// (connection refused, or a pooled connection closed by the upstream).
+	size_t retries = 1;
+
+	bool preserve_host = true;
+	bool forwarded_headers = true;
+
+	// Response bodies of known length go through splice(2) between plain sockets (Linux).
+	bool splice = true;
+};
+
+// Streaming reverse proxy: bodies are relayed in both directions a buffer at a time,
+// so the slower peer holds the other back. Upstream connections are taken from (and
+// returned to) 'pool', hop-by-hop headers are dropped, 'X-Forwarded-*' are added.
+// Register it as a controller: server.on_request<...>("/api/*", std::make_shared<tcp_proxy>(...)).
+template <concepts::stream Stream, core_concepts::char_type CharT, concepts::session_pool SessionPool = session_pool>
+class LIBGS_HTTP_TAPI basic_proxy : public basic_ctrlr_aop<Stream,CharT>
+{
+public:
+	using char_t = CharT;
+	using context_t = basic_service_context<Stream,char_t>;
+	using session_pool_t = SessionPool;
+	using endpoint_t = typename session_pool_t::endpoint_t;
+
+	struct statistics
+	{
+		size_t requests = 0;
+		size_t retries = 0;
+		size_t failures = 0;
+		size_t spliced = 0;
+		size_t copied = 0;
+	};
+
+public:
+	basic_proxy(session_pool_t &pool, std::vector<endpoint_t> upstreams, proxy_option option = {});
+	~basic_proxy() override;
+
+public:
+	[[nodiscard]] awaitable<void> service(context_t &context) override;
+
+public:
+	[[nodiscard]] const proxy_option &option() const noexcept;
+	[[nodiscard]] statistics stats() const noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+template <core_concepts::execution Exec>
+using basic_tcp_proxy = basic_proxy<asio::basic_stream_socket<asio::ip::tcp,Exec>,char>;
+
+template <core_concepts::execution Exec>
+using wbasic_tcp_proxy = basic_proxy<asio::basic_stream_socket<asio::ip::tcp,Exec>,wchar_t>;
+
+using tcp_proxy = basic_tcp_proxy<asio::any_io_executor>;
+using wtcp_proxy = wbasic_tcp_proxy<asio::any_io_executor>;
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/proxy.h>
+
+
+#endif //LIBGS_HTTP_SERVER_PROXY_H
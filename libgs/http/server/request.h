@@ -31,6 +31,7 @@
 
 #include <libgs/http/cxx/socket_operation_helper.h>
 #include <libgs/http/server/request_parser.h>
+#include <libgs/http/server/transport.h>
 
 namespace libgs::http
 {
@@ -44,6 +45,7 @@ public:
 	using next_layer_t = Stream;
 	using executor_t = typename next_layer_t::executor_type;
 	using endpoint_t = typename socket_operation_helper<next_layer_t>::endpoint_t;
+	using transport_t = basic_server_transport<next_layer_t>;
 
 	using char_t = CharT;
 	using parser_t = basic_request_parser<char_t>;
@@ -60,7 +62,7 @@ public:
 
 public:
 	template <typename NextLayer>
-	basic_server_request(NextLayer &&next_layer, parser_t &parser)
+	basic_server_request(NextLayer &&next_layer, parser_t &parser, transport_t *transport = nullptr)
 		requires core_concepts::constructible<next_layer_t,NextLayer&&>;
 	~basic_server_request();
 
@@ -79,11 +81,13 @@ public:
 	[[nodiscard]] method_t method() const noexcept;
 	[[nodiscard]] version_t version() const noexcept;
 	[[nodiscard]] string_view_t path() const noexcept;
+	[[nodiscard]] std::string_view target() const noexcept;
 
 	[[nodiscard]] const parameters_t &parameters() const noexcept;
 	[[nodiscard]] const path_args_t &path_args() const noexcept;
 	[[nodiscard]] const headers_t &headers() const noexcept;
 	[[nodiscard]] const cookies_t &cookies() const noexcept;
+	[[nodiscard]] std::string_view cookie_header() const noexcept;
 
 public:
 	template <core_concepts::basic_text_arg<CharT> T = value_t>
@@ -153,16 +157,20 @@ public:
 	[[nodiscard]] endpoint_t remote_endpoint() const;
 	[[nodiscard]] endpoint_t local_endpoint() const;
 
+	[[nodiscard]] peer_credentials peer_cred(error_code &error) const noexcept requires is_local_stream_v<next_layer_t>;
+	[[nodiscard]] peer_credentials peer_cred() const requires is_local_stream_v<next_layer_t>;
+
 	[[nodiscard]] executor_t get_executor() noexcept;
 	basic_server_request &cancel() noexcept;
 
 public:
 	[[nodiscard]] const next_layer_t &next_layer() const noexcept;
 	[[nodiscard]] next_layer_t &next_layer() noexcept;
+	[[nodiscard]] transport_t *transport() const noexcept;
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 template <core_concepts::execution Exec>
@@ -71,12 +71,18 @@ public:
 	[[nodiscard]] string_view_t path() const noexcept;
 	[[nodiscard]] version_t version() const noexcept;
 
+	// The request-target as received, neither decoded nor normalized.
+	[[nodiscard]] std::string_view target() const noexcept;
+
 public:
 	[[nodiscard]] const parameters_t &parameters() const noexcept;
 	[[nodiscard]] const path_args_t &path_args() const noexcept;
 	[[nodiscard]] const headers_t &headers() const noexcept;
 	[[nodiscard]] const cookies_t &cookies() const noexcept;
 
+	// The 'Cookie' header as received, several of them are joined with "; ".
+	[[nodiscard]] std::string_view cookie_header() const noexcept;
+
 public:
 	[[nodiscard]] bool keep_alive() const noexcept;
 	[[nodiscard]] bool support_gzip() const noexcept;
@@ -91,7 +97,7 @@ public:
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 using request_parser = basic_request_parser<char>;
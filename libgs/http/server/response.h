@@ -31,7 +31,9 @@
 
 #include <libgs/http/server/request.h>
 #include <libgs/http/server/response_helper.h>
+#include <libgs/http/server/tracer.h>
 #include <libgs/core/value.h>
+#include <span>
 
 namespace libgs::http
 {
@@ -117,6 +119,25 @@ public:
 		Token &&token = {}
 	);
 
+	// Writes an already serialized response (status line, headers and body) in
+	// one gathered write, the response is finished afterwards. Over HTTP/2 only
+	// asynchronously, the bytes are then taken apart by the stream.
+	template <core_concepts::dis_func_tf_opt_token Token = use_sync_t>
+	auto write_serialized(std::span<const const_buffer> buffers, Token &&token = {});
+
+	// Appends every byte written from now on to 'buf' (nullptr to stop). HTTP/1.x only.
+	// Past 'max_size' 'buf' is emptied and the recording stops, recorder() is then null.
+	// 'guard' is released with the next call, or with the response.
+	basic_server_response &set_recorder (
+		std::string *buf,
+		size_t max_size = std::numeric_limits<size_t>::max(),
+		std::shared_ptr<void> guard = {}
+	) noexcept;
+	[[nodiscard]] const std::string *recorder() const noexcept;
+
+	// Time spent writing is added to the 'write' span of 'trace' (nullptr to stop).
+	basic_server_response &set_trace(request_trace *trace) noexcept;
+
 public:
 	template <core_concepts::dis_func_tf_opt_token Token = use_sync_t>
 	auto chunk_end(const map_helper_t &headers, Token &&token = {});
@@ -132,6 +153,7 @@ public:
 	[[nodiscard]] const cookies_t &cookies() const noexcept;
 
 	[[nodiscard]] bool is_finished() const noexcept;
+	[[nodiscard]] size_t bytes_sent() const noexcept;
 	[[nodiscard]] executor_t get_executor() noexcept;
 	basic_server_response &cancel() noexcept;
 
@@ -163,7 +185,7 @@ public:
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 template <core_concepts::execution Exec>
@@ -133,7 +133,7 @@ public:
 
 private:
 	class impl;
-	impl *m_impl;
+	arena::ptr<impl> m_impl;
 };
 
 using response_helper = basic_response_helper<char>;
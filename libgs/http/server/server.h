@@ -31,6 +31,11 @@
 
 #include <libgs/http/server/acceptor_wrap.h>
 #include <libgs/http/server/aop.h>
+#include <libgs/http/server/h2_connection.h>
+#include <libgs/http/server/admission.h>
+#include <libgs/http/server/access_log.h>
+#include <libgs/http/server/tracer.h>
+#include <libgs/core/rcu_ptr.h>
 
 namespace libgs::http
 {
@@ -49,7 +54,8 @@ public:
 
 	using next_layer_t = basic_acceptor_wrap<socket_t>;
 	using endpoint_t = typename next_layer_t::acceptor_t::endpoint_type;
-	using endpoint_wrapper_t = basic_endpoint_wrapper<typename endpoint_t::protocol_type>;
+	using protocol_t = typename endpoint_t::protocol_type;
+	using endpoint_wrapper_t = basic_endpoint_wrapper<protocol_t>;
 
 	using char_t = CharT;
 	using string_t = std::basic_string<char_t>;
@@ -68,6 +74,8 @@ public:
 	using ctrlr_aop_t = basic_ctrlr_aop<socket_t,char_t>;
 	using aop_ptr_t = basic_aop_ptr<socket_t,char_t>;
 	using ctrlr_aop_ptr_t = basic_ctrlr_aop_ptr<socket_t,char_t>;
+	using websocket_t = basic_websocket<socket_t>;
+	using h2_connection_t = basic_h2_connection<socket_t,char_t>;
 
 public:
 	template <core_concepts::execution Exec0 = io_executor_t>
@@ -83,19 +91,20 @@ public:
 
 	template <typename Stream0, typename Exec0>
 	basic_server(basic_server<char_t,Stream0,Exec0> &&other) noexcept
-		requires core_concepts::constructible<next_layer_t,asio::basic_socket_acceptor<asio::ip::tcp,Exec0>&&> and
+		requires core_concepts::constructible<next_layer_t,asio::basic_socket_acceptor<protocol_t,Exec0>&&> and
 				 core_concepts::constructible<service_exec_t,typename Stream::executor_type>;
 
 	template <typename Stream0, typename Exec0>
 	basic_server &operator=(basic_server<char_t,Stream0,Exec0> &&other) noexcept
-		requires core_concepts::assignable<next_layer_t,asio::basic_socket_acceptor<asio::ip::tcp,Exec0>&&> and
+		requires core_concepts::assignable<next_layer_t,asio::basic_socket_acceptor<protocol_t,Exec0>&&> and
 				 core_concepts::assignable<service_exec_t,typename Stream::executor_type>;
 
 public:
 	basic_server &bind(endpoint_wrapper_t ep);
 	basic_server &bind(endpoint_wrapper_t ep, error_code &error) noexcept;
 
-	basic_server &start(size_t max = asio::socket_base::max_listen_connections);
+	basic_server &start();
+	basic_server &start(size_t max);
 	basic_server &start(size_t max, error_code &error) noexcept;
 	basic_server &start(error_code &error) noexcept;
 
@@ -111,6 +120,11 @@ public:
 	template <method...Method>
 	basic_server &on_request(const path_opt_token_t &path_rules, ctrlr_aop_t *ctrlr);
 
+	template <typename Func, typename...AopPtrs>
+	basic_server &on_websocket(const path_opt_token_t &path_rules, Func &&func, AopPtrs&&...aops) requires
+		detail::concepts::websocket_handler<Func,socket_t,char_t> and
+		detail::concepts::aop_ptr_list<socket_t,char_t,AopPtrs...>;
+
 	template <typename Func>
 	basic_server &on_default(Func &&func) requires detail::concepts::request_handler<Func,socket_t,char_t>;
 
@@ -118,6 +132,7 @@ public:
 	basic_server &on_service_error(service_error_handler_t func);
 
 	basic_server &unbound_request(string_view_t path_rule = {});
+	basic_server &unbound_websocket(string_view_t path_rule = {});
 	basic_server &unbound_server_error();
 	basic_server &unbound_service_error();
 
@@ -128,8 +143,17 @@ public:
 	template <typename Rep, typename Period>
 	basic_server &set_keepalive_time(const duration<Rep,Period> &d = {});
 
+	basic_server &set_websocket_deflate(const websocket_deflate_option &option);
+	basic_server &set_h2_option(const h2_option &option);
+	basic_server &set_admission_option(const admission_option &option);
+	basic_server &set_access_log(const access_log_option &option);
+	basic_server &set_tracer(const trace_option &option);
+
 public:
 	[[nodiscard]] const executor_t &get_executor() noexcept;
+	[[nodiscard]] admission_statistics admission_stats() const noexcept;
+	[[nodiscard]] access_log_statistics access_log_stats() const noexcept;
+	[[nodiscard]] trace_statistics tracer_stats() const noexcept;
 	[[nodiscard]] awaitable<void> co_stop() noexcept;
 	basic_server &stop() noexcept;
 	basic_server &cancel() noexcept;
@@ -155,6 +179,19 @@ using wtcp_server = wbasic_tcp_server<asio::any_io_executor>;
 using server = tcp_server;
 using wserver = wtcp_server;
 
+#ifdef LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
+template <core_concepts::execution Exec, core_concepts::execution ServiceExec = asio::any_io_executor>
+using basic_local_server = basic_server<char, asio::basic_stream_socket<asio::local::stream_protocol,ServiceExec>, Exec>;
+
+template <core_concepts::execution Exec, core_concepts::execution ServiceExec = asio::any_io_executor>
+using wbasic_local_server = basic_server<wchar_t, asio::basic_stream_socket<asio::local::stream_protocol,ServiceExec>, Exec>;
+
+using local_server = basic_local_server<asio::any_io_executor>;
+using wlocal_server = wbasic_local_server<asio::any_io_executor>;
+
+#endif //LIBGS_ASIO_HAS_LOCAL_SOCKETS
+
 } //namespace libgs::http
 #include <libgs/http/server/detail/server.h>
 
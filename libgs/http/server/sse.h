@@ -0,0 +1,107 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_SSE_H
+#define LIBGS_HTTP_SERVER_SSE_H
+
+#include <libgs/http/server/context.h>
+
+namespace libgs::http
+{
+
+// What happens to an event a subscriber has no room for.
+enum class sse_overflow
+{
+	drop,       // The subscriber misses it.
+	coalesce,   // It replaces the queued event of the same type, or the oldest one.
+	disconnect  // The stream is ended, the client comes back with 'Last-Event-ID'.
+};
+
+struct LIBGS_HTTP_VAPI sse_option
+{
+	// Events kept per topic for 'Last-Event-ID' replay.
+	size_t replay_size = 256;
+
+	// Events queued per subscriber before 'overflow' applies.
+	size_t max_pending = 64;
+	sse_overflow overflow = sse_overflow::drop;
+
+	// A comment line is sent when nothing else was, also finds dead clients.
+	milliseconds keepalive {15000};
+
+	// Reconnection delay announced to the clients (zero leaves it to them).
+	milliseconds retry {0};
+};
+
+struct LIBGS_HTTP_VAPI sse_statistics
+{
+	size_t topics = 0;
+	size_t subscribers = 0;
+	size_t published = 0;
+	size_t dropped = 0;
+	size_t coalesced = 0;
+	size_t disconnected = 0;
+};
+
+// Server-Sent Events fan-out. Every event is encoded once, as a complete HTTP/1.1
+// chunk, into an immutable shared frame; subscribers only queue references to it
+// and write what piled up in one gathered write.
+class LIBGS_HTTP_VAPI sse_hub
+{
+	LIBGS_DISABLE_COPY_MOVE(sse_hub)
+
+public:
+	explicit sse_hub(const sse_option &option = {});
+	~sse_hub();
+
+public:
+	// Returns the id of the event, ids grow across all topics of the hub.
+	uint64_t publish(std::string_view topic, std::string_view data, std::string_view event = {});
+
+	// Streams 'topic' to the client of 'context' until it goes away or the hub is closed.
+	// Events newer than the request's 'Last-Event-ID' are replayed first.
+	template <concepts::stream Stream, core_concepts::char_type CharT>
+	[[nodiscard]] awaitable<void> co_subscribe(basic_service_context<Stream,CharT> &context, std::string_view topic);
+
+	// Ends every stream, later subscriptions end at once.
+	void close() noexcept;
+
+public:
+	[[nodiscard]] const sse_option &option() const noexcept;
+	[[nodiscard]] sse_statistics stats() const noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/sse.h>
+
+
+#endif //LIBGS_HTTP_SERVER_SSE_H
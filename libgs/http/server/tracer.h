@@ -0,0 +1,198 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_TRACER_H
+#define LIBGS_HTTP_SERVER_TRACER_H
+
+#include <libgs/http/types.h>
+#include <span>
+
+namespace libgs::http
+{
+
+enum class trace_format
+{
+	// Chrome 'trace_event' array, opens in chrome://tracing or Perfetto.
+	chrome,
+	// OTLP/JSON, one ExportTraceServiceRequest per line.
+	otlp
+};
+
+struct LIBGS_HTTP_VAPI trace_option
+{
+	std::filesystem::path file_name;
+	trace_format format = trace_format::chrome;
+	std::string service_name = "libgs";
+
+	// Fraction of requests kept whatever their latency.
+	double sample_rate = 0.01;
+
+	// Requests at least this slow are always kept, zero disables it.
+	// Every request is timed when it is set, otherwise only the sampled ones are.
+	std::chrono::microseconds tail_latency {0};
+
+	// Traces an io thread can hold before the writer drains them, beyond it they are dropped.
+	size_t ring_capacity = 256;
+	milliseconds flush_interval {1000};
+};
+
+struct LIBGS_HTTP_VAPI trace_statistics
+{
+	size_t written = 0;
+	size_t sampled_out = 0;
+	size_t dropped = 0;
+	size_t write_errors = 0;
+};
+
+// The stages of one request, timed on the io thread. Fixed size, spans past
+// 'max_spans' are not recorded.
+class LIBGS_HTTP_VAPI request_trace
+{
+public:
+	using clock_t = std::chrono::steady_clock;
+	using time_point = clock_t::time_point;
+
+	static constexpr size_t max_spans = 24;
+	static constexpr size_t max_name_size = 23;
+	static constexpr size_t max_path_size = 128;
+	static constexpr size_t npos = static_cast<size_t>(-1);
+
+	struct span_record
+	{
+		time_point start {};
+		time_point end {};
+
+		// Index of the enclosing span, -1 for the request itself.
+		int8_t parent = -1;
+		uint8_t name_size = 0;
+		char name_data[max_name_size] {};
+
+		[[nodiscard]] std::string_view name() const noexcept;
+	};
+
+	// Ends its span when destroyed, does nothing if the request isn't traced.
+	class LIBGS_HTTP_VAPI scope
+	{
+		LIBGS_DISABLE_COPY(scope)
+
+	public:
+		scope() noexcept = default;
+		~scope();
+
+		scope(scope &&other) noexcept;
+		scope &operator=(scope &&other) noexcept;
+
+	public:
+		void end() noexcept;
+
+	private:
+		friend class request_trace;
+		scope(request_trace *trace, size_t index) noexcept;
+
+		request_trace *m_trace = nullptr;
+		size_t m_index = npos;
+	};
+
+public:
+	void reset(time_point start = clock_t::now()) noexcept;
+
+	// Spans begun while another one is open become its children.
+	[[nodiscard]] scope span(std::string_view name) noexcept;
+	[[nodiscard]] size_t begin(std::string_view name) noexcept;
+	void end(size_t index) noexcept;
+
+	void add(std::string_view name, time_point start, time_point end = clock_t::now()) noexcept;
+
+	// Widens the span of the same name (added if there is none), for stages done in pieces.
+	void extend(std::string_view name, time_point start, time_point end = clock_t::now()) noexcept;
+
+public:
+	void finish(method_t method, status_t status, std::string_view path, time_point end = clock_t::now()) noexcept;
+	void set_sampled(bool sampled) noexcept;
+
+	[[nodiscard]] time_point start() const noexcept;
+	[[nodiscard]] time_point end() const noexcept;
+	[[nodiscard]] std::span<const span_record> spans() const noexcept;
+
+	[[nodiscard]] method_t method() const noexcept;
+	[[nodiscard]] status_t status() const noexcept;
+	[[nodiscard]] std::string_view path() const noexcept;
+	[[nodiscard]] bool is_sampled() const noexcept;
+
+private:
+	span_record m_spans[max_spans] {};
+	uint8_t m_count = 0;
+	int8_t m_current = -1;
+	bool m_sampled = false;
+
+	time_point m_start {};
+	time_point m_end {};
+	method_t m_method = method::GET;
+	status_t m_status = 0;
+
+	char m_path[max_path_size] {};
+	uint8_t m_path_size = 0;
+};
+
+// Per thread SPSC rings drained by a background writer, like the access log.
+class LIBGS_HTTP_VAPI tracer
+{
+	LIBGS_DISABLE_COPY_MOVE(tracer)
+
+public:
+	explicit tracer(const trace_option &option);
+	~tracer();
+
+public:
+	// Resets 'trace' for a request starting at 'start'. False if the request
+	// needs no timing at all (not sampled and no tail latency set).
+	[[nodiscard]] bool begin(request_trace &trace, request_trace::time_point start = request_trace::clock_t::now()) noexcept;
+
+	// Same, but decides before there is a trace: 'trace' is only allocated for a request
+	// that needs timing, and reused after that. Null if it needs none.
+	[[nodiscard]] request_trace *begin (
+		std::unique_ptr<request_trace> &trace, request_trace::time_point start = request_trace::clock_t::now()
+	) noexcept;
+
+	// Keeps the finished trace if it was sampled or is slow enough.
+	bool push(const request_trace &trace) noexcept;
+	[[nodiscard]] const trace_option &option() const noexcept;
+
+public:
+	[[nodiscard]] trace_statistics stats() const noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+} //namespace libgs::http
+#include <libgs/http/server/detail/tracer.h>
+
+
+#endif //LIBGS_HTTP_SERVER_TRACER_H
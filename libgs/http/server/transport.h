@@ -0,0 +1,70 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_SERVER_TRANSPORT_H
+#define LIBGS_HTTP_SERVER_TRANSPORT_H
+
+#include <libgs/http/cxx/socket_operation_helper.h>
+
+namespace libgs::http
+{
+
+// Carries a request/response exchange over something other than the raw stream
+// (e.g. an HTTP/2 stream). The request reads its body bytes from it and the
+// response writes its serialized HTTP/1.1 message into it.
+template <concepts::stream Stream>
+class LIBGS_HTTP_TAPI basic_server_transport
+{
+public:
+	using next_layer_t = Stream;
+	using endpoint_t = typename socket_operation_helper<next_layer_t>::endpoint_t;
+
+public:
+	virtual ~basic_server_transport() = default;
+
+	// Returns 0 without error only when the request body is complete.
+	[[nodiscard]] virtual awaitable<size_t> co_read(const mutable_buffer &buf, error_code &error) noexcept = 0;
+	[[nodiscard]] virtual awaitable<size_t> co_write(std::string_view data, error_code &error) noexcept = 0;
+
+public:
+	[[nodiscard]] virtual endpoint_t remote_endpoint() const = 0;
+	[[nodiscard]] virtual endpoint_t local_endpoint() const = 0;
+	virtual void cancel() noexcept = 0;
+
+	// Unix domain sockets only.
+	[[nodiscard]] virtual peer_credentials peer_cred(error_code &error) const noexcept
+	{
+		error = std::make_error_code(std::errc::operation_not_supported);
+		return {};
+	}
+};
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_SERVER_TRANSPORT_H
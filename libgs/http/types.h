@@ -30,6 +30,7 @@
 #define LIBGS_HTTP_TYPES_H
 
 #include <libgs/core/cxx/flags.h>
+#include <libgs/core/arena.h>
 #include <libgs/http/version.h>
 #include <libgs/http/header.h>
 #include <libgs/http/cookie.h>
@@ -37,9 +37,9 @@ namespace libgs::http
 #define LIBGS_HTTP_VERSION_TABLE \
 X_MACRO( nan , 0x0000 , "NAN" ) \
 X_MACRO( v10 , 0x0100 , "1.0" ) \
-X_MACRO( v11 , 0x0101 , "1.1" )
+X_MACRO( v11 , 0x0101 , "1.1" ) \
+X_MACRO( v20 , 0x0200 , "2.0" )
 // X_MACRO( v12 , 0x0102 , "1.2" )
-// X_MACRO( v20 , 0x0200 , "2.0" )
 
 struct LIBGS_HTTP_VAPI version
 {
@@ -0,0 +1,294 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_WEBSOCKET_DETAIL_FRAME_H
+#define LIBGS_HTTP_WEBSOCKET_DETAIL_FRAME_H
+
+#include <libgs/core/algorithm/sha1.h>
+#include <libgs/core/algorithm/base64.h>
+#include <libgs/core/algorithm/base.h>
+#include <libgs/core/algorithm/random.h>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+#endif
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+class websocket_error_category : public std::error_category
+{
+	LIBGS_DISABLE_COPY_MOVE(websocket_error_category)
+
+public:
+	websocket_error_category() = default;
+	[[nodiscard]] const char *name() const noexcept override {
+		return "libgs::http::websocket_error";
+	}
+	[[nodiscard]] std::string message(int code) const override
+	{
+		switch(static_cast<websocket_errno>(code))
+		{
+#define X_MACRO(e,v,d) case websocket_errno::e: return d;
+			LIBGS_HTTP_WEBSOCKET_ERRNO
+#undef X_MACRO
+			default: break;
+		}
+		return "Unknown error.";
+	}
+	inline static websocket_error_category &instance()
+	{
+		static websocket_error_category category;
+		return category;
+	}
+};
+
+} //namespace detail
+
+inline size_t websocket_frame::encode_header(const websocket_frame_header &header, header_buffer_t &buf) noexcept
+{
+	const auto length = header.payload_length;
+	size_t size = 2;
+
+	buf[0] = static_cast<uint8_t>(header.opcode) & 0x0F;
+	if( header.fin )
+		buf[0] |= 0x80;
+	if( header.rsv1 )
+		buf[0] |= 0x40;
+
+	buf[1] = header.masked ? 0x80 : 0x00;
+	if( length < 126 )
+		buf[1] |= static_cast<uint8_t>(length);
+
+	else if( length <= 0xFFFF )
+	{
+		buf[1] |= 126;
+		buf[2] = static_cast<uint8_t>(length >> 8);
+		buf[3] = static_cast<uint8_t>(length);
+		size += 2;
+	}
+	else
+	{
+		buf[1] |= 127;
+		for(size_t i=0; i<8; i++)
+			buf[2 + i] = static_cast<uint8_t>(length >> (56 - i * 8));
+		size += 8;
+	}
+	if( header.masked )
+	{
+		memcpy(buf.data() + size, header.mask_key.data(), 4);
+		size += 4;
+	}
+	return size;
+}
+
+inline size_t websocket_frame::decode_header
+(const const_buffer &buf, websocket_frame_header &header, bool allow_rsv1, error_code &error) noexcept
+{
+	error = error_code();
+	const auto *data = static_cast<const uint8_t*>(buf.data());
+	if( buf.size() < 2 )
+		return 0;
+
+	if( (data[0] & 0x30) or ((data[0] & 0x40) and not allow_rsv1) )
+	{
+		error = make_error_code(websocket_errno::RBNZ);
+		return 0;
+	}
+	const uint8_t opcode = data[0] & 0x0F;
+	if( not opcode_check(opcode) )
+	{
+		error = make_error_code(websocket_errno::IOP);
+		return 0;
+	}
+	websocket_frame_header result;
+	result.fin = data[0] & 0x80;
+	result.rsv1 = data[0] & 0x40;
+	result.opcode = static_cast<websocket_opcode>(opcode);
+	result.masked = data[1] & 0x80;
+
+	uint64_t length = data[1] & 0x7F;
+	size_t size = 2;
+
+	if( length == 126 )
+	{
+		if( buf.size() < 4 )
+			return 0;
+		length = (data[2] << 8) | data[3];
+		if( length < 126 )
+		{
+			error = make_error_code(websocket_errno::IPL);
+			return 0;
+		}
+		size = 4;
+	}
+	else if( length == 127 )
+	{
+		if( buf.size() < 10 )
+			return 0;
+		length = 0;
+		for(size_t i=0; i<8; i++)
+			length = (length << 8) | data[2 + i];
+		if( (length >> 63) or length <= 0xFFFF )
+		{
+			error = make_error_code(websocket_errno::IPL);
+			return 0;
+		}
+		size = 10;
+	}
+	if( is_control(result.opcode) )
+	{
+		if( not result.fin )
+		{
+			error = make_error_code(websocket_errno::CFF);
+			return 0;
+		}
+		else if( length > max_control_payload )
+		{
+			error = make_error_code(websocket_errno::CFTL);
+			return 0;
+		}
+		else if( result.rsv1 )
+		{
+			error = make_error_code(websocket_errno::RBNZ);
+			return 0;
+		}
+	}
+	if( result.masked )
+	{
+		if( buf.size() < size + 4 )
+			return 0;
+		memcpy(result.mask_key.data(), data + size, 4);
+		size += 4;
+	}
+	result.payload_length = length;
+	header = result;
+	return size;
+}
+
+inline void websocket_frame::mask(void *data, size_t size, const std::array<uint8_t,4> &key, size_t offset) noexcept
+{
+	auto *ptr = static_cast<uint8_t*>(data);
+	const uint8_t rkey[4] {
+		key[offset & 3], key[(offset + 1) & 3], key[(offset + 2) & 3], key[(offset + 3) & 3]
+	};
+	uint32_t key32 = 0;
+	memcpy(&key32, rkey, 4);
+	size_t i = 0;
+
+	// Every block size is a multiple of 4, so the key phase is unchanged after each loop.
+#if defined(__AVX2__)
+	const auto key256 = _mm256_set1_epi32(static_cast<int>(key32));
+	for(; i + 32 <= size; i += 32)
+	{
+		auto *p = reinterpret_cast<__m256i*>(ptr + i);
+		_mm256_storeu_si256(p, _mm256_xor_si256(_mm256_loadu_si256(p), key256));
+	}
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	const auto key128 = _mm_set1_epi32(static_cast<int>(key32));
+	for(; i + 16 <= size; i += 16)
+	{
+		auto *p = reinterpret_cast<__m128i*>(ptr + i);
+		_mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), key128));
+	}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+	const auto key128 = vreinterpretq_u8_u32(vdupq_n_u32(key32));
+	for(; i + 16 <= size; i += 16)
+		vst1q_u8(ptr + i, veorq_u8(vld1q_u8(ptr + i), key128));
+#endif
+	const uint64_t key64 = (static_cast<uint64_t>(key32) << 32) | key32;
+	for(; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, ptr + i, 8);
+		word ^= key64;
+		memcpy(ptr + i, &word, 8);
+	}
+	for(; i < size; i++)
+		ptr[i] ^= rkey[i & 3];
+}
+
+inline std::array<uint8_t,4> websocket_frame::make_mask_key()
+{
+	// RFC 6455 5.3: the masking key must be unpredictable.
+	std::array<uint8_t,4> key {};
+	secure_random::fill(key.data(), key.size());
+	return key;
+}
+
+inline std::string websocket_frame::make_handshake_key()
+{
+	uint8_t nonce[16];
+	secure_random::fill(nonce, sizeof(nonce));
+	return to_base64(nonce, sizeof(nonce));
+}
+
+inline std::string websocket_frame::handshake_accept(std::string_view key)
+{
+	constexpr std::string_view guid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+	sha1 hash;
+	hash.append(str_trimmed(key)).append(guid);
+	return hash.finalize().base64();
+}
+
+inline bool websocket_frame::is_control(websocket_opcode opcode) noexcept
+{
+	return static_cast<uint8_t>(opcode) & 0x08;
+}
+
+inline bool websocket_frame::opcode_check(uint8_t opcode) noexcept
+{
+	switch(static_cast<websocket_opcode>(opcode))
+	{
+#define X_MACRO(e,v) case websocket_opcode::e:
+		LIBGS_HTTP_WEBSOCKET_OPCODE_TABLE
+#undef X_MACRO
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
+inline error_code websocket_frame::make_error_code(websocket_errno errc)
+{
+	return error_code(static_cast<int>(errc), detail::websocket_error_category::instance());
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_WEBSOCKET_DETAIL_FRAME_H
@@ -0,0 +1,1179 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_WEBSOCKET_DETAIL_WEBSOCKET_H
+#define LIBGS_HTTP_WEBSOCKET_DETAIL_WEBSOCKET_H
+
+#include <libgs/core/algorithm/base.h>
+#include <libgs/core/string_list.h>
+
+#ifdef LIBGS_ENABLE_ZLIB
+# include <zlib.h>
+#endif //LIBGS_ENABLE_ZLIB
+
+namespace libgs::http
+{
+
+namespace detail
+{
+
+struct _websocket_static_string
+{
+	static constexpr const char *version = "13";
+	static constexpr const char *permessage_deflate = "permessage-deflate";
+	static constexpr const char *server_no_context_takeover = "server_no_context_takeover";
+	static constexpr const char *client_no_context_takeover = "client_no_context_takeover";
+	static constexpr const char *server_max_window_bits = "server_max_window_bits";
+	static constexpr const char *client_max_window_bits = "client_max_window_bits";
+	static constexpr const char *deflate_tail = "\x00\x00\xFF\xFF";
+};
+
+} //namespace detail
+
+template <concepts::stream Stream>
+class LIBGS_HTTP_TAPI basic_websocket<Stream>::impl
+{
+	LIBGS_DISABLE_COPY_MOVE(impl)
+	using sock_helper_t = socket_operation_helper<socket_t>;
+
+public:
+	using static_string = detail::_websocket_static_string;
+	static constexpr size_t read_block_size = 0x1000;
+
+public:
+	impl(socket_t &&socket, websocket_role role, const websocket_deflate_option &deflate) :
+		m_socket(std::move(socket)), m_role(role), m_deflate(deflate)
+	{
+#ifndef LIBGS_ENABLE_ZLIB
+		m_deflate.enable = false;
+#endif //LIBGS_ENABLE_ZLIB
+	}
+
+	~impl()
+	{
+#ifdef LIBGS_ENABLE_ZLIB
+		if( m_zlib_init )
+		{
+			inflateEnd(&m_inflater);
+			deflateEnd(&m_deflater);
+		}
+#endif //LIBGS_ENABLE_ZLIB
+	}
+
+public:
+	template <core_concepts::char_type CharT>
+	[[nodiscard]] static std::string header_value(const basic_headers<CharT> &headers, const CharT *key)
+	{
+		auto it = headers.find(key);
+		if( it == headers.end() )
+			return {};
+		return xxtombs(it->second.to_string());
+	}
+
+	[[nodiscard]] static bool contains_token(std::string_view value, std::string_view token)
+	{
+		for(auto &str : string_list::from_string(value, ','))
+		{
+			if( str_to_lower(str_trimmed(str)) == token )
+				return true;
+		}
+		return false;
+	}
+
+	// Parse the first 'permessage-deflate' offer / response and merge it into m_deflate.
+	[[nodiscard]] bool negotiate_deflate(std::string_view extensions)
+	{
+		if( not m_deflate.enable )
+			return false;
+
+		for(auto &offer : string_list::from_string(extensions, ','))
+		{
+			auto params = string_list::from_string(offer, ';');
+			if( params.empty() or str_trimmed(params[0]) != static_string::permessage_deflate )
+				continue;
+
+			auto option = m_deflate;
+			bool client_window_offered = false;
+			bool valid = true;
+
+			for(size_t i=1; i<params.size(); i++)
+			{
+				auto param = str_trimmed(params[i]);
+				auto pos = param.find('=');
+
+				std::string key = str_trimmed(param.substr(0, pos));
+				std::string value = pos == std::string::npos ? std::string() : str_trimmed(param.substr(pos + 1));
+				if( value.size() >= 2 and value.front() == '"' and value.back() == '"' )
+					value = value.substr(1, value.size() - 2);
+
+				if( key == static_string::server_no_context_takeover )
+					option.server_no_context_takeover = true;
+				else if( key == static_string::client_no_context_takeover )
+					option.client_no_context_takeover = true;
+				else if( key == static_string::server_max_window_bits or key == static_string::client_max_window_bits )
+				{
+					auto bits = value.empty() ? 15 : stoi32_or(value, 10, 0);
+					if( bits < 8 or bits > 15 )
+					{
+						valid = false;
+						break;
+					}
+					if( key == static_string::server_max_window_bits )
+						option.server_max_window_bits = std::min<uint8_t>(option.server_max_window_bits, bits);
+					else
+					{
+						client_window_offered = true;
+						if( not value.empty() )
+							option.client_max_window_bits = std::min<uint8_t>(option.client_max_window_bits, bits);
+					}
+				}
+				else
+				{
+					valid = false;
+					break;
+				}
+			}
+			if( not valid )
+				continue;
+			if( m_role == websocket_role::server and not client_window_offered )
+				option.client_max_window_bits = 15;
+
+			m_deflate = option;
+			return init_zlib();
+		}
+		m_deflate.enable = false;
+		return false;
+	}
+
+	[[nodiscard]] std::string deflate_response() const
+	{
+		auto result = std::string(static_string::permessage_deflate);
+		if( m_deflate.server_no_context_takeover )
+			result += std::format("; {}", static_string::server_no_context_takeover);
+		if( m_deflate.client_no_context_takeover )
+			result += std::format("; {}", static_string::client_no_context_takeover);
+		if( m_deflate.server_max_window_bits < 15 )
+			result += std::format("; {}={}", static_string::server_max_window_bits, m_deflate.server_max_window_bits);
+		if( m_deflate.client_max_window_bits < 15 )
+			result += std::format("; {}={}", static_string::client_max_window_bits, m_deflate.client_max_window_bits);
+		return result;
+	}
+
+	[[nodiscard]] std::string deflate_offer() const
+	{
+		auto result = std::format("{}; {}", static_string::permessage_deflate, static_string::client_max_window_bits);
+		if( m_deflate.server_no_context_takeover )
+			result += std::format("; {}", static_string::server_no_context_takeover);
+		if( m_deflate.client_no_context_takeover )
+			result += std::format("; {}", static_string::client_no_context_takeover);
+		if( m_deflate.server_max_window_bits < 15 )
+			result += std::format("; {}={}", static_string::server_max_window_bits, m_deflate.server_max_window_bits);
+		return result;
+	}
+
+public:
+	[[nodiscard]] bool init_zlib()
+	{
+#ifdef LIBGS_ENABLE_ZLIB
+		if( m_zlib_init )
+			return true;
+
+		// zlib does not support a raw deflate window of 8 bits, 9 bits is compatible.
+		int bits = m_role == websocket_role::server ?
+			m_deflate.server_max_window_bits : m_deflate.client_max_window_bits;
+		bits = std::max(bits, 9);
+
+		if( inflateInit2(&m_inflater, -15) != Z_OK )
+			return m_deflate.enable = false;
+
+		if( deflateInit2(&m_deflater, m_deflate.level, Z_DEFLATED, -bits, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+		{
+			inflateEnd(&m_inflater);
+			return m_deflate.enable = false;
+		}
+		m_zlib_init = true;
+		return true;
+#else
+		return m_deflate.enable = false;
+#endif //LIBGS_ENABLE_ZLIB
+	}
+
+	[[nodiscard]] bool own_no_context_takeover() const noexcept
+	{
+		return m_role == websocket_role::server ?
+			m_deflate.server_no_context_takeover : m_deflate.client_no_context_takeover;
+	}
+
+	[[nodiscard]] bool compress(const const_buffer &data, std::string &out)
+	{
+#ifdef LIBGS_ENABLE_ZLIB
+		out.clear();
+		m_deflater.next_in = reinterpret_cast<Bytef*>(const_cast<void*>(data.data()));
+		m_deflater.avail_in = static_cast<uInt>(data.size());
+
+		size_t size = 0;
+		do {
+			out.resize(size + std::max<size_t>(data.size() / 2 + 64, 256));
+			m_deflater.next_out = reinterpret_cast<Bytef*>(out.data() + size);
+			m_deflater.avail_out = static_cast<uInt>(out.size() - size);
+
+			if( deflate(&m_deflater, Z_SYNC_FLUSH) == Z_STREAM_ERROR )
+				return false;
+			size = out.size() - m_deflater.avail_out;
+		}
+		while( m_deflater.avail_out == 0 );
+		out.resize(size);
+
+		if( out.size() >= 4 and memcmp(out.data() + out.size() - 4, static_string::deflate_tail, 4) == 0 )
+			out.resize(out.size() - 4);
+		if( own_no_context_takeover() )
+			deflateReset(&m_deflater);
+		return true;
+#else
+		ignore_unused(data, out);
+		return false;
+#endif //LIBGS_ENABLE_ZLIB
+	}
+
+public:
+	[[nodiscard]] awaitable<void> co_fill(error_code &error)
+	{
+		using namespace libgs::operators;
+		if( m_rpos > 0 )
+		{
+			m_rbuf.erase(0, m_rpos);
+			m_rpos = 0;
+		}
+		auto size = m_rbuf.size();
+		m_rbuf.resize(size + read_block_size);
+
+		auto res = co_await m_socket.async_read_some (
+			buffer(m_rbuf.data() + size, read_block_size), use_awaitable | error
+		);
+		m_rbuf.resize(size + res);
+		if( not error and res == 0 )
+			error = asio::error::eof;
+		co_return ;
+	}
+
+	// Reads raw payload bytes of the current frame, buffered bytes first, then straight from the socket.
+	[[nodiscard]] awaitable<size_t> co_read_payload(void *dst, size_t size, error_code &error)
+	{
+		using namespace libgs::operators;
+		size = static_cast<size_t>(std::min<uint64_t>(size, m_frame_remain));
+		if( size == 0 )
+			co_return 0;
+
+		size_t res = 0;
+		if( m_rpos < m_rbuf.size() )
+		{
+			res = std::min(size, m_rbuf.size() - m_rpos);
+			memcpy(dst, m_rbuf.data() + m_rpos, res);
+			m_rpos += res;
+		}
+		else
+		{
+			res = co_await m_socket.async_read_some(buffer(dst, size), use_awaitable | error);
+			if( error )
+				co_return 0;
+			else if( res == 0 )
+			{
+				error = asio::error::eof;
+				co_return 0;
+			}
+		}
+		if( m_frame.masked )
+			websocket_frame::mask(dst, res, m_frame.mask_key, m_frame_offset);
+
+		m_frame_offset += res;
+		m_frame_remain -= res;
+		co_return res;
+	}
+
+	[[nodiscard]] awaitable<bool> co_read_header(error_code &error)
+	{
+		for(;;)
+		{
+			auto size = websocket_frame::decode_header (
+				buffer(m_rbuf.data() + m_rpos, m_rbuf.size() - m_rpos), m_frame, m_deflate.enable, error
+			);
+			if( error )
+				co_return false;
+			else if( size > 0 )
+			{
+				m_rpos += size;
+				break;
+			}
+			co_await co_fill(error);
+			if( error )
+				co_return false;
+		}
+		if( m_role == websocket_role::server and not m_frame.masked )
+		{
+			error = websocket_frame::make_error_code(websocket_errno::UMF);
+			co_return false;
+		}
+		else if( m_role == websocket_role::client and m_frame.masked )
+		{
+			error = websocket_frame::make_error_code(websocket_errno::MSF);
+			co_return false;
+		}
+		m_frame_remain = m_frame.payload_length;
+		m_frame_offset = 0;
+		co_return true;
+	}
+
+	// Returns true if the frame was a control frame (it has been handled).
+	[[nodiscard]] awaitable<bool> co_handle_control(error_code &error)
+	{
+		if( not websocket_frame::is_control(m_frame.opcode) )
+			co_return false;
+
+		char payload[websocket_frame::max_control_payload];
+		size_t size = 0;
+		while( m_frame_remain > 0 )
+		{
+			size += co_await co_read_payload(payload + size, sizeof(payload) - size, error);
+			if( error )
+				co_return true;
+		}
+		if( m_frame.opcode == opcode_t::ping )
+			co_await co_send_frame(opcode_t::pong, true, false, {payload, size}, error);
+
+		else if( m_frame.opcode == opcode_t::close )
+		{
+			m_close_received = true;
+			m_close_code = websocket_close_code::no_status;
+			if( size >= 2 )
+				m_close_code = static_cast<close_code_t>((static_cast<uint8_t>(payload[0]) << 8) | static_cast<uint8_t>(payload[1]));
+
+			if( not m_close_sent )
+			{
+				error_code _error;
+				co_await co_send_close(m_close_code == websocket_close_code::no_status ?
+					websocket_close_code::normal : m_close_code, {}, _error);
+			}
+			sock_helper_t(m_socket).close();
+			error = websocket_frame::make_error_code(websocket_errno::CBP);
+		}
+		co_return true;
+	}
+
+	[[nodiscard]] awaitable<bool> co_next_data_frame(error_code &error)
+	{
+		for(;;)
+		{
+			if( not co_await co_read_header(error) )
+				co_return false;
+			else if( co_await co_handle_control(error) )
+			{
+				if( error )
+					co_return false;
+				continue;
+			}
+			if( m_frame.opcode == opcode_t::continuation )
+			{
+				if( not m_in_message )
+				{
+					error = websocket_frame::make_error_code(websocket_errno::UCF);
+					co_return false;
+				}
+				else if( m_frame.rsv1 )
+				{
+					error = websocket_frame::make_error_code(websocket_errno::RBNZ);
+					co_return false;
+				}
+			}
+			else if( m_in_message )
+			{
+				error = websocket_frame::make_error_code(websocket_errno::ECF);
+				co_return false;
+			}
+			else
+			{
+				m_in_message = true;
+				m_message_done = false;
+				m_message_opcode = m_frame.opcode;
+				m_message_compressed = m_frame.rsv1;
+				m_message_size = 0;
+				m_tail_fed = false;
+			}
+			if( not m_message_compressed )
+			{
+				m_message_size += m_frame.payload_length;
+				if( m_message_size > m_max_message_size )
+				{
+					error = websocket_frame::make_error_code(websocket_errno::MTL);
+					co_return false;
+				}
+			}
+			m_in_frame = true;
+			co_return true;
+		}
+	}
+
+	void frame_done() noexcept
+	{
+		m_in_frame = false;
+		if( m_frame.fin )
+		{
+			m_in_message = false;
+			m_message_done = true;
+		}
+	}
+
+	[[nodiscard]] awaitable<size_t> co_read_some(const mutable_buffer &buf, error_code &error)
+	{
+		error = error_code();
+		if( m_close_received )
+		{
+			error = websocket_frame::make_error_code(websocket_errno::CBP);
+			co_return 0;
+		}
+		for(;;)
+		{
+			if( not m_in_frame and not co_await co_next_data_frame(error) )
+				break;
+
+			if( m_message_compressed )
+			{
+				auto res = co_await co_inflate_some(buf, error);
+				if( error )
+					break;
+				else if( res > 0 or m_message_done )
+					co_return res;
+				continue;
+			}
+			if( m_frame_remain == 0 )
+			{
+				frame_done();
+				if( m_message_done )
+					co_return 0;
+				continue;
+			}
+			auto res = co_await co_read_payload(buf.data(), buf.size(), error);
+			if( error )
+				break;
+			else if( m_frame_remain == 0 )
+				frame_done();
+			co_return res;
+		}
+		if( error.value() == static_cast<int>(websocket_errno::MTL) )
+		{
+			error_code _error;
+			co_await co_send_close(websocket_close_code::message_too_big, {}, _error);
+		}
+		else if( &error.category() == &detail::websocket_error_category::instance() and
+				 error.value() != static_cast<int>(websocket_errno::CBP) )
+		{
+			error_code _error;
+			co_await co_send_close(websocket_close_code::protocol_error, {}, _error);
+		}
+		co_return 0;
+	}
+
+	[[nodiscard]] awaitable<size_t> co_inflate_some(const mutable_buffer &buf, error_code &error)
+	{
+#ifdef LIBGS_ENABLE_ZLIB
+		for(;;)
+		{
+			if( m_zin_pos < m_zin.size() or m_inflate_pending )
+			{
+				m_inflater.next_in = reinterpret_cast<Bytef*>(m_zin.data() + m_zin_pos);
+				m_inflater.avail_in = static_cast<uInt>(m_zin.size() - m_zin_pos);
+				m_inflater.next_out = static_cast<Bytef*>(buf.data());
+				m_inflater.avail_out = static_cast<uInt>(buf.size());
+
+				auto res = inflate(&m_inflater, Z_SYNC_FLUSH);
+				if( res != Z_OK and res != Z_BUF_ERROR and res != Z_STREAM_END )
+				{
+					error = websocket_frame::make_error_code(websocket_errno::CPE);
+					co_return 0;
+				}
+				m_zin_pos = m_zin.size() - m_inflater.avail_in;
+				size_t size = buf.size() - m_inflater.avail_out;
+
+				// Output buffer full: there may be more output without new input.
+				m_inflate_pending = m_inflater.avail_out == 0;
+				if( m_zin_pos == m_zin.size() )
+				{
+					m_zin.clear();
+					m_zin_pos = 0;
+				}
+				if( size > 0 )
+				{
+					m_message_size += size;
+					if( m_message_size > m_max_message_size )
+						error = websocket_frame::make_error_code(websocket_errno::MTL);
+					co_return size;
+				}
+			}
+			if( m_frame_remain > 0 )
+			{
+				auto size = m_zin.size();
+				auto block = static_cast<size_t>(std::min<uint64_t>(m_frame_remain, read_block_size));
+
+				m_zin.resize(size + block);
+				auto res = co_await co_read_payload(m_zin.data() + size, block, error);
+				m_zin.resize(size + res);
+				if( error )
+					co_return 0;
+				continue;
+			}
+			if( not m_frame.fin )
+			{
+				m_in_frame = false;
+				co_return 0;
+			}
+			else if( not m_tail_fed )
+			{
+				m_zin.append(static_string::deflate_tail, 4);
+				m_tail_fed = true;
+				continue;
+			}
+			frame_done();
+			co_return 0;
+		}
+#else
+		ignore_unused(buf);
+		error = websocket_frame::make_error_code(websocket_errno::CPE);
+		co_return 0;
+#endif //LIBGS_ENABLE_ZLIB
+	}
+
+public:
+	[[nodiscard]] websocket_frame_header make_header(opcode_t opcode, bool fin, bool rsv1, size_t size) const
+	{
+		websocket_frame_header header;
+		header.fin = fin;
+		header.rsv1 = rsv1;
+		header.opcode = opcode;
+		header.payload_length = size;
+		if( m_role == websocket_role::client )
+		{
+			header.masked = true;
+			header.mask_key = websocket_frame::make_mask_key();
+		}
+		return header;
+	}
+
+	// Appends the frame to 'buffers', 'storage' keeps the header and a masked copy of the payload alive.
+	void append_frame (
+		std::vector<const_buffer> &buffers, std::string &storage,
+		opcode_t opcode, bool fin, bool rsv1, const const_buffer &payload
+	) const
+	{
+		auto header = make_header(opcode, fin, rsv1, payload.size());
+		websocket_frame::header_buffer_t header_buf;
+		auto header_size = websocket_frame::encode_header(header, header_buf);
+
+		storage.clear();
+		storage.append(reinterpret_cast<const char*>(header_buf.data()), header_size);
+		if( not header.masked )
+		{
+			buffers.emplace_back(storage.data(), storage.size());
+			if( payload.size() > 0 )
+				buffers.emplace_back(payload);
+			return ;
+		}
+		storage.append(static_cast<const char*>(payload.data()), payload.size());
+		websocket_frame::mask(storage.data() + header_size, payload.size(), header.mask_key);
+		buffers.emplace_back(storage.data(), storage.size());
+	}
+
+	[[nodiscard]] awaitable<size_t> co_write_buffers(const std::vector<const_buffer> &buffers, error_code &error)
+	{
+		co_unique_lock lock(m_write_mutex);
+		co_await lock.lock();
+		co_return co_await co_write_locked(buffers, error);
+	}
+
+	// The caller holds 'm_write_mutex'.
+	[[nodiscard]] awaitable<size_t> co_write_locked(const std::vector<const_buffer> &buffers, error_code &error)
+	{
+		using namespace libgs::operators;
+		co_return co_await asio::async_write(m_socket, buffers, use_awaitable | error);
+	}
+
+	awaitable<void> co_send_frame(opcode_t opcode, bool fin, bool rsv1, const const_buffer &payload, error_code &error)
+	{
+		std::vector<const_buffer> buffers;
+		std::string storage;
+		append_frame(buffers, storage, opcode, fin, rsv1, payload);
+		co_await co_write_buffers(buffers, error);
+		co_return ;
+	}
+
+	awaitable<void> co_send_close(close_code_t code, std::string_view reason, error_code &error)
+	{
+		if( m_close_sent )
+			co_return ;
+		m_close_sent = true;
+
+		char payload[websocket_frame::max_control_payload];
+		payload[0] = static_cast<char>(code >> 8);
+		payload[1] = static_cast<char>(code & 0xFF);
+
+		auto size = std::min(reason.size(), sizeof(payload) - 2);
+		memcpy(payload + 2, reason.data(), size);
+		co_await co_send_frame(opcode_t::close, true, false, {payload, size + 2}, error);
+		co_return ;
+	}
+
+	[[nodiscard]] awaitable<size_t> co_write_message(const const_buffer &data, opcode_t opcode, error_code &error)
+	{
+		error = error_code();
+		if( m_close_sent )
+		{
+			error = asio::error::shut_down;
+			co_return 0;
+		}
+		std::vector<const_buffer> buffers;
+		std::string storage;
+
+		// With context takeover the peer inflates in wire order, so compressing
+		// and writing must not interleave with another writer.
+		co_unique_lock lock(m_write_mutex);
+		co_await lock.lock();
+
+		if( m_deflate.enable and data.size() >= m_deflate.min_size )
+		{
+			std::string compressed;
+			if( not compress(data, compressed) )
+			{
+				error = websocket_frame::make_error_code(websocket_errno::CPE);
+				co_return 0;
+			}
+			append_frame(buffers, storage, opcode, true, true, buffer(compressed));
+			co_await co_write_locked(buffers, error);
+		}
+		else
+		{
+			append_frame(buffers, storage, opcode, true, false, data);
+			co_await co_write_locked(buffers, error);
+		}
+		co_return error ? 0 : data.size();
+	}
+
+public:
+	socket_t m_socket;
+	websocket_role m_role;
+	websocket_deflate_option m_deflate;
+
+	std::string m_rbuf;
+	size_t m_rpos = 0;
+
+	websocket_frame_header m_frame {};
+	uint64_t m_frame_remain = 0;
+	uint64_t m_frame_offset = 0;
+	bool m_in_frame = false;
+
+	bool m_in_message = false;
+	bool m_message_done = true;
+	bool m_message_compressed = false;
+	opcode_t m_message_opcode = opcode_t::text;
+	size_t m_message_size = 0;
+	size_t m_max_message_size = 0x1000000;
+
+	bool m_write_in_message = false;
+	co_mutex m_write_mutex;
+
+	bool m_close_sent = false;
+	bool m_close_received = false;
+	close_code_t m_close_code = websocket_close_code::no_status;
+
+	std::string m_zin;
+	size_t m_zin_pos = 0;
+	bool m_inflate_pending = false;
+	bool m_tail_fed = false;
+
+#ifdef LIBGS_ENABLE_ZLIB
+	z_stream m_inflater {};
+	z_stream m_deflater {};
+	bool m_zlib_init = false;
+#endif //LIBGS_ENABLE_ZLIB
+};
+
+template <concepts::stream Stream>
+basic_websocket<Stream>::basic_websocket
+(socket_t &&socket, websocket_role role, const websocket_deflate_option &deflate) :
+	m_impl(new impl(std::move(socket), role, deflate))
+{
+
+}
+
+template <concepts::stream Stream>
+basic_websocket<Stream>::~basic_websocket()
+{
+	delete m_impl;
+}
+
+template <concepts::stream Stream>
+basic_websocket<Stream>::basic_websocket(basic_websocket &&other) noexcept :
+	m_impl(other.m_impl)
+{
+	other.m_impl = nullptr;
+}
+
+template <concepts::stream Stream>
+basic_websocket<Stream> &basic_websocket<Stream>::operator=(basic_websocket &&other) noexcept
+{
+	if( this == &other )
+		return *this;
+	delete m_impl;
+	m_impl = other.m_impl;
+	other.m_impl = nullptr;
+	return *this;
+}
+
+template <concepts::stream Stream>
+template <core_concepts::char_type CharT>
+bool basic_websocket<Stream>::is_upgrade(method_t method, const basic_headers<CharT> &headers) noexcept
+{
+	if( method != method_t::GET )
+		return false;
+
+	auto upgrade = impl::header_value(headers, basic_header<CharT>::upgrade);
+	auto connection = impl::header_value(headers, basic_header<CharT>::connection);
+
+	return str_to_lower(str_trimmed(upgrade)) == detail::string_pool<char>::websocket and
+		   impl::contains_token(connection, detail::string_pool<char>::upgrade);
+}
+
+template <concepts::stream Stream>
+template <core_concepts::char_type CharT>
+awaitable<void> basic_websocket<Stream>::co_accept(const basic_headers<CharT> &request_headers, error_code &error)
+{
+	using namespace libgs::operators;
+	using header_t = basic_header<CharT>;
+
+	error = error_code();
+	auto key = impl::header_value(request_headers, header_t::sec_websocket_key);
+	auto version = impl::header_value(request_headers, header_t::sec_websocket_version);
+
+	if( key.empty() or str_trimmed(version) != impl::static_string::version )
+	{
+		constexpr std::string_view response =
+			"HTTP/1.1 426 Upgrade Required\r\n"
+			"Sec-WebSocket-Version: 13\r\n"
+			"Content-Length: 0\r\n\r\n";
+
+		co_await asio::async_write(m_impl->m_socket, buffer(response), use_awaitable | error);
+		if( not error )
+			error = websocket_frame::make_error_code(websocket_errno::IHS);
+		co_return ;
+	}
+	auto response = std::format (
+		"HTTP/1.1 101 Switching Protocols\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Accept: {}\r\n",
+		websocket_frame::handshake_accept(key)
+	);
+	auto extensions = impl::header_value(request_headers, header_t::sec_websocket_extensions);
+	if( m_impl->negotiate_deflate(extensions) )
+		response += std::format("Sec-WebSocket-Extensions: {}\r\n", m_impl->deflate_response());
+
+	response += "\r\n";
+	co_await asio::async_write(m_impl->m_socket, buffer(response), use_awaitable | error);
+	co_return ;
+}
+
+template <concepts::stream Stream>
+template <core_concepts::char_type CharT>
+awaitable<void> basic_websocket<Stream>::co_accept(const basic_headers<CharT> &request_headers)
+{
+	error_code error;
+	co_await co_accept(request_headers, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_accept");
+	co_return ;
+}
+
+template <concepts::stream Stream>
+awaitable<void> basic_websocket<Stream>::co_handshake(std::string_view host, std::string_view path, error_code &error)
+{
+	using namespace libgs::operators;
+	error = error_code();
+
+	auto key = websocket_frame::make_handshake_key();
+	auto request = std::format (
+		"GET {} HTTP/1.1\r\n"
+		"Host: {}\r\n"
+		"Upgrade: websocket\r\n"
+		"Connection: Upgrade\r\n"
+		"Sec-WebSocket-Key: {}\r\n"
+		"Sec-WebSocket-Version: {}\r\n",
+		path.empty() ? "/" : path, host, key, impl::static_string::version
+	);
+	if( m_impl->m_deflate.enable )
+		request += std::format("Sec-WebSocket-Extensions: {}\r\n", m_impl->deflate_offer());
+	request += "\r\n";
+
+	co_await asio::async_write(m_impl->m_socket, buffer(request), use_awaitable | error);
+	if( error )
+		co_return ;
+
+	size_t pos = std::string::npos;
+	while( (pos = m_impl->m_rbuf.find("\r\n\r\n")) == std::string::npos )
+	{
+		if( m_impl->m_rbuf.size() > 0x2000 )
+		{
+			error = websocket_frame::make_error_code(websocket_errno::IHS);
+			co_return ;
+		}
+		co_await m_impl->co_fill(error);
+		if( error )
+			co_return ;
+	}
+	auto lines = string_list::from_string(std::string_view(m_impl->m_rbuf).substr(0, pos), "\r\n");
+	m_impl->m_rpos = pos + 4;
+
+	if( lines.empty() or not lines[0].starts_with("HTTP/1.1 101") )
+	{
+		error = websocket_frame::make_error_code(websocket_errno::IHS);
+		co_return ;
+	}
+	headers response_headers;
+	for(size_t i=1; i<lines.size(); i++)
+	{
+		auto colon = lines[i].find(':');
+		if( colon != std::string::npos )
+			response_headers[str_trimmed(lines[i].substr(0, colon))] = str_trimmed(lines[i].substr(colon + 1));
+	}
+	auto accept = impl::header_value(response_headers, header::sec_websocket_accept);
+	if( accept != websocket_frame::handshake_accept(key) )
+	{
+		error = websocket_frame::make_error_code(websocket_errno::IHS);
+		co_return ;
+	}
+	auto extensions = impl::header_value(response_headers, header::sec_websocket_extensions);
+	if( extensions.empty() )
+		m_impl->m_deflate.enable = false;
+	else if( not m_impl->negotiate_deflate(extensions) )
+		error = websocket_frame::make_error_code(websocket_errno::IHS);
+	co_return ;
+}
+
+template <concepts::stream Stream>
+awaitable<void> basic_websocket<Stream>::co_handshake(std::string_view host, std::string_view path)
+{
+	error_code error;
+	co_await co_handshake(host, path, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_handshake");
+	co_return ;
+}
+
+template <concepts::stream Stream>
+awaitable<websocket_message> basic_websocket<Stream>::co_read(error_code &error)
+{
+	websocket_message message;
+	do {
+		// Grows with what arrives, not with the length the peer announces.
+		auto size = message.data.size();
+		auto block = impl::read_block_size;
+
+		message.data.resize(size + block);
+		auto res = co_await co_read_some(buffer(message.data.data() + size, block), error);
+		message.data.resize(size + res);
+		if( error )
+			co_return websocket_message{};
+	}
+	while( not m_impl->m_message_done );
+	message.opcode = m_impl->m_message_opcode;
+	co_return message;
+}
+
+template <concepts::stream Stream>
+awaitable<websocket_message> basic_websocket<Stream>::co_read()
+{
+	error_code error;
+	auto message = co_await co_read(error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_read");
+	co_return message;
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_read_some(const mutable_buffer &buf, error_code &error)
+{
+	co_return co_await m_impl->co_read_some(buf, error);
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_read_some(const mutable_buffer &buf)
+{
+	error_code error;
+	auto res = co_await co_read_some(buf, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_read_some");
+	co_return res;
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_write(const const_buffer &data, opcode_t opcode, error_code &error)
+{
+	if( m_impl->m_write_in_message )
+	{
+		error = websocket_frame::make_error_code(websocket_errno::ECF);
+		co_return 0;
+	}
+	co_return co_await m_impl->co_write_message(data, opcode, error);
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_write(const const_buffer &data, opcode_t opcode)
+{
+	error_code error;
+	auto res = co_await co_write(data, opcode, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_write");
+	co_return res;
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_write_some
+(const const_buffer &data, bool fin, opcode_t opcode, error_code &error)
+{
+	error = error_code();
+	if( m_impl->m_close_sent )
+	{
+		error = asio::error::shut_down;
+		co_return 0;
+	}
+	// Fragments are sent uncompressed, permessage-deflate is optional per message.
+	co_await m_impl->co_send_frame (
+		m_impl->m_write_in_message ? opcode_t::continuation : opcode, fin, false, data, error
+	);
+	if( error )
+		co_return 0;
+	m_impl->m_write_in_message = not fin;
+	co_return data.size();
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_write_some(const const_buffer &data, bool fin, opcode_t opcode)
+{
+	error_code error;
+	auto res = co_await co_write_some(data, fin, opcode, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_write_some");
+	co_return res;
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_write_batch
+(std::span<const const_buffer> messages, opcode_t opcode, error_code &error)
+{
+	error = error_code();
+	if( m_impl->m_close_sent )
+	{
+		error = asio::error::shut_down;
+		co_return 0;
+	}
+	else if( m_impl->m_write_in_message )
+	{
+		error = websocket_frame::make_error_code(websocket_errno::ECF);
+		co_return 0;
+	}
+	// One gather write for all messages; the storage must not reallocate after the buffers are taken.
+	std::vector<const_buffer> buffers;
+	std::vector<std::string> storage(messages.size());
+	std::vector<std::string> compressed(messages.size());
+
+	buffers.reserve(messages.size() * 2);
+	size_t sum = 0;
+
+	// Compressed under the write lock, the deflate stream follows the wire order.
+	co_unique_lock lock(m_impl->m_write_mutex);
+	co_await lock.lock();
+
+	for(size_t i=0; i<messages.size(); i++)
+	{
+		auto &data = messages[i];
+		if( m_impl->m_deflate.enable and data.size() >= m_impl->m_deflate.min_size )
+		{
+			if( not m_impl->compress(data, compressed[i]) )
+			{
+				error = websocket_frame::make_error_code(websocket_errno::CPE);
+				co_return 0;
+			}
+			m_impl->append_frame(buffers, storage[i], opcode, true, true, buffer(compressed[i]));
+		}
+		else
+			m_impl->append_frame(buffers, storage[i], opcode, true, false, data);
+		sum += data.size();
+	}
+	co_await m_impl->co_write_locked(buffers, error);
+	co_return error ? 0 : sum;
+}
+
+template <concepts::stream Stream>
+awaitable<size_t> basic_websocket<Stream>::co_write_batch(std::span<const const_buffer> messages, opcode_t opcode)
+{
+	error_code error;
+	auto res = co_await co_write_batch(messages, opcode, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_write_batch");
+	co_return res;
+}
+
+template <concepts::stream Stream>
+awaitable<void> basic_websocket<Stream>::co_ping(const const_buffer &data, error_code &error)
+{
+	error = error_code();
+	auto size = std::min(data.size(), websocket_frame::max_control_payload);
+	co_await m_impl->co_send_frame(opcode_t::ping, true, false, {data.data(), size}, error);
+	co_return ;
+}
+
+template <concepts::stream Stream>
+awaitable<void> basic_websocket<Stream>::co_ping(const const_buffer &data)
+{
+	error_code error;
+	co_await co_ping(data, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_ping");
+	co_return ;
+}
+
+template <concepts::stream Stream>
+awaitable<void> basic_websocket<Stream>::co_close(close_code_t code, std::string_view reason, error_code &error)
+{
+	using namespace std::chrono_literals;
+	error = error_code();
+
+	co_await m_impl->co_send_close(code, reason, error);
+	if( error or m_impl->m_close_received )
+	{
+		socket_operation_helper<socket_t>(m_impl->m_socket).close();
+		co_return ;
+	}
+	// Wait for the peer's close frame, the data received in the meantime is discarded.
+	auto drain = [this]() -> awaitable<void>
+	{
+		char buf[0x1000];
+		error_code _error;
+		while( not _error )
+			co_await m_impl->co_read_some(buffer(buf, sizeof(buf)), _error);
+		co_return ;
+	};
+	co_await (drain() or sleep_for(get_executor(), 5s));
+	socket_operation_helper<socket_t>(m_impl->m_socket).close();
+	co_return ;
+}
+
+template <concepts::stream Stream>
+awaitable<void> basic_websocket<Stream>::co_close(close_code_t code, std::string_view reason)
+{
+	error_code error;
+	co_await co_close(code, reason, error);
+	if( error )
+		throw std::system_error(error, "libgs::http::websocket::co_close");
+	co_return ;
+}
+
+template <concepts::stream Stream>
+basic_websocket<Stream> &basic_websocket<Stream>::set_max_message_size(size_t size) noexcept
+{
+	m_impl->m_max_message_size = size;
+	return *this;
+}
+
+template <concepts::stream Stream>
+size_t basic_websocket<Stream>::max_message_size() const noexcept
+{
+	return m_impl->m_max_message_size;
+}
+
+template <concepts::stream Stream>
+bool basic_websocket<Stream>::is_message_done() const noexcept
+{
+	return m_impl->m_message_done;
+}
+
+template <concepts::stream Stream>
+typename basic_websocket<Stream>::opcode_t basic_websocket<Stream>::message_opcode() const noexcept
+{
+	return m_impl->m_message_opcode;
+}
+
+template <concepts::stream Stream>
+bool basic_websocket<Stream>::is_open() const noexcept
+{
+	return not m_impl->m_close_sent and not m_impl->m_close_received;
+}
+
+template <concepts::stream Stream>
+typename basic_websocket<Stream>::close_code_t basic_websocket<Stream>::close_code() const noexcept
+{
+	return m_impl->m_close_code;
+}
+
+template <concepts::stream Stream>
+websocket_role basic_websocket<Stream>::role() const noexcept
+{
+	return m_impl->m_role;
+}
+
+template <concepts::stream Stream>
+const websocket_deflate_option &basic_websocket<Stream>::deflate_option() const noexcept
+{
+	return m_impl->m_deflate;
+}
+
+template <concepts::stream Stream>
+typename basic_websocket<Stream>::executor_t basic_websocket<Stream>::get_executor() noexcept
+{
+	return m_impl->m_socket.get_executor();
+}
+
+template <concepts::stream Stream>
+basic_websocket<Stream> &basic_websocket<Stream>::cancel() noexcept
+{
+	socket_operation_helper<socket_t>(m_impl->m_socket).cancel();
+	return *this;
+}
+
+template <concepts::stream Stream>
+const typename basic_websocket<Stream>::socket_t &basic_websocket<Stream>::next_layer() const noexcept
+{
+	return m_impl->m_socket;
+}
+
+template <concepts::stream Stream>
+typename basic_websocket<Stream>::socket_t &basic_websocket<Stream>::next_layer() noexcept
+{
+	return m_impl->m_socket;
+}
+
+} //namespace libgs::http
+
+
+#endif //LIBGS_HTTP_WEBSOCKET_DETAIL_WEBSOCKET_H
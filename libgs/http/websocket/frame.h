@@ -0,0 +1,142 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_WEBSOCKET_FRAME_H
+#define LIBGS_HTTP_WEBSOCKET_FRAME_H
+
+#include <libgs/http/types.h>
+#include <array>
+
+namespace libgs::http
+{
+
+#define LIBGS_HTTP_WEBSOCKET_ERRNO \
+X_MACRO( RBNZ , 10100 , "Reserved bits are not zero."          ) \
+X_MACRO( IOP  , 10101 , "Invalid opcode."                      ) \
+X_MACRO( CFTL , 10102 , "Control frame too long."              ) \
+X_MACRO( CFF  , 10103 , "Control frame is fragmented."         ) \
+X_MACRO( UMF  , 10104 , "Client frame is not masked."          ) \
+X_MACRO( MSF  , 10105 , "Server frame is masked."              ) \
+X_MACRO( MTL  , 10106 , "Message too long."                    ) \
+X_MACRO( UCF  , 10107 , "Unexpected continuation frame."       ) \
+X_MACRO( ECF  , 10108 , "Expected a continuation frame."       ) \
+X_MACRO( IPL  , 10109 , "Invalid payload length."              ) \
+X_MACRO( IHS  , 10110 , "Invalid websocket handshake."         ) \
+X_MACRO( CPE  , 10111 , "Compression error."                   ) \
+X_MACRO( CBP  , 10112 , "The connection was closed by peer."   )
+
+enum class websocket_errno
+{
+#define X_MACRO(e,v,d) e=(v),
+	LIBGS_HTTP_WEBSOCKET_ERRNO
+#undef X_MACRO
+};
+
+#define LIBGS_HTTP_WEBSOCKET_OPCODE_TABLE \
+X_MACRO( continuation , 0x0 ) \
+X_MACRO( text         , 0x1 ) \
+X_MACRO( binary       , 0x2 ) \
+X_MACRO( close        , 0x8 ) \
+X_MACRO( ping         , 0x9 ) \
+X_MACRO( pong         , 0xA )
+
+enum class websocket_opcode : uint8_t
+{
+#define X_MACRO(e,v) e=(v),
+	LIBGS_HTTP_WEBSOCKET_OPCODE_TABLE
+#undef X_MACRO
+};
+
+#define LIBGS_HTTP_WEBSOCKET_CLOSE_CODE_TABLE \
+X_MACRO( normal              , 1000 ) \
+X_MACRO( going_away          , 1001 ) \
+X_MACRO( protocol_error      , 1002 ) \
+X_MACRO( unsupported_data    , 1003 ) \
+X_MACRO( no_status           , 1005 ) \
+X_MACRO( abnormal            , 1006 ) \
+X_MACRO( invalid_payload     , 1007 ) \
+X_MACRO( policy_violation    , 1008 ) \
+X_MACRO( message_too_big     , 1009 ) \
+X_MACRO( mandatory_extension , 1010 ) \
+X_MACRO( internal_error      , 1011 )
+
+struct LIBGS_HTTP_VAPI websocket_close_code
+{
+	using type = uint16_t;
+#define X_MACRO(e,v) static constexpr type e = (v);
+	LIBGS_HTTP_WEBSOCKET_CLOSE_CODE_TABLE
+#undef X_MACRO
+};
+using websocket_close_code_t = websocket_close_code::type;
+
+struct LIBGS_HTTP_VAPI websocket_frame_header
+{
+	bool fin = true;
+	bool rsv1 = false; // permessage-deflate
+	websocket_opcode opcode = websocket_opcode::text;
+	bool masked = false;
+	std::array<uint8_t,4> mask_key {};
+	uint64_t payload_length = 0;
+};
+
+class LIBGS_HTTP_VAPI websocket_frame
+{
+public:
+	static constexpr size_t max_header_size = 14;
+	static constexpr size_t max_control_payload = 125;
+	using header_buffer_t = std::array<uint8_t,max_header_size>;
+
+public:
+	[[nodiscard]] static size_t encode_header (
+		const websocket_frame_header &header, header_buffer_t &buf
+	) noexcept;
+
+	// Returns the header size, 0 means more data is needed.
+	[[nodiscard]] static size_t decode_header (
+		const const_buffer &buf, websocket_frame_header &header, bool allow_rsv1, error_code &error
+	) noexcept;
+
+	// Xor the payload with the mask key, 'offset' is the position of 'data' in the frame payload.
+	static void mask(void *data, size_t size, const std::array<uint8_t,4> &key, size_t offset = 0) noexcept;
+
+public:
+	[[nodiscard]] static std::array<uint8_t,4> make_mask_key();
+	[[nodiscard]] static std::string make_handshake_key();
+	[[nodiscard]] static std::string handshake_accept(std::string_view key);
+
+public:
+	[[nodiscard]] static bool is_control(websocket_opcode opcode) noexcept;
+	[[nodiscard]] static bool opcode_check(uint8_t opcode) noexcept;
+	[[nodiscard]] static error_code make_error_code(websocket_errno errc);
+};
+
+} //namespace libgs::http
+#include <libgs/http/websocket/detail/frame.h>
+
+
+#endif //LIBGS_HTTP_WEBSOCKET_FRAME_H
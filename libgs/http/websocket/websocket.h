@@ -0,0 +1,165 @@
+
+/************************************************************************************
+*                                                                                   *
+*   Copyright (c) 2024 Xiaoqiang <username_nullptr@163.com>                         *
+*                                                                                   *
+*   This file is part of LIBGS                                                      *
+*   License: MIT License                                                            *
+*                                                                                   *
+*   Permission is hereby granted, free of charge, to any person obtaining a copy    *
+*   of this software and associated documentation files (the "Software"), to deal   *
+*   in the Software without restriction, including without limitation the rights    *
+*   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell       *
+*   copies of the Software, and to permit persons to whom the Software is           *
+*   furnished to do so, subject to the following conditions:                        *
+*                                                                                   *
+*   The above copyright notice and this permission notice shall be included in      *
+*   all copies or substantial portions of the Software.                             *
+*                                                                                   *
+*   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR      *
+*   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,        *
+*   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE     *
+*   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER          *
+*   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,   *
+*   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE   *
+*   SOFTWARE.                                                                       *
+*                                                                                   *
+*************************************************************************************/
+
+#ifndef LIBGS_HTTP_WEBSOCKET_WEBSOCKET_H
+#define LIBGS_HTTP_WEBSOCKET_WEBSOCKET_H
+
+#include <libgs/http/websocket/frame.h>
+#include <libgs/http/cxx/socket_operation_helper.h>
+#include <libgs/core/coro/mutex.h>
+#include <span>
+
+namespace libgs::http
+{
+
+enum class websocket_role
+{
+	server, client
+};
+
+struct LIBGS_HTTP_VAPI websocket_deflate_option
+{
+	// permessage-deflate (RFC 7692), only negotiated when built with LIBGS_ENABLE_ZLIB.
+	bool enable = false;
+	bool server_no_context_takeover = false;
+	bool client_no_context_takeover = false;
+	uint8_t server_max_window_bits = 15;
+	uint8_t client_max_window_bits = 15;
+	int level = 6;
+	size_t min_size = 64;
+};
+
+struct LIBGS_HTTP_VAPI websocket_message
+{
+	websocket_opcode opcode = websocket_opcode::text;
+	std::string data {};
+};
+
+template <concepts::stream Stream>
+class LIBGS_HTTP_TAPI basic_websocket
+{
+	LIBGS_DISABLE_COPY(basic_websocket)
+
+public:
+	using socket_t = Stream;
+	using executor_t = typename socket_t::executor_type;
+	using opcode_t = websocket_opcode;
+	using close_code_t = websocket_close_code_t;
+
+public:
+	basic_websocket(socket_t &&socket, websocket_role role, const websocket_deflate_option &deflate = {});
+	~basic_websocket();
+
+	basic_websocket(basic_websocket &&other) noexcept;
+	basic_websocket &operator=(basic_websocket &&other) noexcept;
+
+public:
+	template <core_concepts::char_type CharT>
+	[[nodiscard]] static bool is_upgrade(method_t method, const basic_headers<CharT> &headers) noexcept;
+
+	template <core_concepts::char_type CharT>
+	[[nodiscard]] awaitable<void> co_accept(const basic_headers<CharT> &request_headers, error_code &error);
+
+	template <core_concepts::char_type CharT>
+	[[nodiscard]] awaitable<void> co_accept(const basic_headers<CharT> &request_headers);
+
+	[[nodiscard]] awaitable<void> co_handshake(std::string_view host, std::string_view path, error_code &error);
+	[[nodiscard]] awaitable<void> co_handshake(std::string_view host, std::string_view path);
+
+public:
+	[[nodiscard]] awaitable<websocket_message> co_read(error_code &error);
+	[[nodiscard]] awaitable<websocket_message> co_read();
+
+	[[nodiscard]] awaitable<size_t> co_read_some(const mutable_buffer &buf, error_code &error);
+	[[nodiscard]] awaitable<size_t> co_read_some(const mutable_buffer &buf);
+
+public:
+	awaitable<size_t> co_write(const const_buffer &data, opcode_t opcode, error_code &error);
+	awaitable<size_t> co_write(const const_buffer &data, opcode_t opcode = opcode_t::text);
+
+	awaitable<size_t> co_write_some(const const_buffer &data, bool fin, opcode_t opcode, error_code &error);
+	awaitable<size_t> co_write_some(const const_buffer &data, bool fin, opcode_t opcode = opcode_t::text);
+
+	awaitable<size_t> co_write_batch(std::span<const const_buffer> messages, opcode_t opcode, error_code &error);
+	awaitable<size_t> co_write_batch(std::span<const const_buffer> messages, opcode_t opcode = opcode_t::text);
+
+	awaitable<void> co_ping(const const_buffer &data, error_code &error);
+	awaitable<void> co_ping(const const_buffer &data = {});
+
+	awaitable<void> co_close(close_code_t code, std::string_view reason, error_code &error);
+	awaitable<void> co_close(close_code_t code = websocket_close_code::normal, std::string_view reason = {});
+
+public:
+	basic_websocket &set_max_message_size(size_t size) noexcept;
+	[[nodiscard]] size_t max_message_size() const noexcept;
+
+	[[nodiscard]] bool is_message_done() const noexcept;
+	[[nodiscard]] opcode_t message_opcode() const noexcept;
+
+	[[nodiscard]] bool is_open() const noexcept;
+	[[nodiscard]] close_code_t close_code() const noexcept;
+
+	[[nodiscard]] websocket_role role() const noexcept;
+	[[nodiscard]] const websocket_deflate_option &deflate_option() const noexcept;
+
+public:
+	[[nodiscard]] executor_t get_executor() noexcept;
+	basic_websocket &cancel() noexcept;
+
+	[[nodiscard]] const socket_t &next_layer() const noexcept;
+	[[nodiscard]] socket_t &next_layer() noexcept;
+
+private:
+	class impl;
+	impl *m_impl;
+};
+
+template <core_concepts::execution Exec>
+using basic_tcp_websocket = basic_websocket<asio::basic_stream_socket<asio::ip::tcp,Exec>>;
+
+using tcp_websocket = basic_tcp_websocket<asio::any_io_executor>;
+using websocket = tcp_websocket;
+
+} //namespace libgs::http
+#include <libgs/http/websocket/detail/websocket.h>
+
+#ifdef LIBGS_ENABLE_OPENSSL
+namespace libgs::http
+{
+
+template <core_concepts::execution Exec>
+using basic_ssl_tcp_websocket = basic_websocket<asio::ssl::stream<asio::basic_stream_socket<asio::ip::tcp,Exec>>>;
+
+using ssl_tcp_websocket = basic_ssl_tcp_websocket<asio::any_io_executor>;
+using ssl_websocket = ssl_tcp_websocket;
+
+} //namespace libgs::http
+#endif //LIBGS_ENABLE_OPENSSL
+
+
+#endif //LIBGS_HTTP_WEBSOCKET_WEBSOCKET_H
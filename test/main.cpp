@@ -4,6 +4,8 @@
 
 // #include <libgs/http/client.h>
 #include <libgs/http/client/request.h>
+#include <libgs/http/cxx/socket_options.h>
+#include <libgs/http/server.h>
 
 #include <list>
 #include <iostream>
@@ -11,6 +13,226 @@
 using namespace std::chrono_literals;
 // using namespace libgs::operators;
 
+static bool check(const char *name, bool ok)
+{
+	std::cout << (ok ? "[  OK  ] " : "[FAILED] ") << name << std::endl;
+	return ok;
+}
+
+// The socket options policy, read back with getsockopt over loopback.
+static int socket_options_test()
+{
+	using namespace libgs::http;
+	using tcp = asio::ip::tcp;
+
+	asio::io_context ioc;
+	auto options = socket_options::low_latency();
+	options.keep_alive = true;
+	options.receive_buffer_size = 0x10000;
+
+	tcp::acceptor acceptor(ioc);
+	acceptor.open(tcp::v4());
+	apply_socket_options(acceptor, options, socket_option_stage::listen);
+	acceptor.bind({asio::ip::address_v4::loopback(), 0});
+	acceptor.listen();
+
+	tcp::socket client(ioc);
+	client.open(tcp::v4());
+	apply_socket_options(client, options, socket_option_stage::connect);
+	client.connect(acceptor.local_endpoint());
+
+	auto server = acceptor.accept();
+	apply_socket_options(server, options, socket_option_stage::accept);
+
+	int failed = 0;
+	asio::socket_base::reuse_address reuse_address;
+	acceptor.get_option(reuse_address);
+	failed += not check("listen: SO_REUSEADDR", reuse_address.value());
+
+	// Linux reports twice the requested size, the rest is bookkeeping.
+	asio::socket_base::receive_buffer_size receive_buffer_size;
+	client.get_option(receive_buffer_size);
+	failed += not check("connect: SO_RCVBUF", receive_buffer_size.value() >= 0x10000);
+
+	for(auto [stage, socket] : {std::pair{"connect", &client}, std::pair{"accept", &server}})
+	{
+		tcp::no_delay no_delay;
+		socket->get_option(no_delay);
+		failed += not check(std::format("{}: TCP_NODELAY", stage).c_str(), no_delay.value());
+
+		asio::socket_base::keep_alive keep_alive;
+		socket->get_option(keep_alive);
+		failed += not check(std::format("{}: SO_KEEPALIVE", stage).c_str(), keep_alive.value());
+	}
+#ifdef TCP_QUICKACK
+	// The kernel may have left quick-ack mode after the handshake already.
+	rearm_quick_ack(server, options);
+	asio::detail::socket_option::boolean<IPPROTO_TCP,TCP_QUICKACK> quick_ack;
+	server.get_option(quick_ack);
+	failed += not check("accept: TCP_QUICKACK", quick_ack.value());
+#endif //TCP_QUICKACK
+	return failed;
+}
+
+// An idle subscriber outlives the keepalive and gets the comment line instead.
+static int sse_keepalive_test()
+{
+	using namespace libgs::http;
+	using tcp = asio::ip::tcp;
+
+	asio::io_context ioc;
+	tcp::acceptor acceptor(ioc);
+	acceptor.open(tcp::v4());
+	acceptor.bind({asio::ip::address_v4::loopback(), 0});
+	auto endpoint = acceptor.local_endpoint();
+
+	sse_hub hub({.keepalive = 100ms});
+	server http_server(std::move(acceptor), ioc);
+	http_server.on_request<method::GET>("/events",
+	[&](server::context_t &context) -> libgs::awaitable<void> {
+		co_await hub.co_subscribe(context, "topic");
+	})
+	.start();
+
+	size_t pings = 0;
+	libgs::error_code error;
+	asio::co_spawn(ioc, [&]() -> libgs::awaitable<void>
+	{
+		tcp::socket socket(ioc);
+		co_await socket.async_connect(endpoint, libgs::use_awaitable);
+
+		std::string_view head = "GET /events HTTP/1.1\r\nhost: 127.0.0.1\r\n\r\n";
+		co_await asio::async_write(socket, asio::buffer(head), libgs::use_awaitable);
+
+		// Three intervals, the stream must still be up for the later pings.
+		std::string data;
+		asio::steady_timer deadline(ioc, 350ms);
+		deadline.async_wait([&](libgs::error_code){ socket.cancel(); });
+
+		char buf[1024];
+		for(;;)
+		{
+			auto [_error, size] = co_await socket.async_read_some (
+				asio::buffer(buf), asio::as_tuple(libgs::use_awaitable)
+			);
+			if( _error )
+			{
+				error = _error;
+				break;
+			}
+			data.append(buf, size);
+		}
+		for(size_t pos = 0; (pos = data.find(":\n\n", pos)) != std::string::npos; pos += 3)
+			++pings;
+		hub.close();
+		http_server.stop();
+	},
+	asio::detached);
+	ioc.run_for(5s);
+
+	int failed = 0;
+	failed += not check("sse: keepalive keeps the stream", error == asio::error::operation_aborted);
+	failed += not check("sse: keepalive sends ':\\n\\n'", pings >= 2);
+	return failed;
+}
+
+static std::string make_h2_frame(uint8_t type, uint8_t flags, uint32_t stream_id, std::string_view payload)
+{
+	std::string frame {
+		static_cast<char>(payload.size() >> 16), static_cast<char>(payload.size() >> 8),
+		static_cast<char>(payload.size()), static_cast<char>(type), static_cast<char>(flags),
+		static_cast<char>(stream_id >> 24), static_cast<char>(stream_id >> 16),
+		static_cast<char>(stream_id >> 8), static_cast<char>(stream_id)
+	};
+	return frame.append(payload);
+}
+
+// HTTP/2 with prior knowledge over loopback. The stream window is a quarter of the
+// connection window, the four bodies together use up all of its 65535 bytes.
+static int h2c_test()
+{
+	using namespace libgs::http;
+	using tcp = asio::ip::tcp;
+
+	asio::io_context ioc;
+	tcp::acceptor acceptor(ioc);
+	acceptor.open(tcp::v4());
+	acceptor.bind({asio::ip::address_v4::loopback(), 0});
+	auto endpoint = acceptor.local_endpoint();
+
+	server http_server(std::move(acceptor), ioc);
+	http_server.set_h2_option({.initial_window_size = 0x4000})
+	.on_request<method::POST>("/upload",
+	[](server::context_t&) -> libgs::awaitable<void> {
+		co_return ;
+	})
+	.start();
+
+	size_t finished = 0;
+	bool goaway = false;
+	asio::co_spawn(ioc, [&]() -> libgs::awaitable<void>
+	{
+		tcp::socket socket(ioc);
+		co_await socket.async_connect(endpoint, libgs::use_awaitable);
+
+		asio::steady_timer deadline(ioc, 2s);
+		deadline.async_wait([&](libgs::error_code){ socket.close(); });
+
+		auto preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n" + make_h2_frame(0x4, 0, 0, {});
+		co_await asio::async_write(socket, asio::buffer(preface), libgs::use_awaitable);
+
+		std::string data;
+		char buf[0x4000];
+		while( finished < 4 and not goaway )
+		{
+			auto [error, size] = co_await socket.async_read_some (
+				asio::buffer(buf), asio::as_tuple(libgs::use_awaitable)
+			);
+			if( error )
+				break;
+			data.append(buf, size);
+
+			while( data.size() >= 9 )
+			{
+				size_t length = static_cast<uint8_t>(data[0]) << 16 | static_cast<uint8_t>(data[1]) << 8 |
+								static_cast<uint8_t>(data[2]);
+				if( data.size() < 9 + length )
+					break;
+				auto type = static_cast<uint8_t>(data[3]);
+				auto flags = static_cast<uint8_t>(data[4]);
+				data.erase(0, 9 + length);
+
+				if( type == 0x7 )
+					goaway = true;
+				else if( (type == 0x0 or type == 0x1) and (flags & 0x1) )
+					++finished;
+				else if( type == 0x4 and not (flags & 0x1) )
+				{
+					// The server's settings are in, acknowledge them and send the requests.
+					auto requests = make_h2_frame(0x4, 0x1, 0, {});
+					for(uint32_t id=1; id<=7; id+=2)
+					{
+						// :method POST, :scheme http, :path /upload, :authority 127.0.0.1
+						std::string block = "\x83\x86\x04\x07/upload\x01\x09" "127.0.0.1";
+						requests += make_h2_frame(0x1, 0x4, id, block);
+						requests += make_h2_frame(0x0, 0x1, id, std::string(id == 7 ? 0x3FFF : 0x4000, 'x'));
+					}
+					co_await asio::async_write(socket, asio::buffer(requests), libgs::use_awaitable);
+				}
+			}
+		}
+		deadline.cancel();
+		http_server.stop();
+	},
+	asio::detached);
+	ioc.run_for(5s);
+
+	int failed = 0;
+	failed += not check("h2c: no connection error", not goaway);
+	failed += not check("h2c: every stream answered", finished == 4);
+	return failed;
+}
+
 int main()
 {
 	// spdlog::set_level(spdlog::level::trace);
@@ -72,5 +294,5 @@ int main()
 	// std::cout << std::endl;
 
 	// return libgs::execution::exec();
-	return 0;
+	return socket_options_test() + sse_keepalive_test() + h2c_test() == 0 ? 0 : 1;
 }